@@ -0,0 +1,32 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file bsp.cpp
+
+    @brief Board support for the native Linux host
+*/
+
+#include "bsp.h"
+
+#include <string.h>
+#include <unistd.h>
+
+//---------------------------------------------------------------------------
+void DebugPrint(const char* szString_)
+{
+    // Use write(2) directly - stdio's locks are not safe to use from multiple
+    // Mark3 threads sharing one host thread.
+    auto iUnused = write(STDOUT_FILENO, szString_, strlen(szString_));
+    (void)iUnused;
+}
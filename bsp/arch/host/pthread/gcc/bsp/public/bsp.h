@@ -0,0 +1,31 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file bsp.h
+
+    @brief Board support for the native Linux host
+*/
+#pragma once
+
+extern "C" {
+/**
+ * @brief DebugPrint
+ *
+ * Write a null-terminated string to the host process' stdout.  Suitable for
+ * use as the kernel's debug print function.
+ *
+ * @param szString_ String to print
+ */
+void DebugPrint(const char* szString_);
+}
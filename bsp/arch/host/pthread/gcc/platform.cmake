@@ -0,0 +1,10 @@
+# Host BSP - use the kernel's default host toolchain configuration, and link
+# every binary against the host board-support library.
+include("${mark3_root_dir}/build/arch/host/pthread/gcc/platform.cmake")
+
+set(HOST_BSP_BASE_LIBS
+    bsp
+    ${HOST_BASE_LIBS}
+    )
+
+set_property(GLOBAL PROPERTY global_base_libs "${HOST_BSP_BASE_LIBS}")
@@ -0,0 +1,62 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file ut_support.h
+
+    @brief Unit test and profiling support hooks for the native Linux host
+*/
+#pragma once
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+/**
+ * Board-specific hooks invoked by the unit test and profiling harnesses.  On
+ * the host, these install a "/dev/tty" driver bound to stdout, and terminate
+ * the process once the tests have completed.
+ */
+class UnitTestSupport
+{
+public:
+    /**
+     * @brief OnInit
+     *
+     * Called from main(), before the kernel is started.
+     */
+    static void OnInit();
+
+    /**
+     * @brief OnStart
+     *
+     * Called from the test application thread, once the kernel is running.
+     */
+    static void OnStart();
+
+    /**
+     * @brief OnIdle
+     *
+     * Called repeatedly from the idle thread.
+     */
+    static void OnIdle();
+
+    /**
+     * @brief OnExit
+     *
+     * Called once all tests have completed.
+     *
+     * @param iExitCode_ Exit code to report to the host environment
+     */
+    static void OnExit(int iExitCode_);
+};
+} // namespace Mark3
@@ -0,0 +1,93 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file ut_support.cpp
+
+    @brief Unit test and profiling support hooks for the native Linux host
+*/
+
+#include "mark3.h"
+#include "driver.h"
+#include "ut_support.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace Mark3
+{
+namespace
+{
+    //---------------------------------------------------------------------------
+    /**
+        Console driver (/dev/tty) mapped to the host process' stdout.  Output is
+        written with write(2) directly, as stdio's locks are not safe to use from
+        multiple Mark3 threads sharing one host thread.
+    */
+    class HostTTY : public Driver
+    {
+    public:
+        virtual int Init()
+        {
+            SetName("/dev/tty");
+            return 0;
+        }
+        virtual int    Open() { return 0; }
+        virtual int    Close() { return 0; }
+        virtual size_t Read(void* /*pvData_*/, size_t /*uBytes_*/) { return 0; }
+        virtual size_t Write(const void* pvData_, size_t uBytes_)
+        {
+            auto iWritten = write(STDOUT_FILENO, pvData_, uBytes_);
+            return (iWritten < 0) ? 0 : static_cast<size_t>(iWritten);
+        }
+        virtual int Control(uint16_t /*u16EventID_*/,
+                            void* /*pvDataIn_*/,
+                            size_t /*uSizeIn_*/,
+                            const void* /*pvDataOut_*/,
+                            size_t /*uSizeOut_*/)
+        {
+            return 0;
+        }
+    };
+
+    //---------------------------------------------------------------------------
+    HostTTY clHostTTY;
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+void UnitTestSupport::OnInit()
+{
+    DriverList::Init();
+    clHostTTY.Init();
+    DriverList::Add(&clHostTTY);
+}
+
+//---------------------------------------------------------------------------
+void UnitTestSupport::OnStart()
+{
+    // Nothing to do...
+}
+
+//---------------------------------------------------------------------------
+void UnitTestSupport::OnIdle()
+{
+    // Sleep the host thread until the next signal (i.e. kernel tick) arrives
+    pause();
+}
+
+//---------------------------------------------------------------------------
+void UnitTestSupport::OnExit(int iExitCode_)
+{
+    _exit(iExitCode_);
+}
+} // namespace Mark3
@@ -5,14 +5,12 @@ find_program(HOST_SIZE_TOOL size)
 find_program(HOST_OBJDUMP objdump)
 
 #----------------------------------------------------------------------------
-set(HOST_CC_FLAGS "\    
+set(HOST_CC_FLAGS "\
     -funsigned-char \
     -funsigned-bitfields \
     -O0 \
     -g3 \
     -ffunction-sections \
-    -fshort-enums  \
-    -fpack-struct \
     -Wall \
     -c \
     ")
@@ -23,15 +21,15 @@ set(HOST_CXX_FLAGS "\
     -Os \
     -g3 \
     -std=c++11 \
-    -fpack-struct \
     -ffunction-sections \
-    -fshort-enums  \
+    -fno-exceptions \
+    -fno-rtti \
     -Wall \
     -c \
     ")
 
 set(HOST_LN_FLAGS "\
-    -Wl,-start-group \
+    -Wl,--start-group \
     -Wl,-lm  \
     -Wl,--end-group \
     -Wl,--gc-sections \
@@ -41,8 +39,6 @@ set(HOST_LN_DBG_FLAGS "\
     -Wl,--start-group \
     -Wl,-lm  \
     -Wl,--end-group \
-    -Wl,--section-start=.logger=0x1000000 \
-    -mmcu=atmega1284p \
     ")
     
 set(HOST_OBJCOPY_FLAGS
@@ -54,6 +50,8 @@ set(HOST_OBJCOPY_DBG_FLAGS
     )
 
 set(HOST_BASE_LIBS
+    pthread
+    rt
     )
 
 #----------------------------------------------------------------------------
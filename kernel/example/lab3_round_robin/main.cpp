@@ -123,8 +123,10 @@ int main(void)
     // priority group by default.  You can play around with these values and
     // observe how it affects the execution of both threads.
 
+#if KERNEL_ROUND_ROBIN
     clApp1Thread.SetQuantum(4);
     clApp2Thread.SetQuantum(8);
+#endif // #if KERNEL_ROUND_ROBIN
 
     clApp1Thread.Start();
     clApp2Thread.Start();
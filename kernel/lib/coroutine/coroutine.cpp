@@ -0,0 +1,316 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file coroutine.cpp
+
+    @brief Stackless cooperative tasks multiplexed onto a single kernel thread.
+ */
+
+#include "mark3.h"
+#include "coroutine.h"
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void CoTask::Init(CoTaskFunc pfFunc_, void* pvArg_)
+{
+    KERNEL_ASSERT(pfFunc_ != nullptr);
+
+    ClearNode();
+    m_pfFunc       = pfFunc_;
+    m_pvArg        = pvArg_;
+    m_pclScheduler = nullptr;
+    m_u16Resume    = 0;
+    m_eState       = CoState::Stopped;
+}
+
+//---------------------------------------------------------------------------
+void CoScheduler::Init()
+{
+    m_clReady.Init();
+    m_clWake.Init(0, 1);
+}
+
+//---------------------------------------------------------------------------
+void CoScheduler::Add(CoTask* pclTask_)
+{
+    KERNEL_ASSERT(pclTask_ != nullptr);
+    KERNEL_ASSERT(pclTask_->m_eState == CoState::Stopped);
+
+    pclTask_->m_pclScheduler = this;
+    MakeReady(pclTask_);
+}
+
+//---------------------------------------------------------------------------
+void CoScheduler::MakeReady(CoTask* pclTask_)
+{
+    KERNEL_ASSERT(pclTask_->m_pclScheduler == this);
+
+    CS_ENTER();
+    // A task may be woken by several objects between runs - only the first
+    // wakeup moves it; a running task is rescheduled on return instead.
+    if ((pclTask_->m_eState == CoState::Waiting) || (pclTask_->m_eState == CoState::Stopped)) {
+        pclTask_->m_eState = CoState::Ready;
+        m_clReady.Add(pclTask_);
+    }
+    CS_EXIT();
+
+    m_clWake.Post();
+}
+
+//---------------------------------------------------------------------------
+bool CoScheduler::RunOnce()
+{
+    CoTask* pclTask;
+
+    CS_ENTER();
+    pclTask = static_cast<CoTask*>(m_clReady.GetHead());
+    if (pclTask != nullptr) {
+        m_clReady.Remove(pclTask);
+        pclTask->m_eState = CoState::Running;
+    }
+    CS_EXIT();
+
+    if (pclTask == nullptr) {
+        return false;
+    }
+
+    auto eResult = pclTask->m_pfFunc(pclTask, pclTask->m_pvArg);
+
+    CS_ENTER();
+    if (eResult == CoResult::Yield) {
+        pclTask->m_eState = CoState::Ready;
+        m_clReady.Add(pclTask);
+    } else if (eResult == CoResult::Done) {
+        pclTask->m_eState = CoState::Stopped;
+    }
+    // On CoResult::Wait, the task has already been placed in a wait list
+    // (and possibly woken again) by the object it is waiting on.
+    CS_EXIT();
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+void CoScheduler::Run()
+{
+    while (true) {
+        if (!RunOnce()) {
+            m_clWake.Pend();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void CoWaitList::Block(CoTask* pclTask_)
+{
+    KERNEL_ASSERT(pclTask_->m_eState == CoState::Running);
+
+    CS_ENTER();
+    pclTask_->m_eState = CoState::Waiting;
+    m_clList.Add(pclTask_);
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void CoWaitList::WakeOne()
+{
+    CS_ENTER();
+    auto* pclTask = static_cast<CoTask*>(m_clList.GetHead());
+    if (pclTask != nullptr) {
+        m_clList.Remove(pclTask);
+        pclTask->m_pclScheduler->MakeReady(pclTask);
+    }
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void CoWaitList::WakeAll()
+{
+    CS_ENTER();
+    auto* pclTask = static_cast<CoTask*>(m_clList.GetHead());
+    while (pclTask != nullptr) {
+        m_clList.Remove(pclTask);
+        pclTask->m_pclScheduler->MakeReady(pclTask);
+        pclTask = static_cast<CoTask*>(m_clList.GetHead());
+    }
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void CoSemaphore::Init(uint16_t u16InitVal_, uint16_t u16MaxVal_)
+{
+    m_clSemaphore.Init(u16InitVal_, u16MaxVal_);
+    m_clWaiters.Init();
+}
+
+//---------------------------------------------------------------------------
+bool CoSemaphore::Post()
+{
+    auto bPosted = m_clSemaphore.Post();
+    if (bPosted) {
+        m_clWaiters.WakeOne();
+    }
+    return bPosted;
+}
+
+//---------------------------------------------------------------------------
+bool CoSemaphore::Pend(CoTask* pclTask_)
+{
+    auto bClaimed = false;
+
+    CS_ENTER();
+    bClaimed = m_clSemaphore.TryPend();
+    if (!bClaimed) {
+        m_clWaiters.Block(pclTask_);
+    }
+    CS_EXIT();
+
+    return bClaimed;
+}
+
+//---------------------------------------------------------------------------
+void CoMailbox::Init(void* pvBuffer_, uint16_t u16BufferSize_, uint16_t u16ElementSize_)
+{
+    m_clMailbox.Init(pvBuffer_, u16BufferSize_, u16ElementSize_);
+    m_clRecvWaiters.Init();
+    m_clSendWaiters.Init();
+}
+
+//---------------------------------------------------------------------------
+bool CoMailbox::Send(void* pvData_)
+{
+    auto bSent = m_clMailbox.Send(pvData_);
+    if (bSent) {
+        m_clRecvWaiters.WakeOne();
+    }
+    return bSent;
+}
+
+//---------------------------------------------------------------------------
+bool CoMailbox::Send(CoTask* pclTask_, void* pvData_)
+{
+    auto bSent = false;
+
+    CS_ENTER();
+    bSent = m_clMailbox.Send(pvData_);
+    if (!bSent) {
+        m_clSendWaiters.Block(pclTask_);
+    }
+    CS_EXIT();
+
+    if (bSent) {
+        m_clRecvWaiters.WakeOne();
+    }
+    return bSent;
+}
+
+//---------------------------------------------------------------------------
+bool CoMailbox::Receive(CoTask* pclTask_, void* pvData_)
+{
+    auto bReceived = false;
+
+    CS_ENTER();
+    bReceived = m_clMailbox.TryReceive(pvData_);
+    if (!bReceived) {
+        m_clRecvWaiters.Block(pclTask_);
+    }
+    CS_EXIT();
+
+    if (bReceived) {
+        m_clSendWaiters.WakeOne();
+    }
+    return bReceived;
+}
+
+#if KERNEL_EVENT_FLAGS
+//---------------------------------------------------------------------------
+void CoEventFlag::Init()
+{
+    m_clFlag.Init();
+    m_clWaiters.Init();
+}
+
+//---------------------------------------------------------------------------
+void CoEventFlag::Set(uint16_t u16Mask_)
+{
+    m_clFlag.Set(u16Mask_);
+
+    // Each woken task re-tests its own condition, and re-blocks if another
+    // task consumed the flags first.
+    m_clWaiters.WakeAll();
+}
+
+//---------------------------------------------------------------------------
+uint16_t CoEventFlag::Wait(CoTask* pclTask_, uint16_t u16Mask_, EventFlagOperation eMode_)
+{
+    uint16_t u16Match;
+
+    CS_ENTER();
+    u16Match = m_clFlag.TryWait(u16Mask_, eMode_);
+    if (u16Match == 0) {
+        m_clWaiters.Block(pclTask_);
+    }
+    CS_EXIT();
+
+    return u16Match;
+}
+#endif // #if KERNEL_EVENT_FLAGS
+
+//---------------------------------------------------------------------------
+void CoTimer::Init()
+{
+    m_clTimer.Init();
+    m_clWaiters.Init();
+    m_bExpired = false;
+}
+
+//---------------------------------------------------------------------------
+void CoTimer::Start(uint32_t u32IntervalMs_)
+{
+    m_clTimer.Stop();
+    m_bExpired = false;
+    m_clTimer.Start(false, u32IntervalMs_, Callback, this);
+}
+
+//---------------------------------------------------------------------------
+void CoTimer::Stop()
+{
+    m_clTimer.Stop();
+}
+
+//---------------------------------------------------------------------------
+bool CoTimer::Expired(CoTask* pclTask_)
+{
+    auto bExpired = false;
+
+    CS_ENTER();
+    bExpired = m_bExpired;
+    if (!bExpired) {
+        m_clWaiters.Block(pclTask_);
+    }
+    CS_EXIT();
+
+    return bExpired;
+}
+
+//---------------------------------------------------------------------------
+void CoTimer::Callback(Thread* /*pclOwner_*/, void* pvData_)
+{
+    auto* pclThis = static_cast<CoTimer*>(pvData_);
+
+    pclThis->m_bExpired = true;
+    pclThis->m_clWaiters.WakeAll();
+}
+} // namespace Mark3
@@ -0,0 +1,527 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file coroutine.h
+
+    @brief Stackless cooperative tasks multiplexed onto a single kernel thread.
+
+    Each CoTask is a function that is re-entered from the top every time it is
+    scheduled, and which uses the CO_* macros to resume from the point where it
+    last yielded.  Tasks do not own a stack - local variables do not survive a
+    CO_YIELD()/CO_AWAIT(), so any state that must persist belongs in the object
+    passed as the task's argument.  As with any switch-based continuation, a
+    task body must not place CO_YIELD()/CO_AWAIT() inside a switch statement of
+    its own.
+
+    A CoScheduler runs on a regular Mark3 thread and executes its ready tasks
+    round-robin.  When no task is ready, the host thread blocks on a semaphore
+    until a task is made ready again - from another thread, from a timer, or
+    from an interrupt.
+
+    The CoSemaphore, CoMailbox, CoEventFlag and CoTimer classes wrap the kernel
+    objects of the same name, and allow tasks to wait on them with CO_AWAIT().
+    Coroutines are only woken when the object is signalled through the wrapper
+    (e.g. CoSemaphore::Post() rather than Semaphore::Post()), while threads may
+    continue to block on the wrapped kernel object directly.
+ */
+
+#include "kerneltypes.h"
+#include "mark3.h"
+
+#pragma once
+
+namespace Mark3
+{
+class CoTask;
+class CoScheduler;
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The CoResult enum
+ *
+ * Value returned by a task function to its scheduler.  Generated by the CO_*
+ * macros, and not normally returned explicitly.
+ */
+enum class CoResult : uint8_t {
+    Yield, //!< Task yielded and remains ready
+    Wait,  //!< Task is waiting on an awaitable object
+    Done   //!< Task ran to completion
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The CoState enum
+ *
+ * Scheduling state of a CoTask
+ */
+enum class CoState : uint8_t {
+    Stopped, //!< Task is not attached to a scheduler, or has completed
+    Ready,   //!< Task is in its scheduler's ready list
+    Running, //!< Task is currently being executed by its scheduler
+    Waiting  //!< Task is in the wait list of an awaitable object
+};
+
+//---------------------------------------------------------------------------
+/**
+ * Function implementing the body of a CoTask
+ */
+using CoTaskFunc = CoResult (*)(CoTask* pclTask_, void* pvArg_);
+
+//---------------------------------------------------------------------------
+/**
+ * @brief CO_BEGIN - Mark the start of a coroutine body.
+ * @param pclTask_ Pointer to the task being executed
+ */
+#define CO_BEGIN(pclTask_)                                                                                             \
+    switch ((pclTask_)->GetResumePoint()) {                                                                            \
+        case 0:
+
+//---------------------------------------------------------------------------
+/**
+ * @brief CO_YIELD - Return control to the scheduler, resuming at this point
+ *        once every other ready task has had a turn.
+ * @param pclTask_ Pointer to the task being executed
+ */
+#define CO_YIELD(pclTask_)                                                                                             \
+    do {                                                                                                               \
+        (pclTask_)->SetResumePoint(__LINE__);                                                                          \
+        return Mark3::CoResult::Yield;                                                                                 \
+        case __LINE__:;                                                                                                \
+    } while (0)
+
+//---------------------------------------------------------------------------
+/**
+ * @brief CO_AWAIT - Suspend the task until an awaitable condition is met.
+ *
+ * The condition is re-evaluated each time the task is woken, and must be a call
+ * to one of the awaitable wrapper objects (CoSemaphore::Pend(), etc.), which
+ * registers the task to be woken when it fails.
+ *
+ * @param pclTask_ Pointer to the task being executed
+ * @param bCond_ Awaitable expression, true once the task may continue.
+ */
+#define CO_AWAIT(pclTask_, bCond_)                                                                                     \
+    do {                                                                                                               \
+        (pclTask_)->SetResumePoint(__LINE__);                                                                          \
+        case __LINE__:                                                                                                 \
+            if (!(bCond_)) {                                                                                           \
+                return Mark3::CoResult::Wait;                                                                          \
+            }                                                                                                          \
+    } while (0)
+
+//---------------------------------------------------------------------------
+/**
+ * @brief CO_END - Mark the end of a coroutine body.  A task reaching this point
+ *        is complete, and is detached from its scheduler.
+ * @param pclTask_ Pointer to the task being executed
+ */
+#define CO_END(pclTask_)                                                                                               \
+    }                                                                                                                  \
+    (pclTask_)->SetResumePoint(0);                                                                                     \
+    return Mark3::CoResult::Done
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The CoTask class
+ *
+ * Control block for a single stackless task.  A task costs one of these objects,
+ * plus whatever persistent state the application passes in as its argument.
+ */
+class CoTask : public LinkListNode
+{
+public:
+    /**
+     * @brief Init
+     *
+     * Initialize the task prior to adding it to a scheduler.  Calling this on a
+     * completed task allows it to be restarted from the top.
+     *
+     * @param pfFunc_ Function implementing the task body
+     * @param pvArg_  Argument passed to the task body each time it is run
+     */
+    void Init(CoTaskFunc pfFunc_, void* pvArg_);
+
+    /**
+     * @brief GetState
+     * @return The current scheduling state of the task
+     */
+    CoState GetState() { return m_eState; }
+
+    /**
+     * @brief GetScheduler
+     * @return The scheduler the task is attached to, or nullptr if it has never been attached
+     */
+    CoScheduler* GetScheduler() { return m_pclScheduler; }
+
+    /**
+     * @brief GetResumePoint
+     *
+     * Used by the CO_* macros to find where to resume the task body.
+     *
+     * @return The current resume point
+     */
+    uint16_t GetResumePoint() { return m_u16Resume; }
+
+    /**
+     * @brief SetResumePoint
+     *
+     * Used by the CO_* macros to record where to resume the task body.
+     *
+     * @param u16Resume_ New resume point
+     */
+    void SetResumePoint(uint16_t u16Resume_) { m_u16Resume = u16Resume_; }
+
+private:
+    friend class CoScheduler;
+    friend class CoWaitList;
+
+    CoTaskFunc   m_pfFunc;       //!< Task body
+    void*        m_pvArg;        //!< Argument passed to the task body
+    CoScheduler* m_pclScheduler; //!< Scheduler the task is attached to
+    uint16_t     m_u16Resume;    //!< Resume point within the task body
+    CoState      m_eState;       //!< Current scheduling state
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The CoScheduler class
+ *
+ * Round-robin executor for a group of CoTask objects, run from a single host
+ * thread.  Tasks run to their next CO_YIELD()/CO_AWAIT() without preemption by
+ * one another, but the host thread is preempted by the kernel as usual.
+ */
+class CoScheduler
+{
+public:
+    /**
+     * @brief Init
+     *
+     * Initialize the scheduler prior to use.
+     */
+    void Init();
+
+    /**
+     * @brief Add
+     *
+     * Attach an initialized task to this scheduler, and make it ready to run.
+     *
+     * @param pclTask_ Task to add
+     */
+    void Add(CoTask* pclTask_);
+
+    /**
+     * @brief RunOnce
+     *
+     * Run the task at the head of the ready list until it yields, waits, or
+     * completes.
+     *
+     * @return true if a task was run, false if no task was ready
+     */
+    bool RunOnce();
+
+    /**
+     * @brief Run
+     *
+     * Run tasks forever from the calling thread, blocking the thread whenever
+     * there is no task ready to run.
+     */
+    void Run();
+
+    /**
+     * @brief MakeReady
+     *
+     * Place a stopped or waiting task at the tail of the ready list, and wake
+     * the host thread.  This is used by the awaitable objects, and is safe to
+     * call from interrupt context.
+     *
+     * @param pclTask_ Task to make ready
+     */
+    void MakeReady(CoTask* pclTask_);
+
+private:
+    DoubleLinkList m_clReady; //!< Tasks ready to run, in round-robin order
+    Semaphore      m_clWake;  //!< Posted when a task is made ready
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The CoWaitList class
+ *
+ * List of tasks waiting on an awaitable object.  Used to implement the
+ * awaitable wrappers, and available for building custom ones.
+ */
+class CoWaitList
+{
+public:
+    /**
+     * @brief Init
+     *
+     * Initialize the wait list prior to use.
+     */
+    void Init() { m_clList.Init(); }
+
+    /**
+     * @brief Block
+     *
+     * Add the currently-running task to the wait list.  This must be called
+     * from within the same critical section as the failed check on the
+     * awaitable object, so that a wakeup cannot be lost between the two.
+     *
+     * @param pclTask_ Task to block
+     */
+    void Block(CoTask* pclTask_);
+
+    /**
+     * @brief WakeOne
+     *
+     * Make the task at the head of the wait list ready to run.
+     */
+    void WakeOne();
+
+    /**
+     * @brief WakeAll
+     *
+     * Make every task in the wait list ready to run.
+     */
+    void WakeAll();
+
+private:
+    DoubleLinkList m_clList; //!< Tasks currently waiting
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The CoSemaphore class
+ *
+ * Counting semaphore which may be pended by both threads and coroutines.
+ */
+class CoSemaphore
+{
+public:
+    /**
+     * @brief Init
+     *
+     * Initialize the semaphore prior to use.
+     *
+     * @param u16InitVal_ Initial count of the semaphore
+     * @param u16MaxVal_ Maximum count of the semaphore
+     */
+    void Init(uint16_t u16InitVal_, uint16_t u16MaxVal_);
+
+    /**
+     * @brief Post
+     *
+     * Increment the semaphore count, waking a blocked thread or coroutine.
+     * Safe to call from interrupt context.
+     *
+     * @return true if the semaphore was posted, false if the count is already maxed out.
+     */
+    bool Post();
+
+    /**
+     * @brief Pend
+     *
+     * Claim the semaphore from a coroutine.  Use with CO_AWAIT().
+     *
+     * @param pclTask_ Task attempting to claim the semaphore
+     * @return true if the semaphore was claimed, false if the task must wait
+     */
+    bool Pend(CoTask* pclTask_);
+
+    /**
+     * @brief GetSemaphore
+     * @return The wrapped kernel semaphore, which may be pended by threads
+     */
+    Semaphore* GetSemaphore() { return &m_clSemaphore; }
+
+private:
+    Semaphore  m_clSemaphore; //!< Wrapped kernel semaphore
+    CoWaitList m_clWaiters;   //!< Coroutines waiting to pend the semaphore
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The CoMailbox class
+ *
+ * Mailbox which may be read and written by both threads and coroutines.
+ */
+class CoMailbox
+{
+public:
+    /**
+     * @brief Init
+     *
+     * Initialize the mailbox prior to use.
+     *
+     * @param pvBuffer_ Pointer to the static buffer to use for the mailbox
+     * @param u16BufferSize_ Size of the mailbox buffer, in bytes
+     * @param u16ElementSize_ Size of each envelope, in bytes
+     */
+    void Init(void* pvBuffer_, uint16_t u16BufferSize_, uint16_t u16ElementSize_);
+
+    /**
+     * @brief Send
+     *
+     * Send an envelope to the mailbox without blocking, waking a receiving
+     * thread or coroutine.
+     *
+     * @param pvData_ Pointer to the data to copy into the mailbox
+     * @return true if the envelope was sent, false if the mailbox is full
+     */
+    bool Send(void* pvData_);
+
+    /**
+     * @brief Send
+     *
+     * Send an envelope to the mailbox from a coroutine.  Use with CO_AWAIT().
+     *
+     * @param pclTask_ Task sending the envelope
+     * @param pvData_ Pointer to the data to copy into the mailbox
+     * @return true if the envelope was sent, false if the task must wait for a free slot
+     */
+    bool Send(CoTask* pclTask_, void* pvData_);
+
+    /**
+     * @brief Receive
+     *
+     * Receive an envelope from the mailbox from a coroutine.  Use with CO_AWAIT().
+     *
+     * @param pclTask_ Task receiving the envelope
+     * @param pvData_ Pointer to a buffer to copy the envelope into
+     * @return true if an envelope was received, false if the task must wait
+     */
+    bool Receive(CoTask* pclTask_, void* pvData_);
+
+    /**
+     * @brief GetMailbox
+     * @return The wrapped kernel mailbox, which may be received from by threads
+     */
+    Mailbox* GetMailbox() { return &m_clMailbox; }
+
+private:
+    Mailbox    m_clMailbox;     //!< Wrapped kernel mailbox
+    CoWaitList m_clRecvWaiters; //!< Coroutines waiting for an envelope
+    CoWaitList m_clSendWaiters; //!< Coroutines waiting for a free slot
+};
+
+#if KERNEL_EVENT_FLAGS
+//---------------------------------------------------------------------------
+/**
+ * @brief The CoEventFlag class
+ *
+ * Event flag group which may be waited on by both threads and coroutines.
+ */
+class CoEventFlag
+{
+public:
+    /**
+     * @brief Init
+     *
+     * Initialize the event flag group prior to use.
+     */
+    void Init();
+
+    /**
+     * @brief Set
+     *
+     * Set flags in the group, waking any threads or coroutines whose conditions are met.
+     *
+     * @param u16Mask_ Bitmask of flags to set
+     */
+    void Set(uint16_t u16Mask_);
+
+    /**
+     * @brief Clear
+     *
+     * Clear flags in the group.
+     *
+     * @param u16Mask_ Bitmask of flags to clear
+     */
+    void Clear(uint16_t u16Mask_) { m_clFlag.Clear(u16Mask_); }
+
+    /**
+     * @brief Wait
+     *
+     * Wait on flags in the group from a coroutine.  Use with CO_AWAIT().
+     *
+     * @param pclTask_ Task waiting on the flags
+     * @param u16Mask_ Bitmask of flags to wait on
+     * @param eMode_ Operation to test the mask with
+     * @return Bitmask condition that was matched, or 0 if the task must wait
+     */
+    uint16_t Wait(CoTask* pclTask_, uint16_t u16Mask_, EventFlagOperation eMode_);
+
+    /**
+     * @brief GetEventFlag
+     * @return The wrapped kernel event flag, which may be waited on by threads
+     */
+    EventFlag* GetEventFlag() { return &m_clFlag; }
+
+private:
+    EventFlag  m_clFlag;    //!< Wrapped kernel event flag
+    CoWaitList m_clWaiters; //!< Coroutines waiting on the flags
+};
+#endif // #if KERNEL_EVENT_FLAGS
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The CoTimer class
+ *
+ * One-shot timer whose expiry may be awaited by coroutines - the stackless
+ * equivalent of Thread::Sleep().
+ */
+class CoTimer
+{
+public:
+    /**
+     * @brief Init
+     *
+     * Initialize the timer prior to use.
+     */
+    void Init();
+
+    /**
+     * @brief Start
+     *
+     * (Re)start the timer, clearing any previous expiry.
+     *
+     * @param u32IntervalMs_ Time until expiry, in ms
+     */
+    void Start(uint32_t u32IntervalMs_);
+
+    /**
+     * @brief Stop
+     *
+     * Stop the timer without expiring it.
+     */
+    void Stop();
+
+    /**
+     * @brief Expired
+     *
+     * Check whether the timer has expired from a coroutine.  Use with CO_AWAIT().
+     *
+     * @param pclTask_ Task waiting on the timer
+     * @return true if the timer has expired, false if the task must wait
+     */
+    bool Expired(CoTask* pclTask_);
+
+private:
+    static void Callback(Thread* pclOwner_, void* pvData_);
+
+    Timer         m_clTimer;   //!< Wrapped kernel timer
+    CoWaitList    m_clWaiters; //!< Coroutines waiting on expiry
+    volatile bool m_bExpired;  //!< Set when the timer has expired
+};
+} // namespace Mark3
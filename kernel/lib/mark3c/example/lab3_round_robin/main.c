@@ -73,8 +73,10 @@ int main(void)
     // priority group by default.  You can play around with these values and
     // observe how it affects the execution of both threads.
 
+#if KERNEL_ROUND_ROBIN
     Thread_SetQuantum(hApp1Thread, 4);
     Thread_SetQuantum(hApp2Thread, 8);
+#endif // #if KERNEL_ROUND_ROBIN
 
     Thread_Start(hApp1Thread);
     Thread_Start(hApp2Thread);
@@ -23,6 +23,27 @@ See license.txt for more information
 
 using namespace Mark3;
 
+//---------------------------------------------------------------------------
+// The C API allocates kernel objects using the sizes of the fake types, which
+// must track the layout of the C++ objects they stand in for.
+static_assert(sizeof(Fake_LinkedListNode) == sizeof(LinkListNode), "Fake_LinkedListNode size mismatch");
+static_assert(sizeof(Fake_LinkedList) == sizeof(LinkList), "Fake_LinkedList size mismatch");
+static_assert(sizeof(Fake_ThreadList) == sizeof(ThreadList), "Fake_ThreadList size mismatch");
+static_assert(sizeof(Fake_Thread) == sizeof(Thread), "Fake_Thread size mismatch");
+static_assert(sizeof(Fake_Timer) == sizeof(Timer), "Fake_Timer size mismatch");
+static_assert(sizeof(Fake_Semaphore) == sizeof(Semaphore), "Fake_Semaphore size mismatch");
+static_assert(sizeof(Fake_Mutex) == sizeof(Mutex), "Fake_Mutex size mismatch");
+static_assert(sizeof(Fake_Message) == sizeof(Message), "Fake_Message size mismatch");
+static_assert(sizeof(Fake_MessageQueue) == sizeof(MessageQueue), "Fake_MessageQueue size mismatch");
+static_assert(sizeof(Fake_MessagePool) == sizeof(MessagePool), "Fake_MessagePool size mismatch");
+static_assert(sizeof(Fake_Mailbox) == sizeof(Mailbox), "Fake_Mailbox size mismatch");
+static_assert(sizeof(Fake_Notify) == sizeof(Notify), "Fake_Notify size mismatch");
+#if KERNEL_EVENT_FLAGS
+static_assert(sizeof(Fake_EventFlag) == sizeof(EventFlag), "Fake_EventFlag size mismatch");
+#endif // #if KERNEL_EVENT_FLAGS
+static_assert(sizeof(Fake_ConditionVariable) == sizeof(ConditionVariable), "Fake_ConditionVariable size mismatch");
+static_assert(sizeof(Fake_ReaderWriterLock) == sizeof(ReaderWriterLock), "Fake_ReaderWriterLock size mismatch");
+
 //---------------------------------------------------------------------------
 // Kernel Memory managment APIs
 //---------------------------------------------------------------------------
@@ -218,6 +239,12 @@ uint32_t Kernel_GetTicks(void)
     return Kernel::GetTicks();
 }
 
+//---------------------------------------------------------------------------
+uint64_t Kernel_GetTicks64(void)
+{
+    return Kernel::GetTicks64();
+}
+
 #if KERNEL_THREAD_CREATE_CALLOUT
 //---------------------------------------------------------------------------
 void Kernel_SetThreadCreateCallout(thread_create_callout_t pfCreate_)
@@ -357,6 +384,7 @@ PORT_PRIO_TYPE Thread_GetCurPriority(Thread_t handle)
     return pclThread->GetCurPriority();
 }
 
+#if KERNEL_ROUND_ROBIN
 //---------------------------------------------------------------------------
 void Thread_SetQuantum(Thread_t handle, uint16_t u16Quantum_)
 {
@@ -369,6 +397,7 @@ uint16_t Thread_GetQuantum(Thread_t handle)
     Thread* pclThread = (Thread*)handle;
     return pclThread->GetQuantum();
 }
+#endif // #if KERNEL_ROUND_ROBIN
 
 //---------------------------------------------------------------------------
 void Thread_SetPriority(Thread_t handle, PORT_PRIO_TYPE uXPriority_)
@@ -390,6 +419,12 @@ void Thread_Sleep(uint32_t u32TimeMs_)
     Thread::Sleep(u32TimeMs_);
 }
 
+//---------------------------------------------------------------------------
+void Thread_SleepUntil(uint32_t u32WakeTick_)
+{
+    Thread::SleepUntil(u32WakeTick_);
+}
+
 #if KERNEL_EXTENDED_CONTEXT
 //---------------------------------------------------------------------------
 void* Thread_GetExtendedContext(Thread_t handle)
@@ -511,6 +546,13 @@ void Mutex_Init(Mutex_t handle)
     pclMutex->Init();
 }
 
+//---------------------------------------------------------------------------
+void Mutex_InitCeiling(Mutex_t handle, PORT_PRIO_TYPE uXCeiling_)
+{
+    CeilingMutex* pclMutex = new ((void*)handle) CeilingMutex();
+    pclMutex->Init(uXCeiling_, true);
+}
+
 //---------------------------------------------------------------------------
 void Mutex_Claim(Mutex_t handle)
 {
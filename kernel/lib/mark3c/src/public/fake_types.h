@@ -58,8 +58,10 @@ typedef struct {
     Fake_LinkedListNode m_ll_node;
     uint8_t             m_u8Initialized;
     uint8_t             m_u8Flags;
+    uint8_t             m_u8WheelSlot;
     void*               m_pfCallback;
     uint32_t            m_u32Interval;
+    uint32_t            m_u32Tolerance;
     uint32_t            m_u32TimeLeft;
     void*               m_pclOwner;
     void*               m_pvData;
@@ -81,10 +83,15 @@ typedef struct {
     const char* m_szName;
 #endif // #if KERNEL_NAMED_THREADS
     uint16_t m_u16StackSize;
+#if KERNEL_STACK_CHECK
+    uint16_t m_u16StackMark;
+#endif // #if KERNEL_STACK_CHECK
     void*    m_pclCurrent;
     void*    m_pclOwner;
     void*    m_pfEntryPoint;
     void*    m_pvArg;
+    void*    m_pclBlockingMutex;
+    void*    m_pclHeldMutex;
 #if KERNEL_ROUND_ROBIN
     uint16_t m_u16Quantum;
 #endif // #if KERNEL_ROUND_ROBIN
@@ -92,14 +99,41 @@ typedef struct {
     uint16_t m_u16FlagMask;
     uint8_t  m_eFlagMode;
 #endif // #if KERNEL_EVENT_FLAGS
+#if KERNEL_THREAD_NOTIFY
+    uint32_t m_u32NotifyValue;
+    uint32_t m_u32NotifyMask;
+#endif // #if KERNEL_THREAD_NOTIFY
+#if KERNEL_EDF
+    uint32_t m_u32Deadline;
+    uint32_t m_u32RelDeadline;
+    uint32_t m_u32Utilization;
+#endif // #if KERNEL_EDF
+#if KERNEL_CPU_ACCOUNTING
+    uint64_t m_u64RunCycles;
+    uint32_t m_u32CpuWindow;
+#endif // #if KERNEL_CPU_ACCOUNTING
+#if KERNEL_SMP
+    uint8_t m_u8Core;
+    uint8_t m_u8Affinity;
+#endif // #if KERNEL_SMP
+#if KERNEL_CPU_BUDGETS
+    void* m_pclBudget;
+#endif // #if KERNEL_CPU_BUDGETS
     Fake_Timer m_clTimer;
     bool       m_bExpired;
+#if PORT_FPU_LAZY_SWITCH
+    bool m_bFpuContext;
+#endif // #if PORT_FPU_LAZY_SWITCH
 } Fake_Thread;
 
 //---------------------------------------------------------------------------
 typedef struct {
     Fake_ThreadList thread_list;
     uint8_t         m_u8Initialized;
+#if KERNEL_WAIT_SETS
+    uint8_t         m_u8WaitSetIndex;
+    void*           m_pclWaitSet;
+#endif // #if KERNEL_WAIT_SETS
     uint16_t        m_u16Value;
     uint16_t        m_u16MaxValue;
 } Fake_Semaphore;
@@ -108,11 +142,16 @@ typedef struct {
 typedef struct {
     Fake_ThreadList thread_list;
     uint8_t         m_u8Initialized;
+#if KERNEL_WAIT_SETS
+    uint8_t         m_u8WaitSetIndex;
+    void*           m_pclWaitSet;
+#endif // #if KERNEL_WAIT_SETS
     uint8_t         m_u8Recurse;
-    bool            m_bReady;
+    uint8_t         m_u8Lock;
     bool            m_bRecursive;
-    uint8_t         m_u8MaxPri;
+    PORT_PRIO_TYPE  m_uXCeiling;
     void*           m_pclOwner;
+    void*           m_pclNextHeld;
 } Fake_Mutex;
 
 //---------------------------------------------------------------------------
@@ -149,6 +188,10 @@ typedef struct {
 typedef struct {
     Fake_ThreadList thread_list;
     uint8_t         m_u8Initialized;
+#if KERNEL_WAIT_SETS
+    uint8_t         m_u8WaitSetIndex;
+    void*           m_pclWaitSet;
+#endif // #if KERNEL_WAIT_SETS
     bool            m_bPending;
 } Fake_Notify;
 
@@ -156,6 +199,10 @@ typedef struct {
 typedef struct {
     Fake_ThreadList thread_list;
     uint8_t         m_u8Initialized;
+#if KERNEL_WAIT_SETS
+    uint8_t         m_u8WaitSetIndex;
+    void*           m_pclWaitSet;
+#endif // #if KERNEL_WAIT_SETS
     uint16_t        m_u16EventFlag;
 } Fake_EventFlag;
 
@@ -377,6 +377,13 @@ uint16_t Kernel_GetStackGuardThreshold(void);
  */
 uint32_t Kernel_GetTicks(void);
 
+/**
+ * @brief Kernel_GetTicks64
+ * @sa Kernel::GetTicks64()
+ * @return Number of kernel ticks that have elapsed since boot, as a 64-bit count
+ */
+uint64_t Kernel_GetTicks64(void);
+
 //---------------------------------------------------------------------------
 // Scheduler APIs
 /**
@@ -501,6 +508,12 @@ void Thread_Exit(Thread_t handle);
  * @param u32TimeMs_ Time in ms to block the thread for
  */
 void Thread_Sleep(uint32_t u32TimeMs_);
+/**
+ * @brief Thread_SleepUntil
+ * @sa void Thread::SleepUntil(uint32_t u32WakeTick_)
+ * @param u32WakeTick_ Kernel tick count at which to wake the thread
+ */
+void Thread_SleepUntil(uint32_t u32WakeTick_);
 
 #if KERNEL_EXTENDED_CONTEXT
 /**
@@ -639,6 +652,13 @@ bool Semaphore_TimedPend(Semaphore_t handle, uint32_t u32WaitTimeMS_);
  * @param handle Handle of the mutex
  */
 void Mutex_Init(Mutex_t handle);
+/**
+ * @brief Mutex_InitCeiling
+ * @sa void CeilingMutex::Init(PORT_PRIO_TYPE uXCeiling_, bool bRecursive_)
+ * @param handle Handle of the mutex
+ * @param uXCeiling_ Priority the owner is raised to while holding the mutex
+ */
+void Mutex_InitCeiling(Mutex_t handle, PORT_PRIO_TYPE uXCeiling_);
 /**
  * @brief Mutex_Claim
  * @sa void Mutex::Claim()
@@ -0,0 +1,72 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file kernelprofile.cpp
+
+    @brief Profiling timer implementation
+*/
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+#include "profile.h"
+#include "kernelprofile.h"
+#include "kerneltimer.h"
+#include "threadport.h"
+
+#include "a53_raspi3.h"
+
+namespace Mark3
+{
+uint32_t Profiler::m_u32Epoch;
+bool     Profiler::m_bActive;
+
+//---------------------------------------------------------------------------
+void Profiler::Init()
+{
+    m_u32Epoch = 0;
+    m_bActive  = false;
+    ThreadPort::StartCycleCounter();
+}
+
+//---------------------------------------------------------------------------
+void Profiler::Start()
+{
+    m_bActive = true;
+}
+
+//---------------------------------------------------------------------------
+void Profiler::Stop()
+{
+    m_bActive = false;
+}
+//---------------------------------------------------------------------------
+uint16_t Profiler::Read()
+{
+    // The 64-bit cycle counter never wraps in practice, so the epoch is simply
+    // its upper bits, and the value returned its lower 16 bits.
+    uint16_t rc = 0;
+    CS_ENTER();
+    auto u64Count = ThreadPort::ReadCycleCounter();
+    m_u32Epoch    = static_cast<uint32_t>(u64Count >> 16);
+    rc            = static_cast<uint16_t>(u64Count);
+    CS_EXIT();
+    return rc;
+}
+
+//---------------------------------------------------------------------------
+void Profiler::Process()
+{
+    Read();
+}
+} // namespace Mark3
@@ -0,0 +1,84 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   kernelswi.cpp
+
+    @brief  Kernel Software interrupt implementation for ARM Cortex-A53 (Raspberry Pi 3)
+
+    Context switches are requested by setting a bit in the core's mailbox 0,
+    whose interrupt is routed to the core as an IRQ.  With KERNEL_SMP, the
+    same mailbox of another core serves as an inter-processor interrupt.
+*/
+
+#include "kerneltypes.h"
+#include "kernelswi.h"
+#include "threadport.h"
+
+#include "a53_raspi3.h"
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void KernelSWI::Config(void)
+{
+    Clear();
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::Start(void)
+{
+    RPI_CORE_MBOX_IRQCNTL(ThreadPort::CoreId()) |= RPI_MBOX_IRQCNTL_MBOX0;
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::Stop(void)
+{
+    RPI_CORE_MBOX_IRQCNTL(ThreadPort::CoreId()) &= ~RPI_MBOX_IRQCNTL_MBOX0;
+}
+
+//---------------------------------------------------------------------------
+uint8_t KernelSWI::DI()
+{
+    // Not implemented
+    return 0;
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::RI(bool bEnable_)
+{
+    // Not implemented
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::Clear(void)
+{
+    // Mailbox bits are cleared by writing 1's to the read/clear register
+    RPI_CORE_MBOX0_RDCLR(ThreadPort::CoreId()) = 0xFFFFFFFF;
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::Trigger(void)
+{
+    RPI_CORE_MBOX0_SET(ThreadPort::CoreId()) = 1;
+}
+
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+void KernelSWI::TriggerCore(uint8_t u8Core_)
+{
+    RPI_CORE_MBOX0_SET(u8Core_) = 1;
+}
+#endif // #if KERNEL_SMP
+} // namespace Mark3
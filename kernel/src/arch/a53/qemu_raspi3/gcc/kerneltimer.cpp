@@ -0,0 +1,167 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   kerneltimer.cpp
+
+    @brief  Kernel Timer Implementation for ARM Cortex-A53 (Raspberry Pi 3)
+
+    The kernel tick is driven by the core's virtual generic timer, which is
+    routed to core 0's IRQ through the per-core interrupt controller.
+*/
+
+#include "kerneltypes.h"
+#include "kerneltimer.h"
+#include "threadport.h"
+#include "a53_raspi3.h"
+#include "kernel.h"
+#include "ksemaphore.h"
+#include "kernelprofile.h"
+#include "thread.h"
+#include "quantum.h"
+
+using namespace Mark3;
+namespace
+{
+#if KERNEL_TIMERS_THREADED
+//---------------------------------------------------------------------------
+// Static objects implementing the timer thread and its synchronization objects
+Thread    s_clTimerThread;
+K_WORD    s_clTimerThreadStack[PORT_KERNEL_TIMERS_THREAD_STACK];
+Semaphore s_clTimerSemaphore;
+#endif // #if KERNEL_TIMERS_THREADED
+
+//---------------------------------------------------------------------------
+// Generic timer counts per kernel tick, derived from the counter frequency
+uint64_t s_u64CountsPerTick;
+
+//---------------------------------------------------------------------------
+// Process timer expiries for a single pass of the timer scheduler
+void ProcessTimers()
+{
+#if KERNEL_ROUND_ROBIN
+    Quantum::SetInTimer();
+#endif // #if KERNEL_ROUND_ROBIN
+    TimerScheduler::Process();
+#if KERNEL_ROUND_ROBIN
+    Quantum::ClearInTimer();
+#endif // #if KERNEL_ROUND_ROBIN
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+extern "C" {
+void A53_TimerHandler(void)
+{
+    // Advance the compare value by a whole period (rather than reloading
+    // relative to "now"), so that interrupt latency doesn't accumulate as drift.
+    // This also clears the interrupt condition.
+    uint64_t u64Compare;
+    A53_READ_SYSREG(CNTV_CVAL_EL0, u64Compare);
+    A53_WRITE_SYSREG(CNTV_CVAL_EL0, u64Compare + s_u64CountsPerTick);
+
+    if (!Kernel::IsStarted()) {
+        return;
+    }
+
+    Profiler::Process();
+    Kernel::Tick();
+#if KERNEL_TIMERS_THREADED
+    s_clTimerSemaphore.Post();
+#else
+    ProcessTimers();
+#endif // #if KERNEL_TIMERS_THREADED
+}
+}
+
+namespace Mark3
+{
+#if KERNEL_TIMERS_THREADED
+//---------------------------------------------------------------------------
+static void KernelTimer_Task(void* unused)
+{
+    (void)unused;
+    Scheduler::GetCurrentThread()->SetName("Timer");
+    while (1) {
+        s_clTimerSemaphore.Pend();
+        ProcessTimers();
+    }
+}
+#endif // #if KERNEL_TIMERS_THREADED
+
+//---------------------------------------------------------------------------
+void KernelTimer::Config(void)
+{
+#if KERNEL_TIMERS_THREADED
+    s_clTimerSemaphore.Init(0, 1);
+    s_clTimerThread.Init(s_clTimerThreadStack,
+                         sizeof(s_clTimerThreadStack),
+                         KERNEL_TIMERS_THREAD_PRIORITY,
+                         KernelTimer_Task,
+                         0);
+#if KERNEL_ROUND_ROBIN
+    Quantum::SetTimerThread(&s_clTimerThread);
+#endif // #if KERNEL_ROUND_ROBIN
+    s_clTimerThread.Start();
+#endif // #if KERNEL_TIMERS_THREADED
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::Start(void)
+{
+    uint64_t u64Freq;
+    uint64_t u64Count;
+    A53_READ_SYSREG(CNTFRQ_EL0, u64Freq);
+    A53_READ_SYSREG(CNTVCT_EL0, u64Count);
+    s_u64CountsPerTick = u64Freq / PORT_TIMER_FREQ;
+
+    A53_WRITE_SYSREG(CNTV_CVAL_EL0, u64Count + s_u64CountsPerTick);
+    A53_WRITE_SYSREG(CNTV_CTL_EL0, uint64_t{ A53_CNT_CTL_ENABLE });
+    A53_ISB();
+
+    RPI_CORE0_TIMER_IRQCNTL |= RPI_TIMER_IRQCNTL_CNTVIRQ;
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::Stop(void)
+{
+    A53_WRITE_SYSREG(CNTV_CTL_EL0, uint64_t{ A53_CNT_CTL_ENABLE | A53_CNT_CTL_IMASK });
+    A53_ISB();
+}
+
+//---------------------------------------------------------------------------
+PORT_TIMER_COUNT_TYPE KernelTimer::Read(void)
+{
+    uint64_t u64Count;
+    A53_READ_SYSREG(CNTVCT_EL0, u64Count);
+    return static_cast<PORT_TIMER_COUNT_TYPE>(u64Count);
+}
+
+//-------------------------------------------------------------------------
+uint8_t KernelTimer::DI(void)
+{
+    return 0;
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::EI(void)
+{
+    KernelTimer::RI(0);
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::RI(bool bEnable_) {}
+
+//---------------------------------------------------------------------------
+} // namespace Mark3
@@ -0,0 +1,74 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file   a53_raspi3.h
+
+    @brief  Cortex-A53 system register access, and the BCM2836/7 per-core
+            interrupt controller used by the Raspberry Pi 3.
+ */
+#pragma once
+
+#include <stdint.h>
+
+//---------------------------------------------------------------------------
+//! Read/write an AArch64 system register
+#define A53_READ_SYSREG(reg, val)   asm volatile(" mrs %0, " #reg " \n" : "=r"(val))
+#define A53_WRITE_SYSREG(reg, val)  asm volatile(" msr " #reg ", %0 \n" ::"r"((uint64_t)(val)) : "memory")
+#define A53_ISB()                   asm volatile(" isb \n" ::: "memory")
+
+//---------------------------------------------------------------------------
+// Per-core interrupt controller ("ARM local peripherals"), for core n
+#define RPI_LOCAL_BASE              (0x40000000UL)
+#define RPI_CORE_TIMER_IRQCNTL(n)   (*(volatile uint32_t*)(RPI_LOCAL_BASE + 0x40 + (4 * (n))))
+#define RPI_CORE_MBOX_IRQCNTL(n)    (*(volatile uint32_t*)(RPI_LOCAL_BASE + 0x50 + (4 * (n))))
+#define RPI_CORE_IRQ_SOURCE(n)      (*(volatile uint32_t*)(RPI_LOCAL_BASE + 0x60 + (4 * (n))))
+#define RPI_CORE_MBOX0_SET(n)       (*(volatile uint32_t*)(RPI_LOCAL_BASE + 0x80 + (16 * (n))))
+#define RPI_CORE_MBOX0_RDCLR(n)     (*(volatile uint32_t*)(RPI_LOCAL_BASE + 0xC0 + (16 * (n))))
+
+#define RPI_CORE0_TIMER_IRQCNTL     RPI_CORE_TIMER_IRQCNTL(0)
+
+#define RPI_TIMER_IRQCNTL_CNTVIRQ   (0x00000008) //!< Route the virtual timer to IRQ
+#define RPI_MBOX_IRQCNTL_MBOX0      (0x00000001) //!< Route mailbox 0 to IRQ
+
+#define RPI_IRQ_SOURCE_CNTVIRQ      (0x00000008) //!< Virtual timer interrupt pending
+#define RPI_IRQ_SOURCE_MBOX0        (0x00000010) //!< Mailbox 0 interrupt pending
+
+//---------------------------------------------------------------------------
+// Firmware spin table - secondary core n jumps to the address written here
+#define RPI_SPIN_TABLE(n)           (*(volatile uint64_t*)(0xD8UL + (8 * (n))))
+
+//---------------------------------------------------------------------------
+// MPIDR_EL1 affinity level 0 - the index of the core within the cluster
+#define A53_MPIDR_CORE_MASK         (0x00000003)
+
+//---------------------------------------------------------------------------
+// Generic timer control (CNTV_CTL_EL0)
+#define A53_CNT_CTL_ENABLE          (0x00000001)
+#define A53_CNT_CTL_IMASK           (0x00000002)
+
+//---------------------------------------------------------------------------
+// PMU cycle counter control
+#define A53_PMCR_E                  (0x00000001) //!< Enable all counters
+#define A53_PMCR_LC                 (0x00000040) //!< 64-bit cycle counter overflow
+#define A53_PMCNTEN_C               (0x80000000) //!< Enable the cycle counter
+
+//---------------------------------------------------------------------------
+// CPACR_EL1.FPEN - FP/NEON access at EL1/EL0
+#define A53_CPACR_FPEN_MASK         (0x00300000)
+#define A53_CPACR_FPEN_ENABLE       (0x00300000)
+
+//---------------------------------------------------------------------------
+// ESR_EL1 exception classes
+#define A53_ESR_EC_SHIFT            (26)
+#define A53_ESR_EC_SVC64            (0x15)
@@ -0,0 +1,153 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file portcfg.h
+
+    @brief Mark3 Port Configuration
+
+    This file is used to configure the kernel for your specific target CPU
+    in order to provide the optimal set of features for a given use case.
+
+    !! NOTE:  This file must ONLY be included from mark3cfg.h
+*/
+#pragma once
+
+#include <stdint.h>
+
+/**
+    Define the number of thread priorities that the kernel's scheduler will
+    support.  The number of thread priorities is limited only by the memory
+    of the host CPU, as a ThreadList object is statically-allocated for each
+    thread priority.
+
+    In practice, systems rarely need more than 32 priority levels, with the
+    most complex having the capacity for 256.
+*/
+#define KERNEL_NUM_PRIORITIES (32)
+
+#define KERNEL_TIMERS_THREAD_PRIORITY (KERNEL_NUM_PRIORITIES - 1)
+
+#define THREAD_QUANTUM_DEFAULT (4)
+
+#define KERNEL_STACK_GUARD_DEFAULT (32) // words
+
+/**
+    Define a macro indicating the CPU architecture for which this port belongs.
+
+    This may also be set by the toolchain, but that's not guaranteed.
+*/
+#ifndef AARCH64
+#define AARCH64 (1)
+#endif
+
+/**
+    Define types that map to the CPU Architecture's default data-word and address
+    size.
+*/
+#define K_WORD uint64_t //!< Size of a data word
+#define K_ADDR uint64_t //!< Size of an address (pointer size)
+#define K_INT int64_t
+
+/**
+    Set a base datatype used to represent each element of the scheduler's
+    priority bitmap.
+
+    PORT_PRIO_MAP_WORD_SIZE should map to the *size* of an element of type
+    PORT_PROI_TYPE.
+*/
+#define PORT_PRIO_TYPE uint32_t     //!< Type used for bitmap in the PriorityMap class
+#define PORT_PRIO_MAP_WORD_SIZE (4) //!< size of PORT_PRIO_TYPE in bytes
+
+/**
+    Define the running CPU frequency, which is the rate of the PMU cycle counter
+    used as the profiling timer.  QEMU models the cycle counter at 1GHz; the
+    BCM2837 itself runs at 1.2GHz.
+*/
+#define PORT_SYSTEM_FREQ (1000000000)
+
+/**
+    Set the kernel tick frequency, in ticks per second.  The tick is generated by
+    the ARM generic timer (virtual timer), whose compare interval is derived at
+    runtime from the counter frequency held in CNTFRQ_EL0.
+*/
+#define PORT_TIMER_FREQ ((uint32_t)1000)
+
+/**
+    Define the default/minimum size of a thread stack.  Each context switch
+    stacks 272 bytes of integer registers, plus 528 bytes of NEON registers
+    when PORT_NEON_CONTEXT is set.
+*/
+#define PORT_KERNEL_DEFAULT_STACK_SIZE ((K_ADDR)512)
+
+/**
+    Define the size of the kernel-timer thread stack (if one is configured)
+*/
+#define PORT_KERNEL_TIMERS_THREAD_STACK ((K_ADDR)512)
+
+/**
+    Define the native type corresponding to the kernel timer hardware's counter register.
+*/
+#define PORT_TIMER_COUNT_TYPE uint32_t //!< Timer counter type
+
+/**
+    Minimum number of timer ticks for any delay or sleep, required to ensure that a timer cannot
+    be initialized to a negative value.
+*/
+#define PORT_MIN_TIMER_TICKS (0)
+
+/**
+    Define whether this port's kernel timer supports tickless operation (see
+    KERNEL_TIMERS_TICKLESS).  This port implements a fixed-rate tick.
+*/
+#define PORT_TIMERS_TICKLESS (0)
+
+/**
+    Define whether this port provides exclusive-access load/store primitives
+    (ThreadPort::LoadExclusive()/StoreExclusive(), using LDXR/STXR), which
+    allow uncontended Mutex and Semaphore operations to complete without a
+    critical section.  Exception return clears the exclusive monitor, so an
+    interrupted load/store pair always fails.
+*/
+#define PORT_ATOMIC_EXCLUSIVE (1)
+
+/**
+    Define whether this port provides a free-running cycle counter (the PMU's
+    PMCCNTR_EL0), which is used for profiling and CPU time accounting.
+*/
+#define PORT_CYCLE_COUNTER (1)
+
+/**
+    Define whether the NEON/FP registers (q0-q31, FPCR and FPSR) are saved as
+    part of each thread's context.  GCC uses the NEON registers for ordinary
+    integer code (struct copies, memset, etc.), so this must be set unless the
+    kernel and application are all built with -mgeneral-regs-only.  When clear,
+    FP/NEON access is disabled at EL1, so that any stray use faults instead of
+    silently corrupting another thread's registers.
+*/
+#define PORT_NEON_CONTEXT (1)
+
+/**
+    Size of the stack used by exception handlers (the kernel timer interrupt,
+    and the context switch), in bytes.
+*/
+#define PORT_HANDLER_STACK_SIZE ((K_ADDR)4096)
+
+/**
+    Define whether this port can run the kernel on multiple cores (see
+    KERNEL_SMP), and how many.  The secondary cores are released from the
+    firmware's spin table when the kernel is started, and each has its own
+    handler stack.
+*/
+#define PORT_SMP (1)
+#define PORT_CORE_COUNT (4)
@@ -0,0 +1,315 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   threadport.h
+
+    @brief  Cortex-A53 (AArch64) Multithreading support.
+
+    With KERNEL_SMP, critical sections also take a kernel-wide spinlock, so
+    that they exclude the other cores as well as interrupts on this one.  The
+    lock is taken by the outermost critical section on each core, and by the
+    IRQ handler.
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+#include "a53_raspi3.h"
+
+// clang-format off
+//---------------------------------------------------------------------------
+//! ASM Macro - simplify the use of ASM directive in C
+#define ASM      asm volatile
+
+//---------------------------------------------------------------------------
+//! Macro to find the top of a stack given its size and top address
+#define TOP_OF_STACK(x, y)        (K_WORD*) ( ((K_ADDR)x) + (y - sizeof(K_WORD)) )
+//! Push a value y to the stack pointer x and decrement the stack pointer
+#define PUSH_TO_STACK(x, y)        *x = y; x--;
+#define STACK_GROWS_DOWN           (1)
+
+//------------------------------------------------------------------------
+// Use hardware accelerated count-leading zero
+#define HW_CLZ (1)
+#define CLZ(x)      __builtin_clz((x))
+
+//------------------------------------------------------------------------
+//! These macros *must* be used in matched-pairs !
+//! Nesting *is* supported !
+
+#if KERNEL_SMP
+//------------------------------------------------------------------------
+//! Enter critical section (copy current DAIF register value, mask IRQs, lock kernel)
+#define CS_ENTER()                      \
+do {                                    \
+    uint64_t __sr;                      \
+    ASM (                               \
+    " mrs   %[output], DAIF \n"         \
+    " msr   DAIFSet, #2 \n"             \
+    : [output] "=r" (__sr)              \
+    :: "memory");                       \
+    Mark3::ThreadPort::LockKernel();
+
+//------------------------------------------------------------------------
+//! Exit critical section (unlock kernel, restore previous DAIF register value)
+#define CS_EXIT()                       \
+    Mark3::ThreadPort::UnlockKernel();  \
+    ASM (                               \
+    " msr DAIF, %[input] \n"            \
+    :: [input] "r" (__sr) : "memory");  \
+} while(0);
+#else
+//------------------------------------------------------------------------
+//! Enter critical section (copy current DAIF register value, mask IRQs)
+#define CS_ENTER()                      \
+do {                                    \
+    uint64_t __sr;                      \
+    ASM (                               \
+    " mrs   %[output], DAIF \n"         \
+    " msr   DAIFSet, #2 \n"             \
+    : [output] "=r" (__sr)              \
+    :: "memory");
+
+//------------------------------------------------------------------------
+//! Exit critical section (restore previous DAIF register value)
+#define CS_EXIT()                       \
+    ASM (                               \
+    " msr DAIF, %[input] \n"            \
+    :: [input] "r" (__sr) : "memory");  \
+} while(0);
+#endif // #if KERNEL_SMP
+
+namespace Mark3 {
+//------------------------------------------------------------------------
+class Thread;
+/**
+ *  Class defining the architecture specific functions required by the
+ *  kernel.
+ *
+ *  This is limited (at this point) to a function to start the scheduler,
+ *  and a function to initialize the default stack-frame for a thread.
+ */
+class ThreadPort
+{
+public:
+    /**
+     * @brief Init
+     *
+     * Function to perform early init of the target environment prior to
+     * using OS primatives.  Installs the kernel's exception vectors, and
+     * configures FP/NEON access according to PORT_NEON_CONTEXT.
+     */
+    static void Init();
+
+    /**
+     *  @brief StartThreads
+     *
+     *  Function to start the scheduler, initial threads, etc.
+     */
+    static void StartThreads();
+
+    /**
+     *  @brief CoreId
+     *
+     *  @return Index of the core on which the caller is running
+     */
+#if KERNEL_SMP
+    static uint8_t CoreId()
+    {
+        uint64_t u64Mpidr;
+        ASM(" mrs %[mpidr], MPIDR_EL1 \n" : [mpidr] "=r"(u64Mpidr));
+        return static_cast<uint8_t>(u64Mpidr & A53_MPIDR_CORE_MASK);
+    }
+
+    /**
+     *  @brief CoreIdle
+     *
+     *  Called repeatedly from each core's idle thread.  Waits for the next
+     *  interrupt - including an inter-processor interrupt from another core.
+     */
+    static void CoreIdle() { ASM(" wfi \n" ::: "memory"); }
+
+    /**
+     *  @brief LockKernel
+     *
+     *  Take the kernel lock, if this is the core's outermost critical section.
+     *  Must be called with IRQs masked.  Use CS_ENTER() instead of calling
+     *  this directly.
+     */
+    static void LockKernel()
+    {
+        auto u8Core = CoreId();
+        m_au32CriticalCount[u8Core] = m_au32CriticalCount[u8Core] + 1;
+        if (m_au32CriticalCount[u8Core] != 1) {
+            return;
+        }
+
+        // Wait for an event (i.e. the lock being released) between attempts
+        uint32_t u32Val;
+        uint32_t u32Fail;
+        ASM(" sevl \n"
+            "1: \n"
+            " wfe \n"
+            " ldaxr %w[val], [%[lock]] \n"
+            " cbnz %w[val], 1b \n"
+            " stxr %w[fail], %w[one], [%[lock]] \n"
+            " cbnz %w[fail], 1b \n"
+            : [val] "=&r"(u32Val), [fail] "=&r"(u32Fail)
+            : [lock] "r"(&m_u32KernelLock), [one] "r"(1)
+            : "memory");
+    }
+
+    /**
+     *  @brief UnlockKernel
+     *
+     *  Release the kernel lock, if this is the core's outermost critical
+     *  section.  Use CS_EXIT() instead of calling this directly.
+     */
+    static void UnlockKernel()
+    {
+        auto u8Core = CoreId();
+        m_au32CriticalCount[u8Core] = m_au32CriticalCount[u8Core] - 1;
+        if (m_au32CriticalCount[u8Core] != 0) {
+            return;
+        }
+
+        // The release clears the other cores' exclusive monitors, waking them
+        ASM(" stlr wzr, [%[lock]] \n" ::[lock] "r"(&m_u32KernelLock) : "memory");
+    }
+#else
+    static constexpr uint8_t CoreId() { return 0; }
+#endif // #if KERNEL_SMP
+
+    /**
+     *  @brief LoadExclusive
+     *
+     *  Load a value, and tag its address for exclusive access (LDXR).  The
+     *  tag is cleared by any exception return before the matching call to
+     *  StoreExclusive(), which then fails - so a load/store pair that succeeds
+     *  was not interrupted by an ISR or a context switch.
+     *
+     *  @param pu8Addr_ Address to load from
+     *  @return Value loaded
+     */
+    static uint8_t LoadExclusive(volatile uint8_t* pu8Addr_)
+    {
+        uint32_t u32Val;
+        ASM(" ldxrb %w[val], [%[addr]] \n" : [val] "=r"(u32Val) : [addr] "r"(pu8Addr_) : "memory");
+        return static_cast<uint8_t>(u32Val);
+    }
+    static uint16_t LoadExclusive(volatile uint16_t* pu16Addr_)
+    {
+        uint32_t u32Val;
+        ASM(" ldxrh %w[val], [%[addr]] \n" : [val] "=r"(u32Val) : [addr] "r"(pu16Addr_) : "memory");
+        return static_cast<uint16_t>(u32Val);
+    }
+    static uint32_t LoadExclusive(volatile uint32_t* pu32Addr_)
+    {
+        uint32_t u32Val;
+        ASM(" ldxr %w[val], [%[addr]] \n" : [val] "=r"(u32Val) : [addr] "r"(pu32Addr_) : "memory");
+        return u32Val;
+    }
+
+    /**
+     *  @brief StoreExclusive
+     *
+     *  Store a value to an address tagged by LoadExclusive() (STXR), provided
+     *  that exclusive access has not been lost in the meantime.
+     *
+     *  @param pu8Addr_ Address to store to
+     *  @param u8Val_ Value to store
+     *  @return true if the value was stored, false if exclusive access was lost
+     */
+    static bool StoreExclusive(volatile uint8_t* pu8Addr_, uint8_t u8Val_)
+    {
+        uint32_t u32Fail;
+        ASM(" stxrb %w[fail], %w[val], [%[addr]] \n"
+            : [fail] "=&r"(u32Fail)
+            : [val] "r"(static_cast<uint32_t>(u8Val_)), [addr] "r"(pu8Addr_)
+            : "memory");
+        return (u32Fail == 0);
+    }
+    static bool StoreExclusive(volatile uint16_t* pu16Addr_, uint16_t u16Val_)
+    {
+        uint32_t u32Fail;
+        ASM(" stxrh %w[fail], %w[val], [%[addr]] \n"
+            : [fail] "=&r"(u32Fail)
+            : [val] "r"(static_cast<uint32_t>(u16Val_)), [addr] "r"(pu16Addr_)
+            : "memory");
+        return (u32Fail == 0);
+    }
+    static bool StoreExclusive(volatile uint32_t* pu32Addr_, uint32_t u32Val_)
+    {
+        uint32_t u32Fail;
+        ASM(" stxr %w[fail], %w[val], [%[addr]] \n"
+            : [fail] "=&r"(u32Fail)
+            : [val] "r"(u32Val_), [addr] "r"(pu32Addr_)
+            : "memory");
+        return (u32Fail == 0);
+    }
+
+    /**
+     *  @brief ClearExclusive
+     *
+     *  Abandon an exclusive access started by LoadExclusive() (CLREX).
+     */
+    static void ClearExclusive() { ASM(" clrex \n" ::: "memory"); }
+
+    /**
+     *  @brief StartCycleCounter
+     *
+     *  Enable the PMU cycle counter, which is used for profiling and CPU time
+     *  accounting.
+     */
+    static void StartCycleCounter()
+    {
+        uint64_t u64Pmcr;
+        ASM(" mrs %[pmcr], PMCR_EL0 \n" : [pmcr] "=r"(u64Pmcr));
+        u64Pmcr |= (A53_PMCR_E | A53_PMCR_LC);
+        ASM(" msr PMCR_EL0, %[pmcr] \n"
+            " msr PMCNTENSET_EL0, %[cntc] \n"
+            " isb \n"
+            :: [pmcr] "r"(u64Pmcr), [cntc] "r"(uint64_t{ A53_PMCNTEN_C }) : "memory");
+    }
+
+    /**
+     *  @brief ReadCycleCounter
+     *
+     *  @return Current value of the PMU cycle counter (PMCCNTR_EL0)
+     */
+    static uint64_t ReadCycleCounter()
+    {
+        uint64_t u64Count;
+        ASM(" mrs %[count], PMCCNTR_EL0 \n" : [count] "=r"(u64Count));
+        return u64Count;
+    }
+    friend class Thread;
+private:
+
+    /**
+     *  @brief InitStack
+     *
+     *  Initialize the thread's stack.
+     *
+     *  @param pstThread_ Pointer to the thread to initialize
+     */
+    static void InitStack(Thread *pstThread_);
+
+#if KERNEL_SMP
+    static volatile uint32_t m_au32CriticalCount[PORT_CORE_COUNT]; //!< Critical section depth of each core
+    static volatile uint32_t m_u32KernelLock;                      //!< Kernel lock, held by one core at a time
+#endif // #if KERNEL_SMP
+};
+} // namespace Mark3
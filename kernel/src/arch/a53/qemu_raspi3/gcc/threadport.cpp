@@ -0,0 +1,482 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   threadport.cpp
+
+    @brief  ARM Cortex-A53 (AArch64) Multithreading
+
+*/
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+#include "thread.h"
+#include "threadport.h"
+#include "kernelprofile.h"
+#include "kernelswi.h"
+#include "kerneltimer.h"
+#include "timerlist.h"
+#include "quantum.h"
+#include "a53_raspi3.h"
+#include "kernel.h"
+
+//---------------------------------------------------------------------------
+extern "C" {
+void A53_IRQHandler(void);
+void A53_FaultHandler(void);
+void A53_TimerHandler(void);
+extern const uint32_t A53_Vectors[];
+#if KERNEL_SMP
+void A53_SecondaryMain(void);
+extern const uint32_t A53_SecondaryStart[];
+K_ADDR                A53_auHandlerStackTops[PORT_CORE_COUNT];
+#endif // #if KERNEL_SMP
+}
+
+//---------------------------------------------------------------------------
+/*
+    Exception handling and context switching
+
+    Threads run at EL1 using SP_EL0 ("EL1t"), while exception handlers run at
+    EL1 on SP_EL1 ("EL1h") - in the same way that Cortex-M threads use the PSP
+    and handlers the MSP.  Exceptions taken from a thread therefore arrive at
+    the first block of vectors, and those taken from the kernel before it has
+    started (i.e. the SVC used to start the first thread) at the second.
+
+    On an IRQ, the thread's full context is stacked on its own stack, and the
+    resulting stack pointer is stored in the thread object.  Thread objects
+    inherit from the linked-list node class, which holds two pointers (16
+    bytes) - the "stack top" pointer immediately follows.  The frame is laid
+    out as follows, from the saved stack pointer upwards:
+
+    [ FPCR, FPSR, q0-q31 ]               (528 bytes, PORT_NEON_CONTEXT only)
+    [ x0-x30, ELR_EL1, SPSR_EL1, pad ]   (272 bytes)
+
+    The interrupt is then handled in C on the handler stack.  A context switch
+    only has to replace g_pclCurrent, as the context that is restored on the
+    way out of the exception is always that of g_pclCurrent.  With KERNEL_SMP,
+    each core has its own g_pclCurrent (indexed by MPIDR_EL1) and its own
+    handler stack.
+
+    Raspberry Pi 3 has no equivalent of PendSV, so context switches are
+    requested by writing to one of core 0's mailboxes in the per-core
+    interrupt controller.  The resulting IRQ is masked by critical sections
+    like any other, and so is taken as soon as the critical section that
+    requested the switch is left.
+*/
+asm(
+    // Load the current thread of the calling core into a register
+    " .macro A53_CURRENT_THREAD reg, tmp \n"
+#if KERNEL_SMP
+    "   adrp \\reg, g_apclCurrent \n"
+    "   add \\reg, \\reg, :lo12:g_apclCurrent \n"
+    "   mrs \\tmp, mpidr_el1 \n"
+    "   and \\tmp, \\tmp, #3 \n"
+    "   ldr \\reg, [\\reg, \\tmp, lsl #3] \n"
+#else
+    "   adrp \\reg, g_pclCurrent \n"
+    "   ldr \\reg, [\\reg, :lo12:g_pclCurrent] \n"
+#endif // #if KERNEL_SMP
+    " .endm \n"
+
+    " .macro A53_SAVE_CONTEXT \n"
+    "   msr spsel, #0 \n"
+    "   sub sp, sp, #272 \n"
+    "   stp x0, x1, [sp, #0] \n"
+    "   stp x2, x3, [sp, #16] \n"
+    "   stp x4, x5, [sp, #32] \n"
+    "   stp x6, x7, [sp, #48] \n"
+    "   stp x8, x9, [sp, #64] \n"
+    "   stp x10, x11, [sp, #80] \n"
+    "   stp x12, x13, [sp, #96] \n"
+    "   stp x14, x15, [sp, #112] \n"
+    "   stp x16, x17, [sp, #128] \n"
+    "   stp x18, x19, [sp, #144] \n"
+    "   stp x20, x21, [sp, #160] \n"
+    "   stp x22, x23, [sp, #176] \n"
+    "   stp x24, x25, [sp, #192] \n"
+    "   stp x26, x27, [sp, #208] \n"
+    "   stp x28, x29, [sp, #224] \n"
+    "   mrs x0, elr_el1 \n"
+    "   mrs x1, spsr_el1 \n"
+    "   stp x30, x0, [sp, #240] \n"
+    "   str x1, [sp, #256] \n"
+#if PORT_NEON_CONTEXT
+    "   sub sp, sp, #528 \n"
+    "   stp q0, q1, [sp, #16] \n"
+    "   stp q2, q3, [sp, #48] \n"
+    "   stp q4, q5, [sp, #80] \n"
+    "   stp q6, q7, [sp, #112] \n"
+    "   stp q8, q9, [sp, #144] \n"
+    "   stp q10, q11, [sp, #176] \n"
+    "   stp q12, q13, [sp, #208] \n"
+    "   stp q14, q15, [sp, #240] \n"
+    "   stp q16, q17, [sp, #272] \n"
+    "   stp q18, q19, [sp, #304] \n"
+    "   stp q20, q21, [sp, #336] \n"
+    "   stp q22, q23, [sp, #368] \n"
+    "   stp q24, q25, [sp, #400] \n"
+    "   stp q26, q27, [sp, #432] \n"
+    "   stp q28, q29, [sp, #464] \n"
+    "   stp q30, q31, [sp, #496] \n"
+    "   mrs x0, fpcr \n"
+    "   mrs x1, fpsr \n"
+    "   stp x0, x1, [sp, #0] \n"
+#endif // #if PORT_NEON_CONTEXT
+    // g_pclCurrent->m_pwStackTop = sp
+    "   A53_CURRENT_THREAD x1, x2 \n"
+    "   mov x0, sp \n"
+    "   str x0, [x1, #16] \n"
+    "   msr spsel, #1 \n"
+    " .endm \n"
+
+    //-----------------------------------------------------------------------
+    // Exception vector table - 16 entries of 128 bytes, 2KB aligned
+    " .section .text.vectors, \"ax\" \n"
+    " .balign 0x800 \n"
+    " .global A53_Vectors \n"
+    "A53_Vectors: \n"
+    // Current EL using SP_EL0 (threads)
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_ThreadIrq \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    // Current EL using SP_EL1 (kernel startup and exception handlers)
+    " .balign 0x80 \n b A53_KernelSync \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    // Lower EL, AArch64 and AArch32 - EL0 is not used
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+    " .balign 0x80 \n b A53_IrqOrSync_Fault \n"
+
+    //-----------------------------------------------------------------------
+    " .text \n"
+    // IRQ from a thread: stack its context, handle the interrupt, and resume
+    // whichever thread is current on the way out.
+    "A53_ThreadIrq: \n"
+    "   A53_SAVE_CONTEXT \n"
+    "   bl A53_IRQHandler \n"
+
+    // Restore the context of g_pclCurrent, and return into it
+    "A53_RestoreContext: \n"
+    "   A53_CURRENT_THREAD x1, x2 \n"
+    "   ldr x0, [x1, #16] \n"
+    "   msr spsel, #0 \n"
+    "   mov sp, x0 \n"
+#if PORT_NEON_CONTEXT
+    "   ldp x0, x1, [sp, #0] \n"
+    "   msr fpcr, x0 \n"
+    "   msr fpsr, x1 \n"
+    "   ldp q0, q1, [sp, #16] \n"
+    "   ldp q2, q3, [sp, #48] \n"
+    "   ldp q4, q5, [sp, #80] \n"
+    "   ldp q6, q7, [sp, #112] \n"
+    "   ldp q8, q9, [sp, #144] \n"
+    "   ldp q10, q11, [sp, #176] \n"
+    "   ldp q12, q13, [sp, #208] \n"
+    "   ldp q14, q15, [sp, #240] \n"
+    "   ldp q16, q17, [sp, #272] \n"
+    "   ldp q18, q19, [sp, #304] \n"
+    "   ldp q20, q21, [sp, #336] \n"
+    "   ldp q22, q23, [sp, #368] \n"
+    "   ldp q24, q25, [sp, #400] \n"
+    "   ldp q26, q27, [sp, #432] \n"
+    "   ldp q28, q29, [sp, #464] \n"
+    "   ldp q30, q31, [sp, #496] \n"
+    "   add sp, sp, #528 \n"
+#endif // #if PORT_NEON_CONTEXT
+    "   ldp x30, x0, [sp, #240] \n"
+    "   ldr x1, [sp, #256] \n"
+    "   msr elr_el1, x0 \n"
+    "   msr spsr_el1, x1 \n"
+    "   ldp x0, x1, [sp, #0] \n"
+    "   ldp x2, x3, [sp, #16] \n"
+    "   ldp x4, x5, [sp, #32] \n"
+    "   ldp x6, x7, [sp, #48] \n"
+    "   ldp x8, x9, [sp, #64] \n"
+    "   ldp x10, x11, [sp, #80] \n"
+    "   ldp x12, x13, [sp, #96] \n"
+    "   ldp x14, x15, [sp, #112] \n"
+    "   ldp x16, x17, [sp, #128] \n"
+    "   ldp x18, x19, [sp, #144] \n"
+    "   ldp x20, x21, [sp, #160] \n"
+    "   ldp x22, x23, [sp, #176] \n"
+    "   ldp x24, x25, [sp, #192] \n"
+    "   ldp x26, x27, [sp, #208] \n"
+    "   ldp x28, x29, [sp, #224] \n"
+    "   add sp, sp, #272 \n"
+    "   eret \n"
+
+    // Synchronous exception from the kernel: SVC #0 starts the first thread
+    "A53_KernelSync: \n"
+    "   mrs x0, esr_el1 \n"
+    "   lsr x0, x0, #26 \n"
+    "   cmp x0, #0x15 \n"
+    "   b.eq A53_RestoreContext \n"
+
+    // Anything else is a fault
+    "A53_IrqOrSync_Fault: \n"
+    "   bl A53_FaultHandler \n"
+    "   b . \n"
+#if KERNEL_SMP
+
+    // Secondary cores are released from the firmware's spin table, possibly
+    // at EL2 - drop to EL1 (AArch64, using SP_EL1, with all exceptions
+    // masked), switch to the core's handler stack, and join the kernel.
+    " .global A53_SecondaryStart \n"
+    "A53_SecondaryStart: \n"
+    "   mrs x0, currentel \n"
+    "   cmp x0, #8 \n"
+    "   b.ne 1f \n"
+    "   mov x0, #0x80000000 \n"
+    "   msr hcr_el2, x0 \n"
+    "   mov x0, #0x3c5 \n"
+    "   msr spsr_el2, x0 \n"
+    "   adr x0, 1f \n"
+    "   msr elr_el2, x0 \n"
+    "   eret \n"
+    "1: \n"
+    "   msr daifset, #0xf \n"
+    "   mrs x0, mpidr_el1 \n"
+    "   and x0, x0, #3 \n"
+    "   adrp x1, A53_auHandlerStackTops \n"
+    "   add x1, x1, :lo12:A53_auHandlerStackTops \n"
+    "   ldr x1, [x1, x0, lsl #3] \n"
+    "   mov sp, x1 \n"
+    "   bl A53_SecondaryMain \n"
+    "   b . \n"
+#endif // #if KERNEL_SMP
+    );
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+volatile uint32_t g_ulCriticalCount;
+#if KERNEL_SMP
+volatile uint32_t ThreadPort::m_au32CriticalCount[PORT_CORE_COUNT];
+volatile uint32_t ThreadPort::m_u32KernelLock;
+#endif // #if KERNEL_SMP
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Context frame dimensions, in bytes
+constexpr auto cu16GPFrameBytes = uint16_t{ 272 };
+#if PORT_NEON_CONTEXT
+constexpr auto cu16NeonFrameBytes = uint16_t{ 528 };
+#else
+constexpr auto cu16NeonFrameBytes = uint16_t{ 0 };
+#endif // #if PORT_NEON_CONTEXT
+
+//---------------------------------------------------------------------------
+// Initial SPSR_EL1 for a thread - EL1 using SP_EL0, with all exceptions unmasked
+constexpr auto cu64ThreadSPSR = uint64_t{ 0x00000004 };
+
+//---------------------------------------------------------------------------
+// Stacks used by exception handlers, reset when each core's first thread is started
+#if KERNEL_SMP
+constexpr auto cu8Cores = uint8_t{ PORT_CORE_COUNT };
+#else
+constexpr auto cu8Cores = uint8_t{ 1 };
+#endif // #if KERNEL_SMP
+K_WORD s_aawHandlerStacks[cu8Cores][PORT_HANDLER_STACK_SIZE / sizeof(K_WORD)] __attribute__((aligned(16)));
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+/*
+    Setting up the thread stacks
+
+    The initial stack frame is the same as that stacked by an IRQ (see above),
+    so that the first thread can be started - and any new thread switched
+    to - by returning from an exception into it.  ELR_EL1 holds the thread's
+    entrypoint, and x0 its argument.  AArch64 requires the stack pointer to be
+    16-byte aligned, so the frame is placed at the highest aligned address
+    within the stack.
+*/
+void ThreadPort::InitStack(Thread* pclThread_)
+{
+    uint64_t* pu64Frame;
+    uint64_t* pu64Regs;
+    uint16_t  i;
+
+#if KERNEL_STACK_CHECK
+    // Initialize the stack to all FF's to aid in stack depth checking
+    auto* pu64Temp = reinterpret_cast<uint64_t*>(pclThread_->m_pwStack);
+    for (i = 0; i < pclThread_->m_u16StackSize / sizeof(uint64_t); i++) { pu64Temp[i] = 0xFFFFFFFFFFFFFFFF; }
+#endif // #if KERNEL_STACK_CHECK
+
+    auto uTop = (reinterpret_cast<K_ADDR>(pclThread_->m_pwStackTop) + sizeof(K_WORD)) & ~K_ADDR{ 15 };
+    pu64Frame = reinterpret_cast<uint64_t*>(uTop - cu16GPFrameBytes - cu16NeonFrameBytes);
+
+    //-- NEON registers, FPCR and FPSR all start out cleared --
+    for (i = 0; i < cu16NeonFrameBytes / sizeof(uint64_t); i++) { pu64Frame[i] = 0; }
+    pu64Regs = pu64Frame + (cu16NeonFrameBytes / sizeof(uint64_t));
+
+    //-- General purpose registers --
+    pu64Regs[0] = reinterpret_cast<uint64_t>(pclThread_->m_pvArg); // x0 = argument
+    for (i = 1; i < 30; i++) {
+        pu64Regs[i] = i; // x1-x29 hold their register number, as a debugging aid
+    }
+    pu64Regs[30] = 0;                                                       // x30 (LR)
+    pu64Regs[31] = reinterpret_cast<uint64_t>(pclThread_->m_pfEntryPoint); // ELR_EL1
+    pu64Regs[32] = cu64ThreadSPSR;                                          // SPSR_EL1
+    pu64Regs[33] = 0;                                                       // padding
+
+    pclThread_->m_pwStackTop = pu64Frame;
+}
+
+//---------------------------------------------------------------------------
+void Thread_Switch(void)
+{
+    g_pclCurrent = (Thread*)g_pclNext;
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::Init()
+{
+    // Install the kernel's exception vectors
+    A53_WRITE_SYSREG(VBAR_EL1, reinterpret_cast<K_ADDR>(A53_Vectors));
+
+    // Allow, or trap, FP/NEON instructions at EL1
+    uint64_t u64Cpacr;
+    A53_READ_SYSREG(CPACR_EL1, u64Cpacr);
+    u64Cpacr &= ~uint64_t{ A53_CPACR_FPEN_MASK };
+#if PORT_NEON_CONTEXT
+    u64Cpacr |= A53_CPACR_FPEN_ENABLE;
+#endif // #if PORT_NEON_CONTEXT
+    A53_WRITE_SYSREG(CPACR_EL1, u64Cpacr);
+    A53_ISB();
+}
+
+//---------------------------------------------------------------------------
+/*
+    The same general process applies to starting the kernel as on Cortex-M:
+    the handler stack is reset (nothing running on it now will ever return),
+    and the SVC instruction raises a synchronous exception, whose handler
+    restores the context of the first thread and returns into it.  Each
+    secondary core does the same with its own handler stack and first thread.
+*/
+static void ThreadPort_StartFirstThread(void)
+{
+    ASM(" mov sp, %[stack] \n"
+        " svc #0 \n"
+        :
+        : [stack] "r"(&s_aawHandlerStacks[ThreadPort::CoreId()][PORT_HANDLER_STACK_SIZE / sizeof(K_WORD)])
+        : "memory");
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::StartThreads()
+{
+    KernelSWI::Config();   // configure the task switch SWI
+    KernelTimer::Config(); // configure the kernel timer
+
+    Profiler::Init();
+
+    // Tell the kernel that we're ready to start scheduling threads
+    // for the first time.
+    Kernel::CompleteStart();
+
+    Scheduler::SetScheduler(1); // enable the scheduler
+    Scheduler::Schedule();      // run the scheduler - determine the first thread to run
+
+    Thread_Switch(); // Set the next scheduled thread to the current thread
+
+    KernelTimer::Start(); // enable the kernel timer
+    KernelSWI::Start();   // enable the task switch SWI
+
+    // Restart the thread quantum timer, as any value held prior to starting
+    // the kernel will be invalid.  This fixes a bug where multiple threads
+    // started with the highest priority before starting the kernel causes problems
+    // until the running thread voluntarily blocks.
+#if KERNEL_ROUND_ROBIN
+    Quantum::Update(g_pclCurrent);
+#endif // #if KERNEL_ROUND_ROBIN
+
+#if KERNEL_SMP
+    // Release the other cores, which choose their own first threads
+    for (auto i = uint8_t{ 1 }; i < PORT_CORE_COUNT; i++) {
+        A53_auHandlerStackTops[i] = reinterpret_cast<K_ADDR>(&s_aawHandlerStacks[i][PORT_HANDLER_STACK_SIZE / sizeof(K_WORD)]);
+        RPI_SPIN_TABLE(i)         = reinterpret_cast<K_ADDR>(A53_SecondaryStart);
+    }
+    ASM(" dsb sy \n"
+        " sev \n" ::: "memory");
+#endif // #if KERNEL_SMP
+
+    ThreadPort_StartFirstThread(); // Jump to the first thread (does not return)
+}
+} // namespace Mark3
+
+using namespace Mark3;
+
+//---------------------------------------------------------------------------
+void A53_IRQHandler(void)
+{
+    // Handle the kernel timer first, so that any context switch it causes is
+    // taken on the way out of this same exception.
+    auto     u8Core = ThreadPort::CoreId();
+    uint32_t u32Source;
+#if KERNEL_SMP
+    // IRQs are only taken outside of critical sections, so this is always
+    // the core's outermost acquisition of the kernel lock.
+    ThreadPort::LockKernel();
+#endif // #if KERNEL_SMP
+    while ((u32Source = RPI_CORE_IRQ_SOURCE(u8Core) & (RPI_IRQ_SOURCE_CNTVIRQ | RPI_IRQ_SOURCE_MBOX0)) != 0) {
+        if ((u32Source & RPI_IRQ_SOURCE_CNTVIRQ) != 0) {
+            A53_TimerHandler();
+        }
+        if ((u32Source & RPI_IRQ_SOURCE_MBOX0) != 0) {
+            KernelSWI::Clear();
+#if KERNEL_SMP
+            // The request may have come from another core
+            Scheduler::Reschedule();
+#endif // #if KERNEL_SMP
+            Thread_Switch();
+        }
+    }
+#if KERNEL_SMP
+    ThreadPort::UnlockKernel();
+#endif // #if KERNEL_SMP
+}
+
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+void A53_SecondaryMain(void)
+{
+    ThreadPort::Init();
+
+    // Choose this core's first thread, and take context switch requests
+    ThreadPort::LockKernel();
+    Scheduler::Schedule();
+    Thread_Switch();
+    KernelSWI::Clear();
+    KernelSWI::Start();
+    ThreadPort::UnlockKernel();
+
+    ThreadPort_StartFirstThread(); // Jump to the first thread (does not return)
+}
+#endif // #if KERNEL_SMP
+
+//---------------------------------------------------------------------------
+void A53_FaultHandler(void)
+{
+    Kernel::Panic(PANIC_UNHANDLED_USAGE_FAULT);
+}
@@ -23,12 +23,17 @@ See license.txt for more information
 #include "kernelprofile.h"
 #include "threadport.h"
 
+#include "m3_core_cm0.h"
+
 namespace Mark3
 {
 uint32_t Profiler::m_u32Epoch;
 
 //---------------------------------------------------------------------------
-void Profiler::Init() {}
+void Profiler::Init()
+{
+    m_u32Epoch = 0;
+}
 
 //---------------------------------------------------------------------------
 void Profiler::Start() {}
@@ -38,10 +43,16 @@ void Profiler::Stop() {}
 //---------------------------------------------------------------------------
 uint16_t Profiler::Read()
 {
-    return 0;
+    // SysTick counts down from its reload value
+    return static_cast<uint16_t>(SysTick->LOAD - SysTick->VAL);
 }
 
 //---------------------------------------------------------------------------
-void Profiler::Process() {}
+void Profiler::Process()
+{
+    CS_ENTER();
+    m_u32Epoch++;
+    CS_EXIT();
+}
 
 } // namespace Mark3
@@ -41,6 +41,7 @@ void SysTick_Handler(void);
 //---------------------------------------------------------------------------
 void SysTick_Handler(void)
 {
+    Profiler::Process();
     Kernel::Tick();
     s_clTimerSemaphore.Post();
 
@@ -15,6 +15,10 @@ See license.txt for more information
     @file kernelprofile.h
 
     @brief Profiling timer hardware interface
+
+    The Cortex-M0 has no cycle counter, so the profiling timer counts the
+    cycles elapsed within the current SysTick period, and its epoch is the
+    number of SysTick periods (kernel ticks) elapsed.
  */
 #pragma once
 
@@ -23,8 +27,8 @@ See license.txt for more information
 #include "ll.h"
 
 //---------------------------------------------------------------------------
-#define TICKS_PER_OVERFLOW (256)
-#define CLOCK_DIVIDE (8)
+#define TICKS_PER_OVERFLOW (PORT_TIMER_FREQ)
+#define CLOCK_DIVIDE (1)
 
 namespace Mark3
 {
@@ -0,0 +1,57 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   kernelhrtimer.cpp
+
+    @brief  High-resolution timer counter for ARM Cortex-M, using the DWT
+
+    The free-running counter is the DWT cycle counter.  The compare interrupt
+    is board-specific - KernelHRTimer::SetAlarm() and KernelHRTimer::ClearAlarm()
+    are supplied by the board support package.
+*/
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_HRTIMERS
+#include "kernelhrtimer.h"
+#include "threadport.h"
+#include "m3_core_cm3.h"
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Debug exception and monitor control register, and its trace enable bit
+constexpr auto cu32DEMCR       = K_ADDR{ 0xE000EDFC };
+constexpr auto cu32DEMCRTRCENA = uint32_t{ 1UL << 24 };
+} // anonymous namespace
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void KernelHRTimer::Config(void)
+{
+    *reinterpret_cast<volatile uint32_t*>(cu32DEMCR) |= cu32DEMCRTRCENA;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelHRTimer::Read(void)
+{
+    return DWT->CYCCNT;
+}
+} // namespace Mark3
+#endif // #if KERNEL_HRTIMERS
@@ -24,27 +24,141 @@ See license.txt for more information
 #include "m3_core_cm3.h"
 #include "kernel.h"
 #include "ksemaphore.h"
+#include "kernelprofile.h"
 #include "thread.h"
 
 using namespace Mark3;
 namespace
 {
+#if KERNEL_TIMERS_THREADED
 //---------------------------------------------------------------------------
 // Static objects implementing the timer thread and its synchronization objects
 Thread    s_clTimerThread;
 K_WORD    s_clTimerThreadStack[PORT_KERNEL_TIMERS_THREAD_STACK];
 Semaphore s_clTimerSemaphore;
+#endif // #if KERNEL_TIMERS_THREADED
+
+//---------------------------------------------------------------------------
+// Process timer expiries for a single pass of the timer scheduler
+void ProcessTimers()
+{
+#if KERNEL_ROUND_ROBIN
+    Quantum::SetInTimer();
+#endif // #if KERNEL_ROUND_ROBIN
+    TimerScheduler::Process();
+#if KERNEL_ROUND_ROBIN
+    Quantum::ClearInTimer();
+#endif // #if KERNEL_ROUND_ROBIN
+}
+
+#if KERNEL_TIMERS_TICKLESS
+//---------------------------------------------------------------------------
+// Tickless timer state.  SysTick is reprogrammed for each timer expiry, and the
+// kernel's tick count is derived from the number of cycles counted.
+constexpr auto cu32MinReload = uint32_t{ 64 }; // Shortest period that can be programmed
+
+uint32_t s_u32CyclesPerTick; // SysTick cycles per kernel tick
+uint32_t s_u32MaxTicks;      // Longest period that can be programmed, in ticks
+uint32_t s_u32Reload;        // Cycles in the current SysTick period (0 if stopped)
+uint32_t s_u32Residual;      // Cycles counted past the last tick boundary accounted for
+bool     s_bExpiry;          // Whether the current period ends in a timer expiry
+
+//---------------------------------------------------------------------------
+// Return the number of cycles elapsed in the current SysTick period.  If the
+// counter has already wrapped without its exception having been taken, this
+// includes the whole period, plus the cycles counted since the reload.
+uint32_t ElapsedCycles(bool* pbWrapped_)
+{
+    auto u32Val = SysTick->VAL;
+    *pbWrapped_ = ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0);
+    if (*pbWrapped_) {
+        u32Val = SysTick->VAL;
+        return s_u32Reload + (s_u32Reload - 1 - u32Val);
+    }
+    return s_u32Reload - 1 - u32Val;
+}
+
+//---------------------------------------------------------------------------
+// Add the whole ticks in the given number of cycles (plus the cycles left over
+// from previous calls) to the kernel's tick count.
+void AccountCycles(uint32_t u32Cycles_)
+{
+    u32Cycles_ += s_u32Residual;
+    auto u32Ticks = u32Cycles_ / s_u32CyclesPerTick;
+    s_u32Residual = u32Cycles_ % s_u32CyclesPerTick;
+    Kernel::Tick(u32Ticks);
+}
+
+//---------------------------------------------------------------------------
+// Account for the cycles elapsed in the current period, and start a new
+// period ending the given number of ticks after the last tick boundary.
+// Called with interrupts disabled.
+uint32_t Restart(uint32_t u32Ticks_, bool bExpiry_)
+{
+    bool bWrapped;
+    AccountCycles(ElapsedCycles(&bWrapped));
+    if (bWrapped) {
+        // The period ended while interrupts were disabled.  When processing
+        // timers from this interrupt, the caller is about to reprogram the
+        // timer for any overdue expiry instead.
+        SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+#if KERNEL_TIMERS_THREADED
+        if (s_bExpiry) {
+            s_clTimerSemaphore.Post();
+        }
+#endif // #if KERNEL_TIMERS_THREADED
+    }
+
+    if (u32Ticks_ == 0) {
+        u32Ticks_ = 1;
+    } else if (u32Ticks_ > s_u32MaxTicks) {
+        u32Ticks_ = s_u32MaxTicks;
+    }
+
+    s_bExpiry   = bExpiry_;
+    s_u32Reload = (u32Ticks_ * s_u32CyclesPerTick) - s_u32Residual;
+    if (s_u32Reload < cu32MinReload) {
+        s_u32Reload = cu32MinReload;
+    }
+    SysTick->LOAD = s_u32Reload - 1;
+    SysTick->VAL  = 0;
+    return u32Ticks_;
+}
+#endif // #if KERNEL_TIMERS_TICKLESS
 } // anonymous namespace
 
 //---------------------------------------------------------------------------
 extern "C" {
 void SysTick_Handler(void)
 {
+    // Track wraps of the cycle counter used by the profiling timer
+    Profiler::Process();
+
+#if KERNEL_TIMERS_TICKLESS
+    if (s_u32Reload == 0) {
+        return;
+    }
+
+    // SysTick reloads in hardware, so a whole period has elapsed
+    AccountCycles(s_u32Reload);
+    if (Kernel::IsStarted() && s_bExpiry) {
+#if KERNEL_TIMERS_THREADED
+        s_clTimerSemaphore.Post();
+#else
+        ProcessTimers();
+#endif // #if KERNEL_TIMERS_THREADED
+    }
+#else
     if (!Kernel::IsStarted()) {
         return;
     }
     Kernel::Tick();
+#if KERNEL_TIMERS_THREADED
     s_clTimerSemaphore.Post();
+#else
+    ProcessTimers();
+#endif // #if KERNEL_TIMERS_THREADED
+#endif // #if KERNEL_TIMERS_TICKLESS
 
     // Clear the systick interrupt pending bit.
     SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
@@ -53,25 +167,22 @@ void SysTick_Handler(void)
 
 namespace Mark3
 {
+#if KERNEL_TIMERS_THREADED
 //---------------------------------------------------------------------------
 static void KernelTimer_Task(void* unused)
 {
     (void)unused;
     while (1) {
         s_clTimerSemaphore.Pend();
-#if KERNEL_ROUND_ROBIN
-        Quantum::SetInTimer();
-#endif // #if KERNEL_ROUND_ROBIN
-        TimerScheduler::Process();
-#if KERNEL_ROUND_ROBIN
-        Quantum::ClearInTimer();
-#endif // #if KERNEL_ROUND_ROBIN
+        ProcessTimers();
     }
 }
+#endif // #if KERNEL_TIMERS_THREADED
 
 //---------------------------------------------------------------------------
 void KernelTimer::Config(void)
 {
+#if KERNEL_TIMERS_THREADED
     s_clTimerSemaphore.Init(0, 1);
     s_clTimerThread.Init(s_clTimerThreadStack,
                          sizeof(s_clTimerThreadStack) / sizeof(K_WORD),
@@ -80,6 +191,7 @@ void KernelTimer::Config(void)
                          0);
     Quantum::SetTimerThread(&s_clTimerThread);
     s_clTimerThread.Start();
+#endif // #if KERNEL_TIMERS_THREADED
 }
 
 //---------------------------------------------------------------------------
@@ -87,18 +199,63 @@ void KernelTimer::Start(void)
 {
     // Barely higher priority than the SVC and PendSV interrupts.
     uint8_t u8Priority = static_cast<uint8_t>((1 << __NVIC_PRIO_BITS) - 2);
+#if PORT_CS_BASEPRI
+    static_assert((PORT_CS_BASEPRI_MASK != 0)
+                      && (PORT_CS_BASEPRI_MASK <= (((1 << __NVIC_PRIO_BITS) - 2) << (8 - __NVIC_PRIO_BITS))),
+                  "PORT_CS_BASEPRI_MASK must mask the kernel timer interrupt");
+#endif // #if PORT_CS_BASEPRI
 
     M3_SysTick_Config(PORT_TIMER_FREQ); // 1KHz fixed clock...
     M3_NVIC_SetPriority(M3_SYSTICK_IRQn, u8Priority);
     SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+#if KERNEL_TIMERS_TICKLESS
+    // Wake the timer thread on the first tick, which programs the first expiry
+    s_u32CyclesPerTick = PORT_TIMER_FREQ;
+    s_u32MaxTicks      = ((SysTick_LOAD_RELOAD_Msk + 1) / s_u32CyclesPerTick) - 1;
+    s_u32Residual      = 0;
+    s_u32Reload        = s_u32CyclesPerTick;
+    s_bExpiry          = true;
+#endif // #if KERNEL_TIMERS_TICKLESS
 }
 
 //---------------------------------------------------------------------------
 void KernelTimer::Stop(void)
 {
+#if KERNEL_TIMERS_TICKLESS
+    s_u32Reload = 0;
+#endif // #if KERNEL_TIMERS_TICKLESS
     SysTick->CTRL = ~SysTick_CTRL_ENABLE_Msk;
 }
 
+#if KERNEL_TIMERS_TICKLESS
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::SetExpiry(uint32_t u32Interval_)
+{
+    if (s_u32Reload == 0) {
+        return 0;
+    }
+    return Restart(u32Interval_, true);
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::ClearExpiry(void)
+{
+    if (s_u32Reload != 0) {
+        Restart(s_u32MaxTicks, false);
+    }
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetOvertime(void)
+{
+    if (s_u32Reload == 0) {
+        return 0;
+    }
+    bool bWrapped;
+    return (s_u32Residual + ElapsedCycles(&bWrapped)) / s_u32CyclesPerTick;
+}
+#endif // #if KERNEL_TIMERS_TICKLESS
+
 //---------------------------------------------------------------------------
 PORT_TIMER_COUNT_TYPE KernelTimer::Read(void)
 {
@@ -15,6 +15,10 @@ See license.txt for more information
     @file kernelprofile.h
 
     @brief Profiling timer hardware interface
+
+    The profiling timer is the DWT cycle counter.  Read() returns its low 16
+    bits, and GetEpoch() the count of 16-bit overflows, extended past the
+    counter's own 32 bits by Process(), which is called from the kernel timer.
  */
 
 #pragma once
@@ -24,8 +28,8 @@ See license.txt for more information
 #include "ll.h"
 
 //---------------------------------------------------------------------------
-#define TICKS_PER_OVERFLOW (256)
-#define CLOCK_DIVIDE (8)
+#define TICKS_PER_OVERFLOW (65536)
+#define CLOCK_DIVIDE (1)
 
 namespace Mark3
 {
@@ -80,6 +84,8 @@ public:
     static uint32_t GetEpoch() { return m_u32Epoch; }
 
 private:
-    static uint32_t m_u32Epoch;
+    static uint32_t m_u32Epoch;  //!< Overflow count as of the last Read()
+    static uint32_t m_u32Wraps;  //!< Number of times the 32-bit counter has wrapped
+    static uint32_t m_u32Sample; //!< Counter value at the last Read()
 };
 } // namespace Mark3
@@ -0,0 +1,129 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   kernelhrtimer.cpp
+
+    @brief  High-resolution timer implementation for the LM3S6965 (QEMU)
+
+    QEMU's model of the Stellaris general-purpose timers does not allow the
+    running count to be read back, so the free-running counter is derived from
+    the kernel tick count and SysTick's current value instead.  GPTM Timer1 is
+    run as a 32-bit one-shot timer at the core clock, and is loaded with the
+    number of cycles remaining until each alarm.
+*/
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_HRTIMERS
+#if KERNEL_TIMERS_TICKLESS
+#error "KERNEL_HRTIMERS requires a periodic kernel tick on this port"
+#endif // #if KERNEL_TIMERS_TICKLESS
+
+#include "kernelhrtimer.h"
+#include "threadport.h"
+#include "m3_core_cm3.h"
+#include "kernel.h"
+#include "hrtimer.h"
+
+using namespace Mark3;
+namespace
+{
+//---------------------------------------------------------------------------
+// System control and GPTM Timer1 register definitions
+constexpr auto cu32SysCtlRCGC1   = K_ADDR{ 0x400FE104 }; // Run-mode clock gating, register 1
+constexpr auto cu32RCGC1Timer1   = uint32_t{ 1UL << 17 };
+constexpr auto cu32Timer1Base    = K_ADDR{ 0x40031000 };
+constexpr auto cu32TimerCFG      = K_ADDR{ 0x00 }; // Configuration
+constexpr auto cu32TimerTAMR     = K_ADDR{ 0x04 }; // Timer A mode
+constexpr auto cu32TimerCTL      = K_ADDR{ 0x0C }; // Control
+constexpr auto cu32TimerIMR      = K_ADDR{ 0x18 }; // Interrupt mask
+constexpr auto cu32TimerICR      = K_ADDR{ 0x24 }; // Interrupt clear
+constexpr auto cu32TimerTAILR    = K_ADDR{ 0x28 }; // Timer A interval load
+constexpr auto cu32TAMROneShot   = uint32_t{ 0x01 };
+constexpr auto cu32CTLTAEN       = uint32_t{ 0x01 };
+constexpr auto cu32TATOINT       = uint32_t{ 0x01 }; // Timer A timeout interrupt
+constexpr auto ciTimer1AIRQn     = IRQn_Type{ 21 };
+
+//---------------------------------------------------------------------------
+volatile uint32_t& Timer1(K_ADDR u32Offset_)
+{
+    return *reinterpret_cast<volatile uint32_t*>(cu32Timer1Base + u32Offset_);
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+extern "C" {
+void TIMER1A_IRQHandler(void)
+{
+    Timer1(cu32TimerICR) = cu32TATOINT;
+    HRTimerScheduler::Process();
+}
+}
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void KernelHRTimer::Config(void)
+{
+    *reinterpret_cast<volatile uint32_t*>(cu32SysCtlRCGC1) |= cu32RCGC1Timer1;
+
+    Timer1(cu32TimerCTL)  = 0;
+    Timer1(cu32TimerCFG)  = 0; // 32-bit timer
+    Timer1(cu32TimerTAMR) = cu32TAMROneShot;
+    Timer1(cu32TimerICR)  = cu32TATOINT;
+    Timer1(cu32TimerIMR)  = cu32TATOINT;
+#if PORT_CS_BASEPRI
+    // The alarm calls into the kernel, so must be masked by critical sections
+    M3_NVIC_SetPriority(ciTimer1AIRQn, (1 << __NVIC_PRIO_BITS) - 2);
+#endif // #if PORT_CS_BASEPRI
+    M3_NVIC_EnableIRQ(ciTimer1AIRQn);
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelHRTimer::Read(void)
+{
+    // Account for a SysTick wrap whose exception has not yet been taken
+    auto u32Ticks = Kernel::GetTicks();
+    auto u32Val   = SysTick->VAL;
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0) {
+        u32Ticks++;
+        u32Val = SysTick->VAL;
+    }
+    return (u32Ticks * PORT_TIMER_FREQ) + (PORT_TIMER_FREQ - 1 - u32Val);
+}
+
+//---------------------------------------------------------------------------
+void KernelHRTimer::SetAlarm(uint32_t u32Deadline_)
+{
+    auto i32Delta = static_cast<int32_t>(u32Deadline_ - Read());
+    if (i32Delta < 1) {
+        i32Delta = 1;
+    }
+
+    Timer1(cu32TimerCTL)   = 0;
+    Timer1(cu32TimerICR)   = cu32TATOINT;
+    Timer1(cu32TimerTAILR) = static_cast<uint32_t>(i32Delta);
+    Timer1(cu32TimerCTL)   = cu32CTLTAEN;
+}
+
+//---------------------------------------------------------------------------
+void KernelHRTimer::ClearAlarm(void)
+{
+    Timer1(cu32TimerCTL) = 0;
+    Timer1(cu32TimerICR) = cu32TATOINT;
+}
+} // namespace Mark3
+#endif // #if KERNEL_HRTIMERS
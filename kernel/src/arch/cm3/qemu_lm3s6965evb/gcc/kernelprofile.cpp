@@ -52,9 +52,10 @@ void Profiler::Stop()
 //---------------------------------------------------------------------------
 uint16_t Profiler::Read()
 {
+    // SysTick counts down from its reload value, once per kernel tick
     uint16_t rc = 0;
     CS_ENTER();
-    rc = KernelTimer::Read();
+    rc = static_cast<uint16_t>(SysTick->LOAD - KernelTimer::Read());
     CS_EXIT();
     return rc;
 }
@@ -0,0 +1,75 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   kernelhrtimer.h
+
+    @brief  High-resolution timer hardware interface
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+/**
+    Hardware interface used by the HRTimerScheduler - a free-running counter
+    running at PORT_HRTIMER_FREQ, with a compare interrupt.  The counter is
+    derived from the kernel tick and SysTick's current value, and the compare
+    interrupt is generated by GPTM Timer1 (TIMER1A_IRQHandler, which must be
+    installed in the board's vector table).
+ */
+class KernelHRTimer
+{
+public:
+    /**
+     *  @brief Config
+     *
+     *  Initialize the high-resolution timer, and start its free-running
+     *  counter.  The compare interrupt is left disabled.
+     */
+    static void Config(void);
+
+    /**
+     *  @brief Read
+     *
+     *  Read the free-running counter.  Must be called with interrupts
+     *  disabled.
+     *
+     *  @return Current count
+     */
+    static uint32_t Read(void);
+
+    /**
+     *  @brief SetAlarm
+     *
+     *  Program the compare interrupt to fire once the counter reaches the
+     *  given value.  If the value has already passed, the interrupt fires as
+     *  soon as possible.  Must be called with interrupts disabled.
+     *
+     *  @param u32Deadline_ Count at which to interrupt
+     */
+    static void SetAlarm(uint32_t u32Deadline_);
+
+    /**
+     *  @brief ClearAlarm
+     *
+     *  Disable the compare interrupt.  Must be called with interrupts
+     *  disabled.
+     */
+    static void ClearAlarm(void);
+};
+} // namespace Mark3
@@ -105,3 +105,65 @@ See license.txt for more information
     be initialized to a negative value.
 */
 #define PORT_MIN_TIMER_TICKS (0)
+
+/**
+    Define whether this port's kernel timer supports tickless operation (see
+    KERNEL_TIMERS_TICKLESS).
+*/
+#define PORT_TIMERS_TICKLESS (1)
+
+/**
+    Define whether this port provides a high-resolution timer (see
+    KERNEL_HRTIMERS), and the frequency of its free-running counter.  The
+    counter is derived from SysTick, so runs at the core clock.
+*/
+#define PORT_HRTIMERS (1)
+#define PORT_HRTIMER_FREQ ((uint32_t)PORT_SYSTEM_FREQ) // High-resolution timer counts per second
+
+/**
+    Define whether this port provides exclusive-access load/store primitives
+    (ThreadPort::LoadExclusive()/StoreExclusive(), using LDREX/STREX), which
+    allow uncontended Mutex and Semaphore operations to complete without a
+    critical section.
+*/
+#define PORT_ATOMIC_EXCLUSIVE (1)
+
+/**
+    Define whether this port provides a free-running cycle counter.  QEMU does
+    not model the DWT cycle counter, so CPU time accounting uses the profiling
+    timer on this target.
+*/
+#define PORT_CYCLE_COUNTER (0)
+
+/**
+    Define whether critical sections mask interrupts by raising BASEPRI, rather
+    than disabling them all through PRIMASK.  Interrupts with a higher priority
+    than PORT_CS_BASEPRI_MASK are then never masked by the kernel, and see no
+    added latency - but they must not call any kernel APIs.  SysTick, PendSV,
+    and every ISR that does use the kernel must be at or below that priority.
+*/
+#define PORT_CS_BASEPRI (0)
+
+/**
+    Value written to BASEPRI within a critical section when PORT_CS_BASEPRI is
+    set.  This is the raw register value, so the priority level sits in the top
+    __NVIC_PRIO_BITS bits: with 4 priority bits, 0x40 leaves NVIC priority
+    levels 0-3 unmasked.
+*/
+#define PORT_CS_BASEPRI_MASK (0x40)
+
+/**
+    Define whether the MPU guards the bottom of each thread's stack.  A 32-byte
+    no-access region (MPU region 7) is moved to the bottom of the running
+    thread's stack at each context switch, so that an overflow faults as soon
+    as it happens, rather than corrupting whatever lies below the stack.
+*/
+#define PORT_STACK_GUARD_MPU (0)
+
+/**
+    Size of the MPU stack guard region, in bytes (fixed by the port).  The
+    region starts at the first boundary of its size at or above the bottom of
+    the stack, and faults on any access - privileged or not - so the kernel's
+    stack scans stop short of it.
+*/
+#define PORT_STACK_GUARD_MPU_SIZE (32)
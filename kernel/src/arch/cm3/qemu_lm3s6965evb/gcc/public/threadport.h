@@ -54,6 +54,37 @@ See license.txt for more information
     #define xenable_irq()             ASM(" cpsie i \n");
 #endif
 
+#if PORT_CS_BASEPRI
+//------------------------------------------------------------------------
+//! Enter critical section (copy current BASEPRI register value, mask kernel-aware interrupts)
+#define CS_ENTER()                      \
+do {                                    \
+    volatile uint8_t __sr;              \
+    ASM (                               \
+    " mrs   r0, BASEPRI\n "             \
+    " msr   BASEPRI_MAX, %[mask] \n"    \
+    " isb \n"                           \
+    " strb r0, %[output] \n"            \
+    : [output] "=m" (__sr)              \
+    : [mask] "r" (PORT_CS_BASEPRI_MASK) \
+    : "r0", "memory");
+
+//------------------------------------------------------------------------
+//! Exit critical section (restore previous BASEPRI register value)
+#define CS_EXIT()                       \
+    ASM (                               \
+    " ldrb r0, %[input]\n "             \
+    " msr BASEPRI, r0 \n "              \
+    ::[input] "m" (__sr) : "r0", "memory"); \
+} while(0);
+
+//------------------------------------------------------------------------
+//! Mask/unmask kernel-aware interrupts from naked assembly (clobbers r12)
+#define PORT_CS_STRINGIFY_I(x)          #x
+#define PORT_CS_STRINGIFY(x)            PORT_CS_STRINGIFY_I(x)
+#define CS_ENTER_ASM                    " mov r12, #" PORT_CS_STRINGIFY(PORT_CS_BASEPRI_MASK) " \n msr BASEPRI, r12 \n isb \n"
+#define CS_EXIT_ASM                     " mov r12, #0 \n msr BASEPRI, r12 \n"
+#else
 //------------------------------------------------------------------------
 //! Enter critical section (copy current PRIMASK register value, disable interrupts)
 #define CS_ENTER()                      \
@@ -74,6 +105,12 @@ do {                                    \
     ::[input] "m" (__sr) : "r0");       \
 } while(0);
 
+//------------------------------------------------------------------------
+//! Disable/enable interrupts from naked assembly
+#define CS_ENTER_ASM                    " cpsid i \n "
+#define CS_EXIT_ASM                     " cpsie i \n "
+#endif // #if PORT_CS_BASEPRI
+
 namespace Mark3 {
 //------------------------------------------------------------------------
 class Thread;
@@ -101,6 +138,81 @@ public:
      *  Function to start the scheduler, initial threads, etc.
      */
     static void StartThreads();
+
+    /**
+     *  @brief LoadExclusive
+     *
+     *  Load a value, and tag its address for exclusive access (LDREX).  The
+     *  tag is cleared by any exception taken before the matching call to
+     *  StoreExclusive(), which then fails - so a load/store pair that succeeds
+     *  was not interrupted by an ISR or a context switch.
+     *
+     *  @param pu8Addr_ Address to load from
+     *  @return Value loaded
+     */
+    static uint8_t LoadExclusive(volatile uint8_t* pu8Addr_)
+    {
+        uint8_t u8Val;
+        ASM(" ldrexb %[val], [%[addr]] \n" : [val] "=r"(u8Val) : [addr] "r"(pu8Addr_) : "memory");
+        return u8Val;
+    }
+    static uint16_t LoadExclusive(volatile uint16_t* pu16Addr_)
+    {
+        uint16_t u16Val;
+        ASM(" ldrexh %[val], [%[addr]] \n" : [val] "=r"(u16Val) : [addr] "r"(pu16Addr_) : "memory");
+        return u16Val;
+    }
+    static uint32_t LoadExclusive(volatile uint32_t* pu32Addr_)
+    {
+        uint32_t u32Val;
+        ASM(" ldrex %[val], [%[addr]] \n" : [val] "=r"(u32Val) : [addr] "r"(pu32Addr_) : "memory");
+        return u32Val;
+    }
+
+    /**
+     *  @brief StoreExclusive
+     *
+     *  Store a value to an address tagged by LoadExclusive() (STREX), provided
+     *  that exclusive access has not been lost in the meantime.
+     *
+     *  @param pu8Addr_ Address to store to
+     *  @param u8Val_ Value to store
+     *  @return true if the value was stored, false if exclusive access was lost
+     */
+    static bool StoreExclusive(volatile uint8_t* pu8Addr_, uint8_t u8Val_)
+    {
+        uint32_t u32Fail;
+        ASM(" strexb %[fail], %[val], [%[addr]] \n"
+            : [fail] "=&r"(u32Fail)
+            : [val] "r"(u8Val_), [addr] "r"(pu8Addr_)
+            : "memory");
+        return (u32Fail == 0);
+    }
+    static bool StoreExclusive(volatile uint16_t* pu16Addr_, uint16_t u16Val_)
+    {
+        uint32_t u32Fail;
+        ASM(" strexh %[fail], %[val], [%[addr]] \n"
+            : [fail] "=&r"(u32Fail)
+            : [val] "r"(u16Val_), [addr] "r"(pu16Addr_)
+            : "memory");
+        return (u32Fail == 0);
+    }
+    static bool StoreExclusive(volatile uint32_t* pu32Addr_, uint32_t u32Val_)
+    {
+        uint32_t u32Fail;
+        ASM(" strex %[fail], %[val], [%[addr]] \n"
+            : [fail] "=&r"(u32Fail)
+            : [val] "r"(u32Val_), [addr] "r"(pu32Addr_)
+            : "memory");
+        return (u32Fail == 0);
+    }
+
+    /**
+     *  @brief ClearExclusive
+     *
+     *  Abandon an exclusive access started by LoadExclusive() (CLREX).
+     */
+    static void ClearExclusive() { ASM(" clrex \n" ::: "memory"); }
     friend class Thread;
 private:
 
@@ -198,12 +198,23 @@ void PendSV_Handler(void)
         " stmia r2!, {r4-r11} \n "
 
         // Equivalent of Thread_Swap() -- g_pclNext -> g_pclCurrent
-        " cpsid i \n "
+        CS_ENTER_ASM
         " ldr r1, CURR_ \n"
         " ldr r0, NEXT_ \n"
         " ldr r0, [r0] \n"
         " str r0, [r1] \n"
-        " cpsie i \n "
+        CS_EXIT_ASM
+
+#if PORT_STACK_GUARD_MPU
+        // Move the MPU stack guard to the bottom of the new thread's stack
+        " ldr r1, [r0, #12] \n"
+        " add r1, r1, #31 \n"
+        " bic r1, r1, #31 \n"
+        " orr r1, r1, #0x17 \n"
+        " ldr r3, MPU_RBAR_ \n"
+        " str r1, [r3] \n"
+        " dsb \n"
+#endif // #if PORT_STACK_GUARD_MPU
 
         // Get the pointer to the next thread's stack
         " add r0, #8 \n "
@@ -222,7 +233,11 @@ void PendSV_Handler(void)
 
         // Must be 4-byte aligned.  Also - GNU assembler, I hate you for making me resort to this.
         " NEXT_: .word g_pclNext \n"
-        " CURR_: .word g_pclCurrent \n");
+        " CURR_: .word g_pclCurrent \n"
+#if PORT_STACK_GUARD_MPU
+        " MPU_RBAR_: .word 0xE000ED9C \n"
+#endif // #if PORT_STACK_GUARD_MPU
+        );
 }
 
 namespace Mark3
@@ -231,6 +246,39 @@ static void ThreadPort_StartFirstThread(void) __attribute__((naked));
 //---------------------------------------------------------------------------
 volatile uint32_t g_ulCriticalCount;
 
+#if PORT_STACK_GUARD_MPU
+namespace
+{
+//---------------------------------------------------------------------------
+// MPU registers, and the region guarding the bottom of the running thread's stack
+constexpr auto cu32MpuCTRL        = K_ADDR{ 0xE000ED94 };
+constexpr auto cu32MpuRNR         = K_ADDR{ 0xE000ED98 };
+constexpr auto cu32MpuRBAR        = K_ADDR{ 0xE000ED9C };
+constexpr auto cu32MpuRASR        = K_ADDR{ 0xE000EDA0 };
+constexpr auto cu32MpuCTRLEnable  = uint32_t{ 0x00000005 }; // Enabled, default memory map for privileged code
+constexpr auto cu32MpuRBARValid   = uint32_t{ 0x00000010 };
+constexpr auto cu32MpuGuardRegion = uint32_t{ 7 };          // Highest-priority region
+constexpr auto cu32MpuGuardSize   = uint32_t{ 32 };         // Smallest region size, in bytes
+constexpr auto cu32MpuGuardRASR   = uint32_t{ 0x10000009 }; // Enabled, 32 bytes, no access, execute-never
+
+static_assert(PORT_STACK_GUARD_MPU_SIZE == cu32MpuGuardSize, "PORT_STACK_GUARD_MPU_SIZE must match the guard region");
+
+//---------------------------------------------------------------------------
+volatile uint32_t& MpuRegister(K_ADDR uAddr_)
+{
+    return *reinterpret_cast<volatile uint32_t*>(uAddr_);
+}
+
+//---------------------------------------------------------------------------
+void SetStackGuard(Thread* pclThread_)
+{
+    auto uBase = (reinterpret_cast<K_ADDR>(pclThread_->GetStack()) + cu32MpuGuardSize - 1) & ~(cu32MpuGuardSize - 1);
+    MpuRegister(cu32MpuRBAR) = uBase | cu32MpuRBARValid | cu32MpuGuardRegion;
+    ASM(" dsb \n isb \n");
+}
+} // anonymous namespace
+#endif // #if PORT_STACK_GUARD_MPU
+
 //---------------------------------------------------------------------------
 /*
     1) Setting up the thread stacks
@@ -345,6 +393,14 @@ void ThreadPort::StartThreads()
 
     KernelTimer::Start(); // enable the kernel timer
     KernelSWI::Start();   // enable the task switch SWI
+#if PORT_STACK_GUARD_MPU
+    // The context switch moves the guard region from thread to thread
+    MpuRegister(cu32MpuRNR)  = cu32MpuGuardRegion;
+    MpuRegister(cu32MpuRASR) = cu32MpuGuardRASR;
+    SetStackGuard(g_pclCurrent);
+    MpuRegister(cu32MpuCTRL) = cu32MpuCTRLEnable;
+    ASM(" dsb \n isb \n");
+#endif // #if PORT_STACK_GUARD_MPU
 
     // Restart the thread quantum timer, as any value held prior to starting
     // the kernel will be invalid.  This fixes a bug where multiple threads
@@ -75,13 +75,40 @@ public:
      */
     static void EI(void);
 
+#if KERNEL_TIMERS_TICKLESS
+    /**
+     *  @brief SetExpiry
+     *
+     *  Account for all whole ticks elapsed since the last expiry, and program
+     *  the timer to expire the given number of ticks after the most recent
+     *  tick boundary.  Must be called with interrupts disabled.
+     *
+     *  @param u32Interval_ Desired interval in ticks to set the timer for
+     *  @return Actual number of ticks set (may be less than desired)
+     */
+    static uint32_t SetExpiry(uint32_t u32Interval_);
+
     /**
      *  @brief ClearExpiry
      *
-     *  Clear the hardware timer expiry register
+     *  Account for all whole ticks elapsed since the last expiry, and leave the
+     *  timer running only to keep time, without waking the timer thread.  Must
+     *  be called with interrupts disabled.
      */
     static void ClearExpiry(void);
 
+    /**
+     *  @brief GetOvertime
+     *
+     *  Return the number of whole ticks that have elapsed since the last
+     *  expiry, which have not yet been added to the kernel's tick count.
+     *  Must be called with interrupts disabled.
+     *
+     *  @return Number of ticks elapsed since the last expiry
+     */
+    static uint32_t GetOvertime(void);
+#endif // #if KERNEL_TIMERS_TICKLESS
+
     /**
      *  @brief Read
      *
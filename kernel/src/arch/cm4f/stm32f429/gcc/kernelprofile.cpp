@@ -26,22 +26,52 @@ See license.txt for more information
 namespace Mark3
 {
 uint32_t Profiler::m_u32Epoch;
+uint32_t Profiler::m_u32Wraps;
+uint32_t Profiler::m_u32Sample;
 
 //---------------------------------------------------------------------------
-void Profiler::Init() {}
+void Profiler::Init()
+{
+    ThreadPort::StartCycleCounter();
+    CS_ENTER();
+    m_u32Wraps  = 0;
+    m_u32Sample = ThreadPort::ReadCycleCounter();
+    m_u32Epoch  = (m_u32Sample >> 16);
+    CS_EXIT();
+}
 
 //---------------------------------------------------------------------------
-void Profiler::Start() {}
+void Profiler::Start()
+{
+    // The cycle counter is free-running once enabled
+    ThreadPort::StartCycleCounter();
+}
 
 //---------------------------------------------------------------------------
 void Profiler::Stop() {}
 //---------------------------------------------------------------------------
 uint16_t Profiler::Read()
 {
-    return 0;
+    uint32_t u32Sample;
+    CS_ENTER();
+    u32Sample = ThreadPort::ReadCycleCounter();
+    if (u32Sample < m_u32Sample) {
+        m_u32Wraps++;
+    }
+    m_u32Sample = u32Sample;
+
+    // Derive the epoch from this same sample, so that a Read() followed by
+    // GetEpoch() always describes a single point in time.
+    m_u32Epoch = (m_u32Wraps << 16) | (u32Sample >> 16);
+    CS_EXIT();
+    return static_cast<uint16_t>(u32Sample);
 }
 
 //---------------------------------------------------------------------------
-void Profiler::Process() {}
+void Profiler::Process()
+{
+    // Sample the counter at least once per wrap (2^32 cycles) to track them
+    Read();
+}
 
 } // namespace Mark3
@@ -36,8 +36,27 @@ See license.txt for more information
 extern "C" {
 void SVC_Handler(void) __attribute__((naked));
 void PendSV_Handler(void) __attribute__((naked));
+#if PORT_FPU_LAZY_SWITCH
+void UsageFault_Handler(void) __attribute__((naked));
+void ThreadPort_UsageFault(uint32_t u32ExcReturn_);
+#endif // #if PORT_FPU_LAZY_SWITCH
 }
 
+#if PORT_FPU_LAZY_SWITCH
+//---------------------------------------------------------------------------
+//! Thread whose registers are currently held in the FPU, if any
+Mark3::Thread* g_pclFpuOwner;
+
+namespace
+{
+//---------------------------------------------------------------------------
+constexpr auto cu32CPACRFpuEnable  = uint32_t{ 0x00F00000 }; // Full access to CP10/CP11
+constexpr auto cu32CFSRNoCP        = uint32_t{ 1UL << 19 };  // UsageFault: coprocessor disabled
+constexpr auto cu32ExcReturnThread = uint32_t{ 0x4 };        // EXC_RETURN: return to thread mode
+constexpr auto cu16FpuContextWords = uint16_t{ 34 };         // s0-s31, FPSCR, padding
+} // anonymous namespace
+#endif // #if PORT_FPU_LAZY_SWITCH
+
 //---------------------------------------------------------------------------
 /*
     The SVC Call
@@ -158,12 +177,14 @@ void PendSV_Handler(void)
 
         " mrs r2, psp \n "
 
+#if !PORT_FPU_LAZY_SWITCH
         // Check to see if the thread was using floating point -- if so, we need to
         // store the remaining registers not automatically handled automagically on
         // entry to the exception handler.
         " tst r14, #0x10\n "
         " it eq \n "
         " vstmdbeq r2!, {s16-s31} \n "
+#endif // #if !PORT_FPU_LAZY_SWITCH
 
         // And, while r2 is at the bottom of the stack frame, stack r4-r11, lr
         " stmdb r2!, {r4-r11, r14} \n "
@@ -172,12 +193,38 @@ void PendSV_Handler(void)
         " str r2, [r3] \n "
 
         // Equivalent of Thread_Swap() -- g_pclNext -> g_pclCurrent
-        " cpsid i \n "
+        CS_ENTER_ASM
         " ldr r1, CURR_ \n"
         " ldr r0, NEXT_ \n"
         " ldr r0, [r0] \n"
         " str r0, [r1] \n"
-        " cpsie i \n "
+        CS_EXIT_ASM
+
+#if PORT_FPU_LAZY_SWITCH
+        // Enable the FPU only for the thread whose registers it holds; any
+        // other thread traps on its first floating-point instruction.
+        " ldr r1, FPU_OWNER_ \n"
+        " ldr r1, [r1] \n"
+        " ldr r3, CPACR_ \n"
+        " ldr r12, [r3] \n"
+        " cmp r0, r1 \n"
+        " ite eq \n"
+        " orreq r12, r12, #0x00F00000 \n"
+        " bicne r12, r12, #0x00F00000 \n"
+        " str r12, [r3] \n"
+        " dsb \n"
+#endif // #if PORT_FPU_LAZY_SWITCH
+
+#if PORT_STACK_GUARD_MPU
+        // Move the MPU stack guard to the bottom of the new thread's stack
+        " ldr r1, [r0, #12] \n"
+        " add r1, r1, #31 \n"
+        " bic r1, r1, #31 \n"
+        " orr r1, r1, #0x17 \n"
+        " ldr r3, MPU_RBAR_ \n"
+        " str r1, [r3] \n"
+        " dsb \n"
+#endif // #if PORT_STACK_GUARD_MPU
 
         // Get the pointer to the next thread's stack
         " add r0, #8 \n "
@@ -186,11 +233,13 @@ void PendSV_Handler(void)
         // Stack pointer is in r2, start loading registers from the "manually-stacked" set
         " ldmia r2!, {r4-r11, r14} \n "
 
+#if !PORT_FPU_LAZY_SWITCH
         // Check to see if the thread was using floating point -- if so, we need to
         // store the remaining registers not automatically handled due to lazy stacking
         " tst r14, #0x10\n "
         " it eq \n "
         " vldmiaeq r2!, {s16-s31} \n "
+#endif // #if !PORT_FPU_LAZY_SWITCH
 
         // After subbing R2 #32 through ldmia/stack popping, our PSP is where it
         // needs to be when we return from the exception handler
@@ -201,15 +250,91 @@ void PendSV_Handler(void)
 
         // Must be 4-byte aligned.  Also - GNU assembler, I hate you for making me resort to this.
         " NEXT_: .word g_pclNext \n"
-        " CURR_: .word g_pclCurrent \n");
+        " CURR_: .word g_pclCurrent \n"
+#if PORT_FPU_LAZY_SWITCH
+        " FPU_OWNER_: .word g_pclFpuOwner \n"
+        " CPACR_: .word 0xE000ED88 \n"
+#endif // #if PORT_FPU_LAZY_SWITCH
+#if PORT_STACK_GUARD_MPU
+        " MPU_RBAR_: .word 0xE000ED9C \n"
+#endif // #if PORT_STACK_GUARD_MPU
+        );
 }
 
+#if PORT_FPU_LAZY_SWITCH
+//---------------------------------------------------------------------------
+/*
+    Lazy FPU switching
+
+    With PORT_FPU_LAZY_SWITCH set, the hardware's automatic FPU state
+    preservation is turned off, and the kernel tracks which thread's registers
+    are held in the FPU instead.  The context switch leaves the FPU enabled
+    only for that thread - when any other thread executes a floating-point
+    instruction, the resulting NOCP UsageFault hands the FPU over to it, and
+    the faulting instruction is retried on return.
+
+    The handler only passes its EXC_RETURN value along, so that faults taken
+    from handler mode can be told apart.
+*/
+void UsageFault_Handler(void)
+{
+    ASM(" mov r0, lr \n"
+        " b ThreadPort_UsageFault \n");
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort_UsageFault(uint32_t u32ExcReturn_)
+{
+    // Only a thread's use of a disabled FPU can be recovered from - interrupt
+    // handlers may not use the FPU at all.
+    if (((SCB->CFSR & cu32CFSRNoCP) == 0) || ((u32ExcReturn_ & cu32ExcReturnThread) == 0)) {
+        Mark3::Kernel::Panic(PANIC_UNHANDLED_USAGE_FAULT);
+    }
+    SCB->CFSR = cu32CFSRNoCP;
+
+    Mark3::ThreadPort::ClaimFpu();
+}
+#endif // #if PORT_FPU_LAZY_SWITCH
+
 namespace Mark3
 {
 static void ThreadPort_StartFirstThread(void) __attribute__((naked));
 //---------------------------------------------------------------------------
 volatile uint32_t g_ulCriticalCount;
 
+#if PORT_STACK_GUARD_MPU
+namespace
+{
+//---------------------------------------------------------------------------
+// MPU registers, and the region guarding the bottom of the running thread's stack
+constexpr auto cu32MpuCTRL        = K_ADDR{ 0xE000ED94 };
+constexpr auto cu32MpuRNR         = K_ADDR{ 0xE000ED98 };
+constexpr auto cu32MpuRBAR        = K_ADDR{ 0xE000ED9C };
+constexpr auto cu32MpuRASR        = K_ADDR{ 0xE000EDA0 };
+constexpr auto cu32MpuCTRLEnable  = uint32_t{ 0x00000005 }; // Enabled, default memory map for privileged code
+constexpr auto cu32MpuRBARValid   = uint32_t{ 0x00000010 };
+constexpr auto cu32MpuGuardRegion = uint32_t{ 7 };          // Highest-priority region
+constexpr auto cu32MpuGuardSize   = uint32_t{ 32 };         // Smallest region size, in bytes
+constexpr auto cu32MpuGuardRASR   = uint32_t{ 0x10000009 }; // Enabled, 32 bytes, no access, execute-never
+
+static_assert(PORT_STACK_GUARD_MPU_SIZE == cu32MpuGuardSize, "PORT_STACK_GUARD_MPU_SIZE must match the guard region");
+
+//---------------------------------------------------------------------------
+volatile uint32_t& MpuRegister(K_ADDR uAddr_)
+{
+    return *reinterpret_cast<volatile uint32_t*>(uAddr_);
+}
+
+//---------------------------------------------------------------------------
+void SetStackGuard(Thread* pclThread_)
+{
+    auto uBase = (reinterpret_cast<K_ADDR>(pclThread_->GetStack()) + cu32MpuGuardSize - 1) & ~(cu32MpuGuardSize - 1);
+    MpuRegister(cu32MpuRBAR) = uBase | cu32MpuRBARValid | cu32MpuGuardRegion;
+    ASM(" dsb \n isb \n");
+}
+} // anonymous namespace
+#endif // #if PORT_STACK_GUARD_MPU
+
 //---------------------------------------------------------------------------
 /*
     1) Setting up the thread stacks
@@ -285,7 +410,7 @@ void ThreadPort::InitStack(Thread* pclThread_)
     PUSH_TO_STACK(pu32Stack, (uint32_t)pclThread_->m_pvArg); // R0 = argument
 
     //-- Simulated Manually-Stacked Registers --
-    PUSH_TO_STACK(pu32Stack, 0xFFFFFFFD); // Default "EXC_RETURN" value -- Thread mode, floating point.
+    PUSH_TO_STACK(pu32Stack, 0xFFFFFFFD); // Default "EXC_RETURN" value -- Thread mode, PSP, no FPU state.
     PUSH_TO_STACK(pu32Stack, 0x11);
     PUSH_TO_STACK(pu32Stack, 0x10);
     PUSH_TO_STACK(pu32Stack, 0x09);
@@ -297,7 +422,84 @@ void ThreadPort::InitStack(Thread* pclThread_)
     pu32Stack++;
 
     pclThread_->m_pwStackTop = pu32Stack;
+
+#if PORT_FPU_LAZY_SWITCH
+    // A re-initialized thread no longer has any FPU state to preserve
+    if (g_pclFpuOwner == pclThread_) {
+        g_pclFpuOwner = nullptr;
+    }
+    pclThread_->m_bFpuContext = false;
+#endif // #if PORT_FPU_LAZY_SWITCH
+}
+
+#if PORT_FPU_LAZY_SWITCH
+//---------------------------------------------------------------------------
+/*
+    Note that this must not touch the FPU registers itself, other than through
+    the inline assembly below - the thread's registers are loaded on return.
+*/
+void ThreadPort::ClaimFpu()
+{
+    SCB->CPACR |= cu32CPACRFpuEnable;
+    ASM(" dsb \n isb \n");
+
+    auto* pclOwner  = g_pclFpuOwner;
+    auto* pclThread = g_pclCurrent;
+    if (pclOwner == pclThread) {
+        return;
+    }
+
+    // Save the previous owner's registers, unless its stack has since been
+    // given up.
+    if ((pclOwner != nullptr) && (pclOwner->GetState() != ThreadState::Exit)) {
+        auto* pu32Context = pclOwner->m_pwStack - cu16FpuContextWords;
+        ASM(" vstmia %[ctx]!, {s0-s31} \n"
+            " vmrs r1, fpscr \n"
+            " str r1, [%[ctx]] \n"
+            : [ctx] "+r"(pu32Context)
+            :
+            : "r1", "memory");
+    }
+
+    // On first use, take a save area from the bottom of the thread's stack,
+    // holding the FPU's reset state.
+    if (!pclThread->m_bFpuContext) {
+        uint32_t u32Psp;
+        ASM(" mrs %[psp], psp \n" : [psp] "=r"(u32Psp));
+        if (u32Psp <= reinterpret_cast<uint32_t>(pclThread->m_pwStack + cu16FpuContextWords)) {
+            Kernel::Panic(PANIC_STACK_SLACK_VIOLATED);
+        }
+#if KERNEL_STACK_CHECK
+        if (pclThread->m_u16StackMark <= cu16FpuContextWords) {
+            Kernel::Panic(PANIC_STACK_SLACK_VIOLATED);
+        }
+        pclThread->m_u16StackMark -= cu16FpuContextWords;
+#endif // #if KERNEL_STACK_CHECK
+
+        auto* pu32Context = pclThread->m_pwStack;
+        pclThread->m_pwStack += cu16FpuContextWords;
+        pclThread->m_u16StackSize -= cu16FpuContextWords * sizeof(K_WORD);
+        pclThread->m_bFpuContext = true;
+#if PORT_STACK_GUARD_MPU
+        // The guard region is currently over the save area itself
+        SetStackGuard(pclThread);
+#endif // #if PORT_STACK_GUARD_MPU
+
+        for (uint16_t i = 0; i < cu16FpuContextWords; i++) { pu32Context[i] = 0; }
+        pu32Context[32] = FPU->FPDSCR;
+    }
+
+    auto* pu32Context = pclThread->m_pwStack - cu16FpuContextWords;
+    ASM(" vldmia %[ctx]!, {s0-s31} \n"
+        " ldr r1, [%[ctx]] \n"
+        " vmsr fpscr, r1 \n"
+        : [ctx] "+r"(pu32Context)
+        :
+        : "r1", "memory");
+
+    g_pclFpuOwner = pclThread;
 }
+#endif // #if PORT_FPU_LAZY_SWITCH
 
 //---------------------------------------------------------------------------
 void Thread_Switch(void)
@@ -324,14 +526,31 @@ void ThreadPort::StartThreads()
 
     KernelTimer::Start(); // enable the kernel timer
     KernelSWI::Start();   // enable the task switch SWI
+#if PORT_STACK_GUARD_MPU
+    // The context switch moves the guard region from thread to thread
+    MpuRegister(cu32MpuRNR)  = cu32MpuGuardRegion;
+    MpuRegister(cu32MpuRASR) = cu32MpuGuardRASR;
+    SetStackGuard(g_pclCurrent);
+    MpuRegister(cu32MpuCTRL) = cu32MpuCTRLEnable;
+    ASM(" dsb \n isb \n");
+#endif // #if PORT_STACK_GUARD_MPU
 
 #if KERNEL_ROUND_ROBIN
     Quantum::Update(g_pclCurrent);
 #endif // #if KERNEL_ROUND_ROBIN
 
+#if PORT_FPU_LAZY_SWITCH
+    // No thread owns the FPU yet - leave it disabled, and have the kernel manage
+    // its state instead of the exception hardware.
+    FPU->FPCCR &= ~(FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk);
+    SCB->CPACR &= ~cu32CPACRFpuEnable;
+    SCB->SHCSR |= SCB_SHCSR_USGFAULTENA_Msk;
+    ASM(" mov r0, #0 \n msr control, r0 \n isb \n" ::: "r0");
+#else
     SCB->CPACR |= 0x00F00000; // Enable floating-point
 
     FPU->FPCCR |= (FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk); // Enable lazy-stacking
+#endif // #if PORT_FPU_LAZY_SWITCH
 
     ThreadPort_StartFirstThread(); // Jump to the first thread (does not return)
 }
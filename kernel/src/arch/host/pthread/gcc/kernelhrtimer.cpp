@@ -0,0 +1,115 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   kernelhrtimer.cpp
+
+    @brief  High-resolution timer implementation for the native Linux host
+
+    The free-running counter is derived from CLOCK_MONOTONIC, in microseconds.
+    Compare interrupts are generated by a one-shot POSIX timer delivering
+    SIGRTMIN, which raises the high-resolution timer vector.
+*/
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_HRTIMERS
+#include "kernelhrtimer.h"
+#include "threadport.h"
+#include "hrtimer.h"
+
+#include <signal.h>
+#include <time.h>
+
+using namespace Mark3;
+namespace
+{
+//---------------------------------------------------------------------------
+constexpr auto cu64NsPerCount = static_cast<uint64_t>(1000000000ULL / PORT_HRTIMER_FREQ);
+timer_t        s_stHRTimer;
+
+//---------------------------------------------------------------------------
+uint64_t GetTimeNs()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return (static_cast<uint64_t>(stTime.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(stTime.tv_nsec);
+}
+
+//---------------------------------------------------------------------------
+void KernelHRTimer_ISR()
+{
+    HRTimerScheduler::Process();
+}
+
+//---------------------------------------------------------------------------
+void KernelHRTimer_Signal(int /*iSignal_*/)
+{
+    ThreadPort::RaiseInterrupt(PORT_HOST_VECTOR_HRTIMER);
+}
+} // anonymous namespace
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void KernelHRTimer::Config(void)
+{
+    ThreadPort::SetVector(PORT_HOST_VECTOR_HRTIMER, KernelHRTimer_ISR);
+
+    struct sigaction stAction = {};
+    stAction.sa_handler       = KernelHRTimer_Signal;
+    stAction.sa_flags         = SA_RESTART;
+    sigemptyset(&stAction.sa_mask);
+    sigaddset(&stAction.sa_mask, SIGALRM);
+    sigaction(SIGRTMIN, &stAction, nullptr);
+
+    struct sigevent stEvent = {};
+    stEvent.sigev_notify    = SIGEV_SIGNAL;
+    stEvent.sigev_signo     = SIGRTMIN;
+    timer_create(CLOCK_MONOTONIC, &stEvent, &s_stHRTimer);
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelHRTimer::Read(void)
+{
+    return static_cast<uint32_t>(GetTimeNs() / cu64NsPerCount);
+}
+
+//---------------------------------------------------------------------------
+void KernelHRTimer::SetAlarm(uint32_t u32Deadline_)
+{
+    auto u64Now   = GetTimeNs();
+    auto i32Delta = static_cast<int32_t>(u32Deadline_ - static_cast<uint32_t>(u64Now / cu64NsPerCount));
+    if (i32Delta < 1) {
+        i32Delta = 1;
+    }
+
+    // Arm against the absolute time, rounded down to the start of the count
+    auto u64Expiry = ((u64Now / cu64NsPerCount) + static_cast<uint64_t>(i32Delta)) * cu64NsPerCount;
+
+    struct itimerspec stSpec = {};
+    stSpec.it_value.tv_sec   = static_cast<time_t>(u64Expiry / 1000000000ULL);
+    stSpec.it_value.tv_nsec  = static_cast<long>(u64Expiry % 1000000000ULL);
+    timer_settime(s_stHRTimer, TIMER_ABSTIME, &stSpec, nullptr);
+}
+
+//---------------------------------------------------------------------------
+void KernelHRTimer::ClearAlarm(void)
+{
+    struct itimerspec stSpec = {};
+    timer_settime(s_stHRTimer, 0, &stSpec, nullptr);
+}
+} // namespace Mark3
+#endif // #if KERNEL_HRTIMERS
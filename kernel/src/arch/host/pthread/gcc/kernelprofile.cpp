@@ -0,0 +1,91 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file kernelprofile.cpp
+
+    @brief Profiling timer implementation
+*/
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+#include "profile.h"
+#include "kernelprofile.h"
+#include "threadport.h"
+
+#include <time.h>
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Calls to Read() and GetEpoch() made within this many counts of each other
+// share a single clock sample, so that the pair is always self-consistent.
+constexpr uint64_t s_u64PairWindow = 8;
+uint64_t           s_u64Sample;
+
+//---------------------------------------------------------------------------
+// Return the current value of the (virtual) free-running profiling counter
+uint64_t Profiler_Counter()
+{
+    struct timespec stNow;
+    clock_gettime(CLOCK_MONOTONIC, &stNow);
+
+    auto u64Ns  = (static_cast<uint64_t>(stNow.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(stNow.tv_nsec);
+    auto u64Now = u64Ns / (1000000000ULL / (PORT_SYSTEM_FREQ / CLOCK_DIVIDE));
+    if ((u64Now - s_u64Sample) > s_u64PairWindow) {
+        s_u64Sample = u64Now;
+    }
+    return s_u64Sample;
+}
+} // anonymous namespace
+
+namespace Mark3
+{
+bool Profiler::m_bActive;
+
+//---------------------------------------------------------------------------
+void Profiler::Init()
+{
+    m_bActive = false;
+}
+
+//---------------------------------------------------------------------------
+void Profiler::Start()
+{
+    m_bActive = true;
+}
+
+//---------------------------------------------------------------------------
+void Profiler::Stop()
+{
+    m_bActive = false;
+}
+
+//---------------------------------------------------------------------------
+uint16_t Profiler::Read()
+{
+    return static_cast<uint16_t>(Profiler_Counter() % TICKS_PER_OVERFLOW);
+}
+
+//---------------------------------------------------------------------------
+void Profiler::Process()
+{
+    // Epochs are derived from the host clock; nothing to do.
+}
+
+//---------------------------------------------------------------------------
+uint32_t Profiler::GetEpoch()
+{
+    return static_cast<uint32_t>(Profiler_Counter() / TICKS_PER_OVERFLOW);
+}
+} // namespace Mark3
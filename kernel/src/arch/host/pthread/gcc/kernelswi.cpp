@@ -0,0 +1,83 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   kernelswi.cpp
+
+    @brief  Kernel Software interrupt implementation for the native Linux host
+
+    The SWI is modeled as the lowest-priority host vector, so a context switch
+    requested from within a critical section (or from the tick handler) is
+    deferred until all other pending work has been serviced - equivalent to
+    PendSV on ARM Cortex-M.
+*/
+
+#include "kerneltypes.h"
+#include "kernelswi.h"
+#include "threadport.h"
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void KernelSWI::Config(void)
+{
+    ThreadPort::SetVector(PORT_HOST_VECTOR_SWI, ThreadPort::SwitchContext);
+    Clear();
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::Start(void)
+{
+    // Nothing to do...
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::Stop(void)
+{
+    // Nothing to do...
+}
+
+//---------------------------------------------------------------------------
+uint8_t KernelSWI::DI()
+{
+    // Not implemented
+    return 0;
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::RI(bool bEnable_)
+{
+    // Not implemented
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::Clear(void)
+{
+    ThreadPort::ClearInterrupt(PORT_HOST_VECTOR_SWI);
+}
+
+//---------------------------------------------------------------------------
+void KernelSWI::Trigger(void)
+{
+    ThreadPort::RaiseInterrupt(PORT_HOST_VECTOR_SWI);
+}
+
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+void KernelSWI::TriggerCore(uint8_t u8Core_)
+{
+    ThreadPort::RaiseInterrupt(PORT_HOST_VECTOR_SWI, u8Core_);
+}
+#endif // #if KERNEL_SMP
+} // namespace Mark3
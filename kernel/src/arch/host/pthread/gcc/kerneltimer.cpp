@@ -0,0 +1,324 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   kerneltimer.cpp
+
+    @brief  Kernel Timer Implementation for the native Linux host
+
+    The kernel tick is driven by a POSIX interval timer on CLOCK_MONOTONIC,
+    delivering SIGALRM at PORT_TIMER_FREQ.  The signal handler raises the
+    timer vector, which is serviced immediately, or deferred until the current
+    critical section is exited.  Timer expiries are processed by the timer
+    thread, or from the timer vector itself if KERNEL_TIMERS_THREADED is
+    disabled.
+
+    In tickless mode, the timer is instead armed as a one-shot for the next
+    expiry, and elapsed ticks are derived from CLOCK_MONOTONIC directly.
+*/
+
+#include "kerneltypes.h"
+#include "kerneltimer.h"
+#include "threadport.h"
+#include "kernel.h"
+#include "ksemaphore.h"
+#include "thread.h"
+
+#include <signal.h>
+#include <time.h>
+
+using namespace Mark3;
+namespace
+{
+#if KERNEL_TIMERS_THREADED
+//---------------------------------------------------------------------------
+// Static objects implementing the timer thread and its synchronization objects
+Thread    s_clTimerThread;
+K_WORD    s_clTimerThreadStack[PORT_KERNEL_TIMERS_THREAD_STACK];
+Semaphore s_clTimerSemaphore;
+#endif // #if KERNEL_TIMERS_THREADED
+
+//---------------------------------------------------------------------------
+// Host timer state
+constexpr auto s_lTickPeriodNs = static_cast<long>(1000000000L / PORT_TIMER_FREQ);
+timer_t        s_stTimer;
+
+//---------------------------------------------------------------------------
+// Process timer expiries for a single pass of the timer scheduler
+void ProcessTimers()
+{
+#if KERNEL_ROUND_ROBIN
+    Quantum::SetInTimer();
+#endif // #if KERNEL_ROUND_ROBIN
+    TimerScheduler::Process();
+#if KERNEL_ROUND_ROBIN
+    Quantum::ClearInTimer();
+#endif // #if KERNEL_ROUND_ROBIN
+}
+
+#if KERNEL_TIMERS_TICKLESS
+uint64_t s_u64Epoch;   // CLOCK_MONOTONIC time of the last tick boundary accounted for
+bool     s_bExpiry;    // Whether the timer is armed for a timer expiry
+bool     s_bStarted;   // Whether the kernel timer has been started
+
+//---------------------------------------------------------------------------
+uint64_t GetTimeNs()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return (static_cast<uint64_t>(stTime.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(stTime.tv_nsec);
+}
+
+//---------------------------------------------------------------------------
+// Add the whole ticks elapsed since the last accounted tick boundary to the
+// kernel's tick count.  Called with the timer vector masked.
+void AccountTicks()
+{
+    auto u32Ticks = static_cast<uint32_t>((GetTimeNs() - s_u64Epoch) / s_lTickPeriodNs);
+    s_u64Epoch += static_cast<uint64_t>(u32Ticks) * s_lTickPeriodNs;
+    Kernel::Tick(u32Ticks);
+}
+
+//---------------------------------------------------------------------------
+// Account for elapsed ticks, and arm the timer to expire the given number of
+// ticks after the latest tick boundary (or disarm it, if none is requested).
+void Restart(uint32_t u32Ticks_, bool bExpiry_)
+{
+    AccountTicks();
+    s_bExpiry = bExpiry_;
+
+    struct itimerspec stSpec = {};
+    if (bExpiry_) {
+        auto u64Expiry          = s_u64Epoch + (static_cast<uint64_t>(u32Ticks_) * s_lTickPeriodNs);
+        stSpec.it_value.tv_sec  = static_cast<time_t>(u64Expiry / 1000000000ULL);
+        stSpec.it_value.tv_nsec = static_cast<long>(u64Expiry % 1000000000ULL);
+    }
+    timer_settime(s_stTimer, TIMER_ABSTIME, &stSpec, nullptr);
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer_ISR()
+{
+    if (!s_bStarted) {
+        return;
+    }
+
+    AccountTicks();
+    if (Kernel::IsStarted() && s_bExpiry) {
+#if KERNEL_TIMERS_THREADED
+        s_clTimerSemaphore.Post();
+#else
+        // Processes all ticks elapsed since the last expiry, and re-arms the timer
+        ProcessTimers();
+#endif // #if KERNEL_TIMERS_THREADED
+    }
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer_Signal(int /*iSignal_*/)
+{
+#if KERNEL_SMP
+    // The signal may land on any core's host thread; the timer belongs to core 0
+    ThreadPort::RaiseInterrupt(PORT_HOST_VECTOR_TIMER, 0);
+#else
+    ThreadPort::RaiseInterrupt(PORT_HOST_VECTOR_TIMER);
+#endif // #if KERNEL_SMP
+}
+#else
+volatile uint32_t s_u32PendingTicks;
+#if KERNEL_TIMERS_THREADED
+uint32_t s_u32TimerTicks;
+#endif // #if KERNEL_TIMERS_THREADED
+
+//---------------------------------------------------------------------------
+void KernelTimer_ISR()
+{
+    if (!Kernel::IsStarted()) {
+        return;
+    }
+
+    // Account for every tick delivered since the vector was last serviced,
+    // including any that were deferred by a critical section.
+    auto u32Ticks = __atomic_exchange_n(&s_u32PendingTicks, 0, __ATOMIC_SEQ_CST);
+#if KERNEL_TIMERS_THREADED
+    s_u32TimerTicks += u32Ticks;
+    while (u32Ticks-- != 0) { Kernel::Tick(); }
+    s_clTimerSemaphore.Post();
+#else
+    while (u32Ticks-- != 0) {
+        Kernel::Tick();
+        ProcessTimers();
+    }
+#endif // #if KERNEL_TIMERS_THREADED
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer_Signal(int /*iSignal_*/)
+{
+    // Signals coalesce while pending; recover any ticks lost to host latency.
+    auto iOverrun = timer_getoverrun(s_stTimer);
+    __atomic_add_fetch(&s_u32PendingTicks, 1 + ((iOverrun > 0) ? iOverrun : 0), __ATOMIC_SEQ_CST);
+#if KERNEL_SMP
+    // The signal may land on any core's host thread; the timer belongs to core 0
+    ThreadPort::RaiseInterrupt(PORT_HOST_VECTOR_TIMER, 0);
+#else
+    ThreadPort::RaiseInterrupt(PORT_HOST_VECTOR_TIMER);
+#endif // #if KERNEL_SMP
+}
+#endif // #if KERNEL_TIMERS_TICKLESS
+} // anonymous namespace
+
+namespace Mark3
+{
+#if KERNEL_TIMERS_THREADED
+//---------------------------------------------------------------------------
+static void KernelTimer_Task(void* unused)
+{
+    (void)unused;
+    while (1) {
+        s_clTimerSemaphore.Pend();
+
+#if KERNEL_TIMERS_TICKLESS
+        // Processes all ticks elapsed since the last expiry, and re-arms the timer
+        ProcessTimers();
+#else
+        // Process each tick that elapsed since the timer thread last ran
+        uint32_t u32Ticks;
+        CS_ENTER();
+        u32Ticks        = s_u32TimerTicks;
+        s_u32TimerTicks = 0;
+        CS_EXIT();
+
+        while (u32Ticks-- != 0) { ProcessTimers(); }
+#endif // #if KERNEL_TIMERS_TICKLESS
+    }
+}
+#endif // #if KERNEL_TIMERS_THREADED
+
+//---------------------------------------------------------------------------
+void KernelTimer::Config(void)
+{
+#if KERNEL_TIMERS_THREADED
+    s_clTimerSemaphore.Init(0, 1);
+    s_clTimerThread.Init(s_clTimerThreadStack,
+                         sizeof(s_clTimerThreadStack),
+                         KERNEL_TIMERS_THREAD_PRIORITY,
+                         KernelTimer_Task,
+                         0);
+#if KERNEL_ROUND_ROBIN
+    Quantum::SetTimerThread(&s_clTimerThread);
+#endif // #if KERNEL_ROUND_ROBIN
+    s_clTimerThread.Start();
+#endif // #if KERNEL_TIMERS_THREADED
+
+    ThreadPort::SetVector(PORT_HOST_VECTOR_TIMER, KernelTimer_ISR);
+
+    struct sigaction stAction = {};
+    stAction.sa_handler       = KernelTimer_Signal;
+    stAction.sa_flags         = SA_RESTART;
+    sigemptyset(&stAction.sa_mask);
+    sigaction(SIGALRM, &stAction, nullptr);
+
+    struct sigevent stEvent = {};
+    stEvent.sigev_notify    = SIGEV_SIGNAL;
+    stEvent.sigev_signo     = SIGALRM;
+    timer_create(CLOCK_MONOTONIC, &stEvent, &s_stTimer);
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::Start(void)
+{
+#if KERNEL_TIMERS_TICKLESS
+    // Wake the timer thread on the first tick, which programs the first expiry
+    CS_ENTER();
+    s_u64Epoch = GetTimeNs();
+    s_bStarted = true;
+    Restart(1, true);
+    CS_EXIT();
+#else
+    struct itimerspec stSpec = {};
+    stSpec.it_interval.tv_nsec = s_lTickPeriodNs;
+    stSpec.it_value.tv_nsec    = s_lTickPeriodNs;
+    timer_settime(s_stTimer, 0, &stSpec, nullptr);
+#endif // #if KERNEL_TIMERS_TICKLESS
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::Stop(void)
+{
+#if KERNEL_TIMERS_TICKLESS
+    s_bStarted = false;
+#endif // #if KERNEL_TIMERS_TICKLESS
+    struct itimerspec stSpec = {};
+    timer_settime(s_stTimer, 0, &stSpec, nullptr);
+}
+
+#if KERNEL_TIMERS_TICKLESS
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::SetExpiry(uint32_t u32Interval_)
+{
+    if (s_bStarted) {
+        Restart(u32Interval_, true);
+    }
+    return u32Interval_;
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::ClearExpiry(void)
+{
+    if (s_bStarted) {
+        Restart(0, false);
+    }
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetOvertime(void)
+{
+    if (!s_bStarted) {
+        return 0;
+    }
+    return static_cast<uint32_t>((GetTimeNs() - s_u64Epoch) / s_lTickPeriodNs);
+}
+#endif // #if KERNEL_TIMERS_TICKLESS
+
+//---------------------------------------------------------------------------
+PORT_TIMER_COUNT_TYPE KernelTimer::Read(void)
+{
+    // Return the number of nanoseconds elapsed in the current tick period
+#if KERNEL_TIMERS_TICKLESS
+    return static_cast<PORT_TIMER_COUNT_TYPE>((GetTimeNs() - s_u64Epoch) % s_lTickPeriodNs);
+#else
+    struct itimerspec stSpec;
+    timer_gettime(s_stTimer, &stSpec);
+    return static_cast<PORT_TIMER_COUNT_TYPE>(s_lTickPeriodNs - stSpec.it_value.tv_nsec);
+#endif // #if KERNEL_TIMERS_TICKLESS
+}
+
+//-------------------------------------------------------------------------
+uint8_t KernelTimer::DI(void)
+{
+    return 0;
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::EI(void)
+{
+    KernelTimer::RI(0);
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::RI(bool bEnable_) {}
+
+//---------------------------------------------------------------------------
+} // namespace Mark3
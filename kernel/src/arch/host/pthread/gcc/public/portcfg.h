@@ -0,0 +1,147 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+    @file portcfg.h
+
+    @brief Mark3 Port Configuration
+
+    This file is used to configure the kernel for your specific target CPU
+    in order to provide the optimal set of features for a given use case.
+
+    This configuration targets a native Linux host, where each Mark3 thread
+    is backed by a ucontext, and the kernel tick is driven from a POSIX timer.
+
+    !! NOTE:  This file must ONLY be included from mark3cfg.h
+*/
+#pragma once
+
+#include <stdint.h>
+
+/**
+    Define the number of thread priorities that the kernel's scheduler will
+    support.  The number of thread priorities is limited only by the memory
+    of the host CPU, as a ThreadList object is statically-allocated for each
+    thread priority.
+
+    In practice, systems rarely need more than 32 priority levels, with the
+    most complex having the capacity for 256.
+*/
+#define KERNEL_NUM_PRIORITIES (32)
+
+#define KERNEL_TIMERS_THREAD_PRIORITY (KERNEL_NUM_PRIORITIES - 1)
+
+#define THREAD_QUANTUM_DEFAULT (4)
+
+#define KERNEL_STACK_GUARD_DEFAULT (32) // words
+
+/**
+    Define a macro indicating the CPU architecture for which this port belongs.
+
+    This may also be set by the toolchain, but that's not guaranteed.
+*/
+#ifndef HOST
+#define HOST (1)
+#endif
+
+/**
+    Define types that map to the CPU Architecture's default data-word and address
+    size.  On the host these are pointer-sized, so that stacks are naturally
+    aligned for the ucontext frames stored within them.
+*/
+#define K_WORD uint64_t //!< Size of a data word
+#define K_ADDR uint64_t //!< Size of an address (pointer size)
+#define K_INT int64_t
+
+/**
+    Set a base datatype used to represent each element of the scheduler's
+    priority bitmap.
+
+    PORT_PRIO_MAP_WORD_SIZE should map to the *size* of an element of type
+    PORT_PROI_TYPE.
+*/
+#define PORT_PRIO_TYPE uint32_t     //!< Type used for bitmap in the PriorityMap class
+#define PORT_PRIO_MAP_WORD_SIZE (4) //!< size of PORT_PRIO_TYPE in bytes
+
+/**
+    Define the running CPU frequency.  The host has no meaningful fixed CPU
+    clock, so this describes the virtual clock from which the profiling timer
+    is derived (see kernelprofile.h) - 100MHz, giving 10ns profiling resolution
+    while keeping multi-second measurements within 32 bits.
+*/
+#define PORT_SYSTEM_FREQ (100000000)
+
+/**
+    Set the timer frequency.  If running in tickless mode, this is simply the frequency
+    at which the free-running kernel timer increments.
+
+    In tick-based mode, this is the frequency at which the fixed-frequency kernel tick
+    interrupt occurs.
+*/
+#define PORT_TIMER_FREQ ((uint32_t)1000) // Timer ticks per second...
+
+/**
+    Define the default/minimum size of a thread stack.  Host stacks must also
+    accommodate the ucontext frame and the signal frame pushed by the tick
+    handler, so these are much larger than on a microcontroller.  Note that
+    stack sizes are passed to Thread::Init() in bytes as a uint16_t, so this
+    must remain small enough for (2 * default) stacks to fit.
+*/
+#define PORT_KERNEL_DEFAULT_STACK_SIZE ((K_ADDR)2048)
+
+/**
+    Define the size of the kernel-timer thread stack (if one is configured)
+*/
+#define PORT_KERNEL_TIMERS_THREAD_STACK ((K_ADDR)2048)
+
+/**
+    Define the native type corresponding to the kernel timer hardware's counter register.
+*/
+#define PORT_TIMER_COUNT_TYPE uint32_t //!< Timer counter type
+
+/**
+    Minimum number of timer ticks for any delay or sleep, required to ensure that a timer cannot
+    be initialized to a negative value.
+*/
+#define PORT_MIN_TIMER_TICKS (0)
+
+/**
+    Define whether this port's kernel timer supports tickless operation (see
+    KERNEL_TIMERS_TICKLESS).
+*/
+#define PORT_TIMERS_TICKLESS (1)
+
+/**
+    Define whether this port provides a high-resolution timer (see
+    KERNEL_HRTIMERS), and the frequency of its free-running counter.  On the
+    host, the counter is derived from CLOCK_MONOTONIC, in microseconds.
+*/
+#define PORT_HRTIMERS (1)
+#define PORT_HRTIMER_FREQ ((uint32_t)1000000) // High-resolution timer counts per second
+
+/**
+    Define whether this port provides exclusive-access load/store primitives
+    (ThreadPort::LoadExclusive()/StoreExclusive()), which allow uncontended
+    Mutex and Semaphore operations to complete without a critical section.
+    The host models the ARMv7-M exclusive monitor, so that the same code paths
+    are exercised by the unit tests.
+*/
+#define PORT_ATOMIC_EXCLUSIVE (1)
+
+/**
+    Define whether this port can run the kernel on multiple cores (see
+    KERNEL_SMP), and how many.  On the host, each core is modeled by its own
+    host thread, and inter-processor interrupts are delivered as signals.
+*/
+#define PORT_SMP (1)
+#define PORT_CORE_COUNT (4)
@@ -0,0 +1,388 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   threadport.h
+
+    @brief  Native Linux host multithreading support.
+
+    Each Mark3 thread is backed by a ucontext_t stored at the top of its own
+    stack, and all threads are multiplexed on a single host thread.  Hardware
+    interrupts are modeled as "vectors" raised from signal handlers (i.e. the
+    POSIX timer used as the kernel tick) or from kernel code (the context
+    switch SWI).
+
+    Critical sections are implemented with a nesting counter rather than by
+    masking signals: a vector raised while the counter is non-zero is latched
+    and serviced when the outermost critical section exits, exactly as a
+    pending interrupt would be on a microcontroller once interrupts are
+    re-enabled.  This keeps CS_ENTER()/CS_EXIT() free of system calls.
+
+    With KERNEL_SMP, each core is a separate host thread, with its own
+    critical-section count and pending vectors.  The outermost critical
+    section on each core also holds the kernel lock, a spinlock shared by
+    all cores, and vectors raised for another core are delivered by
+    signalling its host thread.
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#include <ucontext.h>
+#if KERNEL_SMP
+#include <pthread.h>
+#endif // #if KERNEL_SMP
+
+// clang-format off
+//---------------------------------------------------------------------------
+//! Macro to find the top of a stack given its size and top address
+#define TOP_OF_STACK(x, y)        (K_WORD*) ( ((K_ADDR)x) + (y - sizeof(K_WORD)) )
+//! Push a value y to the stack pointer x and decrement the stack pointer
+#define PUSH_TO_STACK(x, y)        *x = y; x--;
+#define STACK_GROWS_DOWN           (1)
+
+//------------------------------------------------------------------------
+// Use hardware accelerated count-leading zero
+#define HW_CLZ (1)
+#define CLZ(x)      __builtin_clz((x))
+
+//------------------------------------------------------------------------
+//! Number of "interrupt vectors" supported by the host port
+#define PORT_HOST_VECTOR_COUNT      (8)
+//! Vector used by the kernel timer tick (highest priority)
+#define PORT_HOST_VECTOR_TIMER      (0)
+//! Vector used by the high-resolution timer's compare interrupt
+#define PORT_HOST_VECTOR_HRTIMER    (1)
+//! Vector used by the context switch SWI (lowest priority, like PendSV)
+#define PORT_HOST_VECTOR_SWI        (PORT_HOST_VECTOR_COUNT - 1)
+
+//------------------------------------------------------------------------
+//! Number of cores modeled by the host port
+#if KERNEL_SMP
+#define PORT_HOST_CORES             (PORT_CORE_COUNT)
+#else
+#define PORT_HOST_CORES             (1)
+#endif // #if KERNEL_SMP
+
+//------------------------------------------------------------------------
+//! These macros *must* be used in matched-pairs !
+//! Nesting *is* supported !
+
+//------------------------------------------------------------------------
+//! Enter critical section (increment the nesting count, deferring all vectors)
+#define CS_ENTER()                      \
+do {                                    \
+    Mark3::ThreadPort::EnterCritical();
+
+//------------------------------------------------------------------------
+//! Exit critical section (service any vectors latched while in the critical section)
+#define CS_EXIT()                       \
+    Mark3::ThreadPort::ExitCritical();  \
+} while(0);
+// clang-format on
+
+namespace Mark3
+{
+//------------------------------------------------------------------------
+class Thread;
+
+//------------------------------------------------------------------------
+//! Handler function invoked when a host vector is serviced
+using HostVector = void (*)(void);
+
+/**
+ *  Class defining the architecture specific functions required by the
+ *  kernel.
+ *
+ *  On the host, this also provides the minimal interrupt-controller model
+ *  used by the timer and SWI implementations.
+ */
+class ThreadPort
+{
+public:
+    /**
+     * @brief Init
+     *
+     * Function to perform early init of the target environment prior to
+     * using OS primatives.
+     */
+    static void Init();
+
+    /**
+     *  @brief StartThreads
+     *
+     *  Function to start the scheduler, initial threads, etc.
+     */
+    static void StartThreads();
+
+    /**
+     *  @brief EnterCritical
+     *
+     *  Enter a (nestable) critical section.  Use CS_ENTER() instead of calling
+     *  this directly.
+     */
+    static void EnterCritical()
+    {
+        auto u8Core                 = CoreId();
+        m_au32CriticalCount[u8Core] = m_au32CriticalCount[u8Core] + 1;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+#if KERNEL_SMP
+        if (m_au32CriticalCount[u8Core] == 1) {
+            LockKernel();
+        }
+#endif // #if KERNEL_SMP
+    }
+
+    /**
+     *  @brief ExitCritical
+     *
+     *  Exit a critical section, servicing any vectors that were raised while
+     *  the outermost critical section was held.  Use CS_EXIT() instead of
+     *  calling this directly.
+     */
+    static void ExitCritical()
+    {
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        auto u8Core = CoreId();
+        if (m_au32CriticalCount[u8Core] > 1) {
+            m_au32CriticalCount[u8Core] = m_au32CriticalCount[u8Core] - 1;
+            return;
+        }
+        ProcessPending();
+    }
+
+    /**
+     *  @brief CoreId
+     *
+     *  @return Index of the core on which the caller is running
+     */
+#if KERNEL_SMP
+    static uint8_t CoreId() { return s_u8CoreId; }
+#else
+    static constexpr uint8_t CoreId() { return 0; }
+#endif // #if KERNEL_SMP
+
+    /**
+     *  @brief SetVector
+     *
+     *  Install the handler to be run when the specified vector is serviced.
+     *
+     *  @param u8Vector_ Vector index (0 = highest priority)
+     *  @param pfHandler_ Handler function to install
+     */
+    static void SetVector(uint8_t u8Vector_, HostVector pfHandler_) { m_apfVectors[u8Vector_] = pfHandler_; }
+
+    /**
+     *  @brief RaiseInterrupt
+     *
+     *  Mark a vector as pending.  If no critical section is held, all pending
+     *  vectors are serviced immediately; otherwise they are serviced when the
+     *  outermost critical section exits.  Safe to call from signal handlers.
+     *
+     *  @param u8Vector_ Vector index to raise
+     */
+    static void RaiseInterrupt(uint8_t u8Vector_);
+
+#if KERNEL_SMP
+    /**
+     *  @brief RaiseInterrupt
+     *
+     *  Mark a vector as pending on the specified core, and interrupt that
+     *  core to service it.
+     *
+     *  @param u8Vector_ Vector index to raise
+     *  @param u8Core_ Index of the core to interrupt
+     */
+    static void RaiseInterrupt(uint8_t u8Vector_, uint8_t u8Core_);
+
+    /**
+     *  @brief CoreIdle
+     *
+     *  Called repeatedly from each core's idle thread.  Gives up the host CPU
+     *  to the host threads modeling other cores.
+     */
+    static void CoreIdle();
+#endif // #if KERNEL_SMP
+
+    /**
+     *  @brief ClearInterrupt
+     *
+     *  Clear a pending vector without servicing it.
+     *
+     *  @param u8Vector_ Vector index to clear
+     */
+    static void ClearInterrupt(uint8_t u8Vector_);
+
+    /**
+     *  @brief SwitchContext
+     *
+     *  SWI vector handler - switch from the current thread to the next thread
+     *  selected by the scheduler.
+     */
+    static void SwitchContext();
+
+    /**
+     *  @brief LoadExclusive
+     *
+     *  Load a value, and tag it for exclusive access.  This models the
+     *  LDREX/STREX exclusive monitor found on ARMv7-M: the tag is cleared
+     *  whenever a vector is serviced, so a matching StoreExclusive() only
+     *  succeeds if no interrupt or context switch intervened.
+     *
+     *  @param pvAddr_ Address to load from
+     *  @return Value loaded
+     */
+    template <typename T>
+    static T LoadExclusive(volatile T* pvAddr_)
+    {
+        auto u8Core           = CoreId();
+        m_abExclusive[u8Core] = true;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+#if KERNEL_SMP
+        // Without a monitor shared between cores, remember the value loaded,
+        // so that a store can detect that another core changed it.
+        auto val                   = __atomic_load_n(pvAddr_, __ATOMIC_SEQ_CST);
+        m_au64ExclusiveVal[u8Core] = static_cast<uint64_t>(val);
+        return val;
+#else
+        return *pvAddr_;
+#endif // #if KERNEL_SMP
+    }
+
+    /**
+     *  @brief StoreExclusive
+     *
+     *  Store a value to an address tagged by LoadExclusive(), provided that
+     *  exclusive access has not been lost in the meantime.
+     *
+     *  @param pvAddr_ Address to store to
+     *  @param val_ Value to store
+     *  @return true if the value was stored, false if exclusive access was lost
+     */
+    template <typename T>
+    static bool StoreExclusive(volatile T* pvAddr_, T val_)
+    {
+        EnterCritical();
+        auto u8Core  = CoreId();
+        auto bStored = m_abExclusive[u8Core];
+#if KERNEL_SMP
+        bStored = bStored && (static_cast<uint64_t>(*pvAddr_) == m_au64ExclusiveVal[u8Core]);
+#endif // #if KERNEL_SMP
+        if (bStored) {
+            *pvAddr_ = val_;
+        }
+        m_abExclusive[u8Core] = false;
+        ExitCritical();
+        return bStored;
+    }
+
+    /**
+     *  @brief ClearExclusive
+     *
+     *  Abandon an exclusive access started by LoadExclusive().
+     */
+    static void ClearExclusive() { m_abExclusive[CoreId()] = false; }
+
+    friend class Thread;
+
+private:
+    /**
+     *  @brief InitStack
+     *
+     *  Initialize the thread's stack.
+     *
+     *  @param pstThread_ Pointer to the thread to initialize
+     */
+    static void InitStack(Thread* pstThread_);
+
+    /**
+     *  @brief ProcessPending
+     *
+     *  Service pending vectors in priority order, then leave the critical
+     *  section.  Must be called with a critical-section count of 1.
+     */
+    static void ProcessPending();
+
+    /**
+     *  @brief ThreadEntry
+     *
+     *  Common entry point for all threads, which invokes the thread's entry
+     *  function, and terminates the thread if it returns.
+     */
+    static void ThreadEntry();
+
+    /**
+     *  @brief GetContext
+     *
+     *  Return the ucontext stored at the top of a thread's stack
+     */
+    static ucontext_t* GetContext(Thread* pclThread_);
+
+#if KERNEL_SMP
+    /**
+     *  @brief LockKernel
+     *
+     *  Acquire the kernel lock, on entry to the outermost critical section.
+     */
+    static void LockKernel()
+    {
+        while (__atomic_exchange_n(&m_u32KernelLock, 1, __ATOMIC_ACQUIRE) != 0) {
+            while (__atomic_load_n(&m_u32KernelLock, __ATOMIC_RELAXED) != 0) { Relax(); }
+        }
+    }
+
+    /**
+     *  @brief UnlockKernel
+     *
+     *  Release the kernel lock, on exit from the outermost critical section.
+     */
+    static void UnlockKernel() { __atomic_store_n(&m_u32KernelLock, 0, __ATOMIC_RELEASE); }
+
+    /**
+     *  @brief Relax
+     *
+     *  Give up the host CPU while spinning, as the thread being waited for may
+     *  be sharing it.
+     */
+    static void Relax();
+
+    /**
+     *  @brief CoreEntry
+     *
+     *  Host thread entry point for each secondary core, which starts running
+     *  the threads assigned to that core.
+     */
+    static void* CoreEntry(void* pvCore_);
+
+    /**
+     *  @brief IpiSignal
+     *
+     *  Signal handler for inter-processor interrupts, which services the
+     *  vectors raised for the core on which it runs.
+     */
+    static void IpiSignal(int iSignal_);
+
+    static thread_local uint8_t s_u8CoreId;
+    static volatile uint32_t    m_u32KernelLock;
+    static pthread_t            m_astCoreThreads[PORT_HOST_CORES];
+    static uint64_t             m_au64ExclusiveVal[PORT_HOST_CORES];
+#endif // #if KERNEL_SMP
+
+    static volatile uint32_t m_au32CriticalCount[PORT_HOST_CORES];
+    static volatile uint32_t m_au32PendingVectors[PORT_HOST_CORES];
+    static volatile bool     m_abExclusive[PORT_HOST_CORES];
+    static HostVector        m_apfVectors[PORT_HOST_VECTOR_COUNT];
+};
+} // namespace Mark3
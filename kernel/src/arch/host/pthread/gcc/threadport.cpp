@@ -0,0 +1,304 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   threadport.cpp
+
+    @brief  Native Linux host multithreading
+
+*/
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+#include "thread.h"
+#include "threadport.h"
+#include "kernelprofile.h"
+#include "kernelswi.h"
+#include "kerneltimer.h"
+#include "timerlist.h"
+#include "quantum.h"
+#include "kernel.h"
+
+#include <signal.h>
+#include <ucontext.h>
+#if KERNEL_SMP
+#include <sched.h>
+#endif // #if KERNEL_SMP
+
+namespace Mark3
+{
+volatile uint32_t ThreadPort::m_au32CriticalCount[PORT_HOST_CORES];
+volatile uint32_t ThreadPort::m_au32PendingVectors[PORT_HOST_CORES];
+volatile bool     ThreadPort::m_abExclusive[PORT_HOST_CORES];
+HostVector        ThreadPort::m_apfVectors[PORT_HOST_VECTOR_COUNT];
+#if KERNEL_SMP
+thread_local uint8_t ThreadPort::s_u8CoreId;
+volatile uint32_t    ThreadPort::m_u32KernelLock;
+pthread_t            ThreadPort::m_astCoreThreads[PORT_HOST_CORES];
+uint64_t             ThreadPort::m_au64ExclusiveVal[PORT_HOST_CORES];
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Signal used to deliver inter-processor interrupts to a core's host thread
+constexpr auto ciIpiSignal = SIGUSR1;
+} // anonymous namespace
+#endif // #if KERNEL_SMP
+
+//---------------------------------------------------------------------------
+void ThreadPort::Init()
+{
+    for (uint8_t i = 0; i < PORT_HOST_CORES; i++) {
+        m_au32CriticalCount[i]  = 0;
+        m_au32PendingVectors[i] = 0;
+        m_abExclusive[i]        = false;
+    }
+    for (auto& pfVector : m_apfVectors) { pfVector = nullptr; }
+
+#if KERNEL_SMP
+    // main() runs on the boot core
+    s_u8CoreId        = 0;
+    m_u32KernelLock   = 0;
+    m_astCoreThreads[0] = pthread_self();
+
+    struct sigaction stAction = {};
+    stAction.sa_handler       = IpiSignal;
+    stAction.sa_flags         = SA_RESTART;
+    sigemptyset(&stAction.sa_mask);
+    sigaction(ciIpiSignal, &stAction, nullptr);
+#endif // #if KERNEL_SMP
+}
+
+//---------------------------------------------------------------------------
+ucontext_t* ThreadPort::GetContext(Thread* pclThread_)
+{
+    return reinterpret_cast<ucontext_t*>(pclThread_->m_pwStackTop);
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::InitStack(Thread* pclThread_)
+{
+    // Initialize the stack to all FF's to aid in stack depth checking
+#if KERNEL_STACK_CHECK
+    auto* pwTemp = pclThread_->m_pwStack;
+    for (uint16_t i = 0; i < pclThread_->m_u16StackSize / sizeof(K_WORD); i++) { pwTemp[i] = (K_WORD)(-1); }
+#endif // #if KERNEL_STACK_CHECK
+
+    // Reserve space for the thread's ucontext at the top of its stack, leaving
+    // the remainder of the stack to be used by the thread itself.
+    auto uStackBase = reinterpret_cast<K_ADDR>(pclThread_->m_pwStack);
+    auto uContext   = (uStackBase + pclThread_->m_u16StackSize - sizeof(ucontext_t)) & ~static_cast<K_ADDR>(15);
+    auto* pstContext = reinterpret_cast<ucontext_t*>(uContext);
+
+    getcontext(pstContext);
+    pstContext->uc_link          = nullptr;
+    pstContext->uc_stack.ss_sp   = pclThread_->m_pwStack;
+    pstContext->uc_stack.ss_size = uContext - uStackBase;
+    pstContext->uc_stack.ss_flags = 0;
+    sigemptyset(&pstContext->uc_sigmask);
+    makecontext(pstContext, ThreadPort::ThreadEntry, 0);
+
+    pclThread_->m_pwStackTop = reinterpret_cast<K_WORD*>(uContext);
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::ThreadEntry()
+{
+    // Threads are always switched-in from within a critical section, so the
+    // first thing a new thread must do is complete that critical section.
+    ProcessPending();
+
+    auto* pclThread = g_pclCurrent;
+    pclThread->m_pfEntryPoint(pclThread->m_pvArg);
+    pclThread->Exit();
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::RaiseInterrupt(uint8_t u8Vector_)
+{
+    auto u8Core = CoreId();
+    __atomic_fetch_or(&m_au32PendingVectors[u8Core], (1U << u8Vector_), __ATOMIC_SEQ_CST);
+    if (m_au32CriticalCount[u8Core] == 0) {
+        m_au32CriticalCount[u8Core] = 1;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+#if KERNEL_SMP
+        LockKernel();
+#endif // #if KERNEL_SMP
+        ProcessPending();
+    }
+}
+
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+void ThreadPort::RaiseInterrupt(uint8_t u8Vector_, uint8_t u8Core_)
+{
+    if (u8Core_ == CoreId()) {
+        RaiseInterrupt(u8Vector_);
+        return;
+    }
+    __atomic_fetch_or(&m_au32PendingVectors[u8Core_], (1U << u8Vector_), __ATOMIC_SEQ_CST);
+    pthread_kill(m_astCoreThreads[u8Core_], ciIpiSignal);
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::IpiSignal(int /*iSignal_*/)
+{
+    // Vectors raised while the core is in a critical section are serviced
+    // when it exits, as with any other interrupt.
+    auto u8Core = CoreId();
+    if ((m_au32CriticalCount[u8Core] == 0) && (__atomic_load_n(&m_au32PendingVectors[u8Core], __ATOMIC_SEQ_CST) != 0)) {
+        m_au32CriticalCount[u8Core] = 1;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        LockKernel();
+        ProcessPending();
+    }
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::Relax()
+{
+    sched_yield();
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::CoreIdle()
+{
+    sched_yield();
+}
+#endif // #if KERNEL_SMP
+
+//---------------------------------------------------------------------------
+void ThreadPort::ClearInterrupt(uint8_t u8Vector_)
+{
+    __atomic_fetch_and(&m_au32PendingVectors[CoreId()], ~(1U << u8Vector_), __ATOMIC_SEQ_CST);
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::ProcessPending()
+{
+    auto u8Core = CoreId();
+    while (true) {
+        auto u32Pending = __atomic_load_n(&m_au32PendingVectors[u8Core], __ATOMIC_SEQ_CST);
+        if (u32Pending != 0) {
+            // Service the highest-priority (lowest-numbered) vector first
+            auto u8Vector = static_cast<uint8_t>(__builtin_ctz(u32Pending));
+            ClearInterrupt(u8Vector);
+
+            // Taking an exception clears the exclusive monitor
+            m_abExclusive[u8Core] = false;
+            if (m_apfVectors[u8Vector] != nullptr) {
+                m_apfVectors[u8Vector]();
+            }
+            continue;
+        }
+
+        // Leave the critical section, then re-check for any vector that was
+        // latched between the check above and the count being cleared.
+#if KERNEL_SMP
+        UnlockKernel();
+#endif // #if KERNEL_SMP
+        m_au32CriticalCount[u8Core] = 0;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&m_au32PendingVectors[u8Core], __ATOMIC_SEQ_CST) == 0) {
+            return;
+        }
+        m_au32CriticalCount[u8Core] = 1;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+#if KERNEL_SMP
+        LockKernel();
+#endif // #if KERNEL_SMP
+    }
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::SwitchContext()
+{
+    if (!Kernel::IsStarted()) {
+        return;
+    }
+#if KERNEL_SMP
+    Scheduler::Reschedule();
+#endif // #if KERNEL_SMP
+
+    auto* pclPrev = g_pclCurrent;
+    g_pclCurrent  = (Thread*)g_pclNext;
+    if (pclPrev == g_pclCurrent) {
+        return;
+    }
+
+    // Execution resumes here (still within the critical section) when the
+    // previous thread is next switched-in.
+    swapcontext(GetContext(pclPrev), GetContext(g_pclCurrent));
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::StartThreads()
+{
+    // Hold off all vectors until the first thread has been switched-in.
+    EnterCritical();
+
+    KernelSWI::Config();   // configure the task switch SWI
+    KernelTimer::Config(); // configure the kernel timer
+
+    Profiler::Init();
+
+    // Tell the kernel that we're ready to start scheduling threads
+    // for the first time.
+    Kernel::CompleteStart();
+
+    Scheduler::SetScheduler(1); // enable the scheduler
+    Scheduler::Schedule();      // run the scheduler - determine the first thread to run
+
+    g_pclCurrent = (Thread*)g_pclNext; // Set the next scheduled thread to the current thread
+    KernelSWI::Clear();
+
+    KernelTimer::Start(); // enable the kernel timer
+    KernelSWI::Start();   // enable the task switch SWI
+
+#if KERNEL_ROUND_ROBIN
+    // Restart the thread quantum timer, as any value held prior to starting
+    // the kernel will be invalid.  This fixes a bug where multiple threads
+    // started with the highest priority before starting the kernel causes problems
+    // until the running thread voluntarily blocks.
+    Quantum::Update(g_pclCurrent);
+#endif // #if KERNEL_ROUND_ROBIN
+
+#if KERNEL_SMP
+    // Start the other cores, which wait for the kernel lock to be released
+    // by this one when its first thread is switched-in.
+    for (uint8_t i = 1; i < PORT_HOST_CORES; i++) {
+        pthread_create(&m_astCoreThreads[i], nullptr, CoreEntry, reinterpret_cast<void*>(static_cast<K_ADDR>(i)));
+    }
+#endif // #if KERNEL_SMP
+
+    // Jump to the first thread (does not return)
+    setcontext(GetContext(g_pclCurrent));
+}
+
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+void* ThreadPort::CoreEntry(void* pvCore_)
+{
+    s_u8CoreId = static_cast<uint8_t>(reinterpret_cast<K_ADDR>(pvCore_));
+
+    EnterCritical();
+    Scheduler::Schedule();
+    g_pclCurrent = (Thread*)g_pclNext;
+
+    // Jump to the core's first thread (does not return)
+    setcontext(GetContext(g_pclCurrent));
+    return nullptr;
+}
+#endif // #if KERNEL_SMP
+} // namespace Mark3
@@ -150,4 +150,51 @@ bool Atomic::TestAndSet(bool* pbLock_)
     CS_EXIT();
     return u8Ret;
 }
+
+namespace
+{
+    //---------------------------------------------------------------------------
+    template <typename T>
+    bool CompareAndSwap_i(volatile T* pSource_, T expected_, T val_)
+    {
+        KERNEL_ASSERT(pSource_ != nullptr);
+
+#if PORT_ATOMIC_EXCLUSIVE
+        do {
+            if (ThreadPort::LoadExclusive(pSource_) != expected_) {
+                ThreadPort::ClearExclusive();
+                return false;
+            }
+        } while (!ThreadPort::StoreExclusive(pSource_, val_));
+        return true;
+#else
+        auto bRet = false;
+        CS_ENTER();
+        if (*pSource_ == expected_) {
+            *pSource_ = val_;
+            bRet      = true;
+        }
+        CS_EXIT();
+        return bRet;
+#endif
+    }
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+bool Atomic::CompareAndSwap(volatile uint8_t* pu8Source_, uint8_t u8Expected_, uint8_t u8Val_)
+{
+    return CompareAndSwap_i(pu8Source_, u8Expected_, u8Val_);
+}
+
+//---------------------------------------------------------------------------
+bool Atomic::CompareAndSwap(volatile uint16_t* pu16Source_, uint16_t u16Expected_, uint16_t u16Val_)
+{
+    return CompareAndSwap_i(pu16Source_, u16Expected_, u16Val_);
+}
+
+//---------------------------------------------------------------------------
+bool Atomic::CompareAndSwap(volatile uint32_t* pu32Source_, uint32_t u32Expected_, uint32_t u32Val_)
+{
+    return CompareAndSwap_i(pu32Source_, u32Expected_, u32Val_);
+}
 } // namespace Mark3
@@ -68,4 +68,31 @@ void BlockingObject::UnBlock(Thread* pclThread_)
     pclThread_->SetCurrent(pclThread_->GetOwner());
     pclThread_->SetState(ThreadState::Ready);
 }
+
+//---------------------------------------------------------------------------
+void BlockingObject::ArmTimeout(uint32_t u32WaitTimeMS_, TimerCallback pfCallback_)
+{
+    auto* pclThread = Scheduler::GetCurrentThread();
+    pclThread->SetExpired(false);
+    pclThread->GetTimer()->Start(false, u32WaitTimeMS_, pfCallback_, this);
+}
+
+//---------------------------------------------------------------------------
+bool BlockingObject::DisarmTimeout()
+{
+    auto* pclThread = Scheduler::GetCurrentThread();
+    pclThread->GetTimer()->Stop();
+    return !pclThread->GetExpired();
+}
+
+#if KERNEL_WAIT_SETS
+//---------------------------------------------------------------------------
+void BlockingObject::SignalWaitSet()
+{
+    auto* pclWaitSet = m_pclWaitSet;
+    if (pclWaitSet != nullptr) {
+        pclWaitSet->Signal(m_u8WaitSetIndex);
+    }
+}
+#endif // #if KERNEL_WAIT_SETS
 } // namespace Mark3
@@ -28,6 +28,7 @@ void ConditionVariable::Init()
 {
     m_clMutex.Init();
     m_clSemaphore.Init(0, 255);
+    m_u8Waiters = 0;
 }
 
 //---------------------------------------------------------------------------
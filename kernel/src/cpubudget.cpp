@@ -0,0 +1,169 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   cpubudget.cpp
+
+    @brief  CPU budget reservations - bounded bandwidth for aperiodic threads
+
+*/
+#include "mark3.h"
+
+#if KERNEL_CPU_BUDGETS
+namespace Mark3
+{
+namespace
+{
+    //---------------------------------------------------------------------------
+    /**
+     * @brief CpuBudget_Callback
+     *
+     * This function is called from the timer-expired context at the end of each
+     * budget window, replenishing the budget.
+     *
+     * @param pclOwner_ Unused
+     * @param pvData_   Pointer to the budget object being replenished
+     */
+    void CpuBudget_Callback(Thread* /*pclOwner_*/, void* pvData_)
+    {
+        KERNEL_ASSERT(pvData_ != nullptr);
+
+        auto* pclBudget = static_cast<CpuBudget*>(pvData_);
+        pclBudget->Replenish();
+    }
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+CpuBudget::~CpuBudget()
+{
+    Stop();
+}
+
+//---------------------------------------------------------------------------
+void CpuBudget::Init(void)
+{
+    m_clTimer.Init();
+    m_pclThread            = nullptr;
+    m_u32Budget            = 0;
+    m_u32Period            = 0;
+    m_u32Used              = 0;
+    m_u32Overruns          = 0;
+    m_uXPriority           = 0;
+    m_uXBackgroundPriority = 0;
+    m_bDepleted            = false;
+}
+
+//---------------------------------------------------------------------------
+void CpuBudget::Start(Thread* pclThread_, uint32_t u32BudgetMs_, uint32_t u32PeriodMs_, PORT_PRIO_TYPE uXBackgroundPriority_)
+{
+    KERNEL_ASSERT(pclThread_ != nullptr);
+    KERNEL_ASSERT(u32BudgetMs_ != 0);
+    KERNEL_ASSERT(u32BudgetMs_ <= u32PeriodMs_);
+    KERNEL_ASSERT(uXBackgroundPriority_ < pclThread_->GetPriority());
+
+    Stop();
+
+    CS_ENTER();
+    KERNEL_ASSERT(pclThread_->m_pclBudget == nullptr);
+    m_pclThread            = pclThread_;
+    m_u32Budget            = u32BudgetMs_;
+    m_u32Period            = u32PeriodMs_;
+    m_u32Used              = 0;
+    m_u32Overruns          = 0;
+    m_uXPriority           = pclThread_->GetPriority();
+    m_uXBackgroundPriority = uXBackgroundPriority_;
+    m_bDepleted            = false;
+
+    pclThread_->m_pclBudget = this;
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void CpuBudget::Stop(void)
+{
+    m_clTimer.Stop();
+
+    auto* pclThread = static_cast<Thread*>(nullptr);
+    CS_ENTER();
+    if (m_pclThread != nullptr) {
+        m_pclThread->m_pclBudget = nullptr;
+        if (m_bDepleted) {
+            pclThread = m_pclThread;
+        }
+        m_pclThread = nullptr;
+        m_bDepleted = false;
+    }
+    CS_EXIT();
+
+    if (pclThread != nullptr) {
+        pclThread->SetPriority(m_uXPriority);
+    }
+}
+
+//---------------------------------------------------------------------------
+void CpuBudget::Replenish(void)
+{
+    auto* pclThread = static_cast<Thread*>(nullptr);
+    CS_ENTER();
+    m_u32Used = 0;
+    if (m_bDepleted) {
+        pclThread   = m_pclThread;
+        m_bDepleted = false;
+    }
+    CS_EXIT();
+
+    // The next window opens when the thread next runs at its own priority
+    if (pclThread != nullptr) {
+        pclThread->SetPriority(m_uXPriority);
+    }
+}
+
+//---------------------------------------------------------------------------
+void CpuBudget::Tick(uint32_t u32Ticks_)
+{
+    if (!Kernel::IsStarted()) {
+        return;
+    }
+
+    auto* pclBudget = Scheduler::GetCurrentThread()->m_pclBudget;
+    if (pclBudget != nullptr) {
+        pclBudget->Charge(u32Ticks_);
+    }
+}
+
+//---------------------------------------------------------------------------
+void CpuBudget::Charge(uint32_t u32Ticks_)
+{
+    // Time used at the background priority is not charged
+    if (m_bDepleted) {
+        return;
+    }
+
+    if (m_u32Used == 0) {
+        m_clTimer.Start(false, m_u32Period, CpuBudget_Callback, this);
+    }
+    m_u32Used += u32Ticks_;
+    if (m_u32Used < m_u32Budget) {
+        return;
+    }
+
+    // Budget exhausted - run in the background until the window closes
+    m_u32Used   = m_u32Budget;
+    m_bDepleted = true;
+    m_u32Overruns++;
+    m_uXPriority = m_pclThread->GetPriority();
+    m_pclThread->SetPriority(m_uXBackgroundPriority);
+}
+} // namespace Mark3
+#endif // #if KERNEL_CPU_BUDGETS
@@ -0,0 +1,145 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   cpuusage.cpp
+
+    @brief  Per-thread CPU time accounting
+
+*/
+
+#include "mark3.h"
+#include "cpuusage.h"
+
+#if KERNEL_CPU_ACCOUNTING
+namespace Mark3
+{
+namespace
+{
+//---------------------------------------------------------------------------
+// Read the free-running counter used for accounting
+uint32_t CpuUsage_ReadCounter(uint32_t u32LastCount_)
+{
+#if PORT_CYCLE_COUNTER
+    (void)u32LastCount_;
+    return ThreadPort::ReadCycleCounter();
+#else
+    auto u32Count = (Profiler::GetEpoch() * TICKS_PER_OVERFLOW) + Profiler::Read();
+
+    // The timer has wrapped, but the overflow has yet to be processed
+    if (static_cast<int32_t>(u32Count - u32LastCount_) < 0) {
+        u32Count += TICKS_PER_OVERFLOW;
+    }
+    return u32Count;
+#endif // #if PORT_CYCLE_COUNTER
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+uint64_t CpuUsage::m_u64WindowCycles;
+uint64_t CpuUsage::m_u64IdleCycles;
+uint32_t CpuUsage::m_u32LastCount;
+uint32_t CpuUsage::m_u32Window;
+
+//---------------------------------------------------------------------------
+void CpuUsage::Start()
+{
+#if PORT_CYCLE_COUNTER
+    ThreadPort::StartCycleCounter();
+#else
+    Profiler::Start();
+#endif // #if PORT_CYCLE_COUNTER
+
+    CS_ENTER();
+    m_u32LastCount = CpuUsage_ReadCounter(0);
+    CS_EXIT();
+    Reset();
+}
+
+//---------------------------------------------------------------------------
+void CpuUsage::Update()
+{
+    CS_ENTER();
+    auto u32Now     = CpuUsage_ReadCounter(m_u32LastCount);
+    auto u32Elapsed = u32Now - m_u32LastCount;
+    m_u32LastCount  = u32Now;
+    m_u64WindowCycles += u32Elapsed;
+
+    auto* pclThread = g_pclCurrent;
+    if (pclThread != nullptr) {
+        if (pclThread->m_u32CpuWindow != m_u32Window) {
+            pclThread->m_u32CpuWindow = m_u32Window;
+            pclThread->m_u64RunCycles = 0;
+        }
+        pclThread->m_u64RunCycles += u32Elapsed;
+        if (pclThread->GetCurPriority() == 0) {
+            m_u64IdleCycles += u32Elapsed;
+        }
+    }
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+uint64_t CpuUsage::Sample()
+{
+    uint64_t u64Window;
+    CS_ENTER();
+    Update();
+    u64Window = m_u64WindowCycles;
+    CS_EXIT();
+    return u64Window;
+}
+
+//---------------------------------------------------------------------------
+void CpuUsage::Reset()
+{
+    CS_ENTER();
+    Update();
+    m_u32Window++;
+    m_u64WindowCycles = 0;
+    m_u64IdleCycles   = 0;
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+uint16_t CpuUsage::GetLoad(uint64_t u64Cycles_, uint64_t u64Window_)
+{
+    if (u64Window_ == 0) {
+        return 0;
+    }
+    if (u64Cycles_ >= u64Window_) {
+        return 10000;
+    }
+    // Scale both terms down until the product fits
+    while (u64Cycles_ > (UINT64_MAX / 10000)) {
+        u64Cycles_ >>= 1;
+        u64Window_ >>= 1;
+    }
+    return static_cast<uint16_t>((u64Cycles_ * 10000) / u64Window_);
+}
+
+//---------------------------------------------------------------------------
+uint16_t CpuUsage::GetCpuLoad()
+{
+    uint64_t u64Window;
+    uint64_t u64Idle;
+    CS_ENTER();
+    Update();
+    u64Window = m_u64WindowCycles;
+    u64Idle   = m_u64IdleCycles;
+    CS_EXIT();
+    return static_cast<uint16_t>(10000 - GetLoad(u64Idle, u64Window));
+}
+} // namespace Mark3
+#endif // #if KERNEL_CPU_ACCOUNTING
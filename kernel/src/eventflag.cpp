@@ -41,7 +41,7 @@ namespace
         KERNEL_ASSERT(pclOwner_ != nullptr);
         KERNEL_ASSERT(pvData_ != nullptr);
 
-        auto* pclEventFlag = static_cast<EventFlag*>(pvData_);
+        auto* pclEventFlag = static_cast<EventFlag*>(static_cast<BlockingObject*>(pvData_));
 
         pclOwner_->SetExpired(true);
         pclOwner_->SetEventFlagMask(0);
@@ -88,8 +88,9 @@ uint16_t EventFlag::Wait_i(uint16_t u16Mask_, EventFlagOperation eMode_, uint32_
     auto bThreadYield = false;
     auto bMatch       = false;
 
-    Timer clEventTimer;
-    auto  bUseTimer = false;
+    auto bUseTimer = false;
+
+    uint16_t u16Match;
 
     // Ensure we're operating in a critical section while we determine
     // whether or not we need to block the current thread on this object.
@@ -97,31 +98,11 @@ uint16_t EventFlag::Wait_i(uint16_t u16Mask_, EventFlagOperation eMode_, uint32_
 
     // Check to see whether or not the current mask matches any of the
     // desired bits.
-    g_pclCurrent->SetEventFlagMask(u16Mask_);
-
-    if ((eMode_ == EventFlagOperation::All_Set) || (eMode_ == EventFlagOperation::All_Clear)) {
-        // Check to see if the flags in their current state match all of
-        // the set flags in the event flag group, with this mask.
-        if ((m_u16SetMask & u16Mask_) == u16Mask_) {
-            bMatch = true;
-            g_pclCurrent->SetEventFlagMask(u16Mask_);
-
-            if (EventFlagOperation::All_Clear == eMode_) {
-                m_u16SetMask &= ~u16Mask_;
-                g_pclCurrent->SetExpired(false);
-            }
-        }
-    } else if ((eMode_ == EventFlagOperation::Any_Set) || (eMode_ == EventFlagOperation::Any_Clear)) {
-        // Check to see if the existing flags match any of the set flags in
-        // the event flag group  with this mask
-        if ((m_u16SetMask & u16Mask_) != 0) {
-            bMatch = true;
-            g_pclCurrent->SetEventFlagMask(m_u16SetMask & u16Mask_);
-
-            if (EventFlagOperation::Any_Clear == eMode_) {
-                m_u16SetMask &= ~u16Mask_;
-                g_pclCurrent->SetExpired(false);
-            }
+    bMatch = Match_i(u16Mask_, eMode_, &u16Match);
+    if (bMatch) {
+        g_pclCurrent->SetEventFlagMask(u16Match);
+        if ((EventFlagOperation::All_Clear == eMode_) || (EventFlagOperation::Any_Clear == eMode_)) {
+            g_pclCurrent->SetExpired(false);
         }
     }
 
@@ -132,9 +113,7 @@ uint16_t EventFlag::Wait_i(uint16_t u16Mask_, EventFlagOperation eMode_, uint32_
         g_pclCurrent->SetEventFlagMode(eMode_);
 
         if (u32TimeMS_ != 0u) {
-            g_pclCurrent->SetExpired(false);
-            clEventTimer.Init();
-            clEventTimer.Start(false, u32TimeMS_, TimedEventFlag_Callback, this);
+            ArmTimeout(u32TimeMS_, TimedEventFlag_Callback);
             bUseTimer = true;
         }
 
@@ -161,12 +140,54 @@ uint16_t EventFlag::Wait_i(uint16_t u16Mask_, EventFlagOperation eMode_, uint32_
     //!! thread will not return back until a matching SetFlags call is made
     //!! or a timeout occurs.
     if (bUseTimer && bThreadYield) {
-        clEventTimer.Stop();
+        DisarmTimeout();
     }
 
     return g_pclCurrent->GetEventFlagMask();
 }
 
+//---------------------------------------------------------------------------
+bool EventFlag::Match_i(uint16_t u16Mask_, EventFlagOperation eMode_, uint16_t* pu16Match_)
+{
+    auto bMatch = false;
+
+    if ((eMode_ == EventFlagOperation::All_Set) || (eMode_ == EventFlagOperation::All_Clear)) {
+        // Check to see if the flags in their current state match all of
+        // the set flags in the event flag group, with this mask.
+        if ((m_u16SetMask & u16Mask_) == u16Mask_) {
+            bMatch      = true;
+            *pu16Match_ = u16Mask_;
+        }
+    } else if ((eMode_ == EventFlagOperation::Any_Set) || (eMode_ == EventFlagOperation::Any_Clear)) {
+        // Check to see if the existing flags match any of the set flags in
+        // the event flag group  with this mask
+        if ((m_u16SetMask & u16Mask_) != 0) {
+            bMatch      = true;
+            *pu16Match_ = m_u16SetMask & u16Mask_;
+        }
+    }
+
+    if (bMatch && ((EventFlagOperation::All_Clear == eMode_) || (EventFlagOperation::Any_Clear == eMode_))) {
+        m_u16SetMask &= ~u16Mask_;
+    }
+    return bMatch;
+}
+
+//---------------------------------------------------------------------------
+uint16_t EventFlag::TryWait(uint16_t u16Mask_, EventFlagOperation eMode_)
+{
+    KERNEL_ASSERT(eMode_ < EventFlagOperation::Pending_Unblock);
+    KERNEL_ASSERT(IsInitialized());
+
+    uint16_t u16Match = 0;
+
+    CS_ENTER();
+    Match_i(u16Mask_, eMode_, &u16Match);
+    CS_EXIT();
+
+    return u16Match;
+}
+
 //---------------------------------------------------------------------------
 uint16_t EventFlag::Wait(uint16_t u16Mask_, EventFlagOperation eMode_)
 {
@@ -287,6 +308,10 @@ void EventFlag::Set(uint16_t u16Mask_)
     // Restore interrupts - will potentially cause a context switch if a
     // thread is unblocked.
     CS_EXIT();
+
+#if KERNEL_WAIT_SETS
+    SignalWaitSet();
+#endif // #if KERNEL_WAIT_SETS
 }
 
 //---------------------------------------------------------------------------
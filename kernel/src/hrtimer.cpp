@@ -0,0 +1,234 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   hrtimer.cpp
+
+    @brief  High-resolution timer implementation
+*/
+
+#include "mark3.h"
+
+#if KERNEL_HRTIMERS
+#include "kernelhrtimer.h"
+
+namespace Mark3
+{
+namespace
+{
+//---------------------------------------------------------------------------
+// Interval of the timer keeping the 64-bit count extension current, which
+// must expire at least once per wrap of the hardware counter.
+constexpr auto cu32WrapInterval = uint32_t{ 0x40000000 };
+
+//---------------------------------------------------------------------------
+void WrapCallback(HRTimer* /*pclTimer_*/, void* /*pvData_*/)
+{
+    HRTimer::GetCount64();
+}
+} // anonymous namespace
+
+DoubleLinkList HRTimerScheduler::m_clList;
+HRTimer        HRTimerScheduler::m_clWrapTimer;
+uint32_t       HRTimerScheduler::m_u32CountHigh;
+uint32_t       HRTimerScheduler::m_u32LastCount;
+
+//---------------------------------------------------------------------------
+HRTimer::HRTimer()
+{
+    m_bActive     = false;
+    m_bInCallback = false;
+}
+
+//---------------------------------------------------------------------------
+void HRTimer::Init()
+{
+    KERNEL_ASSERT(!m_bActive);
+
+    ClearNode();
+    m_u32Deadline = 0;
+    m_u32Interval = 0;
+    m_pfCallback  = nullptr;
+    m_pvData      = nullptr;
+    m_bRepeat     = false;
+    m_bActive     = false;
+    m_bInCallback = false;
+}
+
+//---------------------------------------------------------------------------
+void HRTimer::Start(bool bRepeat_, uint32_t u32Interval_, HRTimerCallback pfCallback_, void* pvData_)
+{
+    KERNEL_ASSERT(u32Interval_ <= MAX_TIMER_TICKS);
+
+    if (m_bActive) {
+        return;
+    }
+
+    m_bRepeat     = bRepeat_;
+    m_u32Interval = u32Interval_;
+    m_pfCallback  = pfCallback_;
+    m_pvData      = pvData_;
+
+    HRTimerScheduler::Add(this);
+}
+
+//---------------------------------------------------------------------------
+void HRTimer::Stop()
+{
+    if (!m_bActive) {
+        return;
+    }
+    HRTimerScheduler::Remove(this);
+}
+
+//---------------------------------------------------------------------------
+uint32_t HRTimer::GetCount()
+{
+    uint32_t u32Count;
+    CS_ENTER();
+    u32Count = KernelHRTimer::Read();
+    CS_EXIT();
+    return u32Count;
+}
+
+//---------------------------------------------------------------------------
+uint64_t HRTimer::GetCount64()
+{
+    uint64_t u64Count;
+    CS_ENTER();
+    u64Count = HRTimerScheduler::Extend(KernelHRTimer::Read());
+    CS_EXIT();
+    return u64Count;
+}
+
+//---------------------------------------------------------------------------
+void HRTimerScheduler::Init()
+{
+    m_clList.Init();
+    KernelHRTimer::Config();
+
+    m_u32CountHigh = 0;
+    m_u32LastCount = KernelHRTimer::Read();
+    m_clWrapTimer.Init();
+    m_clWrapTimer.Start(true, cu32WrapInterval, WrapCallback, nullptr);
+}
+
+//---------------------------------------------------------------------------
+void HRTimerScheduler::Add(HRTimer* pclTimer_)
+{
+    KERNEL_ASSERT(pclTimer_ != nullptr);
+
+    CS_ENTER();
+    pclTimer_->m_u32Deadline = KernelHRTimer::Read() + pclTimer_->m_u32Interval;
+    pclTimer_->m_bActive     = true;
+
+    // A timer restarted from its own callback is re-queued by Process()
+    if (!pclTimer_->m_bInCallback) {
+        Insert(pclTimer_);
+        if (m_clList.GetHead() == pclTimer_) {
+            SetAlarm();
+        }
+    }
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void HRTimerScheduler::Remove(HRTimer* pclTimer_)
+{
+    KERNEL_ASSERT(pclTimer_ != nullptr);
+
+    CS_ENTER();
+    if (!pclTimer_->m_bInCallback) {
+        auto bWasHead = (m_clList.GetHead() == pclTimer_);
+        m_clList.Remove(pclTimer_);
+        if (bWasHead) {
+            SetAlarm();
+        }
+    }
+    pclTimer_->m_bActive = false;
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void HRTimerScheduler::Process()
+{
+    CS_ENTER();
+    auto* pclCurr = static_cast<HRTimer*>(m_clList.GetHead());
+    while ((pclCurr != nullptr) && DeadlineReached(pclCurr->m_u32Deadline, KernelHRTimer::Read())) {
+        m_clList.Remove(pclCurr);
+
+        pclCurr->m_bInCallback = true;
+        if (!pclCurr->m_bRepeat) {
+            pclCurr->m_bActive = false;
+        }
+        if (pclCurr->m_pfCallback != nullptr) {
+            pclCurr->m_pfCallback(pclCurr, pclCurr->m_pvData);
+        }
+        pclCurr->m_bInCallback = false;
+
+        // Requeue timers that are still active - repeating timers are kept in
+        // phase with their original deadline, unless the callback restarted
+        // the timer (and with it, the deadline).
+        if (pclCurr->m_bActive) {
+            if (pclCurr->m_bRepeat && DeadlineReached(pclCurr->m_u32Deadline, KernelHRTimer::Read())) {
+                pclCurr->m_u32Deadline += pclCurr->m_u32Interval;
+            }
+            Insert(pclCurr);
+        }
+        pclCurr = static_cast<HRTimer*>(m_clList.GetHead());
+    }
+    SetAlarm();
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void HRTimerScheduler::Insert(HRTimer* pclTimer_)
+{
+    pclTimer_->ClearNode();
+
+    // Timers with the same deadline expire in the order they were added.
+    auto* pclCurr = static_cast<HRTimer*>(m_clList.GetHead());
+    while ((pclCurr != nullptr) && !TimeAfter(pclCurr->m_u32Deadline, pclTimer_->m_u32Deadline)) {
+        pclCurr = static_cast<HRTimer*>(pclCurr->GetNext());
+    }
+
+    if (pclCurr == nullptr) {
+        m_clList.Add(pclTimer_);
+    } else {
+        m_clList.InsertNodeBefore(pclTimer_, pclCurr);
+    }
+}
+
+//---------------------------------------------------------------------------
+void HRTimerScheduler::SetAlarm()
+{
+    auto* pclHead = static_cast<HRTimer*>(m_clList.GetHead());
+    if (pclHead == nullptr) {
+        KernelHRTimer::ClearAlarm();
+    } else {
+        KernelHRTimer::SetAlarm(pclHead->m_u32Deadline);
+    }
+}
+
+//---------------------------------------------------------------------------
+uint64_t HRTimerScheduler::Extend(uint32_t u32Count_)
+{
+    if (u32Count_ < m_u32LastCount) {
+        m_u32CountHigh++;
+    }
+    m_u32LastCount = u32Count_;
+    return (static_cast<uint64_t>(m_u32CountHigh) << 32) | u32Count_;
+}
+} // namespace Mark3
+#endif // #if KERNEL_HRTIMERS
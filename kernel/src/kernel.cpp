@@ -38,7 +38,8 @@ DebugPrintFunction Kernel::m_pfDebugPrintFunction;     //!< Function to call whe
 #if KERNEL_STACK_CHECK
 uint16_t Kernel::m_u16GuardThreshold;
 #endif // #if KERNEL_STACK_CHECK
-uint32_t Kernel::m_u32Ticks;
+volatile uint64_t Kernel::m_u64Ticks;
+volatile uint32_t Kernel::m_u32TickSeq;
 
 //---------------------------------------------------------------------------
 void Kernel::Init()
@@ -51,9 +52,15 @@ void Kernel::Init()
     // Initialize the global kernel data - thread-scheduler, and timer-scheduler.
     Scheduler::Init();
     TimerScheduler::Init();
+#if KERNEL_HRTIMERS
+    HRTimerScheduler::Init();
+#endif // #if KERNEL_HRTIMERS
 #if KERNEL_STACK_CHECK
     m_u16GuardThreshold = KERNEL_STACK_GUARD_DEFAULT;
 #endif // #if KERNEL_STACK_CHECK
+#if KERNEL_SMP
+    Scheduler::StartIdle();
+#endif // #if KERNEL_SMP
 }
 
 //---------------------------------------------------------------------------
@@ -66,6 +73,9 @@ void Kernel::Start()
 void Kernel::CompleteStart()
 {
     m_bIsStarted = true;
+#if KERNEL_CPU_ACCOUNTING
+    CpuUsage::Start();
+#endif // #if KERNEL_CPU_ACCOUNTING
 }
 
 //---------------------------------------------------------------------------
@@ -89,13 +99,48 @@ void Kernel::DebugPrint(const char* szString_)
 }
 
 //---------------------------------------------------------------------------
-uint32_t Kernel::GetTicks()
+void Kernel::Tick(uint32_t u32Ticks_)
 {
-    uint32_t rc;
+    // The tick count is updated within a critical section, so readers on the
+    // same core can never interrupt an update part-way through - they only
+    // need to detect that an update happened between their reads.
     CS_ENTER();
-    rc = m_u32Ticks;
+    m_u32TickSeq = m_u32TickSeq + 1;
+    m_u64Ticks   = m_u64Ticks + u32Ticks_;
+    m_u32TickSeq = m_u32TickSeq + 1;
     CS_EXIT();
+
+#if KERNEL_CPU_BUDGETS
+    CpuBudget::Tick(u32Ticks_);
+#endif // #if KERNEL_CPU_BUDGETS
+}
+
+//---------------------------------------------------------------------------
+uint64_t Kernel::GetTicks64()
+{
+#if KERNEL_TIMERS_TICKLESS
+    // Ticks elapsed since the kernel timer's last expiry have to be sampled
+    // from the timer hardware, consistently with the tick count.
+    uint64_t rc;
+    CS_ENTER();
+    rc = m_u64Ticks + KernelTimer::GetOvertime();
+    CS_EXIT();
+    return rc;
+#else
+    // Where a 64-bit load is a single access, the count can be read directly.
+    // Otherwise, retry until the count is read without an update in between.
+    if (sizeof(K_ADDR) >= sizeof(uint64_t)) {
+        return m_u64Ticks;
+    }
+
+    uint32_t u32Seq;
+    uint64_t rc;
+    do {
+        u32Seq = m_u32TickSeq;
+        rc     = m_u64Ticks;
+    } while (((u32Seq & 1) != 0) || (u32Seq != m_u32TickSeq));
     return rc;
+#endif // #if KERNEL_TIMERS_TICKLESS
 }
 
 } // namespace Mark3
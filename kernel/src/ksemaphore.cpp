@@ -41,7 +41,7 @@ namespace
         KERNEL_ASSERT(pclOwner_ != nullptr);
         KERNEL_ASSERT(pvData_ != nullptr);
 
-        auto* pclSemaphore = static_cast<Semaphore*>(pvData_);
+        auto* pclSemaphore = static_cast<Semaphore*>(static_cast<BlockingObject*>(pvData_));
 
         // Indicate that the semaphore has expired on the thread
         pclOwner_->SetExpired(true);
@@ -112,6 +112,30 @@ bool Semaphore::Post()
 
     auto bThreadWake = false;
     auto bBail       = false;
+#if KERNEL_WAIT_SETS
+    auto bIncremented = false;
+#endif // #if KERNEL_WAIT_SETS
+
+#if PORT_ATOMIC_EXCLUSIVE && !KERNEL_SMP
+    // If nothing is waiting for the semaphore, the count can be incremented
+    // without a critical section.  A thread can only block on the semaphore
+    // by way of a context switch, which cancels the exclusive access.  That
+    // doesn't hold for threads on other cores, so SMP builds (which protect
+    // kernel objects with the kernel lock) always use the critical section.
+    while (true) {
+        auto u16Value = ThreadPort::LoadExclusive(&m_u16Value);
+        if ((u16Value >= m_u16MaxValue) || (m_clBlockList.GetHead() != nullptr)) {
+            ThreadPort::ClearExclusive();
+            break;
+        }
+        if (ThreadPort::StoreExclusive(&m_u16Value, static_cast<uint16_t>(u16Value + 1))) {
+#if KERNEL_WAIT_SETS
+            SignalWaitSet();
+#endif // #if KERNEL_WAIT_SETS
+            return true;
+        }
+    }
+#endif
     // Increment the semaphore count - we can mess with threads so ensure this
     // is in a critical section.  We don't just disable the scheudler since
     // we want to be able to do this from within an interrupt context as well.
@@ -123,6 +147,9 @@ bool Semaphore::Post()
         if (m_u16Value < m_u16MaxValue) {
             // Increment the count value
             m_u16Value++;
+#if KERNEL_WAIT_SETS
+            bIncremented = true;
+#endif // #if KERNEL_WAIT_SETS
         } else {
             // Maximum value has been reached, bail out.
             bBail = true;
@@ -139,6 +166,14 @@ bool Semaphore::Post()
         return false;
     }
 
+#if KERNEL_WAIT_SETS
+    // Only a count left on the semaphore can satisfy the set - a post handed
+    // to a waiting thread, of any priority, leaves nothing behind.
+    if (bIncremented) {
+        SignalWaitSet();
+    }
+#endif // #if KERNEL_WAIT_SETS
+
     // if bThreadWake was set, it means that a higher-priority thread was
     // woken.  Trigger a context switch to ensure that this thread gets
     // to execute next.
@@ -153,8 +188,14 @@ bool Semaphore::Pend_i(uint32_t u32WaitTimeMS_)
 {
     KERNEL_ASSERT(IsInitialized());
 
-    Timer clSemTimer;
-    auto  bUseTimer = false;
+    auto bUseTimer = false;
+
+#if PORT_ATOMIC_EXCLUSIVE && !KERNEL_SMP
+    // Decrement a non-zero count without a critical section
+    if (TryPend()) {
+        return true;
+    }
+#endif
 
     // Once again, messing with thread data - ensure
     // we're doing all of these operations from within a thread-safe context.
@@ -169,9 +210,7 @@ bool Semaphore::Pend_i(uint32_t u32WaitTimeMS_)
         // The semaphore count is zero - we need to block the current thread
         // and wait until the semaphore is posted from elsewhere.
         if (u32WaitTimeMS_ != 0u) {
-            g_pclCurrent->SetExpired(false);
-            clSemTimer.Init();
-            clSemTimer.Start(false, u32WaitTimeMS_, TimedSemaphore_Callback, this);
+            ArmTimeout(u32WaitTimeMS_, TimedSemaphore_Callback);
             bUseTimer = true;
         }
         BlockPriority(g_pclCurrent);
@@ -183,8 +222,7 @@ bool Semaphore::Pend_i(uint32_t u32WaitTimeMS_)
     CS_EXIT();
 
     if (bUseTimer) {
-        clSemTimer.Stop();
-        return (static_cast<int>(g_pclCurrent->GetExpired()) == 0);
+        return DisarmTimeout();
     }
     return true;
 }
@@ -202,6 +240,32 @@ bool Semaphore::Pend(uint32_t u32WaitTimeMS_)
     return Pend_i(u32WaitTimeMS_);
 }
 
+//---------------------------------------------------------------------------
+bool Semaphore::TryPend()
+{
+    KERNEL_ASSERT(IsInitialized());
+
+#if PORT_ATOMIC_EXCLUSIVE && !KERNEL_SMP
+    auto u16Value = m_u16Value;
+    while (u16Value != 0) {
+        if (Atomic::CompareAndSwap(&m_u16Value, u16Value, static_cast<uint16_t>(u16Value - 1))) {
+            return true;
+        }
+        u16Value = m_u16Value;
+    }
+    return false;
+#else
+    auto bClaimed = false;
+    CS_ENTER();
+    if (m_u16Value != 0) {
+        m_u16Value--;
+        bClaimed = true;
+    }
+    CS_EXIT();
+    return bClaimed;
+#endif
+}
+
 //---------------------------------------------------------------------------
 uint16_t Semaphore::GetCount()
 {
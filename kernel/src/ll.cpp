@@ -77,6 +77,23 @@ void DoubleLinkList::Remove(LinkListNode* node_)
     node_->ClearNode();
 }
 
+//---------------------------------------------------------------------------
+void DoubleLinkList::InsertNodeBefore(LinkListNode* node_, LinkListNode* insert_)
+{
+    KERNEL_ASSERT(node_ != nullptr);
+    KERNEL_ASSERT(insert_ != nullptr);
+
+    node_->next = insert_;
+    node_->prev = insert_->prev;
+
+    if (insert_->prev != nullptr) {
+        insert_->prev->next = node_;
+    } else {
+        m_pclHead = node_;
+    }
+    insert_->prev = node_;
+}
+
 //---------------------------------------------------------------------------
 void CircularLinkList::Add(LinkListNode* node_)
 {
@@ -107,6 +107,28 @@ bool Mailbox::ReceiveTail(void* pvData_, uint32_t u32TimeoutMS_)
     return Receive_i(pvData_, true, u32TimeoutMS_);
 }
 
+//---------------------------------------------------------------------------
+bool Mailbox::TryReceive(void* pvData_)
+{
+    KERNEL_ASSERT(pvData_ != nullptr);
+    if (!m_clRecvSem.TryPend()) {
+        return false;
+    }
+    Dequeue_i(pvData_, false);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+bool Mailbox::TryReceiveTail(void* pvData_)
+{
+    KERNEL_ASSERT(pvData_ != nullptr);
+    if (!m_clRecvSem.TryPend()) {
+        return false;
+    }
+    Dequeue_i(pvData_, true);
+    return true;
+}
+
 //---------------------------------------------------------------------------
 bool Mailbox::Send(void* pvData_)
 {
@@ -197,7 +219,6 @@ bool Mailbox::Send_i(const void* pvData_, bool bTail_, uint32_t u32TimeoutMS_)
 bool Mailbox::Receive_i(const void* pvData_, bool bTail_, uint32_t u32WaitTimeMS_)
 {
     KERNEL_ASSERT(pvData_ != nullptr);
-    const void* pvSrc;
 
     if (!m_clRecvSem.Pend(u32WaitTimeMS_)) {
         // Failed to get the notification from the counting semaphore in the
@@ -205,6 +226,15 @@ bool Mailbox::Receive_i(const void* pvData_, bool bTail_, uint32_t u32WaitTimeMS
         return false;
     }
 
+    Dequeue_i(pvData_, bTail_);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+void Mailbox::Dequeue_i(const void* pvData_, bool bTail_)
+{
+    const void* pvSrc;
+
     // Disable the scheduler while we do this -- this ensures we don't have
     // multiple concurrent readers off the same queue, which could be problematic
     // if multiple writes occur during reads, etc.
@@ -232,7 +262,5 @@ bool Mailbox::Receive_i(const void* pvData_, bool bTail_, uint32_t u32WaitTimeMS
 
     // Unblock a thread waiting for a free slot to send to
     m_clSendSem.Post();
-
-    return true;
 }
 } // namespace Mark3
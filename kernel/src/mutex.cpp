@@ -22,6 +22,11 @@ namespace Mark3
 {
 namespace
 {
+    // Values held in a mutex's lock word
+    constexpr auto cu8MutexFree      = uint8_t{0}; //!< Not claimed
+    constexpr auto cu8MutexHeld      = uint8_t{1}; //!< Claimed, no thread has blocked on it since
+    constexpr auto cu8MutexContended = uint8_t{2}; //!< Claimed, threads may be waiting on it
+
     //---------------------------------------------------------------------------
     /**
      * @brief TimedMutex_Calback
@@ -38,7 +43,7 @@ namespace
         KERNEL_ASSERT(pclOwner_ != nullptr);
         KERNEL_ASSERT(pvData_ != nullptr);
 
-        auto* pclMutex = static_cast<Mutex*>(pvData_);
+        auto* pclMutex = static_cast<Mutex*>(static_cast<BlockingObject*>(pvData_));
 
         // Indicate that the semaphore has expired on the thread
         pclOwner_->SetExpired(true);
@@ -60,6 +65,14 @@ Mutex::~Mutex()
     if (m_clBlockList.GetHead() != nullptr) {
         Kernel::Panic(PANIC_ACTIVE_MUTEX_DESCOPED);
     }
+
+    // A mutex going out of scope while claimed must not be left in its
+    // owner's list of held mutexes.
+    if (IsInitialized() && (m_pclOwner != nullptr)) {
+        Scheduler::SetScheduler(false);
+        RemoveHeld();
+        Scheduler::SetScheduler(true);
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -68,6 +81,87 @@ void Mutex::WakeMe(Thread* pclOwner_)
     KERNEL_ASSERT(pclOwner_ != nullptr);
     // Remove from the semaphore waitlist and back to its ready list.
     UnBlock(pclOwner_);
+    pclOwner_->SetBlockingMutex(nullptr);
+
+    // The owner no longer inherits priority from the timed-out thread
+    PropagatePriority();
+}
+
+//---------------------------------------------------------------------------
+void Mutex::AddHeld(Thread* pclOwner_)
+{
+    m_pclOwner    = pclOwner_;
+    m_pclNextHeld = pclOwner_->GetHeldMutex();
+    pclOwner_->SetHeldMutex(this);
+}
+
+//---------------------------------------------------------------------------
+void Mutex::RemoveHeld()
+{
+    // Mutexes are usually released in the reverse order they were claimed,
+    // so this is typically found at the head of the list.
+    if (m_pclOwner == nullptr) {
+        return;
+    }
+
+    // The mutex may be missing if its owner has since exited and been
+    // re-initialized.
+    auto* pclPrev = static_cast<Mutex*>(nullptr);
+    auto* pclCurr = m_pclOwner->GetHeldMutex();
+    while ((pclCurr != nullptr) && (pclCurr != this)) {
+        pclPrev = pclCurr;
+        pclCurr = pclCurr->m_pclNextHeld;
+    }
+
+    if (pclCurr == nullptr) {
+        return;
+    }
+    if (pclPrev == nullptr) {
+        m_pclOwner->SetHeldMutex(m_pclNextHeld);
+    } else {
+        pclPrev->m_pclNextHeld = m_pclNextHeld;
+    }
+    m_pclNextHeld = nullptr;
+}
+
+//---------------------------------------------------------------------------
+PORT_PRIO_TYPE Mutex::InheritedPriority(Thread* pclThread_)
+{
+    // Block lists are sorted by priority, so the highest waiter on each held
+    // mutex is at the head of its list.
+    auto uXPriority = pclThread_->GetPriority();
+    for (auto* pclMutex = pclThread_->GetHeldMutex(); pclMutex != nullptr; pclMutex = pclMutex->m_pclNextHeld) {
+        if (pclMutex->m_uXCeiling > uXPriority) {
+            uXPriority = pclMutex->m_uXCeiling;
+        }
+        auto* pclWaiter = pclMutex->m_clBlockList.HighestWaiter();
+        if ((pclWaiter != nullptr) && (pclWaiter->GetCurPriority() > uXPriority)) {
+            uXPriority = pclWaiter->GetCurPriority();
+        }
+    }
+    return uXPriority;
+}
+
+//---------------------------------------------------------------------------
+void Mutex::PropagatePriority()
+{
+    auto* pclMutex = this;
+    while ((pclMutex != nullptr) && (pclMutex->m_pclOwner != nullptr)) {
+        auto* pclOwner   = pclMutex->m_pclOwner;
+        auto  uXPriority = InheritedPriority(pclOwner);
+        if (uXPriority == pclOwner->GetCurPriority()) {
+            break;
+        }
+        pclOwner->InheritPriority(uXPriority);
+
+        // If the owner is waiting on another mutex, keep that mutex's block
+        // list in priority order, and carry the change on to its owner.
+        pclMutex = pclOwner->GetBlockingMutex();
+        if (pclMutex != nullptr) {
+            pclMutex->m_clBlockList.Remove(pclOwner);
+            pclMutex->m_clBlockList.AddPriority(pclOwner);
+        }
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -79,9 +173,11 @@ uint8_t Mutex::WakeNext()
 
     // Unblock the thread
     UnBlock(pclChosenOne);
+    pclChosenOne->SetBlockingMutex(nullptr);
 
-    // The chosen one now owns the mutex
-    m_pclOwner = pclChosenOne;
+    // The chosen one now owns the mutex, and inherits from the remaining waiters
+    AddHeld(pclChosenOne);
+    PropagatePriority();
 
     // Signal a context switch if it's a greater than or equal to the current priority
     if (pclChosenOne->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
@@ -96,12 +192,20 @@ void Mutex::Init(bool bRecursive_)
     // Cannot re-init a mutex which has threads blocked on it
     KERNEL_ASSERT(!m_clBlockList.GetHead());
 
+    // Re-initializing a claimed mutex releases it from its owner
+    if (IsInitialized() && (m_pclOwner != nullptr)) {
+        Scheduler::SetScheduler(false);
+        RemoveHeld();
+        Scheduler::SetScheduler(true);
+    }
+
     // Reset the data in the mutex
-    m_bReady     = true;    // The mutex is free.
-    m_u8MaxPri   = 0;       // Set the maximum priority inheritence state
-    m_pclOwner   = nullptr; // Clear the mutex owner
-    m_u8Recurse  = 0;       // Reset recurse count
-    m_bRecursive = bRecursive_;
+    m_u8Lock      = cu8MutexFree; // The mutex is free.
+    m_pclOwner    = nullptr;      // Clear the mutex owner
+    m_pclNextHeld = nullptr;      // Not held, so not in any thread's held list
+    m_u8Recurse   = 0;            // Reset recurse count
+    m_uXCeiling   = 0;            // Priority inheritence only
+    m_bRecursive  = bRecursive_;
     SetInitialized();
 }
 
@@ -109,9 +213,36 @@ void Mutex::Init(bool bRecursive_)
 bool Mutex::Claim_i(uint32_t u32WaitTimeMS_)
 {
     KERNEL_ASSERT(IsInitialized());
+    KERNEL_ASSERT((m_uXCeiling == 0) || (g_pclCurrent->GetPriority() <= m_uXCeiling));
+
+    auto bUseTimer = false;
+
+#if PORT_ATOMIC_EXCLUSIVE && !KERNEL_SMP
+    // Uncontended claims of priority-inheritence mutexes only need to swap the
+    // lock word, without disabling the scheduler.
+    if (m_uXCeiling == 0) {
+        if (Atomic::CompareAndSwap(&m_u8Lock, cu8MutexFree, cu8MutexHeld)) {
+            m_u8Recurse = 0;
+            AddHeld(g_pclCurrent);
+
+            // A thread may have blocked on the mutex before its owner was
+            // recorded, in which case it hasn't boosted us yet.
+            if (m_u8Lock == cu8MutexContended) {
+                Scheduler::SetScheduler(false);
+                PropagatePriority();
+                Scheduler::SetScheduler(true);
+            }
+            return true;
+        }
 
-    Timer clTimer;
-    auto  bUseTimer = false;
+        // Only the owner can modify the recursive lock-count
+        if (m_bRecursive && (g_pclCurrent == m_pclOwner)) {
+            KERNEL_ASSERT((m_u8Recurse < 255));
+            m_u8Recurse++;
+            return true;
+        }
+    }
+#endif
 
     // Disable the scheduler while claiming the mutex - we're dealing with all
     // sorts of private thread data, can't have a thread switch while messing
@@ -119,12 +250,16 @@ bool Mutex::Claim_i(uint32_t u32WaitTimeMS_)
     Scheduler::SetScheduler(false);
 
     // Check to see if the mutex is claimed or not
-    if (static_cast<int>(m_bReady) != 0) {
+    if (m_u8Lock == cu8MutexFree) {
         // Mutex isn't claimed, claim it.
-        m_bReady    = false;
+        m_u8Lock    = cu8MutexHeld;
         m_u8Recurse = 0;
-        m_u8MaxPri  = g_pclCurrent->GetPriority();
-        m_pclOwner  = g_pclCurrent;
+        AddHeld(g_pclCurrent);
+
+        // Priority-ceiling mutexes raise the owner as soon as it is claimed
+        if (m_uXCeiling > g_pclCurrent->GetCurPriority()) {
+            g_pclCurrent->InheritPriority(m_uXCeiling);
+        }
 
         Scheduler::SetScheduler(true);
         return true;
@@ -145,29 +280,18 @@ bool Mutex::Claim_i(uint32_t u32WaitTimeMS_)
     // The mutex is claimed already - we have to block now.  Move the
     // current thread to the list of threads waiting on the mutex.
     if (u32WaitTimeMS_ != 0u) {
-        g_pclCurrent->SetExpired(false);
-        clTimer.Init();
-        clTimer.Start(false, u32WaitTimeMS_, (TimerCallback)TimedMutex_Callback, this);
+        ArmTimeout(u32WaitTimeMS_, TimedMutex_Callback);
         bUseTimer = true;
     }
     BlockPriority(g_pclCurrent);
+    g_pclCurrent->SetBlockingMutex(this);
 
-    // Check if priority inheritence is necessary.  We do this in order
-    // to ensure that we don't end up with priority inversions in case
-    // multiple threads are waiting on the same resource.
-    if (m_u8MaxPri <= g_pclCurrent->GetPriority()) {
-        m_u8MaxPri = g_pclCurrent->GetPriority();
-
-        auto* pclTemp = static_cast<Thread*>(m_clBlockList.GetHead());
-        while (pclTemp != nullptr) {
-            pclTemp->InheritPriority(m_u8MaxPri);
-            if (pclTemp == static_cast<Thread*>(m_clBlockList.GetTail())) {
-                break;
-            }
-            pclTemp = static_cast<Thread*>(pclTemp->GetNext());
-        }
-        m_pclOwner->InheritPriority(m_u8MaxPri);
-    }
+    // Force the owner through the slow path when releasing the mutex
+    m_u8Lock = cu8MutexContended;
+
+    // Boost the owner (and whatever it is blocked on in turn) to avoid
+    // priority inversion while this thread waits.
+    PropagatePriority();
 
     // Done with thread data -reenable the scheduler
     Scheduler::SetScheduler(true);
@@ -176,8 +300,7 @@ bool Mutex::Claim_i(uint32_t u32WaitTimeMS_)
     Thread::Yield();
 
     if (bUseTimer) {
-        clTimer.Stop();
-        return (static_cast<int>(g_pclCurrent->GetExpired()) == 0);
+        return DisarmTimeout();
     }
     return true;
 }
@@ -201,6 +324,30 @@ void Mutex::Release()
 
     auto bSchedule = false;
 
+#if PORT_ATOMIC_EXCLUSIVE && !KERNEL_SMP
+    KERNEL_ASSERT((g_pclCurrent == m_pclOwner));
+
+    // Only the owner can modify the recursive lock-count
+    if (m_bRecursive && (m_u8Recurse != 0u)) {
+        m_u8Recurse--;
+        return;
+    }
+
+    // If no thread has blocked on the mutex, nobody has boosted the owner
+    // through it, and there is nobody to wake - just give it up.
+    if ((m_uXCeiling == 0) && (m_u8Lock == cu8MutexHeld)) {
+        RemoveHeld();
+        m_pclOwner = nullptr;
+        if (Atomic::CompareAndSwap(&m_u8Lock, cu8MutexHeld, cu8MutexFree)) {
+            return;
+        }
+
+        // A thread blocked on the mutex in the meantime - take it back, and
+        // hand it over the long way.
+        AddHeld(g_pclCurrent);
+    }
+#endif
+
     // Disable the scheduler while we deal with internal data structures.
     Scheduler::SetScheduler(false);
 
@@ -215,9 +362,13 @@ void Mutex::Release()
         return;
     }
 
-    // Restore the thread's original priority
-    if (g_pclCurrent->GetCurPriority() != g_pclCurrent->GetPriority()) {
-        g_pclCurrent->SetPriority(g_pclCurrent->GetPriority());
+    RemoveHeld();
+
+    // Drop any priority inherited through this mutex, keeping whatever is
+    // still inherited through other mutexes the thread holds.
+    auto uXPriority = InheritedPriority(g_pclCurrent);
+    if (g_pclCurrent->GetCurPriority() != uXPriority) {
+        g_pclCurrent->InheritPriority(uXPriority);
 
         // In this case, we want to reschedule
         bSchedule = true;
@@ -226,8 +377,7 @@ void Mutex::Release()
     // No threads are waiting on this semaphore?
     if (m_clBlockList.GetHead() == nullptr) {
         // Re-initialize the mutex to its default values
-        m_bReady   = true;
-        m_u8MaxPri = 0;
+        m_u8Lock   = cu8MutexFree;
         m_pclOwner = nullptr;
     } else {
         // Wake the highest priority Thread pending on the mutex
@@ -235,6 +385,10 @@ void Mutex::Release()
             // Switch threads if it's higher or equal priority than the current thread
             bSchedule = true;
         }
+
+        // The new owner can give up the mutex without a critical section if
+        // it was the only waiter.
+        m_u8Lock = (m_clBlockList.GetHead() != nullptr) ? cu8MutexContended : cu8MutexHeld;
     }
 
     // Must enable the scheduler again in order to switch threads.
@@ -244,4 +398,13 @@ void Mutex::Release()
         Thread::Yield();
     }
 }
+
+//---------------------------------------------------------------------------
+void CeilingMutex::Init(PORT_PRIO_TYPE uXCeiling_, bool bRecursive_)
+{
+    KERNEL_ASSERT(uXCeiling_ < KERNEL_NUM_PRIORITIES);
+
+    Mutex::Init(bRecursive_);
+    m_uXCeiling = uXCeiling_;
+}
 } // namespace Mark3
@@ -29,7 +29,7 @@ namespace
         KERNEL_ASSERT(pclOwner_ != nullptr);
         KERNEL_ASSERT(pvData_ != nullptr);
 
-        auto* pclNotify = static_cast<Notify*>(pvData_);
+        auto* pclNotify = static_cast<Notify*>(static_cast<BlockingObject*>(pvData_));
 
         // Indicate that the semaphore has expired on the thread
         pclOwner_->SetExpired(true);
@@ -68,11 +68,17 @@ void Notify::Signal(void)
     KERNEL_ASSERT(IsInitialized());
 
     auto bReschedule = false;
+#if KERNEL_WAIT_SETS
+    auto bPending = false;
+#endif // #if KERNEL_WAIT_SETS
 
     CS_ENTER();
     auto* pclCurrent = static_cast<Thread*>(m_clBlockList.GetHead());
     if (pclCurrent == nullptr) {
         m_bPending = true;
+#if KERNEL_WAIT_SETS
+        bPending = true;
+#endif // #if KERNEL_WAIT_SETS
     } else {
         while (pclCurrent != nullptr) {
             UnBlock(pclCurrent);
@@ -85,6 +91,12 @@ void Notify::Signal(void)
     }
     CS_EXIT();
 
+#if KERNEL_WAIT_SETS
+    if (bPending) {
+        SignalWaitSet();
+    }
+#endif // #if KERNEL_WAIT_SETS
+
     if (bReschedule) {
         Thread::Yield();
     }
@@ -125,18 +137,14 @@ bool Notify::Wait(uint32_t u32WaitTimeMS_, bool* pbFlag_)
     KERNEL_ASSERT(pbFlag_ != nullptr);
     KERNEL_ASSERT(IsInitialized());
 
-    auto  bUseTimer  = false;
-    auto  bEarlyExit = false;
-    Timer clNotifyTimer;
+    auto bUseTimer  = false;
+    auto bEarlyExit = false;
 
     CS_ENTER();
     if (!m_bPending) {
         if (u32WaitTimeMS_ != 0u) {
             bUseTimer = true;
-            g_pclCurrent->SetExpired(false);
-
-            clNotifyTimer.Init();
-            clNotifyTimer.Start(false, u32WaitTimeMS_, TimedNotify_Callback, this);
+            ArmTimeout(u32WaitTimeMS_, TimedNotify_Callback);
         }
 
         Block(g_pclCurrent);
@@ -157,8 +165,7 @@ bool Notify::Wait(uint32_t u32WaitTimeMS_, bool* pbFlag_)
     Thread::Yield();
 
     if (bUseTimer) {
-        clNotifyTimer.Stop();
-        return (static_cast<int>(g_pclCurrent->GetExpired()) == 0);
+        return DisarmTimeout();
     }
 
     if (pbFlag_ != nullptr) {
@@ -0,0 +1,174 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   periodic.cpp
+
+    @brief  Periodic release object - drift-free periodic threads
+
+*/
+#include "mark3.h"
+namespace Mark3
+{
+namespace
+{
+    //---------------------------------------------------------------------------
+    /**
+     * @brief PeriodicRelease_Callback
+     *
+     * This function is called from the timer-expired context at the end of each
+     * period, releasing the thread waiting on the periodic object.
+     *
+     * @param pclOwner_ Unused
+     * @param pvData_   Pointer to the periodic object being released
+     */
+    void PeriodicRelease_Callback(Thread* /*pclOwner_*/, void* pvData_)
+    {
+        KERNEL_ASSERT(pvData_ != nullptr);
+
+        auto* pclPeriodic = static_cast<Periodic*>(pvData_);
+        pclPeriodic->Release();
+    }
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+Periodic::~Periodic()
+{
+    // If there are any threads waiting on this object when it goes out
+    // of scope, set a kernel panic.
+    if (m_clBlockList.GetHead() != nullptr) {
+        Kernel::Panic(PANIC_ACTIVE_PERIODIC_DESCOPED);
+    }
+    m_clTimer.Stop();
+}
+
+//---------------------------------------------------------------------------
+void Periodic::Init(void)
+{
+    KERNEL_ASSERT(!m_clBlockList.GetHead());
+
+    m_clTimer.Init();
+    m_u32Period      = 0;
+    m_u32NextRelease = 0;
+    m_u32Overruns    = 0;
+    m_u16Pending     = 0;
+
+    SetInitialized();
+}
+
+//---------------------------------------------------------------------------
+void Periodic::Start(uint32_t u32PeriodMs_)
+{
+    KERNEL_ASSERT(IsInitialized());
+    KERNEL_ASSERT(u32PeriodMs_ != 0);
+
+    m_clTimer.Stop();
+
+    CS_ENTER();
+    m_u32Period      = u32PeriodMs_;
+    m_u32NextRelease = Kernel::GetTicks() + u32PeriodMs_;
+    m_u32Overruns    = 0;
+    m_u16Pending     = 0;
+    CS_EXIT();
+
+    // The timer repeats relative to its own expiry, not to the time at which
+    // the thread gets around to waiting, so the releases never drift.
+    m_clTimer.Start(true, u32PeriodMs_, PeriodicRelease_Callback, this);
+}
+
+//---------------------------------------------------------------------------
+void Periodic::Stop(void)
+{
+    KERNEL_ASSERT(IsInitialized());
+
+    m_clTimer.Stop();
+
+    auto bReschedule = false;
+    CS_ENTER();
+    auto* pclThread = static_cast<Thread*>(m_clBlockList.GetHead());
+    if (pclThread != nullptr) {
+        UnBlock(pclThread);
+        bReschedule = (pclThread->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority());
+    }
+    m_u16Pending = 0;
+    CS_EXIT();
+
+    if (bReschedule) {
+        Thread::Yield();
+    }
+}
+
+//---------------------------------------------------------------------------
+bool Periodic::Wait(void)
+{
+    KERNEL_ASSERT(IsInitialized());
+    KERNEL_ASSERT(!m_clBlockList.GetHead());
+
+    auto bOnTime = true;
+    CS_ENTER();
+    if (m_u16Pending == 0) {
+        Block(g_pclCurrent);
+    } else {
+        // The thread has missed one or more releases - run the late period
+        // now, and leave the following releases where they were.
+        m_u32Overruns += m_u16Pending;
+        m_u16Pending = 0;
+        bOnTime      = false;
+#if KERNEL_EDF
+        // The late job is due relative to the most recent release
+        if (g_pclCurrent->HasDeadline()) {
+            g_pclCurrent->ReleaseJob(m_u32NextRelease - m_u32Period);
+        }
+#endif // #if KERNEL_EDF
+    }
+    CS_EXIT();
+
+#if KERNEL_EDF
+    // A late job may no longer have the earliest deadline
+    Thread::Yield();
+#else
+    if (bOnTime) {
+        Thread::Yield();
+    }
+#endif // #if KERNEL_EDF
+    return bOnTime;
+}
+
+//---------------------------------------------------------------------------
+void Periodic::Release(void)
+{
+    auto bReschedule = false;
+
+    CS_ENTER();
+    auto* pclThread = static_cast<Thread*>(m_clBlockList.GetHead());
+    if (pclThread != nullptr) {
+#if KERNEL_EDF
+        // Each release starts a new job for an EDF thread
+        if (pclThread->HasDeadline()) {
+            pclThread->ReleaseJob(m_u32NextRelease);
+        }
+#endif // #if KERNEL_EDF
+        UnBlock(pclThread);
+        bReschedule = (pclThread->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority());
+    } else if (m_u16Pending != 0xFFFF) {
+        m_u16Pending++;
+    }
+    m_u32NextRelease += m_u32Period;
+    CS_EXIT();
+
+    if (bReschedule) {
+        Thread::Yield();
+    }
+}
+} // namespace Mark3
@@ -19,25 +19,51 @@ See license.txt for more information
 */
 
 #include "mark3.h"
+namespace
+{
+//---------------------------------------------------------------------------
+// One bucket for a zero count, and one for each bit of a 32-bit count
+constexpr auto cu8MaxBuckets = uint8_t{ 33 };
+} // anonymous namespace
+
 namespace Mark3
 {
 //---------------------------------------------------------------------------
 void ProfileTimer::Init()
 {
-    m_u32Cumulative       = 0;
+    m_u64Cumulative       = 0;
+    m_u64SumSquares       = 0;
+    m_u32Mean             = 0;
     m_u32CurrentIteration = 0;
-    m_u16Iterations       = 0;
+    m_u32Iterations       = 0;
+    m_u32Min              = 0;
+    m_u32Max              = 0;
+    m_au32Histogram       = nullptr;
+    m_u8Buckets           = 0;
     m_bActive             = false;
 }
 
+//---------------------------------------------------------------------------
+void ProfileTimer::SetHistogram(uint32_t* au32Buckets_, uint8_t u8Buckets_)
+{
+    if (au32Buckets_ == nullptr) {
+        u8Buckets_ = 0;
+    } else if (u8Buckets_ > cu8MaxBuckets) {
+        u8Buckets_ = cu8MaxBuckets;
+    }
+    for (uint8_t i = 0; i < u8Buckets_; i++) { au32Buckets_[i] = 0; }
+    m_au32Histogram = (u8Buckets_ != 0) ? au32Buckets_ : nullptr;
+    m_u8Buckets     = u8Buckets_;
+}
+
 //---------------------------------------------------------------------------
 void ProfileTimer::Start()
 {
     if (!m_bActive) {
         CS_ENTER();
         m_u32CurrentIteration = 0;
-        m_u32InitialEpoch     = Profiler::GetEpoch();
         m_u16Initial          = Profiler::Read();
+        m_u32InitialEpoch     = Profiler::GetEpoch();
         CS_EXIT();
         m_bActive = true;
     }
@@ -54,8 +80,7 @@ void ProfileTimer::Stop()
         u32Epoch = Profiler::GetEpoch();
         // Compute total for current iteration...
         m_u32CurrentIteration = ComputeCurrentTicks(u16Final, u32Epoch);
-        m_u32Cumulative += m_u32CurrentIteration;
-        m_u16Iterations++;
+        AddSample(m_u32CurrentIteration);
         CS_EXIT();
         m_bActive = false;
     }
@@ -64,12 +89,73 @@ void ProfileTimer::Stop()
 //---------------------------------------------------------------------------
 uint32_t ProfileTimer::GetAverage()
 {
-    if (m_u16Iterations != 0u) {
-        return m_u32Cumulative / (uint32_t)m_u16Iterations;
+    if (m_u32Iterations != 0u) {
+        return static_cast<uint32_t>(m_u64Cumulative / m_u32Iterations);
+    }
+    return 0;
+}
+
+//---------------------------------------------------------------------------
+uint64_t ProfileTimer::GetVariance()
+{
+    if (m_u32Iterations != 0u) {
+        return m_u64SumSquares / m_u32Iterations;
     }
     return 0;
 }
 
+//---------------------------------------------------------------------------
+uint32_t ProfileTimer::GetPercentile(uint8_t u8Percent_)
+{
+    if ((m_au32Histogram == nullptr) || (m_u32Iterations == 0u)) {
+        return m_u32Max;
+    }
+
+    // Number of iterations at or below the percentile, rounded up
+    auto u64Rank  = ((static_cast<uint64_t>(m_u32Iterations) * u8Percent_) + 99) / 100;
+    auto u64Count = uint64_t{ 0 };
+    for (uint8_t i = 0; i < (m_u8Buckets - 1); i++) {
+        u64Count += m_au32Histogram[i];
+        if (u64Count >= u64Rank) {
+            auto u32Bound = (i < 32) ? ((uint32_t{ 1 } << i) - 1) : UINT32_MAX;
+            return (u32Bound < m_u32Max) ? u32Bound : m_u32Max;
+        }
+    }
+    return m_u32Max;
+}
+
+//---------------------------------------------------------------------------
+void ProfileTimer::AddSample(uint32_t u32Ticks_)
+{
+    m_u64Cumulative += u32Ticks_;
+    m_u32Iterations++;
+
+    if ((m_u32Iterations == 1) || (u32Ticks_ < m_u32Min)) {
+        m_u32Min = u32Ticks_;
+    }
+    if (u32Ticks_ > m_u32Max) {
+        m_u32Max = u32Ticks_;
+    }
+
+    // Welford's method, with the mean kept as an integer.  The mean moves
+    // towards the new sample, so the deviations from the old and new means
+    // share a sign, and their product is taken on the magnitudes.
+    auto i64Delta = static_cast<int64_t>(u32Ticks_) - m_u32Mean;
+    m_u32Mean     = static_cast<uint32_t>(m_u32Mean + (i64Delta / static_cast<int64_t>(m_u32Iterations)));
+    if (i64Delta >= 0) {
+        m_u64SumSquares += static_cast<uint64_t>(i64Delta) * (u32Ticks_ - m_u32Mean);
+    } else {
+        m_u64SumSquares += static_cast<uint64_t>(-i64Delta) * (m_u32Mean - u32Ticks_);
+    }
+
+    if (m_au32Histogram != nullptr) {
+        // Bucket n holds samples with n significant bits
+        auto u8Bucket = uint8_t{ 0 };
+        while ((u8Bucket < (m_u8Buckets - 1)) && ((u32Ticks_ >> u8Bucket) != 0)) { u8Bucket++; }
+        m_au32Histogram[u8Bucket]++;
+    }
+}
+
 //---------------------------------------------------------------------------
 uint32_t ProfileTimer::GetCurrent()
 {
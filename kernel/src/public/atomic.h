@@ -82,5 +82,24 @@ namespace Atomic
      * @return true - Lock value was "true" on entry, false - Lock was set
      */
     bool TestAndSet(bool* pbLock);
+
+    /**
+     * @brief CompareAndSwap Replace the contents of a variable with a new value,
+     *        but only if it currently holds an expected value.  This is an
+     *        uninterruptable operation.
+     *
+     *        On ports providing exclusive-access primitives (PORT_ATOMIC_EXCLUSIVE),
+     *        this is implemented with a load/store-exclusive sequence, and does not
+     *        require a critical section.
+     *
+     * @param pu8Source_ Pointer to a variable
+     * @param u8Expected_ Value the variable is expected to hold
+     * @param u8Val_ New value to set in the variable
+     * @return true - variable held the expected value, and was updated.  false - the
+     *         variable held a different value, and was left unmodified.
+     */
+    bool CompareAndSwap(volatile uint8_t* pu8Source_, uint8_t u8Expected_, uint8_t u8Val_);
+    bool CompareAndSwap(volatile uint16_t* pu16Source_, uint16_t u16Expected_, uint16_t u16Val_);
+    bool CompareAndSwap(volatile uint32_t* pu32Source_, uint32_t u32Expected_, uint32_t u32Val_);
 } // namespace Atomic
 } // namespace Mark3
@@ -50,6 +50,7 @@ See license.txt for more information
 
 #include "ll.h"
 #include "threadlist.h"
+#include "timer.h"
 
 namespace Mark3
 {
@@ -59,6 +60,9 @@ namespace Mark3
 #define BLOCKING_INIT_COOKIE (0xC3)
 
 class Thread;
+#if KERNEL_WAIT_SETS
+class WaitSet;
+#endif // #if KERNEL_WAIT_SETS
 
 //---------------------------------------------------------------------------
 /**
@@ -69,7 +73,13 @@ class Thread;
 class BlockingObject
 {
 public:
-    BlockingObject() { m_u8Initialized = BLOCKING_INVALID_COOKIE; }
+    BlockingObject()
+    {
+        m_u8Initialized = BLOCKING_INVALID_COOKIE;
+#if KERNEL_WAIT_SETS
+        m_pclWaitSet = nullptr;
+#endif // #if KERNEL_WAIT_SETS
+    }
     ~BlockingObject() { m_u8Initialized = BLOCKING_INVALID_COOKIE; }
 
 protected:
@@ -118,6 +128,31 @@ protected:
      */
     void UnBlock(Thread* pclThread_);
 
+    /**
+     *  @brief ArmTimeout
+     *
+     *  Start a timeout on the calling thread's embedded timer, prior to
+     *  blocking it on this object.  The thread's expired flag is cleared, and
+     *  the callback is invoked with the thread as its owner and this object as
+     *  its data if the timeout elapses before the thread is woken.  No timer
+     *  object is constructed or initialized in the process.
+     *
+     *  @param u32WaitTimeMS_ Timeout in ticks
+     *  @param pfCallback_    Callback that wakes the thread on timeout
+     */
+    void ArmTimeout(uint32_t u32WaitTimeMS_, TimerCallback pfCallback_);
+
+    /**
+     *  @brief DisarmTimeout
+     *
+     *  Cancel a timeout previously armed with ArmTimeout(), once the calling
+     *  thread has been woken.
+     *
+     *  @return true if the thread was woken before the timeout elapsed, false
+     *          if it was woken by the timeout.
+     */
+    bool DisarmTimeout();
+
     /**
      * @brief SetInitialized
      */
@@ -129,6 +164,18 @@ protected:
      */
     bool IsInitialized(void) { return (m_u8Initialized == BLOCKING_INIT_COOKIE); }
 
+#if KERNEL_WAIT_SETS
+    /**
+     *  @brief SignalWaitSet
+     *
+     *  Signal the wait set this object belongs to (if any) that the object may
+     *  have become ready.  Must be called outside of a critical section.
+     */
+    void SignalWaitSet();
+
+    friend class WaitSet;
+#endif // #if KERNEL_WAIT_SETS
+
     /**
      *  ThreadList which is used to hold the list of threads blocked
      *  on a given object.
@@ -140,5 +187,13 @@ protected:
      * prior to use.
      */
     uint8_t m_u8Initialized;
+
+#if KERNEL_WAIT_SETS
+    //! Index of this object in its wait set
+    uint8_t m_u8WaitSetIndex;
+
+    //! Wait set this object belongs to, or nullptr
+    WaitSet* m_pclWaitSet;
+#endif // #if KERNEL_WAIT_SETS
 };
 } // namespace Mark3
@@ -0,0 +1,179 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   cpubudget.h
+
+    @brief  CPU budget reservations - bounded bandwidth for aperiodic threads
+
+*/
+
+#pragma once
+
+#include "mark3cfg.h"
+#include "timer.h"
+
+#if KERNEL_CPU_BUDGETS
+#if KERNEL_TIMERS_TICKLESS || KERNEL_SMP
+#error "KERNEL_CPU_BUDGETS requires a periodic kernel tick, and does not support KERNEL_SMP"
+#endif // #if KERNEL_TIMERS_TICKLESS || KERNEL_SMP
+
+namespace Mark3
+{
+class Thread;
+
+/**
+ * @brief The CpuBudget class reserves a share of the CPU for a thread - an
+ * execution budget per replenishment period - and enforces it, so that a
+ * high-priority thread doing aperiodic work cannot starve the threads below
+ * it, however much work it is given.
+ *
+ * The budget is managed as a sporadic server with a single pending
+ * replenishment.  The thread is charged for each kernel tick during which
+ * it was running, and the first charge after a replenishment opens a new
+ * window; the whole budget is replenished one period after the window
+ * opened.  A thread that exhausts its budget within a window is demoted to
+ * a background priority - where it only gets time no other thread wants,
+ * and is not charged - until the replenishment restores its own priority.
+ * Each exhaustion is counted as an overrun.
+ *
+ * Time is charged by sampling the running thread on each tick, so budgets
+ * are only as precise as the kernel tick.
+ */
+class CpuBudget
+{
+public:
+    void* operator new(size_t sz, void* pv) { return (CpuBudget*)pv; };
+    ~CpuBudget();
+
+    /**
+     *  @brief Init
+     *
+     *  Initialize the budget object prior to use.
+     */
+    void Init(void);
+
+    /**
+     *  @brief Start
+     *
+     *  Attach the budget to a thread, and start enforcing it with a full
+     *  budget.  A thread can only have one budget attached at a time.
+     *
+     *  @param pclThread_ Thread to which the budget applies
+     *  @param u32BudgetMs_ Execution time the thread may use per period (in ms)
+     *  @param u32PeriodMs_ Replenishment period (in ms) - at least the budget
+     *  @param uXBackgroundPriority_ Priority at which the thread runs while
+     *                               its budget is exhausted - lower than its
+     *                               own priority
+     */
+    void Start(Thread* pclThread_, uint32_t u32BudgetMs_, uint32_t u32PeriodMs_, PORT_PRIO_TYPE uXBackgroundPriority_);
+
+    /**
+     *  @brief Stop
+     *
+     *  Stop enforcing the budget, and detach it from its thread.  A thread
+     *  that has been demoted gets its own priority back.  Called
+     *  automatically when the thread exits.
+     */
+    void Stop(void);
+
+    /**
+     *  @brief GetRemaining
+     *
+     *  @return Execution time left in the current window (in ms)
+     */
+    uint32_t GetRemaining(void) { return m_u32Budget - m_u32Used; }
+
+    /**
+     *  @brief GetOverruns
+     *
+     *  @return Number of times the thread has exhausted its budget
+     */
+    uint32_t GetOverruns(void) { return m_u32Overruns; }
+
+    /**
+     *  @brief IsDepleted
+     *
+     *  @return true if the thread is running at its background priority,
+     *          waiting for its budget to be replenished
+     */
+    bool IsDepleted(void) { return m_bDepleted; }
+
+    /**
+     *  @brief GetThread
+     *
+     *  @return Thread to which the budget is attached, or nullptr
+     */
+    Thread* GetThread(void) { return m_pclThread; }
+
+    /**
+     *  @brief Replenish
+     *
+     *  Restore the full budget, and the thread's own priority if it had
+     *  been demoted.  Note that this is only public in order to be
+     *  accessible from a timer callback.
+     */
+    void Replenish(void);
+
+    /**
+     *  @brief Tick
+     *
+     *  Charge the running thread for elapsed kernel ticks, if it has a
+     *  budget.  Called by the kernel on each tick.
+     *
+     *  @param u32Ticks_ Number of ticks that have elapsed
+     */
+    static void Tick(uint32_t u32Ticks_);
+
+private:
+    /**
+     *  @brief Charge
+     *
+     *  Charge the thread for time it has spent running, opening a window if
+     *  one is not open already, and demoting the thread if it has exhausted
+     *  its budget.
+     *
+     *  @param u32Ticks_ Number of ticks to charge
+     */
+    void Charge(uint32_t u32Ticks_);
+
+    //! Timer used to replenish the budget at the end of each window
+    Timer m_clTimer;
+
+    //! Thread to which the budget is attached
+    Thread* m_pclThread;
+
+    //! Execution time allowed per period (in ms)
+    uint32_t m_u32Budget;
+
+    //! Replenishment period (in ms)
+    uint32_t m_u32Period;
+
+    //! Execution time used in the current window (in ms)
+    uint32_t m_u32Used;
+
+    //! Number of times the budget has been exhausted
+    uint32_t m_u32Overruns;
+
+    //! The thread's own priority, restored by replenishment
+    PORT_PRIO_TYPE m_uXPriority;
+
+    //! Priority at which the thread runs while its budget is exhausted
+    PORT_PRIO_TYPE m_uXBackgroundPriority;
+
+    //! Whether the thread has been demoted to its background priority
+    bool m_bDepleted;
+};
+} // namespace Mark3
+#endif // #if KERNEL_CPU_BUDGETS
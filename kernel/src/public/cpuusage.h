@@ -0,0 +1,132 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   cpuusage.h
+
+    @brief  Per-thread CPU time accounting
+
+ */
+
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#include "thread.h"
+
+#if KERNEL_CPU_ACCOUNTING
+namespace Mark3
+{
+/**
+ *  Static-class used to account for the CPU time consumed by each thread.
+ *
+ *  Time is measured in counts of the port's cycle counter where one exists
+ *  (PORT_CYCLE_COUNTER - the DWT cycle counter on Cortex-M3/M4F), and in
+ *  counts of the profiling timer otherwise.  At each context switch, the time
+ *  elapsed since the previous switch is charged to the outgoing thread, and
+ *  to the idle counter if that thread was running at priority 0.  Time spent
+ *  in interrupts is charged to the thread that was interrupted.
+ *
+ *  All counters are accumulated over an accounting window, which begins when
+ *  the kernel is started, and again whenever Reset() is called.  The counter
+ *  only needs to be sampled (by a context switch, or a call to Sample())
+ *  at least once per counter wrap - roughly 25s for a 32-bit cycle counter
+ *  at 168MHz.
+ */
+class CpuUsage
+{
+public:
+    /**
+     *  @brief Start
+     *
+     *  Start the counter used for accounting, and begin the first accounting
+     *  window.  Called by the kernel once the port has started its timers.
+     */
+    static void Start();
+
+    /**
+     *  @brief Update
+     *
+     *  Charge the time elapsed since the last update to the running thread.
+     *  Called by the kernel on each context switch.
+     */
+    static void Update();
+
+    /**
+     *  @brief Sample
+     *
+     *  Bring the counters up to date, charging the running thread for the
+     *  time it has spent running so far.  For a consistent snapshot of several
+     *  threads, call this and read the counters with the scheduler disabled.
+     *
+     *  @return Length of the current accounting window, in counts
+     */
+    static uint64_t Sample();
+
+    /**
+     *  @brief Reset
+     *
+     *  Begin a new accounting window, zeroing the idle counter and the run
+     *  time of every thread.  Each thread's counter is zeroed lazily, the
+     *  next time it is read or charged.
+     */
+    static void Reset();
+
+    /**
+     *  @brief GetIdleCycles
+     *
+     *  @return Counts spent running priority-0 threads in the current window,
+     *          as of the last update.
+     */
+    static uint64_t GetIdleCycles() { return m_u64IdleCycles; }
+
+    /**
+     *  @brief GetLoad
+     *
+     *  Compute a share of an accounting window, such as the share of the
+     *  window used by a thread (Thread::GetRunCycles()) or by the idle threads.
+     *
+     *  @param u64Cycles_ Counts used
+     *  @param u64Window_ Length of the window, as returned by Sample()
+     *  @return Share of the window used, in hundredths of a percent (0-10000)
+     */
+    static uint16_t GetLoad(uint64_t u64Cycles_, uint64_t u64Window_);
+
+    /**
+     *  @brief GetCpuLoad
+     *
+     *  Sample the counters and compute the share of the current window that
+     *  was not spent running priority-0 threads.
+     *
+     *  @return CPU load, in hundredths of a percent (0-10000)
+     */
+    static uint16_t GetCpuLoad();
+
+    /**
+     *  @brief GetWindow
+     *
+     *  @return Index of the current accounting window, used to zero each
+     *          thread's counter lazily after a Reset().
+     */
+    static uint32_t GetWindow() { return m_u32Window; }
+
+private:
+    static uint64_t m_u64WindowCycles; //!< Length of the current window, as of the last update
+    static uint64_t m_u64IdleCycles;   //!< Counts charged to priority-0 threads in the current window
+    static uint32_t m_u32LastCount;    //!< Counter value at the last update
+    static uint32_t m_u32Window;       //!< Index of the current accounting window
+};
+} // namespace Mark3
+#endif // #if KERNEL_CPU_ACCOUNTING
@@ -72,6 +72,16 @@ public:
      */
     uint16_t Wait(uint16_t u16Mask_, EventFlagOperation eMode_, uint32_t u32TimeMS_);
 
+    /**
+     * @brief TryWait - Check the flags in this event flag group against a mask, without blocking.
+     *                  For the "clear" operations, matching flags are consumed as they would be by Wait().
+     * @param u16Mask_ - 16-bit bitmask to check
+     * @param eMode_ - EventFlagOperation::Any_Set:  Match any of the bits in the mask
+     *               - EventFlagOperation::All_Set:  Match all of the bits in the mask
+     * @return Bitmask condition that matched, or 0 if the condition is not currently met
+     */
+    uint16_t TryWait(uint16_t u16Mask_, EventFlagOperation eMode_);
+
     /**
      * @brief WakeMe
      *
@@ -100,6 +110,10 @@ public:
      */
     uint16_t GetMask();
 
+#if KERNEL_WAIT_SETS
+    friend class WaitSet;
+#endif // #if KERNEL_WAIT_SETS
+
 private:
     /**
      * @brief Wait_i
@@ -115,6 +129,20 @@ private:
      */
     uint16_t Wait_i(uint16_t u16Mask_, EventFlagOperation eMode_, uint32_t u32TimeMS_);
 
+    /**
+     * @brief Match_i
+     *
+     * Internal abstraction which tests the current flags against a mask/mode, consuming
+     * the matched flags for the "clear" operations.  Must be called from a critical section.
+     *
+     * @param u16Mask_ - 16-bit bitmask to test
+     * @param eMode_ - Operation to test the mask with
+     * @param pu16Match_ - [out] Bitmask condition that matched
+     *
+     * @return true if the condition was met, false otherwise
+     */
+    bool Match_i(uint16_t u16Mask_, EventFlagOperation eMode_, uint16_t* pu16Match_);
+
     uint16_t m_u16SetMask; //!< Event flags currently set in this object
 };
 } // namespace Mark3
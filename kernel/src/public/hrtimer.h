@@ -0,0 +1,255 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   hrtimer.h
+
+    @brief  High-resolution timer class declarations
+*/
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#include "ll.h"
+
+#if KERNEL_HRTIMERS
+#if !PORT_HRTIMERS
+#error "KERNEL_HRTIMERS is not supported by this port"
+#endif // #if !PORT_HRTIMERS
+
+namespace Mark3
+{
+class HRTimer;
+
+//---------------------------------------------------------------------------
+/**
+ * This type defines the callback function type for high-resolution timer
+ * events.  These are always called from the high-resolution timer's interrupt.
+ *
+ * pclTimer_ is a pointer to the timer that expired
+ * pvData_ is a pointer to the data passed in when the timer was started
+ */
+using HRTimerCallback = void (*)(HRTimer* pclTimer_, void* pvData_);
+
+//---------------------------------------------------------------------------
+/**
+ * @brief High-resolution software timers.
+ *
+ * Timers scheduled against a free-running hardware counter with a compare
+ * interrupt, rather than the kernel tick.  Intervals are expressed in counts
+ * of the port's high-resolution clock (PORT_HRTIMER_FREQ), allowing timers
+ * far shorter than a kernel tick, with no tick-related jitter.
+ *
+ * Callbacks are run directly from the compare interrupt, so must be kept
+ * short, and may only use the kernel APIs that are safe from an interrupt.
+ * High-resolution timers are managed independently of the kernel's
+ * TimerScheduler, and are not affected by its configuration.
+ */
+class HRTimer : public LinkListNode
+{
+public:
+    void* operator new(size_t sz, void* pv) { return (HRTimer*)pv; }
+    ~HRTimer() {}
+
+    /**
+     *  @brief HRTimer
+     *
+     *  Default Constructor - Mark the timer as inactive.  Allow the init
+     *  call to perform the necessary object initialization prior to use.
+     */
+    HRTimer();
+
+    /**
+     *  @brief Init
+     *
+     *  Re-initialize the timer to default values.  Must not be called while
+     *  the timer is active.
+     */
+    void Init();
+
+    /**
+     *  @brief Start
+     *
+     *  Start the timer.  Has no effect if the timer is already active.
+     *
+     *  @param bRepeat_ 0 - timer is one-shot.  1 - timer is repeating.
+     *  @param u32Interval_ Interval of the timer, in high-resolution clock
+     *                      counts (see UsToCounts()).  Must be less than
+     *                      2^31 counts.
+     *  @param pfCallback_ Function to call on timer expiry
+     *  @param pvData_ Data to pass into the callback function
+     */
+    void Start(bool bRepeat_, uint32_t u32Interval_, HRTimerCallback pfCallback_, void* pvData_);
+
+    /**
+     *  @brief Stop
+     *
+     *  Stop a timer already in progress.  Has no effect on timers that have
+     *  already been stopped.  May be called from the timer's own callback.
+     */
+    void Stop();
+
+    /**
+     *  @brief IsActive
+     *
+     *  @return true if the timer is running, false otherwise
+     */
+    bool IsActive() { return m_bActive; }
+
+    /**
+     *  @brief UsToCounts
+     *
+     *  Convert a number of microseconds to high-resolution clock counts.
+     *
+     *  @param u32Us_ Interval in microseconds
+     *  @return Interval in high-resolution clock counts
+     */
+    static uint32_t UsToCounts(uint32_t u32Us_)
+    {
+        return static_cast<uint32_t>((static_cast<uint64_t>(u32Us_) * PORT_HRTIMER_FREQ) / 1000000ULL);
+    }
+
+    /**
+     *  @brief GetCount
+     *
+     *  Return the current value of the port's free-running high-resolution
+     *  counter.
+     *
+     *  @return Current high-resolution clock count
+     */
+    static uint32_t GetCount();
+
+    /**
+     *  @brief GetCount64
+     *
+     *  Return the current value of the high-resolution counter, extended to
+     *  64 bits so that it never wraps in practice.  The extension is kept up
+     *  to date by an internal timer, which expires at least twice per wrap of
+     *  the hardware counter.
+     *
+     *  @return Current high-resolution clock count
+     */
+    static uint64_t GetCount64();
+
+private:
+    friend class HRTimerScheduler;
+
+    //! Absolute high-resolution count at which the timer next expires
+    uint32_t m_u32Deadline;
+    //! Interval of the timer in high-resolution clock counts
+    uint32_t m_u32Interval;
+    //! Pointer to the callback function
+    HRTimerCallback m_pfCallback;
+    //! Pointer to the callback data
+    void* m_pvData;
+    //! Whether the timer re-arms itself on expiry
+    bool m_bRepeat;
+    //! Whether the timer is running
+    bool m_bActive;
+    //! Whether the timer has been taken off the list to run its callback
+    bool m_bInCallback;
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief Static class managing the list of active high-resolution timers.
+ *
+ * Timers are held in order of expiry, and the port's compare interrupt is
+ * programmed for the timer at the head of the list.
+ */
+class HRTimerScheduler
+{
+public:
+    /**
+     *  @brief Init
+     *
+     *  Initialize the high-resolution timer list, and start the port's
+     *  free-running counter.
+     */
+    static void Init();
+
+    /**
+     *  @brief Add
+     *
+     *  Add a timer to the list, to expire one interval from now.
+     *
+     *  @param pclTimer_ Pointer to the timer to add
+     */
+    static void Add(HRTimer* pclTimer_);
+
+    /**
+     *  @brief Remove
+     *
+     *  Remove a timer from the list.
+     *
+     *  @param pclTimer_ Pointer to the timer to remove
+     */
+    static void Remove(HRTimer* pclTimer_);
+
+    /**
+     *  @brief Process
+     *
+     *  Run the callbacks of all timers that have expired, and program the
+     *  compare interrupt for the next one.  Called from the port's
+     *  high-resolution timer interrupt.
+     */
+    static void Process();
+
+private:
+    /**
+     *  @brief Insert
+     *
+     *  Insert a timer into the list, in order of its deadline.
+     *
+     *  @param pclTimer_ Pointer to the timer to insert
+     */
+    static void Insert(HRTimer* pclTimer_);
+
+    /**
+     *  @brief SetAlarm
+     *
+     *  Program the compare interrupt for the timer at the head of the list,
+     *  or disable it if the list is empty.
+     */
+    static void SetAlarm();
+
+    /**
+     *  @brief Extend
+     *
+     *  Extend a reading of the hardware counter to 64 bits, accounting for
+     *  any wrap since the last reading.  Must be called with interrupts
+     *  disabled, at least once per wrap of the hardware counter.
+     *
+     *  @param u32Count_ Current hardware counter value
+     *  @return 64-bit count
+     */
+    static uint64_t Extend(uint32_t u32Count_);
+
+    //! List of active timers, in order of expiry
+    static DoubleLinkList m_clList;
+
+    //! Timer used to keep the 64-bit count extension current
+    static HRTimer m_clWrapTimer;
+
+    //! Upper 32 bits of the extended count
+    static uint32_t m_u32CountHigh;
+
+    //! Hardware counter value at the last reading
+    static uint32_t m_u32LastCount;
+
+    friend class HRTimer;
+};
+} // namespace Mark3
+#endif // #if KERNEL_HRTIMERS
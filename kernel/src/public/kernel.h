@@ -210,8 +210,37 @@ public:
     static uint16_t GetStackGuardThreshold() { return m_u16GuardThreshold; }
 #endif // #if KERNEL_STACK_CHECK
 
-    static void Tick() { m_u32Ticks++; }
-    static uint32_t GetTicks();
+    /**
+     * @brief Tick
+     *
+     * Advance the kernel's tick count.  Called from the port's kernel timer.
+     *
+     * @param u32Ticks_ Number of ticks that have elapsed
+     */
+    static void Tick(uint32_t u32Ticks_ = 1);
+
+    /**
+     * @brief GetTicks
+     *
+     * Return the number of kernel timer ticks that have elapsed since the
+     * kernel timer was started.  The count wraps after 2^32 ticks - use the
+     * helpers in ktime.h to compare tick values, or GetTicks64().
+     *
+     * @return Current kernel tick count
+     */
+    static uint32_t GetTicks() { return static_cast<uint32_t>(GetTicks64()); }
+
+    /**
+     * @brief GetTicks64
+     *
+     * Return the number of kernel timer ticks that have elapsed since the
+     * kernel timer was started, as a 64-bit count that will never wrap in
+     * practice.  With a periodic kernel timer, the count is read without
+     * disabling interrupts.
+     *
+     * @return Current kernel tick count
+     */
+    static uint64_t GetTicks64();
 
 private:
     static bool      m_bIsStarted; //!< true if kernel is running, false otherwise
@@ -231,7 +260,8 @@ private:
 #if KERNEL_STACK_CHECK
     static uint16_t m_u16GuardThreshold;
 #endif // #if KERNEL_STACK_CHECK
-    static uint32_t m_u32Ticks;
+    static volatile uint64_t m_u64Ticks;   //!< Kernel tick count
+    static volatile uint32_t m_u32TickSeq; //!< Odd while m_u64Ticks is being updated
 };
 
 } // namespace Mark3
@@ -55,6 +55,17 @@ enum class EventFlagOperation : uint8_t {
     Pending_Unblock //!< Special code.  Not used by user
 };
 
+//---------------------------------------------------------------------------
+/**
+ * This enumeration describes how Thread::Notify() updates the notification
+ * word of the thread being notified.
+ */
+enum class NotifyAction : uint8_t {
+    SetBits = 0, //!< Set the specified bits in the notification word
+    Increment,   //!< Increment the notification word, treating it as a count
+    Overwrite    //!< Replace the notification word with the specified value
+};
+
 //---------------------------------------------------------------------------
 /**
  *   Enumeration representing the different states a thread can exist in
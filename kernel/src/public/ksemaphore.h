@@ -99,6 +99,17 @@ public:
      */
     uint16_t GetCount();
 
+    /**
+     *  @brief
+     *
+     *  Decrement the semaphore count if it is non-zero, without ever
+     *  blocking the caller.  Safe to call from interrupt context.
+     *
+     *  @return true - the semaphore was claimed
+     *          false - the count was zero, nothing was claimed
+     */
+    bool TryPend();
+
     /**
      *  @brief
      *
@@ -124,6 +135,10 @@ public:
      */
     void WakeMe(Thread* pclChosenOne_);
 
+#if KERNEL_WAIT_SETS
+    friend class WaitSet;
+#endif // #if KERNEL_WAIT_SETS
+
 private:
     /**
      *  @brief
@@ -142,7 +157,7 @@ private:
      */
     bool Pend_i(uint32_t u32WaitTimeMS_);
 
-    uint16_t m_u16Value;    //!< Current count held by the semaphore
-    uint16_t m_u16MaxValue; //!< Maximum count that can be held by this semaphore
+    volatile uint16_t m_u16Value;    //!< Current count held by the semaphore
+    uint16_t          m_u16MaxValue; //!< Maximum count that can be held by this semaphore
 };
 } // namespace Mark3
@@ -0,0 +1,131 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   ktime.h
+
+    @brief  Wrap-safe time and deadline comparison helpers
+
+    Tick counts and hardware counter values wrap around once they overflow
+    their type.  Comparing them directly gives the wrong answer across a wrap,
+    so the helpers here compare the signed difference between two values
+    instead - which is correct so long as the values being compared are within
+    half of the counter's range of each other.
+*/
+#pragma once
+
+#include "kerneltypes.h"
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+/**
+ *  @brief TimeAfter
+ *
+ *  @param u32A_ Time to compare
+ *  @param u32B_ Time to compare against
+ *  @return true if u32A_ is strictly later than u32B_
+ */
+inline bool TimeAfter(uint32_t u32A_, uint32_t u32B_)
+{
+    return (static_cast<int32_t>(u32B_ - u32A_) < 0);
+}
+
+/**
+ *  @brief TimeAfter
+ *
+ *  @param u64A_ Time to compare
+ *  @param u64B_ Time to compare against
+ *  @return true if u64A_ is strictly later than u64B_
+ */
+inline bool TimeAfter(uint64_t u64A_, uint64_t u64B_)
+{
+    return (static_cast<int64_t>(u64B_ - u64A_) < 0);
+}
+
+//---------------------------------------------------------------------------
+/**
+ *  @brief TimeBefore
+ *
+ *  @param u32A_ Time to compare
+ *  @param u32B_ Time to compare against
+ *  @return true if u32A_ is strictly earlier than u32B_
+ */
+inline bool TimeBefore(uint32_t u32A_, uint32_t u32B_)
+{
+    return TimeAfter(u32B_, u32A_);
+}
+
+/**
+ *  @brief TimeBefore
+ *
+ *  @param u64A_ Time to compare
+ *  @param u64B_ Time to compare against
+ *  @return true if u64A_ is strictly earlier than u64B_
+ */
+inline bool TimeBefore(uint64_t u64A_, uint64_t u64B_)
+{
+    return TimeAfter(u64B_, u64A_);
+}
+
+//---------------------------------------------------------------------------
+/**
+ *  @brief DeadlineReached
+ *
+ *  @param u32Deadline_ Deadline to check
+ *  @param u32Now_ Current time
+ *  @return true if the deadline is at or before the current time
+ */
+inline bool DeadlineReached(uint32_t u32Deadline_, uint32_t u32Now_)
+{
+    return !TimeAfter(u32Deadline_, u32Now_);
+}
+
+/**
+ *  @brief DeadlineReached
+ *
+ *  @param u64Deadline_ Deadline to check
+ *  @param u64Now_ Current time
+ *  @return true if the deadline is at or before the current time
+ */
+inline bool DeadlineReached(uint64_t u64Deadline_, uint64_t u64Now_)
+{
+    return !TimeAfter(u64Deadline_, u64Now_);
+}
+
+//---------------------------------------------------------------------------
+/**
+ *  @brief TimeUntil
+ *
+ *  @param u32Deadline_ Deadline to check
+ *  @param u32Now_ Current time
+ *  @return Time remaining until the deadline, or 0 if it has been reached
+ */
+inline uint32_t TimeUntil(uint32_t u32Deadline_, uint32_t u32Now_)
+{
+    return DeadlineReached(u32Deadline_, u32Now_) ? 0 : (u32Deadline_ - u32Now_);
+}
+
+/**
+ *  @brief TimeUntil
+ *
+ *  @param u64Deadline_ Deadline to check
+ *  @param u64Now_ Current time
+ *  @return Time remaining until the deadline, or 0 if it has been reached
+ */
+inline uint64_t TimeUntil(uint64_t u64Deadline_, uint64_t u64Now_)
+{
+    return DeadlineReached(u64Deadline_, u64Now_) ? 0 : (u64Deadline_ - u64Now_);
+}
+} // namespace Mark3
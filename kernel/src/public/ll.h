@@ -172,6 +172,17 @@ public:
      *  @param node_ Pointer to the node to remove
      */
     void Remove(LinkListNode* node_);
+
+    /**
+     * @brief InsertNodeBefore
+     *
+     * Insert a linked-list node into the list before the specified insertion
+     * point, which must already be a member of this list.
+     *
+     * @param node_     Node to insert into the list
+     * @param insert_   Insert point.
+     */
+    void InsertNodeBefore(LinkListNode* node_, LinkListNode* insert_);
 };
 
 //---------------------------------------------------------------------------
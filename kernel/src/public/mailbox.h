@@ -176,6 +176,30 @@ public:
      */
     bool ReceiveTail(void* pvData_, uint32_t u32TimeoutMS_);
 
+    /**
+     * @brief TryReceive
+     *
+     * Read one envelope from the head of the mailbox if one is available.  The
+     * calling thread never blocks.
+     *
+     * @param pvData_ Pointer to a buffer that will have the envelope's contents
+     *                copied into upon delivery.
+     * @return true - envelope was delivered, false - mailbox was empty.
+     */
+    bool TryReceive(void* pvData_);
+
+    /**
+     * @brief TryReceiveTail
+     *
+     * Read one envelope from the tail of the mailbox if one is available.  The
+     * calling thread never blocks.
+     *
+     * @param pvData_ Pointer to a buffer that will have the envelope's contents
+     *                copied into upon delivery.
+     * @return true - envelope was delivered, false - mailbox was empty.
+     */
+    bool TryReceiveTail(void* pvData_);
+
     uint16_t GetFreeSlots(void)
     {
         uint16_t rc;
@@ -188,6 +212,10 @@ public:
     bool IsFull(void) { return (GetFreeSlots() == 0); }
     bool IsEmpty(void) { return (GetFreeSlots() == m_u16Count); }
 
+#if KERNEL_WAIT_SETS
+    friend class WaitSet;
+#endif // #if KERNEL_WAIT_SETS
+
 private:
     /**
      * @brief GetHeadPointer
@@ -311,6 +339,17 @@ private:
      */
     bool Receive_i(const void* pvData_, bool bTail_, uint32_t u32WaitTimeMS_);
 
+    /**
+     * @brief Dequeue_i
+     *
+     * Internal method which copies out an envelope once the caller has claimed
+     * it from the receive semaphore, and releases its slot to senders.
+     *
+     * @param pvData_       Pointer to the envelope data
+     * @param bTail_        true - read from tail, false - read from head
+     */
+    void Dequeue_i(const void* pvData_, bool bTail_);
+
     uint16_t m_u16Head; //!< Current head index
     uint16_t m_u16Tail; //!< Current tail index
 
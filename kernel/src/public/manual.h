@@ -145,10 +145,15 @@ See license.txt for more information
     in detecting stack overflows / near overflows.  Near-overflow detection uses
     thresholds defined in the target's portcfg.h.  Enabling this also adds the
     Thread::GetStackSlack() method, which allows a thread's stack to be profiled
-    on-demand.
+    on-demand, and Thread::GetStackHighWater(), which reports the deepest stack
+    use observed so far.
 
-    Note:  When enabled, the additional stack checks result in a performance hit
-    to context switches and thread initialization.
+    Note:  The per-switch check tests a canary word at the guard threshold and
+    advances an incremental high-water mark, so its cost does not grow with the
+    stack size.  Thread initialization still paints the whole stack.  On the
+    Cortex-M3/M4F ports, PORT_STACK_GUARD_MPU additionally places an MPU
+    no-access region at the bottom of the running thread's stack, so an overflow
+    faults immediately rather than on the next context switch.
 
     <b>KERNEL_NAMED_THREADS</b>
 
@@ -167,6 +172,14 @@ See license.txt for more information
     While other synchronization objects are enabled by default, this one is configurable
     because it impacts the Thread object's member data.
 
+    <b>KERNEL_THREAD_NOTIFY</b>
+
+    Give each thread a 32-bit notification word.  Thread::Notify() sets bits in,
+    increments, or overwrites the word of a given thread - from a thread or an
+    interrupt - and Thread::WaitNotification() blocks the calling thread until
+    any of a set of bits is set in its own word.  This provides direct
+    thread signalling without a Semaphore or EventFlag object.
+
     <b>KERNEL_CONTEXT_SWITCH_CALLOUT</b>
 
     When enabled, this feature allows a user to define a callback to be executed
@@ -197,6 +210,58 @@ See license.txt for more information
     additional context to a thread.  Typically this would be used to implement
     thread-local-storage.
 
+    <b>KERNEL_TIMERS_THREADED</b>
+
+    Process timer expiries from the kernel timer thread (the default).  When
+    disabled, expiries are processed directly from the kernel timer interrupt,
+    which saves two context switches per tick, as well as the timer thread and
+    its stack.  In that case, all timer callbacks run in
+    interrupt context.
+
+    <b>KERNEL_HRTIMERS</b>
+
+    Provide high-resolution timers (HRTimer), which are scheduled against a
+    free-running hardware counter with a compare interrupt, rather than the
+    kernel tick.  Intervals are expressed in counts of the port's
+    high-resolution clock (PORT_HRTIMER_FREQ), and callbacks run from the
+    compare interrupt.  Requires port support (PORT_HRTIMERS).
+
+    <b>KERNEL_EDF</b>
+
+    Provide an earliest-deadline-first scheduling class at KERNEL_EDF_PRIORITY.
+    Threads at that priority which declare a deadline with Thread::SetDeadline()
+    are run in order of their absolute deadlines instead of round-robin, and
+    are subject to utilization-based admission control.
+
+    <b>KERNEL_CPU_ACCOUNTING</b>
+
+    Account for the CPU time used by each thread, and for the time spent in
+    idle (priority 0) threads.  At each context switch, the time since the last
+    switch is charged to the outgoing thread, using the DWT cycle counter on
+    ports that provide one (PORT_CYCLE_COUNTER), and the profiling timer on all
+    others.  CpuUsage::Sample() and Thread::GetRunCycles() give a snapshot of
+    the counters, CpuUsage::Reset() begins a new measurement window, and
+    CpuUsage::GetLoad() and CpuUsage::GetCpuLoad() convert counts to load in
+    hundredths of a percent.
+
+    <b>KERNEL_CPU_BUDGETS</b>
+
+    Allow a thread to be given a CPU budget reservation, using a CpuBudget
+    object.  The time a thread runs is charged against its budget at each
+    kernel tick; once the budget is used up, the thread is demoted to a
+    background priority until the budget is replenished, one period after the
+    thread first ran.  CpuBudget::GetOverruns() reports how often that happened.
+    Not available with KERNEL_TICKLESS or KERNEL_SMP.
+
+    <b>KERNEL_WAIT_SETS</b>
+
+    Allow a thread to block on a set of Semaphore, MessageQueue, Mailbox,
+    EventFlag and Notify objects at once, using a WaitSet object.  Each object
+    in a set signals it directly when it becomes ready, waking the waiting
+    thread, and WaitSet::Wait() returns the index of the ready object so that
+    the caller can service it.  The number of objects in a set is limited by
+    KERNEL_WAIT_SET_SIZE.
+
     @subsection CONFIG_PORTCFG Port Configuration Options
 
     The bulk of kernel configuration options reside in the target's portcfg.h file.
@@ -639,6 +704,29 @@ See license.txt for more information
     intermediate priorities cannot artificically prevent progress from being
     made.
 
+    Inheritance is transitive: if the owner is itself blocked on another
+    mutex, the boost is passed along to that mutex's owner, and so on down
+    the chain.  When a thread holding several mutexes releases one of them,
+    its priority only drops as far as the highest priority it still inherits
+    through the others.  A waiter that times out stops boosting the owner.
+
+    For locks whose users are all known ahead of time, CeilingMutex implements
+    the immediate priority-ceiling protocol instead.  It is initialized with a
+    ceiling priority - at least that of any thread that claims it - and the
+    owner runs at the ceiling for as long as it holds the lock.  No thread that
+    could contend for the lock can run in the meantime, so claims do not
+    block, and chains of blocked owners cannot form.  The price is that the
+    owner is raised on every claim, even when there is no contention.
+
+    On ports with exclusive-access load/store instructions (PORT_ATOMIC_EXCLUSIVE,
+    LDREX/STREX on ARMv7-M), each mutex keeps a lock word recording whether it
+    is free, held, or held with threads waiting on it.  Claiming a free mutex,
+    and releasing a mutex that no thread has blocked on, only needs to update
+    that word, and does not disable the scheduler.  Semaphore Post and Pend
+    likewise adjust the count directly when no thread has to be woken or
+    blocked.  Contended operations, and CeilingMutex objects, always take the
+    regular path.
+
     Mutex objects are very easy to use, as there are only three operations
     supported: Initialize, Claim and Release. An example is shown below.
 
@@ -1144,6 +1232,68 @@ See license.txt for more information
     }
     @endcode
 
+    @subsection SLPU Periodic Threads
+
+    Thread::Sleep() is relative to the time at which it is called, so a loop
+    that performs some work and then sleeps for its period drifts later by the
+    time spent working on every iteration.  Thread::SleepUntil() instead takes
+    an absolute deadline in kernel ticks, so advancing the deadline by a fixed
+    amount on each iteration keeps the loop running at a fixed rate.
+
+    For threads that need to run at a fixed rate and detect when they fall
+    behind, the Periodic object keeps a repeating timer armed across periods
+    and releases the waiting thread at each one.  If the thread is still busy
+    when a release occurs, Periodic::Wait() returns false immediately, and the
+    missed releases are counted (see Periodic::GetOverruns()).
+
+    @code
+    Periodic clPeriodic;
+
+    void ControlLoop(void* unused_)
+    {
+        clPeriodic.Init();
+        clPeriodic.Start(5);    // Release the thread every 5ms
+        while (1) {
+            if (!clPeriodic.Wait()) {
+                // Previous iteration overran its period
+            }
+            UpdateControlLoop();
+        }
+    }
+    @endcode
+
+    @subsection SLPEDF Deadline Scheduling
+
+    With KERNEL_EDF enabled, threads at KERNEL_EDF_PRIORITY may declare a
+    relative deadline, a period, and a worst-case execution time using
+    Thread::SetDeadline().  Ready threads in that priority group are kept
+    sorted by absolute deadline, so the thread whose deadline is nearest always
+    runs first; threads at other priorities still preempt (or are preempted by)
+    the group as a whole.
+
+    A thread is only admitted if the total density of the group - the sum of
+    each thread's execution time divided by the lesser of its deadline and
+    period - does not exceed 1.  SetDeadline() returns false otherwise, and the
+    thread's timing parameters are left unchanged.
+
+    Each job's absolute deadline is computed from its release time.  A thread
+    waiting on a Periodic object has a new job released automatically at each
+    period; otherwise, call Thread::ReleaseJob() when a new job arrives.
+
+    @code
+    void ControlLoop(void* unused_)
+    {
+        // 2ms of work every 10ms, due 8ms after each release
+        Scheduler::GetCurrentThread()->SetDeadline(8, 10, 2);
+        clPeriodic.Init();
+        clPeriodic.Start(10);
+        while (1) {
+            clPeriodic.Wait();
+            UpdateControlLoop();
+        }
+    }
+    @endcode
+
     @section RR Round-Robin Quantum
 
     Threads at the same thread priority are scheduled using a round-robin
@@ -2378,8 +2528,8 @@ See license.txt for more information
     process.  While each of the Blocking types implement a different condition,
     they are effectively variations on the same theme.  Many simple Blocking
     objects are also used to build complex blocking objects - for instance, the
-    Thread Sleep mechanism is essentially a binary semaphore and a timer object,
-    while a message queue is a linked-list of message objects combined with a
+    Thread Sleep mechanism is essentially a shared block list and the thread's
+    own timer object, while a message queue is a linked-list of message objects combined with a
     semaphore.
 
     @section INSIDESCHED Inside the Mark3 Scheduler
@@ -2633,7 +2783,12 @@ See license.txt for more information
     the frequency of these interrupts wakeups, by using an optional “tolerance”
     parameter in the timer API calls.  In this way, periodic tasks that have
     less rigorous real-time constraints can all be grouped together – executing
-    as a group instead of one-after-another.
+    as a group instead of one-after-another.  A timer's tolerance is the number
+    of ticks by which its expiry may be delayed; the timer scheduler wakes up at
+    the latest point that still honours every timer's tolerance, and expires all
+    timers that are due at once.  When combined with tickless timers, this
+    directly reduces the number of CPU wakeups.  The number of expiries handled
+    this way can be read back using TimerScheduler::GetCoalescedCount().
 
     Mark3 also contains two different timer implementations that can be
     configured at build-time, each with their own advantages.
@@ -2660,14 +2815,14 @@ See license.txt for more information
 
     @subsection TICKLESSTIMERS Tickless Timers
 
-    Note:  Tickless timers are removed as of the R7 release.  The below documentation
-    is preserved for historical information only.  The reason for removing
-    tickless timers include the overhead associated with managing those timers
-    (significantly more math and management is involved).  In practice, there
-    are few scenarios where purely tickless timers add benefit - beyond the most
-    constrained devices.  Also, it is entirely possible to disable software timers
-    from the idle task when lower power/fewer interrupts are desired in most cases
-    where a tickless timer would be of value.
+    Note:  Tickless timers are an optional feature, enabled by setting
+    KERNEL_TIMERS_TICKLESS in mark3cfg.h, on ports that define
+    PORT_TIMERS_TICKLESS.  Tickless operation requires the sorted TimerList
+    backend.  Timers are still specified in ticks, and Kernel::GetTicks()
+    continues to return the number of ticks elapsed, including those that have
+    passed since the last timer interrupt.  Applications that stop the kernel
+    timer while sleeping can account for the time spent asleep by calling
+    TimerScheduler::ForceUpdate() on wakeup.
 
     ---
 
@@ -3573,6 +3728,71 @@ See license.txt for more information
     }
     @endcode
 
+    The Cortex-M3 and Cortex-M4F ports can instead implement critical sections
+    using the BASEPRI register, by setting PORT_CS_BASEPRI in portcfg.h.
+    CS_ENTER() then raises BASEPRI to PORT_CS_BASEPRI_MASK (using BASEPRI_MAX,
+    so nested critical sections never lower it), and CS_EXIT() restores the
+    previous value.  Interrupts at a higher priority than the mask are never
+    disabled by the kernel, so their latency is that of the hardware alone.
+    The price is a set of rules for the interrupts on either side of the mask:
+
+        - An ISR above the mask must not call any kernel API - no Post(),
+          Signal(), Set(), timer or thread calls - nor anything else that
+          uses CS_ENTER().  The kernel's data structures may be partway
+          through an update when it runs.
+        - Such an ISR can hand work over to the kernel by pending a
+          kernel-aware interrupt (e.g. through the NVIC's set-pending
+          registers), which will run once the critical section is left.
+        - Every ISR that does call the kernel, as well as SysTick, PendSV and
+          SVC, must be assigned a priority at or below the mask.  The kernel
+          configures its own exceptions accordingly, but application and
+          board-specific interrupts default to priority 0, the highest.
+        .
+
+    On the Cortex-M4F, the exception hardware normally reserves space for the
+    FPU registers in the exception frame of any thread that has used the FPU,
+    and the context switch saves and restores s16-s31 for each of them.
+    Setting PORT_FPU_LAZY_SWITCH in portcfg.h moves this to the kernel: the
+    FPU is only enabled while the thread whose registers it holds is running,
+    and is handed over from the UsageFault handler the first time another
+    thread executes a floating-point instruction.  Switching between threads
+    that don't use the FPU - or between one FPU thread and integer-only
+    threads - never touches the FPU registers.  Each thread that uses the FPU
+    gives up 136 bytes at the bottom of its stack to hold its registers while
+    another thread owns the FPU.  Interrupt handlers must not use the FPU in
+    this configuration.
+
+    The Cortex-A53 (AArch64) port for the Raspberry Pi 3 (qemu_raspi3) follows
+    the same structure, with the AArch64 equivalents of each block.  Threads
+    run at EL1 on SP_EL0, and exception handlers on SP_EL1, mirroring the PSP
+    and MSP.  The SVC instruction starts the kernel, the virtual generic timer
+    provides the tick, and - in the absence of anything like PendSV - a write to
+    one of core 0's local mailboxes raises the IRQ in which context switches
+    take place.  Since IRQs save the full context of the interrupted thread
+    (x0-x30, ELR and SPSR, plus the NEON registers when PORT_NEON_CONTEXT is
+    set), a context switch consists only of replacing the current thread
+    before the exception returns.  Critical sections mask IRQs through DAIF,
+    and the exclusive-access primitives use LDXR/STXR.
+
+    The same port can run the kernel on all four of the Raspberry Pi 3's cores
+    (KERNEL_SMP).  Each core has its own set of ready lists, its own current
+    and next threads, and its own idle thread, created by the kernel.  A
+    thread is assigned to a core when it is initialized - the least-loaded of
+    the cores permitted by its affinity mask (Thread::SetAffinity()), which
+    defaults to the boot core alone - and only ever runs on that core, so a
+    thread's context is never saved by one core while another restores it.
+    Every critical section also takes a kernel-wide spinlock (LDAXR/STXR,
+    waiting with WFE), so the kernel's data structures are only ever updated
+    by one core at a time.  When a core makes a thread on another core ready,
+    and that thread should preempt whatever the other core is running - or
+    stops the other core's running thread - it writes to the other core's
+    mailbox, and that core picks its next thread in the resulting IRQ.  The
+    secondary cores are released from the firmware's spin table when the
+    kernel starts.  Round-robin scheduling, EDF and CPU time accounting are
+    not available in this configuration.  The host port models the same
+    design with one host thread per core, which is how the SMP unit tests
+    (ut_smp) and the scaling benchmark (smp_profile) are run.
+
     <b>Summary</b>
 
     In this section we have investigated how the main non-portable areas of the
@@ -22,6 +22,7 @@ See license.txt for more information
 #include "mark3cfg.h"
 #include "kerneltypes.h"
 #include "kerneldebug.h"
+#include "ktime.h"
 
 #include "threadport.h"
 #include "kernelswi.h"
@@ -31,6 +32,8 @@ See license.txt for more information
 #include "kernel.h"
 #include "thread.h"
 #include "timerlist.h"
+#include "timerwheel.h"
+#include "hrtimer.h"
 
 #include "ksemaphore.h"
 #include "mutex.h"
@@ -38,12 +41,16 @@ See license.txt for more information
 #include "eventflag.h"
 #include "message.h"
 #include "notify.h"
+#include "periodic.h"
 #include "mailbox.h"
 #include "readerwriter.h"
 #include "condvar.h"
+#include "waitset.h"
 
 #include "atomic.h"
 
 #include "profile.h"
 #include "autoalloc.h"
 #include "priomap.h"
+#include "cpuusage.h"
+#include "cpubudget.h"
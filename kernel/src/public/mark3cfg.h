@@ -35,10 +35,12 @@ See license.txt for more information
  * in detecting stack overflows / near overflows.  Near-overflow detection uses
  * thresholds defined in the target's portcfg.h.  Enabling this also adds the
  * Thread::GetStackSlack() method, which allows a thread's stack to be profiled
- * on-demand.
+ * on-demand, and Thread::GetStackHighWater(), which reports the deepest stack
+ * use observed so far.
  *
- * Note:  When enabled, the additional stack checks result in a performance hit
- * to context switches and thread initialization.
+ * Note:  The per-switch check tests a canary word at the guard threshold and
+ * advances an incremental high-water mark, so its cost does not grow with the
+ * stack size.  Thread initialization still paints the whole stack.
  *
  */
 #define KERNEL_STACK_CHECK (1)
@@ -62,6 +64,18 @@ See license.txt for more information
  */
 #define KERNEL_EVENT_FLAGS (1)
 
+/**
+ * This flag gives each thread a 32-bit notification word, which can be updated
+ * from other threads or interrupts using Thread::Notify(), and waited on by
+ * the thread itself using Thread::WaitNotification().  This provides simple
+ * thread signalling without the RAM or overhead of a Semaphore or EventFlag
+ * object.
+ *
+ * Like event flags, this is configurable because it impacts the Thread
+ * object's member data.
+ */
+#define KERNEL_THREAD_NOTIFY (1)
+
 /**
  * When enabled, this feature allows a user to define a callback to be executed
  * whenever a context switch occurs.  Enabling this provides a means for a user
@@ -97,4 +111,124 @@ See license.txt for more information
  */
 #define KERNEL_EXTENDED_CONTEXT (1)
 
+/**
+ * Process timer expiries from a dedicated kernel timer thread, which is woken by
+ * the kernel timer interrupt.  Timer callbacks run in thread context.  When
+ * disabled, expiries are processed directly from the kernel timer interrupt.
+ * This saves two context switches on every tick, along with the timer thread's
+ * stack (PORT_KERNEL_TIMERS_THREAD_STACK), but all timer callbacks then run in
+ * interrupt context.  In either case, the timer scheduler's data is guarded by
+ * short critical sections.
+ */
+#define KERNEL_TIMERS_THREADED (1)
+
+/**
+ * Use a hierarchical timer wheel as the backend for the kernel's timer scheduler,
+ * instead of the default sorted timer list.  Starting and stopping a timer on the
+ * wheel are constant-time operations regardless of the number of active timers,
+ * at the cost of a fixed table of list heads (see KERNEL_TIMERS_WHEEL_BITS and
+ * KERNEL_TIMERS_WHEEL_LEVELS).  Recommended for systems with hundreds of
+ * concurrently-active timers.
+ */
+#define KERNEL_TIMERS_WHEEL (0)
+
+/**
+ * Number of slots in each level of the timer wheel, expressed as a power of two.
+ */
+#define KERNEL_TIMERS_WHEEL_BITS (6)
+
+/**
+ * Number of levels in the timer wheel.  Timers that expire further out than
+ * 2^(KERNEL_TIMERS_WHEEL_BITS * KERNEL_TIMERS_WHEEL_LEVELS) ticks are held in
+ * the top level of the wheel until they come into range.
+ */
+#define KERNEL_TIMERS_WHEEL_LEVELS (4)
+
+/**
+ * Run the kernel timer in tickless mode.  Instead of interrupting at a fixed
+ * rate, the hardware timer is programmed to expire when the next software timer
+ * is due, and the ticks that elapsed in between are accounted for on expiry (or
+ * whenever a new timer is scheduled).  When no timers are active, the timer
+ * thread is not woken at all - the hardware timer only interrupts when its
+ * counter needs to wrap.  Kernel::GetTicks() remains accurate throughout.
+ *
+ * Requires port support (PORT_TIMERS_TICKLESS), and the TimerList backend.
+ */
+#define KERNEL_TIMERS_TICKLESS (0)
+
+/**
+ * Provide high-resolution timers (HRTimer), which run from a free-running
+ * hardware counter and a compare interrupt rather than the kernel tick, giving
+ * sub-tick resolution (see PORT_HRTIMER_FREQ).  High-resolution timer callbacks
+ * are run directly from the compare interrupt.  These timers are independent of,
+ * and coexist with, the kernel's TimerScheduler.
+ *
+ * Requires port support (PORT_HRTIMERS).
+ */
+#define KERNEL_HRTIMERS (0)
+
+/**
+ * Provide an earliest-deadline-first scheduling class.  Threads at priority
+ * KERNEL_EDF_PRIORITY which declare a relative deadline (Thread::SetDeadline())
+ * are run in order of their absolute deadlines, rather than round-robin.
+ * Threads at other priorities are scheduled by fixed priority as usual, and
+ * preempt (or are preempted by) the EDF threads as a group.  The total
+ * utilization of the EDF threads is tracked, and threads which would overload
+ * the band are refused admission.
+ */
+#define KERNEL_EDF (0)
+
+/**
+ * Priority level occupied by earliest-deadline-first threads.
+ */
+#define KERNEL_EDF_PRIORITY (KERNEL_NUM_PRIORITIES - 2)
+
+/**
+ * Account for the CPU time used by each thread (Thread::GetRunCycles()), and
+ * for the time spent running idle (priority 0) threads.  Time is measured with
+ * the port's cycle counter where available (PORT_CYCLE_COUNTER), and with the
+ * profiling timer otherwise, and is charged to the outgoing thread on each
+ * context switch.  See CpuUsage for snapshots, resets, and load percentages.
+ */
+#define KERNEL_CPU_ACCOUNTING (0)
+
+/**
+ * Run the scheduler on every core of a multi-core part (PORT_CORE_COUNT).
+ * Each core has its own set of ready lists, and runs the highest-priority
+ * ready thread assigned to it.  Threads are assigned to a core when they are
+ * initialized, choosing the least-loaded core permitted by their affinity
+ * (Thread::SetAffinity()) - by default, the boot core only - and stay on that
+ * core.  Waking a thread assigned to another core interrupts that core to
+ * reschedule.  Kernel data is protected by a kernel-wide lock, taken by every
+ * critical section, and the kernel provides an idle thread for each core.
+ *
+ * Requires port support (PORT_SMP).  Round-robin scheduling, the EDF class,
+ * and CPU accounting are not available in this configuration.
+ */
+#define KERNEL_SMP (0)
+
+/**
+ * Provide CPU budget reservations (CpuBudget), which bound the execution time
+ * of a thread within each replenishment period.  The running thread is charged
+ * on each kernel tick, and a thread that exhausts its budget is demoted to a
+ * background priority until the budget is replenished.
+ *
+ * Requires a periodic kernel tick (i.e. not KERNEL_TIMERS_TICKLESS), and is not
+ * available with KERNEL_SMP.
+ */
+#define KERNEL_CPU_BUDGETS (0)
+
+/**
+ * Provide wait sets (WaitSet), which allow a single thread to block on any of
+ * a set of Semaphore, MessageQueue, Mailbox, EventFlag and Notify objects,
+ * without polling each in turn.  Each blocking object gains a pointer to the
+ * set it belongs to, which it signals when it becomes ready.
+ */
+#define KERNEL_WAIT_SETS (0)
+
+/**
+ * Maximum number of objects in a wait set (up to 32).
+ */
+#define KERNEL_WAIT_SET_SIZE (8)
+
 #include "portcfg.h" //!< include CPU/Port specific configuration options
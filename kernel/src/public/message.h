@@ -262,6 +262,10 @@ public:
      */
     uint16_t GetCount();
 
+#if KERNEL_WAIT_SETS
+    friend class WaitSet;
+#endif // #if KERNEL_WAIT_SETS
+
 private:
     /**
      * @brief Receive_i
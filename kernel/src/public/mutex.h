@@ -46,6 +46,18 @@ See license.txt for more information
     clMutex.Release();
     @endcode
 
+    @section MCeiling Priority-ceiling mutexes
+
+    Where every thread that uses a lock is known up front, a CeilingMutex can
+    be used instead.  It is initialized with a ceiling - the highest priority
+    of any thread that claims it - and the claiming thread is raised to that
+    priority as soon as it takes the lock, rather than when another thread
+    blocks on it.
+
+    @code
+    clCeilingMutex.Init(5);
+    @endcode
+
  */
 #pragma once
 
@@ -87,7 +99,9 @@ public:
      *  If the calling Thread's priority is lower than that of a Thread that
      *  currently owns the Mutex object, then the priority of that Thread will
      *  be elevated to that of the highest-priority calling object until the
-     *  Mutex is released.  This property is known as "Priority Inheritence"
+     *  Mutex is released.  This property is known as "Priority Inheritence".
+     *  If the owner is itself blocked on another Mutex, the elevated priority
+     *  is passed along to that Mutex's owner, and so on down the chain.
      *
      *  Note:  A single thread can recursively claim a mutex up to a count of
      *  255.  Attempting to claim a mutex beyond that will cause a kernel panic.
@@ -133,8 +147,8 @@ public:
      *  switch, depending on relative priorities.
      *
      *  If the calling Thread's priority was boosted as a result of priority
-     *  inheritence, the Thread's previous priority will also be restored at this
-     *  time.
+     *  inheritence, it drops to the highest priority still inherited through
+     *  any other Mutex objects it holds (or its own priority, if none).
      *
      *  Note that if a Mutex is held recursively, it must be Release'd the same
      *  number of times that it was Claim'd before it will be availabel for use
@@ -161,10 +175,96 @@ private:
      */
     bool Claim_i(uint32_t u32WaitTimeMS_);
 
-    uint8_t m_u8Recurse;  //!< The recursive lock-count when a mutex is claimed multiple times by the same owner
-    bool    m_bReady;     //!< State of the mutex - true = ready, false = claimed
-    bool    m_bRecursive; //!< Whether or not the lock is recursive
-    uint8_t m_u8MaxPri;   //!< Maximum priority of thread in queue, used for priority inheritence
-    Thread* m_pclOwner;   //!< Pointer to the thread that owns the mutex (when claimed)
+    /**
+     * @brief AddHeld
+     *
+     * Make the given thread the owner of the mutex, and add the mutex to the
+     * thread's list of held mutexes.
+     *
+     * @param pclOwner_ Thread taking ownership of the mutex
+     */
+    void AddHeld(Thread* pclOwner_);
+
+    /**
+     * @brief RemoveHeld
+     *
+     * Remove the mutex from its owner's list of held mutexes.
+     */
+    void RemoveHeld();
+
+    /**
+     * @brief PropagatePriority
+     *
+     * Recompute the priority of the mutex owner after the set of threads
+     * waiting on the mutex (or their priorities) has changed.  If the owner is
+     * itself blocked on another mutex, the change is carried along the chain
+     * of owners until it reaches a thread whose priority is unaffected.
+     */
+    void PropagatePriority();
+
+    /**
+     * @brief InheritedPriority
+     *
+     * Compute the priority a thread should run at - the greater of its own
+     * priority and that of the highest-priority thread waiting on any of the
+     * mutexes it holds.
+     *
+     * @param pclThread_ Thread to compute the priority for
+     * @return Priority to run the thread at
+     */
+    static PORT_PRIO_TYPE InheritedPriority(Thread* pclThread_);
+
+    uint8_t          m_u8Recurse;  //!< The recursive lock-count when a mutex is claimed multiple times by the same owner
+    volatile uint8_t m_u8Lock;     //!< State of the mutex - free, claimed, or claimed with waiters
+    bool             m_bRecursive; //!< Whether or not the lock is recursive
+
+protected:
+    PORT_PRIO_TYPE m_uXCeiling; //!< Priority the owner is raised to on claim, 0 for priority inheritence only
+
+private:
+    Thread* m_pclOwner;    //!< Pointer to the thread that owns the mutex (when claimed)
+    Mutex*  m_pclNextHeld; //!< Next mutex held by the same owner, used for priority inheritence
+};
+
+//---------------------------------------------------------------------------
+/**
+ *  Mutual-exclusion lock implementing the immediate priority-ceiling protocol.
+ *
+ *  A thread claiming a CeilingMutex is raised to the mutex's ceiling priority
+ *  for as long as it holds the lock.  Provided that the ceiling is at least
+ *  the priority of every thread that claims the mutex, no thread that could
+ *  contend for it can run while it is held, so claims never block and never
+ *  require the priority-inheritence bookkeeping of a contended Mutex.  If the
+ *  owner blocks while holding the lock, other claimants wait as they would on
+ *  a regular Mutex.
+ *
+ *  As it derives from Mutex, a CeilingMutex can be used anywhere a Mutex is
+ *  expected, including with LockGuard.
+ */
+class CeilingMutex : public Mutex
+{
+public:
+    void* operator new(size_t sz, void* pv) { return (CeilingMutex*)pv; };
+
+    /**
+     *  @brief Init
+     *
+     *  Initialize a priority-ceiling mutex for use - must call this function
+     *  before using the object.
+     *
+     *  @param uXCeiling_ Ceiling priority, which must be at least that of the
+     *                    highest-priority thread that claims the mutex.
+     *  @param bRecursive_ Whether or not the mutex can be recursively locked.
+     *                    Has no default, so that a Mutex::Init(bool) style
+     *                    call can't silently be taken as a ceiling.
+     */
+    void Init(PORT_PRIO_TYPE uXCeiling_, bool bRecursive_);
+
+    /**
+     *  @brief GetCeiling
+     *
+     *  @return The ceiling priority of the mutex
+     */
+    PORT_PRIO_TYPE GetCeiling() { return m_uXCeiling; }
 };
 } // namespace Mark3
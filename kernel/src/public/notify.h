@@ -89,6 +89,10 @@ public:
      */
     void WakeMe(Thread* pclChosenOne_);
 
+#if KERNEL_WAIT_SETS
+    friend class WaitSet;
+#endif // #if KERNEL_WAIT_SETS
+
 private:
     bool m_bPending;
 };
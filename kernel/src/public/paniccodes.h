@@ -32,3 +32,6 @@ See license.txt for more information
 #define PANIC_ACTIVE_NOTIFY_DESCOPED (11)
 #define PANIC_ACTIVE_MAILBOX_DESCOPED (12)
 #define PANIC_ACTIVE_TIMER_DESCOPED (13)
+#define PANIC_ACTIVE_PERIODIC_DESCOPED (14)
+#define PANIC_UNHANDLED_USAGE_FAULT (15)
+#define PANIC_ACTIVE_WAITSET_DESCOPED (16)
@@ -0,0 +1,124 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   periodic.h
+
+    @brief  Periodic release object - drift-free periodic threads
+
+*/
+
+#pragma once
+
+#include "mark3cfg.h"
+#include "blocking.h"
+#include "timer.h"
+
+namespace Mark3
+{
+/**
+ * @brief The Periodic class is a blocking object which releases a single
+ * thread at fixed intervals, for use in periodic control loops.
+ *
+ * Releases are driven by a repeating timer that remains armed across periods,
+ * so the release times are fixed relative to the time the object was started,
+ * regardless of how long the thread takes to process each period.  A thread
+ * that is still busy when its next release occurs has overrun its period -
+ * such overruns are counted, and the next call to Wait() returns immediately.
+ */
+class Periodic : public BlockingObject
+{
+public:
+    void* operator new(size_t sz, void* pv) { return (Periodic*)pv; };
+    ~Periodic();
+
+    /**
+     *  @brief Init
+     *
+     *  Initialize the periodic object prior to use.
+     */
+    void Init(void);
+
+    /**
+     *  @brief Start
+     *
+     *  Start releasing the waiting thread at a fixed period.  The first
+     *  release occurs one period from now.
+     *
+     *  @param u32PeriodMs_ Period between releases (in ms)
+     */
+    void Start(uint32_t u32PeriodMs_);
+
+    /**
+     *  @brief Stop
+     *
+     *  Stop releasing the waiting thread.  A thread currently blocked in
+     *  Wait() is released immediately.
+     */
+    void Stop(void);
+
+    /**
+     *  @brief Wait
+     *
+     *  Block the current thread until its next release.  Only one thread may
+     *  wait on a given periodic object.
+     *
+     *  @return true if the thread was released on time, false if one or more
+     *          releases occurred before the thread called Wait() (i.e. the
+     *          previous period was overrun), in which case Wait() returns
+     *          immediately.
+     */
+    bool Wait(void);
+
+    /**
+     *  @brief GetNextRelease
+     *
+     *  @return Kernel tick count at which the next release is due
+     */
+    uint32_t GetNextRelease(void) { return m_u32NextRelease; }
+
+    /**
+     *  @brief GetOverruns
+     *
+     *  @return Number of releases which occurred while the thread was still
+     *          processing a previous period.
+     */
+    uint32_t GetOverruns(void) { return m_u32Overruns; }
+
+    /**
+     *  @brief Release
+     *
+     *  Release the waiting thread, and advance the next release time by one
+     *  period.  Note that this is only public in order to be accessible from
+     *  a timer callback.
+     */
+    void Release(void);
+
+private:
+    //! Timer used to generate the releases
+    Timer m_clTimer;
+
+    //! Period between releases (in ms)
+    uint32_t m_u32Period;
+
+    //! Kernel tick count at which the next release is due
+    uint32_t m_u32NextRelease;
+
+    //! Number of releases missed by the thread
+    uint32_t m_u32Overruns;
+
+    //! Number of releases which occurred with no thread waiting
+    uint16_t m_u16Pending;
+};
+} // namespace Mark3
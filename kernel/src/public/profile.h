@@ -47,6 +47,11 @@ See license.txt for more information
     u32LastTimer = clMyTimer.GetCurrent();
 
     @endcode
+
+    Besides the average, each timer tracks the minimum and maximum iteration
+    times, and an estimate of their variance.  For tail latencies, a timer can
+    also be given an array of counters to use as a log2 histogram of iteration
+    times (SetHistogram()), from which percentiles can be estimated.
  */
 
 #pragma once
@@ -72,7 +77,8 @@ public:
      *  @brief Init
      *
      *  Initialize the profiling timer prior to use.  Can also
-     *  be used to reset a timer that's been used previously.
+     *  be used to reset a timer that's been used previously, in
+     *  which case any histogram must be set again.
      */
     void Init();
 
@@ -101,6 +107,69 @@ public:
      */
     uint32_t GetAverage();
 
+    /**
+     *  @brief GetMin
+     *
+     *  @return Shortest iteration time, or 0 if no iterations have completed
+     */
+    uint32_t GetMin() { return (m_u32Iterations != 0u) ? m_u32Min : 0; }
+
+    /**
+     *  @brief GetMax
+     *
+     *  @return Longest iteration time
+     */
+    uint32_t GetMax() { return m_u32Max; }
+
+    /**
+     *  @brief GetCumulative
+     *
+     *  @return Total tick count of all iterations
+     */
+    uint64_t GetCumulative() { return m_u64Cumulative; }
+
+    /**
+     *  @brief GetIterations
+     *
+     *  @return Number of iterations completed
+     */
+    uint32_t GetIterations() { return m_u32Iterations; }
+
+    /**
+     *  @brief GetVariance
+     *
+     *  Get an estimate of the (population) variance of the iteration times,
+     *  computed incrementally with an integer running mean.
+     *
+     *  @return Variance, in ticks squared
+     */
+    uint64_t GetVariance();
+
+    /**
+     *  @brief SetHistogram
+     *
+     *  Record iteration times in a log2 histogram.  Bucket 0 counts iterations
+     *  of 0 ticks, and bucket n counts those of 2^(n-1) to (2^n)-1 ticks, with
+     *  the last bucket also counting all longer iterations.  The buckets are
+     *  zeroed here, so this must be called after Init().
+     *
+     *  @param au32Buckets_ Array of bucket counters, or nullptr to disable
+     *  @param u8Buckets_ Number of buckets in the array (up to 33 are used)
+     */
+    void SetHistogram(uint32_t* au32Buckets_, uint8_t u8Buckets_);
+
+    /**
+     *  @brief GetPercentile
+     *
+     *  Estimate a percentile of the iteration times from the histogram, as
+     *  the upper bound of the bucket in which it falls.
+     *
+     *  @param u8Percent_ Percentile to estimate (1-100)
+     *  @return Upper bound of the percentile, or GetMax() if it falls in the
+     *          last bucket, or if no histogram has been set.
+     */
+    uint32_t GetPercentile(uint8_t u8Percent_);
+
     /**
      *  @brief GetCurrent
      *
@@ -124,11 +193,26 @@ private:
      */
     uint32_t ComputeCurrentTicks(uint16_t u16Current_, uint32_t u32Epoch_);
 
-    uint32_t m_u32Cumulative;       //!< Cumulative tick-count for this timer
-    uint32_t m_u32CurrentIteration; //!< Tick-count for the current iteration
-    uint16_t m_u16Initial;          //!< Initial count
-    uint32_t m_u32InitialEpoch;     //!< Initial Epoch
-    uint16_t m_u16Iterations;       //!< Number of iterations executed for this profiling timer
-    bool     m_bActive;             //!< Wheter or not the timer is active or stopped
+    /**
+     *  @brief AddSample
+     *
+     *  Add a completed iteration to the timer's statistics
+     *
+     *  @param u32Ticks_ Tick count of the iteration
+     */
+    void AddSample(uint32_t u32Ticks_);
+
+    uint64_t  m_u64Cumulative;       //!< Cumulative tick-count for this timer
+    uint64_t  m_u64SumSquares;       //!< Sum of squared deviations from the running mean
+    uint32_t  m_u32Mean;             //!< Running mean of the iteration times
+    uint32_t  m_u32CurrentIteration; //!< Tick-count for the current iteration
+    uint32_t  m_u32InitialEpoch;     //!< Initial Epoch
+    uint32_t  m_u32Iterations;       //!< Number of iterations executed for this profiling timer
+    uint32_t  m_u32Min;              //!< Shortest iteration
+    uint32_t  m_u32Max;              //!< Longest iteration
+    uint32_t* m_au32Histogram;       //!< log2 histogram buckets, if any
+    uint16_t  m_u16Initial;          //!< Initial count
+    uint8_t   m_u8Buckets;           //!< Number of histogram buckets
+    bool      m_bActive;             //!< Wheter or not the timer is active or stopped
 };
 } // namespace Mark3
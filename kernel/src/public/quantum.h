@@ -87,6 +87,15 @@ public:
      */
     static void Cancel();
 
+    /**
+     * @brief IsActive
+     *
+     * Return whether a thread's round-robin quantum is being counted down.
+     *
+     * @return true if a quantum is active, false otherwise
+     */
+    static bool IsActive() { return (m_pclActiveThread != nullptr); }
+
 private:
     static Thread*  m_pclActiveThread;
     static Thread*  m_pclTimerThread;
@@ -50,11 +50,36 @@ See license.txt for more information
 #include "threadport.h"
 #include "priomap.h"
 
+#if KERNEL_SMP
+#if !PORT_SMP
+#error "KERNEL_SMP is not supported by this port"
+#endif // #if !PORT_SMP
+#if KERNEL_ROUND_ROBIN || KERNEL_EDF || KERNEL_CPU_ACCOUNTING
+#error "KERNEL_SMP does not support KERNEL_ROUND_ROBIN, KERNEL_EDF, or KERNEL_CPU_ACCOUNTING"
+#endif // #if KERNEL_ROUND_ROBIN || KERNEL_EDF || KERNEL_CPU_ACCOUNTING
+static_assert(PORT_CORE_COUNT <= 8, "Thread affinity masks support up to 8 cores");
+
+//---------------------------------------------------------------------------
+// Each core has its own current and next threads.  The usual names refer to
+// those of the calling core.
+extern volatile Mark3::Thread* g_apclNext[PORT_CORE_COUNT];
+extern Mark3::Thread*          g_apclCurrent[PORT_CORE_COUNT];
+
+#define g_pclNext (g_apclNext[Mark3::ThreadPort::CoreId()])
+#define g_pclCurrent (g_apclCurrent[Mark3::ThreadPort::CoreId()])
+#else
 extern volatile Mark3::Thread* g_pclNext;
 extern Mark3::Thread*          g_pclCurrent;
+#endif // #if KERNEL_SMP
 
 namespace Mark3
 {
+#if KERNEL_EDF
+//---------------------------------------------------------------------------
+//! Utilization representing 100% of the CPU, for EDF admission control
+#define SCHEDULER_EDF_UTILIZATION_MAX (65536UL)
+#endif // #if KERNEL_EDF
+
 //---------------------------------------------------------------------------
 /**
  *  Priority-based round-robin Thread scheduling, using ThreadLists for
@@ -76,6 +101,8 @@ public:
      *  Run the scheduler, determines the next thread to run based on the
      *  current state of the threads.  Note that the next-thread chosen
      *  from this function is only valid while in a critical section.
+     *  On multi-core systems, this chooses the next thread for the calling
+     *  core.
      */
     static void Schedule();
 
@@ -112,6 +139,31 @@ public:
      */
     static bool SetScheduler(bool bEnable_);
 
+#if KERNEL_EDF
+    /**
+     *  @brief Admit
+     *
+     *  Update the total utilization of the earliest-deadline-first threads,
+     *  replacing one thread's share with a new value, provided the total
+     *  remains schedulable (no more than SCHEDULER_EDF_UTILIZATION_MAX).
+     *
+     *  @param u32Old_ Utilization previously reserved by the thread
+     *  @param u32New_ Utilization requested by the thread
+     *  @return true if the new utilization was admitted, false otherwise
+     */
+    static bool Admit(uint32_t u32Old_, uint32_t u32New_);
+
+    /**
+     *  @brief GetUtilization
+     *
+     *  Return the total utilization reserved by earliest-deadline-first
+     *  threads, where SCHEDULER_EDF_UTILIZATION_MAX represents 100% of the CPU.
+     *
+     *  @return Total utilization of the EDF threads
+     */
+    static uint32_t GetUtilization() { return m_u32Utilization; }
+#endif // #if KERNEL_EDF
+
     /**
      *  @brief GetCurrentThread
      *
@@ -136,10 +188,78 @@ public:
      *  given priority level in the scheduler.
      *
      *  @param uXPriority_ Priority level of the threadlist
+     *  @param u8Core_ Core whose ready lists are used (KERNEL_SMP only)
      *
      *  @return Pointer to the ThreadList for the given priority level
      */
+#if KERNEL_SMP
+    static ThreadList* GetThreadList(PORT_PRIO_TYPE uXPriority_, uint8_t u8Core_)
+    {
+        return &m_aclPriorities[u8Core_][uXPriority_];
+    }
+
+    /**
+     *  @brief SelectCore
+     *
+     *  Choose the core to which a thread is assigned - the core permitted by
+     *  the affinity mask with the fewest threads assigned to it - and account
+     *  for the new thread on it.
+     *
+     *  @param u8Affinity_ Bitmask of the cores the thread may run on
+     *  @return Index of the chosen core
+     */
+    static uint8_t SelectCore(uint8_t u8Affinity_);
+
+    /**
+     *  @brief ReleaseCore
+     *
+     *  Stop accounting for a thread assigned to a core by SelectCore().
+     *
+     *  @param u8Core_ Index of the core the thread was assigned to
+     */
+    static void ReleaseCore(uint8_t u8Core_);
+
+    /**
+     *  @brief GetCoreLoad
+     *
+     *  Return the number of threads assigned to a core (including its idle
+     *  thread).
+     *
+     *  @param u8Core_ Index of the core
+     *  @return Number of threads assigned to the core
+     */
+    static uint16_t GetCoreLoad(uint8_t u8Core_) { return m_au16CoreLoad[u8Core_]; }
+
+    /**
+     *  @brief Reschedule
+     *
+     *  Choose the next thread for the calling core from its context switch
+     *  interrupt, which may have been raised by another core that has only
+     *  updated the ready lists.  Must be called from within a critical
+     *  section.
+     */
+    static void Reschedule();
+
+    /**
+     *  @brief WaitForSwitch
+     *
+     *  Wait until a thread that has been removed from scheduling is no longer
+     *  running on another core, so that its stack and context can be safely
+     *  reused.  Must not be called from within a critical section.
+     *
+     *  @param pclThread_ Thread that has been stopped or terminated
+     */
+    static void WaitForSwitch(Thread* pclThread_);
+
+    /**
+     *  @brief StartIdle
+     *
+     *  Create and start the kernel's idle thread for each core.
+     */
+    static void StartIdle();
+#else
     static ThreadList* GetThreadList(PORT_PRIO_TYPE uXPriority_) { return &m_aclPriorities[uXPriority_]; }
+#endif // #if KERNEL_SMP
     /**
      *  @brief GetStopList
      *
@@ -176,10 +296,37 @@ private:
     //! ThreadList for all stopped threads
     static ThreadList m_clStopList;
 
+#if KERNEL_SMP
+    /**
+     *  @brief NotifyCore
+     *
+     *  Interrupt another core, if a change to its ready lists affects which
+     *  thread it should be running.
+     *
+     *  @param pclThread_ Thread that was added to, or removed from, the lists
+     *  @param bAdded_ true if the thread was made ready, false if it was removed
+     */
+    static void NotifyCore(Thread* pclThread_, bool bAdded_);
+
+    //! ThreadLists for all threads at all priorities, on each core
+    static ThreadList m_aclPriorities[PORT_CORE_COUNT][KERNEL_NUM_PRIORITIES];
+
+    //! Priority bitmap lookup structures for each core
+    static PriorityMap m_aclPrioMap[PORT_CORE_COUNT];
+
+    //! Number of threads assigned to each core
+    static uint16_t m_au16CoreLoad[PORT_CORE_COUNT];
+#else
     //! ThreadLists for all threads at all priorities
     static ThreadList m_aclPriorities[KERNEL_NUM_PRIORITIES];
 
     //! Priority bitmap lookup structure, 1-bit per thread priority.
     static PriorityMap m_clPrioMap;
+#endif // #if KERNEL_SMP
+
+#if KERNEL_EDF
+    //! Total utilization reserved by earliest-deadline-first threads
+    static uint32_t m_u32Utilization;
+#endif // #if KERNEL_EDF
 };
 } // namespace Mark3
@@ -48,6 +48,10 @@ See license.txt for more information
 namespace Mark3
 {
 class Thread;
+#if KERNEL_CPU_BUDGETS
+class CpuBudget;
+#endif // #if KERNEL_CPU_BUDGETS
+class Mutex;
 
 //---------------------------------------------------------------------------
 using ThreadCreateCallout  = void (*)(Thread* pclThread_);
@@ -235,13 +239,144 @@ public:
      *  @brief InheritPriority
      *
      *  Allow the thread to run at a different priority level (temporarily)
-     *  for the purpose of avoiding priority inversions.  This should
+     *  for the purpose of avoiding priority inversions.  If the thread is
+     *  ready, it is moved to the ready list for its new priority.  This should
      *  only be called from within the implementation of blocking-objects.
      *
      *  @param uXPriority_  New Priority to boost to.
      */
     void InheritPriority(PORT_PRIO_TYPE uXPriority_);
 
+    /**
+     *  @brief SetBlockingMutex
+     *
+     *  Record the mutex on which the thread is blocked, so that priority
+     *  inheritance can follow chains of nested mutexes.  Used internally by
+     *  the Mutex class.
+     *
+     *  @param pclMutex_ Mutex the thread is blocked on, or nullptr
+     */
+    void SetBlockingMutex(Mutex* pclMutex_) { m_pclBlockingMutex = pclMutex_; }
+    /**
+     *  @brief GetBlockingMutex
+     *
+     *  @return The mutex on which the thread is blocked, or nullptr
+     */
+    Mutex* GetBlockingMutex(void) { return m_pclBlockingMutex; }
+    /**
+     *  @brief SetHeldMutex
+     *
+     *  Set the head of the list of mutexes owned by the thread.  Used
+     *  internally by the Mutex class.
+     *
+     *  @param pclMutex_ Most recently claimed mutex, or nullptr
+     */
+    void SetHeldMutex(Mutex* pclMutex_) { m_pclHeldMutex = pclMutex_; }
+    /**
+     *  @brief GetHeldMutex
+     *
+     *  @return The most recently claimed mutex owned by the thread, or nullptr
+     */
+    Mutex* GetHeldMutex(void) { return m_pclHeldMutex; }
+
+#if KERNEL_EDF
+    /**
+     *  @brief SetDeadline
+     *
+     *  Declare the timing parameters of a thread in the earliest-deadline-
+     *  first band (KERNEL_EDF_PRIORITY), making it an EDF thread.  The thread
+     *  is admitted only if the total utilization of all EDF threads - the sum
+     *  of each thread's execution time over the lesser of its deadline and
+     *  period - would not exceed 100%.  The first job is released immediately.
+     *
+     *  Passing a relative deadline of 0 returns the thread to round-robin
+     *  scheduling within the band, and releases its utilization.
+     *
+     *  @param u32RelDeadline_ Deadline of each job, relative to its release (in ms)
+     *  @param u32Period_      Minimum time between job releases (in ms), or 0 if
+     *                         the thread is not periodic
+     *  @param u32ExecTime_    Worst-case execution time of each job (in ms)
+     *  @return true if the thread was admitted, false if it would overload
+     *          the EDF band, in which case its parameters are unchanged.
+     */
+    bool SetDeadline(uint32_t u32RelDeadline_, uint32_t u32Period_, uint32_t u32ExecTime_);
+
+    /**
+     *  @brief ReleaseJob
+     *
+     *  Release the EDF thread's next job, setting its absolute deadline to
+     *  the release time plus its relative deadline, and moving it to its new
+     *  position among the ready EDF threads.  This is called automatically
+     *  when the thread is released by a Periodic object.
+     *
+     *  @param u32ReleaseTick_ Kernel tick count at which the job was released
+     */
+    void ReleaseJob(uint32_t u32ReleaseTick_);
+
+    /**
+     *  @brief HasDeadline
+     *
+     *  @return true if the thread is scheduled by deadline
+     */
+    bool HasDeadline(void) { return (m_u32RelDeadline != 0); }
+
+    /**
+     *  @brief GetDeadline
+     *
+     *  @return Kernel tick count by which the thread's current job is due
+     */
+    uint32_t GetDeadline(void) { return m_u32Deadline; }
+#endif // #if KERNEL_EDF
+
+#if KERNEL_CPU_ACCOUNTING
+    /**
+     *  @brief GetRunCycles
+     *
+     *  Return the time the thread has spent running in the current accounting
+     *  window, as of the last context switch or call to CpuUsage::Sample().
+     *
+     *  @return Run time, in counts of the accounting counter (see CpuUsage)
+     */
+    uint64_t GetRunCycles();
+#endif // #if KERNEL_CPU_ACCOUNTING
+
+#if KERNEL_SMP
+    /**
+     *  @brief SetAffinity
+     *
+     *  Set the cores on which the thread may run, and reassign the thread to
+     *  the least-loaded of them.  Threads run only on the boot core (core 0)
+     *  unless set otherwise.  The thread must be stopped, and must not still
+     *  be running on any core - i.e. it must not have just stopped itself.
+     *
+     *  @param u8Affinity_ Bitmask of the permitted cores (bit n = core n)
+     */
+    void SetAffinity(uint8_t u8Affinity_);
+
+    /**
+     *  @brief GetAffinity
+     *
+     *  @return Bitmask of the cores on which the thread may run
+     */
+    uint8_t GetAffinity(void) { return m_u8Affinity; }
+
+    /**
+     *  @brief GetCore
+     *
+     *  @return Index of the core to which the thread is assigned
+     */
+    uint8_t GetCore(void) { return m_u8Core; }
+#endif // #if KERNEL_SMP
+
+#if KERNEL_CPU_BUDGETS
+    /**
+     *  @brief GetBudget
+     *
+     *  @return CPU budget attached to the thread (see CpuBudget), or nullptr
+     */
+    CpuBudget* GetBudget(void) { return m_pclBudget; }
+#endif // #if KERNEL_CPU_BUDGETS
+
     /**
      *  @brief Exit
      *
@@ -265,6 +400,20 @@ public:
      */
     static void Sleep(uint32_t u32TimeMs_);
 
+    /**
+     *  @brief SleepUntil
+     *
+     *  Put the thread to sleep until the kernel tick count reaches an absolute
+     *  deadline.  Unlike Sleep(), time spent by the thread between successive
+     *  calls does not accumulate, so a loop advancing its deadline by a fixed
+     *  amount each iteration runs at a fixed rate without drifting.  Returns
+     *  immediately if the deadline has already passed.
+     *
+     *  @param u32WakeTick_ Kernel tick count (as returned by
+     *                      Kernel::GetTicks()) at which to wake
+     */
+    static void SleepUntil(uint32_t u32WakeTick_);
+
     /**
      *  @brief Yield
      *
@@ -316,6 +465,19 @@ public:
      *  @return The amount of slack (unused bytes) on the stack
      */
     uint16_t GetStackSlack();
+
+    /**
+     *  @brief GetStackHighWater
+     *
+     *  Return the deepest extent of the thread's stack observed so far.  This
+     *  is maintained incrementally at each context switch, so is cheap to
+     *  read - but only reflects stack usage up to the thread's last switch, and
+     *  can be fooled by unwritten gaps in a stack frame in the same way as
+     *  GetStackSlack().
+     *
+     *  @return Number of words of the thread's stack used so far
+     */
+    uint16_t GetStackHighWater();
 #endif // #if KERNEL_STACK_CHECK
 
 #if KERNEL_EVENT_FLAGS
@@ -348,6 +510,51 @@ public:
     EventFlagOperation GetEventFlagMode() { return m_eFlagMode; }
 #endif // #if KERNEL_EVENT_FLAGS
 
+#if KERNEL_THREAD_NOTIFY
+    /**
+     *  @brief Notify
+     *
+     *  Update the thread's notification word, waking the thread if it is
+     *  blocked in WaitNotification() and any of the bits it is waiting for
+     *  are now set.  May be called from a thread or an interrupt.
+     *
+     *  @param u32Value_ Bits to set, or value to write (ignored for Increment)
+     *  @param eAction_  How the notification word is updated
+     */
+    void Notify(uint32_t u32Value_, NotifyAction eAction_);
+
+    /**
+     *  @brief WaitNotification
+     *
+     *  Block the calling thread until any of the specified bits are set in its
+     *  notification word.  The bits that were set are cleared from the word
+     *  before returning.
+     *
+     *  @param u32Mask_ Bits to wait for
+     *  @return The bits from u32Mask_ that were set
+     */
+    static uint32_t WaitNotification(uint32_t u32Mask_);
+
+    /**
+     *  @brief WaitNotification
+     *
+     *  Block the calling thread until any of the specified bits are set in its
+     *  notification word, or until the timeout expires.
+     *
+     *  @param u32Mask_       Bits to wait for
+     *  @param u32WaitTimeMS_ Time to wait (in ms)
+     *  @return The bits from u32Mask_ that were set, or 0 on timeout
+     */
+    static uint32_t WaitNotification(uint32_t u32Mask_, uint32_t u32WaitTimeMS_);
+
+    /**
+     *  @brief GetNotification
+     *
+     *  @return The current value of the thread's notification word
+     */
+    uint32_t GetNotification() { return m_u32NotifyValue; }
+#endif // #if KERNEL_THREAD_NOTIFY
+
     /**
      *  Return a pointer to the thread's timer object
      */
@@ -425,6 +632,12 @@ public:
     uint16_t GetStackSize() { return m_u16StackSize; }
 
     friend class ThreadPort;
+#if KERNEL_CPU_ACCOUNTING
+    friend class CpuUsage;
+#endif // #if KERNEL_CPU_ACCOUNTING
+#if KERNEL_CPU_BUDGETS
+    friend class CpuBudget;
+#endif // #if KERNEL_CPU_BUDGETS
 
 private:
     /**
@@ -436,6 +649,24 @@ private:
      */
     static void ContextSwitchSWI(void);
 
+#if KERNEL_STACK_CHECK
+    /**
+     *  @brief UpdateStackMark
+     *
+     *  Move the thread's stack high-water mark down past any words that have
+     *  been written since it was last updated.
+     */
+    void UpdateStackMark();
+
+    /**
+     *  @brief CheckStack
+     *
+     *  Raise a kernel panic if the thread has used any of the guard margin at
+     *  the bottom of its stack.
+     */
+    void CheckStack();
+#endif // #if KERNEL_STACK_CHECK
+
     /**
      *  @brief SetPriorityBase
      *
@@ -443,6 +674,17 @@ private:
      */
     void SetPriorityBase(PORT_PRIO_TYPE uXPriority_);
 
+    /**
+     *  @brief GetReadyList
+     *
+     *  Return the scheduler's list of ready threads at the given priority,
+     *  on the core to which this thread is assigned.
+     *
+     *  @param uXPriority_ Priority level of the list
+     *  @return Pointer to the ThreadList
+     */
+    ThreadList* GetReadyList(PORT_PRIO_TYPE uXPriority_);
+
     //! Pointer to the top of the thread's stack
     K_WORD* m_pwStackTop;
 
@@ -474,6 +716,11 @@ private:
     //! Size of the stack (in bytes)
     uint16_t m_u16StackSize;
 
+#if KERNEL_STACK_CHECK
+    //! Index of the deepest stack word known to have been used
+    uint16_t m_u16StackMark;
+#endif // #if KERNEL_STACK_CHECK
+
     //! Pointer to the thread-list where the thread currently resides
     ThreadList* m_pclCurrent;
 
@@ -486,6 +733,12 @@ private:
     //! Pointer to the argument passed into the thread's entrypoint
     void* m_pvArg;
 
+    //! Mutex on which the thread is blocked, if any
+    Mutex* m_pclBlockingMutex;
+
+    //! Head of the list of mutexes owned by the thread
+    Mutex* m_pclHeldMutex;
+
 #if KERNEL_ROUND_ROBIN
     //! Thread quantum (in milliseconds)
     uint16_t m_u16Quantum;
@@ -499,11 +752,56 @@ private:
     EventFlagOperation m_eFlagMode;
 #endif // #if KERNEL_EVENT_FLAGS
 
+#if KERNEL_THREAD_NOTIFY
+    //! Notification word, updated by Notify()
+    uint32_t m_u32NotifyValue;
+
+    //! Notification bits the thread is waiting for, or 0 if it is not waiting
+    uint32_t m_u32NotifyMask;
+#endif // #if KERNEL_THREAD_NOTIFY
+
+#if KERNEL_EDF
+    //! Absolute deadline of the thread's current job
+    uint32_t m_u32Deadline;
+
+    //! Deadline of each job, relative to its release
+    uint32_t m_u32RelDeadline;
+
+    //! Utilization reserved by the thread in the EDF band
+    uint32_t m_u32Utilization;
+#endif // #if KERNEL_EDF
+
+#if KERNEL_CPU_ACCOUNTING
+    //! Time the thread has spent running in its accounting window
+    uint64_t m_u64RunCycles;
+
+    //! Accounting window in which the thread was last charged
+    uint32_t m_u32CpuWindow;
+#endif // #if KERNEL_CPU_ACCOUNTING
+
+#if KERNEL_SMP
+    //! Core to which the thread is assigned
+    uint8_t m_u8Core;
+
+    //! Bitmask of the cores to which the thread may be assigned
+    uint8_t m_u8Affinity;
+#endif // #if KERNEL_SMP
+
+#if KERNEL_CPU_BUDGETS
+    //! CPU budget charged for the thread's execution time, if any
+    CpuBudget* m_pclBudget;
+#endif // #if KERNEL_CPU_BUDGETS
+
     //! Timer used for blocking-object timeouts
     Timer m_clTimer;
 
     //! Indicate whether or not a blocking-object timeout has occurred
     bool m_bExpired;
+
+#if PORT_FPU_LAZY_SWITCH
+    //! Whether the thread has used the FPU, and has a save area for it below its stack
+    bool m_bFpuContext;
+#endif // #if PORT_FPU_LAZY_SWITCH
 };
 
 } // namespace Mark3
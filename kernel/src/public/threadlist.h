@@ -100,6 +100,19 @@ public:
      */
     void AddPriority(LinkListNode* node_);
 
+#if KERNEL_EDF
+    /**
+     * @brief AddDeadline
+     *
+     * Add a thread to the list such that threads are ordered from earliest to
+     * latest absolute deadline from the head of the list.  Threads without a
+     * deadline are placed after all threads that have one.
+     *
+     * @param node_         Pointer to a thread to add to the list.
+     */
+    void AddDeadline(LinkListNode* node_);
+#endif // #if KERNEL_EDF
+
     /**
      *  @brief Remove
      *
@@ -29,10 +29,12 @@ namespace Mark3
 class Thread;
 
 //---------------------------------------------------------------------------
-#define TIMERLIST_FLAG_ONE_SHOT (0x01) //!< Timer is one-shot
-#define TIMERLIST_FLAG_ACTIVE (0x02)   //!< Timer is currently active
-#define TIMERLIST_FLAG_CALLBACK (0x04) //!< Timer is pending a callback
-#define TIMERLIST_FLAG_EXPIRED (0x08)  //!< Timer is actually expired.
+#define TIMERLIST_FLAG_ONE_SHOT (0x01)  //!< Timer is one-shot
+#define TIMERLIST_FLAG_ACTIVE (0x02)    //!< Timer is currently active
+#define TIMERLIST_FLAG_CALLBACK (0x04)  //!< Timer is pending a callback
+#define TIMERLIST_FLAG_EXPIRED (0x08)   //!< Timer is actually expired.
+#define TIMERLIST_FLAG_PENDING (0x10)   //!< Timer is waiting to be sorted into the list
+#define TIMERLIST_FLAG_INSERTING (0x20) //!< Timer is being sorted into the list
 
 //---------------------------------------------------------------------------
 #define TIMER_INVALID_COOKIE (0x3C)
@@ -64,6 +66,7 @@ using TimerCallback = void (*)(Thread* pclOwner_, void* pvData_);
 
 //---------------------------------------------------------------------------
 class TimerList;
+class TimerWheel;
 class TimerScheduler;
 class Quantum;
 
@@ -111,6 +114,26 @@ public:
      */
     void Start(bool bRepeat_, uint32_t u32IntervalMs_, TimerCallback pfCallback_, void* pvData_);
 
+    /**
+     *  @brief Start
+     *
+     *  Start a timer using default ownership, with an allowable tolerance on
+     *  its expiry.  The timer may expire up to u32ToleranceMs_ late, which
+     *  allows the timer scheduler to batch its expiry together with those of
+     *  other timers, reducing the number of timer wakeups.
+     *
+     *  @param bRepeat_ 0 - timer is one-shot.  1 - timer is repeating.
+     *  @param u32IntervalMs_ - Interval of the timer in miliseconds
+     *  @param u32ToleranceMs_ - Time (in ms) by which the expiry may be delayed
+     *  @param pfCallback_ - Function to call on timer expiry
+     *  @param pvData_ - Data to pass into the callback function
+     */
+    void Start(bool          bRepeat_,
+               uint32_t      u32IntervalMs_,
+               uint32_t      u32ToleranceMs_,
+               TimerCallback pfCallback_,
+               void*         pvData_);
+
     /**
      * @brief Start
      *
@@ -131,6 +154,7 @@ public:
 
 private:
     friend class TimerList;
+    friend class TimerWheel;
 
     /**
      * @brief SetInitialized
@@ -149,13 +173,21 @@ private:
     //! Flags for the timer, defining if the timer is one-shot or repeated
     uint8_t m_u8Flags;
 
+    //! Index of the timer wheel slot holding this timer (TimerWheel only)
+    uint8_t m_u8WheelSlot;
+
     //! Pointer to the callback function
     TimerCallback m_pfCallback;
 
     //! Interval of the timer in timer ticks
     uint32_t m_u32Interval;
 
-    //! Time remaining on the timer
+    //! Number of ticks by which the timer's expiry may be delayed
+    uint32_t m_u32Tolerance;
+
+    //! Time remaining on the timer, relative to the previous timer in the list
+    //! (or the absolute expiry tick, when held in a TimerWheel or waiting to be
+    //! sorted into a TimerList)
     uint32_t m_u32TimeLeft;
 
     //! Pointer to the owner thread
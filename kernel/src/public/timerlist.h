@@ -26,7 +26,7 @@ See license.txt for more information
 #include "kerneltypes.h"
 #include "mark3cfg.h"
 
-#include "mutex.h"
+#include "ll.h"
 
 namespace Mark3
 {
@@ -35,6 +35,15 @@ class Timer;
 //---------------------------------------------------------------------------
 /**
  *   TimerList class - a doubly-linked-list of timer objects.
+ *
+ *   Timers are kept sorted by expiry as a delta list: each timer's time-left
+ *   is relative to the timer in front of it, so a tick only needs to update
+ *   the head of the list, and only timers that actually expire are visited.
+ *
+ *   Timers started with a tolerance may expire late, so that their expiries
+ *   can be batched: the list is only processed once the earliest latest-
+ *   allowable expiry of any timer is reached, at which point every timer whose
+ *   expiry has been reached fires together.
  */
 class TimerList : public DoubleLinkList
 {
@@ -50,7 +59,10 @@ public:
     /**
      *  @brief Add
      *
-     *  Add a timer to the TimerList.
+     *  Add a timer to the TimerList, in order of expiry.  With
+     *  KERNEL_TIMERS_THREADED, the timer is only queued here, and is sorted
+     *  into the list by the timer thread, so that interrupts aren't disabled
+     *  for longer as more timers are armed.
      *
      *  @param pclListNode_ Pointer to the Timer to Add
      */
@@ -68,19 +80,181 @@ public:
     /**
      *  @brief Process
      *
-     *  Process all timers in the timerlist as a result of the timer expiring.
-     *  This will select a new timer epoch based on the next timer to expire.
+     *  Advance the timerlist by one tick, running the callbacks of all timers
+     *  that expire as a result.  Repeating timers are re-queued according to
+     *  their interval.  Expiries are deferred until the next wakeup is due,
+     *  allowing timers with a tolerance to be batched together.
+     *
+     *  In tickless mode, the timerlist is instead advanced by the number of
+     *  ticks elapsed since it was last processed, and the kernel timer is
+     *  programmed for the next expiry.
      */
     void Process();
 
+#if KERNEL_TIMERS_TICKLESS
+    /**
+     *  @brief ForceUpdate
+     *
+     *  Add ticks that elapsed without being seen by the kernel timer to the
+     *  kernel's tick count, and process the timerlist.
+     *
+     *  @param u32Ticks_ Number of ticks to account for
+     */
+    void ForceUpdate(uint32_t u32Ticks_);
+#endif // #if KERNEL_TIMERS_TICKLESS
+
+    /**
+     *  @brief GetWakeupCount
+     *
+     *  @return Number of times the list has been processed with at least one
+     *          timer expiring
+     */
+    uint32_t GetWakeupCount() const { return m_u32Wakeups; }
+
+    /**
+     *  @brief GetCoalescedCount
+     *
+     *  @return Number of timer expiries that were batched into a wakeup
+     *          belonging to another timer (i.e. the number of wakeups saved)
+     */
+    uint32_t GetCoalescedCount() const { return m_u32Coalesced; }
+
 private:
-    //! The time (in system clock ticks) of the next wakeup event
+    /**
+     *  @brief Advance
+     *
+     *  Bring the timerlist up to date with the ticks elapsed since it was
+     *  last processed, expiring timers along the way.  The list is only
+     *  locked while it is being modified, not while callbacks run.
+     */
+    void Advance();
+
+    /**
+     *  @brief Consume
+     *
+     *  Move the head of the list forward by a number of elapsed ticks.  Must
+     *  be called with interrupts disabled.
+     *
+     *  @param u32Ticks_    Number of ticks to move the list forward by
+     */
+    void Consume(uint32_t u32Ticks_);
+
+    /**
+     *  @brief UpdateWakeup
+     *
+     *  Recompute the time of the next wakeup - the earliest time by which any
+     *  timer in the list must expire, allowing for its tolerance.  Must be
+     *  called with interrupts disabled, whenever the list is modified.
+     */
+    void UpdateWakeup();
+
+    /**
+     *  @brief GetLag
+     *
+     *  @return Number of ticks elapsed since the head of the list was last
+     *          brought up to date
+     */
+    uint32_t GetLag();
+
+#if KERNEL_TIMERS_TICKLESS
+    /**
+     *  @brief SetWakeup
+     *
+     *  Program the kernel timer to expire when the timer at the head of the
+     *  list is due, or to simply keep time when the list is empty.
+     */
+    void SetWakeup();
+#endif // #if KERNEL_TIMERS_TICKLESS
+
+    /**
+     *  @brief Insert
+     *
+     *  Insert a timer into the list at its sorted position, adjusting the
+     *  delta of the timer that follows it.  Must be called with interrupts
+     *  disabled.
+     *
+     *  @param pclListNode_ Pointer to the Timer to insert
+     *  @param u32Ticks_    Number of ticks from now until the timer expires
+     */
+    void Insert(Timer* pclListNode_, uint32_t u32Ticks_);
+
+    /**
+     *  @brief Find
+     *
+     *  Find the sorted position of a timer in the list, without modifying it.
+     *
+     *  @param pu32Ticks_   [in] Ticks from the head of the list until the timer
+     *                      expires.  [out] Ticks from the timer preceding the
+     *                      position found.
+     *  @return The timer to insert in front of, or nullptr for the tail
+     */
+    Timer* Find(uint32_t* pu32Ticks_);
+
+    /**
+     *  @brief Splice
+     *
+     *  Link a timer into the list at a position returned by Find().  Must be
+     *  called with interrupts disabled.
+     *
+     *  @param pclListNode_ Pointer to the Timer to link in
+     *  @param pclNext_     Timer to insert in front of, or nullptr for the tail
+     *  @param u32Ticks_    Ticks from the preceding timer until it expires
+     */
+    void Splice(Timer* pclListNode_, Timer* pclNext_, uint32_t u32Ticks_);
+
+#if KERNEL_TIMERS_THREADED
+    /**
+     *  @brief Defer
+     *
+     *  Queue a timer to be sorted into the list the next time it is processed.
+     *  Must be called with interrupts disabled.
+     *
+     *  @param pclListNode_ Pointer to the Timer to queue
+     *  @param u32Expiry_   Expiry of the timer, in list time (see m_u32Epoch)
+     */
+    void Defer(Timer* pclListNode_, uint32_t u32Expiry_);
+
+    /**
+     *  @brief Merge
+     *
+     *  Sort the timers queued by Defer() into the list.  Each timer's place is
+     *  found with the scheduler disabled, and interrupts are only disabled
+     *  to link it in.
+     */
+    void Merge();
+#endif // #if KERNEL_TIMERS_THREADED
+
+    //! The time (in system clock ticks) of the next wakeup event, relative to
+    //! the head of the list
     uint32_t m_u32NextWakeup;
 
+    //! Number of wakeups that expired at least one timer
+    uint32_t m_u32Wakeups;
+
+    //! Number of timer expiries batched into another timer's wakeup
+    uint32_t m_u32Coalesced;
+
     //! Whether or not the timer is active
     bool m_bTimerActive;
 
-    //! Guards against concurrent access to the timer list - Only needed when running threaded.
-    Mutex m_clMutex;
+    //! List time corresponding to the head of the list - the kernel tick count
+    //! in tickless mode, and the number of ticks processed otherwise
+    uint32_t m_u32Epoch;
+
+#if !KERNEL_TIMERS_TICKLESS
+    //! Ticks processed since the head of the list was last brought up to date
+    uint32_t m_u32Lag;
+#endif // #if !KERNEL_TIMERS_TICKLESS
+
+#if KERNEL_TIMERS_THREADED
+    //! Timers started since the list was last processed, in no particular order
+    DoubleLinkList m_clPending;
+
+    //! Earliest latest-allowable expiry of the pending timers, in list time
+    uint32_t m_u32PendingWakeup;
+
+    //! Incremented whenever a timer is unlinked from (or linked into) the list
+    uint16_t m_u16Generation;
+#endif // #if KERNEL_TIMERS_THREADED
 };
 } // namespace Mark3
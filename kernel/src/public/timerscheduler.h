@@ -26,6 +26,16 @@ See license.txt for more information
 #include "ll.h"
 #include "timer.h"
 #include "timerlist.h"
+#include "timerwheel.h"
+
+#if KERNEL_TIMERS_TICKLESS
+#if !PORT_TIMERS_TICKLESS
+#error "KERNEL_TIMERS_TICKLESS is not supported by this port"
+#endif
+#if KERNEL_TIMERS_WHEEL
+#error "KERNEL_TIMERS_TICKLESS requires the TimerList backend (KERNEL_TIMERS_WHEEL = 0)"
+#endif
+#endif // #if KERNEL_TIMERS_TICKLESS
 
 namespace Mark3
 {
@@ -72,12 +82,48 @@ public:
      */
     static void Process() { m_clTimerList.Process(); }
 
+    /**
+     *  @brief GetWakeupCount
+     *
+     *  @return Number of timer scheduler wakeups in which at least one timer
+     *          expired
+     */
+    static uint32_t GetWakeupCount() { return m_clTimerList.GetWakeupCount(); }
+
+    /**
+     *  @brief GetCoalescedCount
+     *
+     *  Return the number of timer expiries that were batched into a wakeup
+     *  along with another timer's expiry, rather than needing a wakeup of
+     *  their own.  Timers started with a tolerance (see Timer::Start) may be
+     *  delayed to increase this.
+     *
+     *  @return Number of wakeups saved by coalescing timer expiries
+     */
+    static uint32_t GetCoalescedCount() { return m_clTimerList.GetCoalescedCount(); }
+
 #if KERNEL_TIMERS_TICKLESS
+    /**
+     *  @brief ForceUpdate
+     *
+     *  Account for ticks that elapsed without being seen by the kernel timer
+     *  (e.g. while the application held the CPU in a low-power state with the
+     *  kernel timer stopped), and process any timers expiring as a result.
+     *  Must be called from thread context; expired timer callbacks are run
+     *  from the caller's context.
+     *
+     *  @param u32Ticks_ Number of ticks to add to the kernel's tick count
+     */
     static void ForceUpdate(uint32_t u32Ticks_) { m_clTimerList.ForceUpdate(u32Ticks_); }
 #endif
 
 private:
+#if KERNEL_TIMERS_WHEEL
+    //! TimerWheel object manipulated by the Timer Scheduler
+    static TimerWheel m_clTimerList;
+#else
     //! TimerList object manipu32ated by the Timer Scheduler
     static TimerList m_clTimerList;
+#endif
 };
 } // namespace Mark3
@@ -0,0 +1,144 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   timerwheel.h
+
+    @brief  Timer wheel object declarations
+
+    A hierarchical timer wheel, used as an alternative to the kernel's sorted
+    TimerList when a large number of timers are expected to be active at once.
+ */
+
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#include "ll.h"
+
+namespace Mark3
+{
+class Timer;
+
+//---------------------------------------------------------------------------
+/**
+ *   TimerWheel class - a hierarchical wheel of timer lists.
+ *
+ *   Each level of the wheel is an array of (1 << KERNEL_TIMERS_WHEEL_BITS)
+ *   unsorted slots, where each slot at a given level covers (1 << BITS) times
+ *   as many ticks as a slot in the level below it.  Timers are hashed into a
+ *   slot by their absolute expiry, making Add/Remove constant-time.  As the
+ *   lowest level of the wheel wraps, the next slot of the level above it is
+ *   cascaded down, so every timer is touched at most once per level before it
+ *   expires.
+ *
+ *   Provides the same interface as TimerList, so that either can be used as
+ *   the timer scheduler's backend (see KERNEL_TIMERS_WHEEL).  Timers started
+ *   with a tolerance have their expiry rounded to a coarser tick boundary
+ *   within that tolerance, so that their expiries fall into a shared slot.
+ */
+class TimerWheel
+{
+public:
+    /**
+     *  @brief Init
+     *
+     *  Initialize the TimerWheel object.  Must be called before
+     *  using the object.
+     */
+    void Init();
+
+    /**
+     *  @brief Add
+     *
+     *  Add a timer to the TimerWheel.
+     *
+     *  @param pclListNode_ Pointer to the Timer to Add
+     */
+    void Add(Timer* pclListNode_);
+
+    /**
+     *  @brief Remove
+     *
+     *  Remove a timer from the TimerWheel, cancelling its expiry.
+     *
+     *  @param pclLinkListNode_ Pointer to the Timer to remove
+     */
+    void Remove(Timer* pclLinkListNode_);
+
+    /**
+     *  @brief Process
+     *
+     *  Advance the wheel by one tick, running the callbacks of all timers
+     *  that expire as a result.  Repeating timers are re-queued according to
+     *  their interval.
+     */
+    void Process();
+
+    /**
+     *  @brief GetWakeupCount
+     *
+     *  @return Number of ticks on which at least one timer expired
+     */
+    uint32_t GetWakeupCount() const { return m_u32Wakeups; }
+
+    /**
+     *  @brief GetCoalescedCount
+     *
+     *  @return Number of timer expiries that shared a tick with another
+     *          timer's expiry (i.e. the number of wakeups saved)
+     */
+    uint32_t GetCoalescedCount() const { return m_u32Coalesced; }
+
+private:
+    /**
+     *  @brief Insert
+     *
+     *  Hash a timer into the slot corresponding to its absolute expiry.  Must
+     *  be called with interrupts disabled.
+     *
+     *  @param pclListNode_ Pointer to the Timer to insert
+     */
+    void Insert(Timer* pclListNode_);
+
+    /**
+     *  @brief Cascade
+     *
+     *  Re-insert all timers from the current slot of a given level, moving
+     *  them to the levels below it as their expiry approaches.
+     *
+     *  @param u8Level_ Level of the wheel to cascade from
+     */
+    void Cascade(uint8_t u8Level_);
+
+    //! Number of slots in each level of the wheel
+    static constexpr auto m_u16Slots = uint16_t{ 1 << KERNEL_TIMERS_WHEEL_BITS };
+
+    //! Total number of slots in the wheel
+    static constexpr auto m_u16TotalSlots = uint16_t{ m_u16Slots * KERNEL_TIMERS_WHEEL_LEVELS };
+
+    //! Timer lists, indexed by (level * slots-per-level) + slot
+    DoubleLinkList m_aclSlots[m_u16TotalSlots];
+
+    //! Number of ticks processed by the wheel
+    uint32_t m_u32Now;
+
+    //! Number of ticks on which at least one timer expired
+    uint32_t m_u32Wakeups;
+
+    //! Number of timer expiries that shared a tick with another expiry
+    uint32_t m_u32Coalesced;
+};
+} // namespace Mark3
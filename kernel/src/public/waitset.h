@@ -0,0 +1,228 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   waitset.h
+
+    @brief  Wait sets - blocking on several kernel objects at once
+
+*/
+
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+#include "blocking.h"
+
+#if KERNEL_WAIT_SETS
+#if KERNEL_WAIT_SET_SIZE > 32
+#error "KERNEL_WAIT_SET_SIZE must not exceed 32"
+#endif // #if KERNEL_WAIT_SET_SIZE > 32
+
+namespace Mark3
+{
+class Semaphore;
+class MessageQueue;
+class Mailbox;
+class EventFlag;
+class Notify;
+
+//---------------------------------------------------------------------------
+//! Returned by WaitSet::Wait() when no object became ready before the timeout
+#define WAIT_SET_NONE (0xFF)
+
+/**
+ * @brief The WaitSet class allows a single thread to block on a set of
+ * Semaphore, MessageQueue, Mailbox, EventFlag and Notify objects at once,
+ * returning as soon as any one of them becomes ready.
+ *
+ * Objects are added to the set once, and identified by the order in which
+ * they were added.  Each object in a set signals the set directly when it
+ * becomes ready - a semaphore or mailbox is posted, a message is sent, flags
+ * are set, or a notification is signalled while no thread is blocked on the
+ * object itself - which wakes the thread waiting on the set without any
+ * polling.  Wait() then returns the index of the ready object, and the caller
+ * collects the data or event using the object's own non-blocking call (e.g.
+ * Semaphore::TryPend(), Mailbox::TryReceive(), EventFlag::TryWait()).
+ *
+ * An object can belong to at most one set.  Objects in a set may still be
+ * used directly by other threads, in which case the object returned by Wait()
+ * may already have been consumed by the time the caller gets to it.
+ */
+class WaitSet : public BlockingObject
+{
+public:
+    void* operator new(size_t sz, void* pv) { return (WaitSet*)pv; };
+    ~WaitSet();
+
+    /**
+     *  @brief Init
+     *
+     *  Initialize the wait set prior to use, removing any objects that were
+     *  previously added to it.
+     */
+    void Init();
+
+    /**
+     *  @brief Add
+     *
+     *  Add a semaphore to the set, which is ready while its count is non-zero.
+     *
+     *  @param pclSemaphore_ Semaphore to add
+     *  @return Index of the object in the set
+     */
+    uint8_t Add(Semaphore* pclSemaphore_);
+
+    /**
+     *  @brief Add
+     *
+     *  Add a message queue to the set, which is ready while it holds messages.
+     *
+     *  @param pclMessageQueue_ Message queue to add
+     *  @return Index of the object in the set
+     */
+    uint8_t Add(MessageQueue* pclMessageQueue_);
+
+    /**
+     *  @brief Add
+     *
+     *  Add a mailbox to the set, which is ready while it holds envelopes.
+     *
+     *  @param pclMailbox_ Mailbox to add
+     *  @return Index of the object in the set
+     */
+    uint8_t Add(Mailbox* pclMailbox_);
+
+#if KERNEL_EVENT_FLAGS
+    /**
+     *  @brief Add
+     *
+     *  Add an event flag object to the set, which is ready while any of the
+     *  specified flags are set.
+     *
+     *  @param pclEventFlag_ Event flag object to add
+     *  @param u16Mask_      Flags of interest
+     *  @return Index of the object in the set
+     */
+    uint8_t Add(EventFlag* pclEventFlag_, uint16_t u16Mask_);
+#endif // #if KERNEL_EVENT_FLAGS
+
+    /**
+     *  @brief Add
+     *
+     *  Add a notification object to the set, which is ready while a signal is
+     *  pending on it.
+     *
+     *  @param pclNotify_ Notification object to add
+     *  @return Index of the object in the set
+     */
+    uint8_t Add(Notify* pclNotify_);
+
+    /**
+     *  @brief Wait
+     *
+     *  Block the calling thread until any object in the set is ready.
+     *
+     *  @return Index of the ready object
+     */
+    uint8_t Wait();
+
+    /**
+     *  @brief Wait
+     *
+     *  Block the calling thread until any object in the set is ready, or until
+     *  the timeout expires.
+     *
+     *  @param u32WaitTimeMS_ Time to wait (in ms)
+     *  @return Index of the ready object, or WAIT_SET_NONE on timeout
+     */
+    uint8_t Wait(uint32_t u32WaitTimeMS_);
+
+    /**
+     *  @brief Signal
+     *
+     *  Called by an object in the set when it may have become ready.  Wakes
+     *  the highest-priority thread waiting on the set.
+     *
+     *  @param u8Index_ Index of the object in the set
+     */
+    void Signal(uint8_t u8Index_);
+
+    /**
+     *  @brief WakeMe
+     *
+     *  Wake a thread blocked on the set, used to implement timeouts.
+     *
+     *  @param pclChosenOne_ Thread to wake
+     */
+    void WakeMe(Thread* pclChosenOne_);
+
+private:
+    //! Condition under which an object in the set is ready
+    enum class Readiness : uint8_t {
+        Count,  //!< Semaphore count is non-zero
+        Flags,  //!< Any of the flags of interest are set
+        Pending //!< Notification is pending
+    };
+
+    /**
+     *  @brief Add_i
+     *
+     *  Internal method which implements all Add() methods in the class.
+     *
+     *  @param pclObject_  Object that signals the set
+     *  @param eReadiness_ Condition under which the object is ready
+     *  @param u16Mask_    Flags of interest (event flags only)
+     *  @return Index of the object in the set
+     */
+    uint8_t Add_i(BlockingObject* pclObject_, Readiness eReadiness_, uint16_t u16Mask_);
+
+    /**
+     *  @brief Wait_i
+     *
+     *  Internal method which implements timed and untimed Wait() methods.
+     *
+     *  @param u32WaitTimeMS_ Time to wait (in ms), 0 to wait indefinitely
+     *  @return Index of the ready object, or WAIT_SET_NONE on timeout
+     */
+    uint8_t Wait_i(uint32_t u32WaitTimeMS_);
+
+    /**
+     *  @brief FindReady_i
+     *
+     *  Check the objects which have signalled the set, in index order,
+     *  forgetting those which are no longer ready.  Must be called from a
+     *  critical section.
+     *
+     *  @return Index of the first ready object, or WAIT_SET_NONE
+     */
+    uint8_t FindReady_i();
+
+    //! Objects in the set
+    BlockingObject* m_apclObjects[KERNEL_WAIT_SET_SIZE];
+
+    //! Flags of interest, for each event flag object in the set
+    uint16_t m_au16Masks[KERNEL_WAIT_SET_SIZE];
+
+    //! Readiness condition of each object in the set
+    Readiness m_aeReadiness[KERNEL_WAIT_SET_SIZE];
+
+    //! Bitmap of the objects which have signalled the set
+    uint32_t m_u32Signalled;
+
+    //! Number of objects in the set
+    uint8_t m_u8Count;
+};
+} // namespace Mark3
+#endif // #if KERNEL_WAIT_SETS
@@ -56,6 +56,10 @@ void Quantum::ClearInTimer()
             pclThreadList->PivotForward();
         }
         m_pclActiveThread = nullptr;
+#if !KERNEL_TIMERS_THREADED
+        // There's no timer thread to block on - switch to the next thread here.
+        Thread::Yield();
+#endif // #if !KERNEL_TIMERS_THREADED
     }
     CS_EXIT();
 }
@@ -71,10 +75,23 @@ void Quantum::Update(Thread* pclTargetThread_)
         || (pclTargetThread_ == m_pclActiveThread) || m_bInTimer) {
         return;
     }
+#if KERNEL_EDF
+    // Threads in the EDF band run in deadline order, and are never rotated
+    if (pclThreadList == Scheduler::GetThreadList(KERNEL_EDF_PRIORITY)) {
+        return;
+    }
+#endif // #if KERNEL_EDF
 
     // Update with a new thread and timeout.
     m_pclActiveThread = pclTargetThread_;
     m_u16TicksRemain  = pclTargetThread_->GetQuantum();
+
+#if KERNEL_TIMERS_TICKLESS
+    // The quantum is counted in timer thread wakeups, so resume ticking.
+    CS_ENTER();
+    KernelTimer::SetExpiry(1);
+    CS_EXIT();
+#endif // #if KERNEL_TIMERS_TICKLESS
 }
 
 //---------------------------------------------------------------------------
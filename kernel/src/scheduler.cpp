@@ -21,30 +21,73 @@ See license.txt for more information
 
 #include "mark3.h"
 
+#if KERNEL_SMP
+volatile Mark3::Thread* g_apclNext[PORT_CORE_COUNT];
+Mark3::Thread*          g_apclCurrent[PORT_CORE_COUNT];
+#else
 volatile Mark3::Thread* g_pclNext;
 Mark3::Thread*          g_pclCurrent;
+#endif // #if KERNEL_SMP
 
 namespace Mark3
 {
-bool        Scheduler::m_bEnabled;
-bool        Scheduler::m_bQueuedSchedule;
-ThreadList  Scheduler::m_clStopList;
+bool       Scheduler::m_bEnabled;
+bool       Scheduler::m_bQueuedSchedule;
+ThreadList Scheduler::m_clStopList;
+#if KERNEL_SMP
+ThreadList  Scheduler::m_aclPriorities[PORT_CORE_COUNT][KERNEL_NUM_PRIORITIES];
+PriorityMap Scheduler::m_aclPrioMap[PORT_CORE_COUNT];
+uint16_t    Scheduler::m_au16CoreLoad[PORT_CORE_COUNT];
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Idle threads, one assigned to each core, so that every core always has a
+// thread to run.
+Thread s_aclIdleThreads[PORT_CORE_COUNT];
+K_WORD s_aawIdleStacks[PORT_CORE_COUNT][PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+//---------------------------------------------------------------------------
+void IdleEntry(void* /*unused*/)
+{
+    while (true) { ThreadPort::CoreIdle(); }
+}
+} // anonymous namespace
+#else
 ThreadList  Scheduler::m_aclPriorities[KERNEL_NUM_PRIORITIES];
 PriorityMap Scheduler::m_clPrioMap;
+#endif // #if KERNEL_SMP
+#if KERNEL_EDF
+uint32_t Scheduler::m_u32Utilization;
+#endif // #if KERNEL_EDF
 
 //---------------------------------------------------------------------------
 void Scheduler::Init()
 {
+#if KERNEL_SMP
+    for (int c = 0; c < PORT_CORE_COUNT; c++) {
+        for (int i = 0; i < KERNEL_NUM_PRIORITIES; i++) {
+            m_aclPriorities[c][i].SetPriority(i);
+            m_aclPriorities[c][i].SetMapPointer(&m_aclPrioMap[c]);
+        }
+    }
+#else
     for (int i = 0; i < KERNEL_NUM_PRIORITIES; i++) {
         m_aclPriorities[i].SetPriority(i);
         m_aclPriorities[i].SetMapPointer(&m_clPrioMap);
     }
+#endif // #if KERNEL_SMP
 }
 
 //---------------------------------------------------------------------------
 void Scheduler::Schedule()
 {
+#if KERNEL_SMP
+    auto u8Core = ThreadPort::CoreId();
+    auto uXPrio = m_aclPrioMap[u8Core].HighestPriority();
+#else
     auto uXPrio = m_clPrioMap.HighestPriority();
+#endif // #if KERNEL_SMP
     if (uXPrio == 0) {
         Kernel::Panic(PANIC_NO_READY_THREADS);
     }
@@ -52,7 +95,11 @@ void Scheduler::Schedule()
     uXPrio--;
 
     // Get the thread node at this priority.
+#if KERNEL_SMP
+    g_apclNext[u8Core] = static_cast<Thread*>(m_aclPriorities[u8Core][uXPrio].GetHead());
+#else
     g_pclNext = static_cast<Thread*>(m_aclPriorities[uXPrio].GetHead());
+#endif // #if KERNEL_SMP
 }
 
 //---------------------------------------------------------------------------
@@ -60,7 +107,20 @@ void Scheduler::Add(Thread* pclThread_)
 {
     KERNEL_ASSERT(pclThread_ != nullptr);
 
-    m_aclPriorities[pclThread_->GetPriority()].Add(pclThread_);
+#if KERNEL_EDF
+    // Threads in the EDF band are kept in deadline order, so the head of the
+    // list is always the thread with the earliest deadline.
+    if (pclThread_->GetCurPriority() == KERNEL_EDF_PRIORITY) {
+        m_aclPriorities[KERNEL_EDF_PRIORITY].AddDeadline(pclThread_);
+        return;
+    }
+#endif // #if KERNEL_EDF
+#if KERNEL_SMP
+    m_aclPriorities[pclThread_->GetCore()][pclThread_->GetCurPriority()].Add(pclThread_);
+    NotifyCore(pclThread_, true);
+#else
+    m_aclPriorities[pclThread_->GetCurPriority()].Add(pclThread_);
+#endif // #if KERNEL_SMP
 }
 
 //---------------------------------------------------------------------------
@@ -68,8 +128,123 @@ void Scheduler::Remove(Thread* pclThread_)
 {
     KERNEL_ASSERT(pclThread_ != nullptr);
 
-    m_aclPriorities[pclThread_->GetPriority()].Remove(pclThread_);
+#if KERNEL_SMP
+    m_aclPriorities[pclThread_->GetCore()][pclThread_->GetCurPriority()].Remove(pclThread_);
+    NotifyCore(pclThread_, false);
+#else
+    m_aclPriorities[pclThread_->GetCurPriority()].Remove(pclThread_);
+#endif // #if KERNEL_SMP
+}
+
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+void Scheduler::NotifyCore(Thread* pclThread_, bool bAdded_)
+{
+    // The calling core reschedules itself as usual
+    auto u8Core = pclThread_->GetCore();
+    if (!Kernel::IsStarted() || (u8Core == ThreadPort::CoreId())) {
+        return;
+    }
+
+    // The other core only needs to switch threads if a thread that should
+    // preempt its current thread was made ready, or its current thread was
+    // removed.  Cores that haven't started yet will schedule when they do.
+    auto* pclCurrent = g_apclCurrent[u8Core];
+    if (pclCurrent == nullptr) {
+        return;
+    }
+    if (bAdded_ ? (pclThread_->GetCurPriority() > pclCurrent->GetCurPriority()) : (pclThread_ == pclCurrent)) {
+        KernelSWI::TriggerCore(u8Core);
+    }
+}
+
+//---------------------------------------------------------------------------
+void Scheduler::Reschedule()
+{
+    if (m_bEnabled) {
+        Schedule();
+    } else {
+        m_bQueuedSchedule = true;
+    }
+}
+
+//---------------------------------------------------------------------------
+uint8_t Scheduler::SelectCore(uint8_t u8Affinity_)
+{
+    KERNEL_ASSERT((u8Affinity_ & ((1 << PORT_CORE_COUNT) - 1)) != 0);
+
+    auto u8Core = uint8_t{ PORT_CORE_COUNT };
+    CS_ENTER();
+    for (auto i = uint8_t{ 0 }; i < PORT_CORE_COUNT; i++) {
+        if (((u8Affinity_ & (1 << i)) != 0)
+            && ((u8Core == PORT_CORE_COUNT) || (m_au16CoreLoad[i] < m_au16CoreLoad[u8Core]))) {
+            u8Core = i;
+        }
+    }
+    m_au16CoreLoad[u8Core]++;
+    CS_EXIT();
+    return u8Core;
+}
+
+//---------------------------------------------------------------------------
+void Scheduler::ReleaseCore(uint8_t u8Core_)
+{
+    CS_ENTER();
+    m_au16CoreLoad[u8Core_]--;
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void Scheduler::WaitForSwitch(Thread* pclThread_)
+{
+    auto u8Core = pclThread_->GetCore();
+    if (!Kernel::IsStarted() || (u8Core == ThreadPort::CoreId())) {
+        return;
+    }
+
+    // The other core switches out the thread from its context switch
+    // interrupt, which completes while that core holds the kernel lock.
+    auto bRunning = true;
+    while (bRunning) {
+        CS_ENTER();
+        bRunning = (g_apclCurrent[u8Core] == pclThread_);
+        CS_EXIT();
+        if (bRunning) {
+            ThreadPort::CoreIdle();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void Scheduler::StartIdle()
+{
+    for (auto i = uint8_t{ 0 }; i < PORT_CORE_COUNT; i++) {
+        auto& clIdle = s_aclIdleThreads[i];
+        clIdle.Init(s_aawIdleStacks[i], sizeof(s_aawIdleStacks[i]), 0, IdleEntry, nullptr);
+        clIdle.SetAffinity(static_cast<uint8_t>(1 << i));
+#if KERNEL_NAMED_THREADS
+        clIdle.SetName("Idle");
+#endif // #if KERNEL_NAMED_THREADS
+        clIdle.Start();
+    }
+}
+#endif // #if KERNEL_SMP
+
+#if KERNEL_EDF
+//---------------------------------------------------------------------------
+bool Scheduler::Admit(uint32_t u32Old_, uint32_t u32New_)
+{
+    auto bAdmit = false;
+    CS_ENTER();
+    auto u32Utilization = m_u32Utilization - u32Old_;
+    if (u32New_ <= (SCHEDULER_EDF_UTILIZATION_MAX - u32Utilization)) {
+        m_u32Utilization = u32Utilization + u32New_;
+        bAdmit           = true;
+    }
+    CS_EXIT();
+    return bAdmit;
 }
+#endif // #if KERNEL_EDF
 
 //---------------------------------------------------------------------------
 bool Scheduler::SetScheduler(bool bEnable_)
@@ -82,6 +257,14 @@ bool Scheduler::SetScheduler(bool bEnable_)
     // immediate Yield
     if (m_bEnabled && m_bQueuedSchedule) {
         m_bQueuedSchedule = false;
+#if KERNEL_SMP
+        // Other cores may have deferred rescheduling as well
+        for (auto i = uint8_t{ 0 }; i < PORT_CORE_COUNT; i++) {
+            if (i != ThreadPort::CoreId()) {
+                KernelSWI::TriggerCore(i);
+            }
+        }
+#endif // #if KERNEL_SMP
         Thread::Yield();
     }
     CS_EXIT();
@@ -26,6 +26,187 @@ See license.txt for more information
 
 namespace Mark3
 {
+namespace
+{
+    //---------------------------------------------------------------------------
+    /**
+     * @brief The SleepQueue class holds all threads blocked in Thread::Sleep(),
+     * each of which is woken by its own embedded timer.
+     */
+    class SleepQueue : public BlockingObject
+    {
+    public:
+        /**
+         *  @brief Sleep
+         *
+         *  Block the current thread until its timer expires.
+         *
+         *  @param u32TimeMs_ Time to sleep (in ms)
+         */
+        void Sleep(uint32_t u32TimeMs_)
+        {
+            CS_ENTER();
+            ArmTimeout(u32TimeMs_, Sleep_Callback);
+            Block(g_pclCurrent);
+            CS_EXIT();
+
+            Thread::Yield();
+            DisarmTimeout();
+        }
+
+        /**
+         *  @brief SleepUntil
+         *
+         *  Block the current thread until the kernel's tick count reaches the
+         *  given deadline.  The time remaining is computed in the same critical
+         *  section that arms the timer, so a tick landing in between cannot
+         *  push the wakeup past the deadline.
+         *
+         *  @param u32WakeTick_ Kernel tick count at which to wake
+         */
+        void SleepUntil(uint32_t u32WakeTick_)
+        {
+            auto bBlocked = false;
+
+            CS_ENTER();
+            auto u32TimeMs = TimeUntil(u32WakeTick_, Kernel::GetTicks());
+            if (u32TimeMs != 0) {
+                ArmTimeout(u32TimeMs, Sleep_Callback);
+                Block(g_pclCurrent);
+                bBlocked = true;
+            }
+            CS_EXIT();
+
+            if (bBlocked) {
+                Thread::Yield();
+                DisarmTimeout();
+            }
+        }
+
+    private:
+        static void Sleep_Callback(Thread* pclOwner_, void* pvData_)
+        {
+            KERNEL_ASSERT(pclOwner_ != nullptr);
+            KERNEL_ASSERT(pvData_ != nullptr);
+
+            auto* pclSleepQueue = static_cast<SleepQueue*>(static_cast<BlockingObject*>(pvData_));
+            CS_ENTER();
+            pclSleepQueue->UnBlock(pclOwner_);
+            CS_EXIT();
+
+            if (pclOwner_->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+                Thread::Yield();
+            }
+        }
+    };
+
+    SleepQueue s_clSleepQueue;
+
+#if KERNEL_THREAD_NOTIFY
+    //---------------------------------------------------------------------------
+    /**
+     * @brief The NotifyQueue class holds all threads blocked in
+     * Thread::WaitNotification().  A notifier always knows which thread it is
+     * waking, so a single shared list serves every thread.
+     */
+    class NotifyQueue : public BlockingObject
+    {
+    public:
+        /**
+         *  @brief Wait
+         *
+         *  Block the current thread, and switch threads once the caller leaves
+         *  its critical section.  Must be called from within a critical section.
+         *
+         *  @param u32TimeMs_ Time to wait (in ms), or 0 to wait indefinitely
+         */
+        void Wait(uint32_t u32TimeMs_)
+        {
+            if (u32TimeMs_ != 0u) {
+                ArmTimeout(u32TimeMs_, Timeout_Callback);
+            }
+            Block(g_pclCurrent);
+            Thread::Yield();
+        }
+
+        /**
+         *  @brief Disarm
+         *
+         *  Cancel the timeout of a timed wait, once the current thread is woken.
+         */
+        void Disarm() { DisarmTimeout(); }
+
+        /**
+         *  @brief Wake
+         *
+         *  Return a waiting thread to its ready list.  Must be called from
+         *  within a critical section.
+         *
+         *  @param pclThread_ Thread to wake
+         */
+        void Wake(Thread* pclThread_) { UnBlock(pclThread_); }
+
+        /**
+         *  @brief IsWaiting
+         *
+         *  @param pclThread_ Thread to check
+         *  @return true if the thread is blocked on this queue
+         */
+        bool IsWaiting(Thread* pclThread_) { return (pclThread_->GetCurrent() == &m_clBlockList); }
+
+    private:
+        static void Timeout_Callback(Thread* pclOwner_, void* pvData_)
+        {
+            KERNEL_ASSERT(pclOwner_ != nullptr);
+            KERNEL_ASSERT(pvData_ != nullptr);
+
+            auto* pclNotifyQueue = static_cast<NotifyQueue*>(static_cast<BlockingObject*>(pvData_));
+            auto  bWoken         = false;
+
+            // The thread may already have been woken by a notification
+            CS_ENTER();
+            if (pclNotifyQueue->IsWaiting(pclOwner_)) {
+                pclOwner_->SetExpired(true);
+                pclNotifyQueue->UnBlock(pclOwner_);
+                bWoken = true;
+            }
+            CS_EXIT();
+
+            if (bWoken && (pclOwner_->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority())) {
+                Thread::Yield();
+            }
+        }
+    };
+
+    NotifyQueue s_clNotifyQueue;
+#endif // #if KERNEL_THREAD_NOTIFY
+
+#if KERNEL_STACK_CHECK
+    //! Longest run of unwritten words tolerated within the used part of a stack
+    constexpr auto cu16StackGapWords = uint16_t{ 8 };
+
+    //---------------------------------------------------------------------------
+    // Number of words at the bottom of a stack that the stack scans must not
+    // touch.  With an MPU guard, this is everything up to the end of the guard
+    // region, which faults on any access - even from privileged code.
+#if PORT_STACK_GUARD_MPU
+    uint16_t StackFloor(const K_WORD* pwStack_)
+    {
+        constexpr auto cuGuardSize = K_ADDR{ PORT_STACK_GUARD_MPU_SIZE };
+
+        auto uBase  = reinterpret_cast<K_ADDR>(pwStack_);
+        auto uLimit = ((uBase + cuGuardSize - 1) & ~(cuGuardSize - 1)) + cuGuardSize;
+        return static_cast<uint16_t>((uLimit - uBase) / sizeof(K_WORD));
+    }
+#else
+    constexpr uint16_t StackFloor(const K_WORD* /*pwStack_*/)
+    {
+        return 0;
+    }
+#endif // #if PORT_STACK_GUARD_MPU
+#endif // #if KERNEL_STACK_CHECK
+} // anonymous namespace
+
 //---------------------------------------------------------------------------
 Thread::~Thread()
 {
@@ -69,21 +250,49 @@ void Thread::Init(
     m_pfEntryPoint  = pfEntryPoint_;
     m_pvArg         = pvArg_;
 
+    m_pclBlockingMutex = nullptr;
+    m_pclHeldMutex     = nullptr;
+
 #if KERNEL_NAMED_THREADS
     m_szName = nullptr;
 #endif
 #if KERNEL_ROUND_ROBIN
     m_u16Quantum = THREAD_QUANTUM_DEFAULT;
 #endif
+#if KERNEL_THREAD_NOTIFY
+    m_u32NotifyValue = 0;
+    m_u32NotifyMask  = 0;
+#endif // #if KERNEL_THREAD_NOTIFY
+#if KERNEL_EDF
+    m_u32Deadline    = 0;
+    m_u32RelDeadline = 0;
+    m_u32Utilization = 0;
+#endif // #if KERNEL_EDF
+#if KERNEL_CPU_ACCOUNTING
+    m_u64RunCycles = 0;
+    m_u32CpuWindow = CpuUsage::GetWindow();
+#endif // #if KERNEL_CPU_ACCOUNTING
+#if KERNEL_SMP
+    m_u8Affinity = 1;
+    m_u8Core     = Scheduler::SelectCore(m_u8Affinity);
+#endif // #if KERNEL_SMP
+#if KERNEL_CPU_BUDGETS
+    m_pclBudget = nullptr;
+#endif // #if KERNEL_CPU_BUDGETS
 
     m_clTimer.Init();
 
     // Call CPU-specific stack initialization
     ThreadPort::InitStack(this);
 
+#if KERNEL_STACK_CHECK
+    // Everything above the initial context is in use from the start
+    m_u16StackMark = static_cast<uint16_t>(m_pwStackTop - m_pwStack);
+#endif // #if KERNEL_STACK_CHECK
+
     // Add to the global "stop" list.
     CS_ENTER();
-    m_pclOwner   = Scheduler::GetThreadList(m_uXPriority);
+    m_pclOwner   = GetReadyList(m_uXPriority);
     m_pclCurrent = Scheduler::GetStopList();
     m_eState     = ThreadState::Stop;
     m_pclCurrent->Add(this);
@@ -117,7 +326,7 @@ void Thread::Start(void)
     CS_ENTER();
     Scheduler::GetStopList()->Remove(this);
     Scheduler::Add(this);
-    m_pclOwner   = Scheduler::GetThreadList(m_uXPriority);
+    m_pclOwner   = GetReadyList(m_uXCurPriority);
     m_pclCurrent = m_pclOwner;
     m_eState     = ThreadState::Ready;
 
@@ -179,6 +388,10 @@ void Thread::Stop()
 
     CS_EXIT();
 
+#if KERNEL_SMP
+    Scheduler::WaitForSwitch(this);
+#endif // #if KERNEL_SMP
+
     if (bReschedule) {
         Thread::Yield();
     }
@@ -195,6 +408,13 @@ void Thread::Exit()
         return;
     }
 
+#if KERNEL_CPU_BUDGETS
+    // Stop replenishing the budget of a thread that no longer exists
+    if (m_pclBudget != nullptr) {
+        m_pclBudget->Stop();
+    }
+#endif // #if KERNEL_CPU_BUDGETS
+
     CS_ENTER();
 
     // If this thread is the actively-running thread, make sure we run the
@@ -217,6 +437,9 @@ void Thread::Exit()
     m_pclCurrent = 0;
     m_pclOwner   = 0;
     m_eState     = ThreadState::Exit;
+#if KERNEL_SMP
+    Scheduler::ReleaseCore(m_u8Core);
+#endif // #if KERNEL_SMP
 
     // We've removed the thread from scheduling, but interrupts might
     // trigger checks against this thread's currently priority before
@@ -226,12 +449,23 @@ void Thread::Exit()
     m_uXCurPriority = 0;
     m_uXPriority    = 0;
 
+#if KERNEL_EDF
+    // Give up the thread's share of the EDF band
+    Scheduler::Admit(m_u32Utilization, 0);
+    m_u32Utilization = 0;
+    m_u32RelDeadline = 0;
+#endif // #if KERNEL_EDF
+
     // Just to be safe - attempt to remove the thread's timer
     // from the timer-scheduler (does no harm if it isn't
     // in the timer-list)
     TimerScheduler::Remove(&m_clTimer);
     CS_EXIT();
 
+#if KERNEL_SMP
+    Scheduler::WaitForSwitch(this);
+#endif // #if KERNEL_SMP
+
 #if KERNEL_THREAD_EXIT_CALLOUT
     ThreadExitCallout pfCallout = Kernel::GetThreadExitCallout();
     if (pfCallout != nullptr) {
@@ -248,32 +482,97 @@ void Thread::Exit()
 //---------------------------------------------------------------------------
 void Thread::Sleep(uint32_t u32TimeMs_)
 {
-    Semaphore clSemaphore;
-    auto*     pclTimer       = g_pclCurrent->GetTimer();
-    auto      lTimerCallback = [](Thread* /*pclOwner*/, void* pvData_) {
-        auto* pclSemaphore = static_cast<Semaphore*>(pvData_);
-        pclSemaphore->Post();
-    };
+    // Block on the kernel's sleep queue, using the thread's own timer to wake
+    // it - no other kernel objects are required.
+    s_clSleepQueue.Sleep(u32TimeMs_);
+}
+
+//---------------------------------------------------------------------------
+void Thread::SleepUntil(uint32_t u32WakeTick_)
+{
+    // Deadlines already reached return immediately, without blocking
+    s_clSleepQueue.SleepUntil(u32WakeTick_);
+}
+
+#if KERNEL_THREAD_NOTIFY
+//---------------------------------------------------------------------------
+void Thread::Notify(uint32_t u32Value_, NotifyAction eAction_)
+{
+    KERNEL_ASSERT(IsInitialized());
+
+    auto bReschedule = false;
+
+    CS_ENTER();
+    switch (eAction_) {
+        case NotifyAction::SetBits: m_u32NotifyValue |= u32Value_; break;
+        case NotifyAction::Increment: m_u32NotifyValue++; break;
+        case NotifyAction::Overwrite: m_u32NotifyValue = u32Value_; break;
+        default: break;
+    }
 
-    // Create a semaphore that this thread will block on
-    clSemaphore.Init(0, 1);
+    // Wake the thread directly - there is no list of waiters to search
+    if (((m_u32NotifyValue & m_u32NotifyMask) != 0) && s_clNotifyQueue.IsWaiting(this)) {
+        m_u32NotifyMask = 0;
+        s_clNotifyQueue.Wake(this);
+        bReschedule = (m_uXCurPriority >= Scheduler::GetCurrentThread()->GetCurPriority());
+    }
+    CS_EXIT();
 
-    // Create a one-shot timer that will call a callback that posts the
-    // semaphore, waking our thread.
-    pclTimer->Init();
-    pclTimer->Start(false, u32TimeMs_, lTimerCallback, &clSemaphore);
+    if (bReschedule) {
+        Thread::Yield();
+    }
+}
 
-    clSemaphore.Pend();
+//---------------------------------------------------------------------------
+uint32_t Thread::WaitNotification(uint32_t u32Mask_)
+{
+    return WaitNotification(u32Mask_, 0);
 }
 
+//---------------------------------------------------------------------------
+uint32_t Thread::WaitNotification(uint32_t u32Mask_, uint32_t u32WaitTimeMS_)
+{
+    KERNEL_ASSERT(u32Mask_ != 0);
+
+    auto* pclThread = Scheduler::GetCurrentThread();
+    auto  u32Ready  = uint32_t{ 0 };
+    auto  bWait     = false;
+
+    CS_ENTER();
+    u32Ready = pclThread->m_u32NotifyValue & u32Mask_;
+    if (u32Ready != 0) {
+        pclThread->m_u32NotifyValue &= ~u32Ready;
+    } else {
+        pclThread->m_u32NotifyMask = u32Mask_;
+        s_clNotifyQueue.Wait(u32WaitTimeMS_);
+        bWait = true;
+    }
+    CS_EXIT();
+
+    if (bWait) {
+        if (u32WaitTimeMS_ != 0u) {
+            s_clNotifyQueue.Disarm();
+        }
+
+        // Consume the bits that were set, even if they arrived with the timeout
+        CS_ENTER();
+        pclThread->m_u32NotifyMask = 0;
+        u32Ready                   = pclThread->m_u32NotifyValue & u32Mask_;
+        pclThread->m_u32NotifyValue &= ~u32Ready;
+        CS_EXIT();
+    }
+    return u32Ready;
+}
+#endif // #if KERNEL_THREAD_NOTIFY
+
 #if KERNEL_STACK_CHECK
 //---------------------------------------------------------------------------
 uint16_t Thread::GetStackSlack()
 {
     KERNEL_ASSERT(IsInitialized());
 
-    K_ADDR wBottom = 0;
-    auto   wTop    = static_cast<K_ADDR>(m_u16StackSize - 1);
+    K_ADDR wBottom = StackFloor(m_pwStack);
+    auto   wTop    = static_cast<K_ADDR>((m_u16StackSize / sizeof(K_WORD)) - 1);
     auto   wMid    = ((wTop + wBottom) + 1) / 2;
 
     CS_ENTER();
@@ -299,6 +598,56 @@ uint16_t Thread::GetStackSlack()
 
     return wMid;
 }
+
+//---------------------------------------------------------------------------
+uint16_t Thread::GetStackHighWater()
+{
+    KERNEL_ASSERT(IsInitialized());
+
+    uint16_t u16HighWater;
+    CS_ENTER();
+    UpdateStackMark();
+    u16HighWater = static_cast<uint16_t>((m_u16StackSize / sizeof(K_WORD)) - m_u16StackMark);
+    CS_EXIT();
+
+    return u16HighWater;
+}
+
+//---------------------------------------------------------------------------
+void Thread::UpdateStackMark()
+{
+    // The mark only ever moves down the stack, and rarely by much between two
+    // context switches - this is usually a handful of comparisons.  Short runs
+    // of painted words, left by stack slots that were never written, are
+    // skipped over.
+    auto u16Floor = StackFloor(m_pwStack);
+    auto u16Gap   = uint16_t{ 0 };
+    while ((m_u16StackMark > (u16Floor + u16Gap)) && (u16Gap < cu16StackGapWords)) {
+        if (m_pwStack[m_u16StackMark - u16Gap - 1] != (K_WORD)(-1)) {
+            m_u16StackMark -= (u16Gap + 1);
+            u16Gap = 0;
+        } else {
+            u16Gap++;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void Thread::CheckStack()
+{
+    UpdateStackMark();
+
+    // The painted word at the edge of the guard margin acts as a canary, in
+    // case the stack has grown past an unwritten gap above it.
+    auto u16Guard = Kernel::GetStackGuardThreshold();
+    auto u16Floor = StackFloor(m_pwStack);
+    if (u16Guard < u16Floor) {
+        u16Guard = u16Floor;
+    }
+    if ((m_u16StackMark <= u16Guard) || (m_pwStack[u16Guard] != (K_WORD)(-1))) {
+        Kernel::Panic(PANIC_STACK_SLACK_VIOLATED);
+    }
+}
 #endif
 
 //---------------------------------------------------------------------------
@@ -325,7 +674,13 @@ void Thread::Yield()
 //---------------------------------------------------------------------------
 void Thread::CoopYield(void)
 {
-    g_pclCurrent->GetCurrent()->PivotForward();
+#if KERNEL_EDF
+    // EDF threads are run in deadline order, not round-robin
+    if (g_pclCurrent->GetPriority() != KERNEL_EDF_PRIORITY)
+#endif // #if KERNEL_EDF
+    {
+        g_pclCurrent->GetCurrent()->PivotForward();
+    }
     Yield();
 }
 
@@ -335,10 +690,20 @@ void Thread::SetPriorityBase(PORT_PRIO_TYPE /*uXPriority_*/)
     KERNEL_ASSERT(IsInitialized());
 
     GetCurrent()->Remove(this);
-    SetCurrent(Scheduler::GetThreadList(m_uXPriority));
+    SetCurrent(GetReadyList(m_uXPriority));
     GetCurrent()->Add(this);
 }
 
+//---------------------------------------------------------------------------
+ThreadList* Thread::GetReadyList(PORT_PRIO_TYPE uXPriority_)
+{
+#if KERNEL_SMP
+    return Scheduler::GetThreadList(uXPriority_, m_u8Core);
+#else
+    return Scheduler::GetThreadList(uXPriority_);
+#endif // #if KERNEL_SMP
+}
+
 //---------------------------------------------------------------------------
 void Thread::SetPriority(PORT_PRIO_TYPE uXPriority_)
 {
@@ -355,14 +720,14 @@ void Thread::SetPriority(PORT_PRIO_TYPE uXPriority_)
         Quantum::Cancel();
 #endif
     }
-    Scheduler::Remove(this);
-    CS_EXIT();
 
-    m_uXCurPriority = uXPriority_;
-    m_uXPriority    = uXPriority_;
-
-    CS_ENTER();
-    Scheduler::Add(this);
+    // A priority inherited through a mutex is kept until the mutex is released
+    auto uXCurPriority = uXPriority_;
+    if ((m_uXCurPriority > m_uXPriority) && (m_uXCurPriority > uXPriority_)) {
+        uXCurPriority = m_uXCurPriority;
+    }
+    m_uXPriority = uXPriority_;
+    InheritPriority(uXCurPriority);
     CS_EXIT();
 
     if (bSchedule) {
@@ -385,9 +750,102 @@ void Thread::InheritPriority(PORT_PRIO_TYPE uXPriority_)
 {
     KERNEL_ASSERT(IsInitialized());
 
-    SetOwner(Scheduler::GetThreadList(uXPriority_));
+    CS_ENTER();
+    // Ready threads are queued by their current priority, and must be moved
+    // to the list for their new one.
+    auto bReady = (m_eState == ThreadState::Ready);
+    if (bReady) {
+        Scheduler::Remove(this);
+    }
     m_uXCurPriority = uXPriority_;
+    SetOwner(GetReadyList(uXPriority_));
+    if (bReady) {
+        Scheduler::Add(this);
+        SetCurrent(m_pclOwner);
+    }
+    CS_EXIT();
+}
+
+#if KERNEL_EDF
+//---------------------------------------------------------------------------
+bool Thread::SetDeadline(uint32_t u32RelDeadline_, uint32_t u32Period_, uint32_t u32ExecTime_)
+{
+    KERNEL_ASSERT(IsInitialized());
+    KERNEL_ASSERT(m_uXPriority == KERNEL_EDF_PRIORITY);
+
+    // Each job must complete within the lesser of its deadline and period
+    auto u32Utilization = uint32_t{ 0 };
+    if (u32RelDeadline_ != 0) {
+        auto u32Window = u32RelDeadline_;
+        if ((u32Period_ != 0) && (u32Period_ < u32Window)) {
+            u32Window = u32Period_;
+        }
+        if (u32ExecTime_ > u32Window) {
+            return false;
+        }
+        u32Utilization = static_cast<uint32_t>(
+            (static_cast<uint64_t>(u32ExecTime_) * SCHEDULER_EDF_UTILIZATION_MAX) / u32Window);
+    }
+
+    if (!Scheduler::Admit(m_u32Utilization, u32Utilization)) {
+        return false;
+    }
+
+    CS_ENTER();
+    m_u32Utilization = u32Utilization;
+    m_u32RelDeadline = u32RelDeadline_;
+    CS_EXIT();
+
+    ReleaseJob(Kernel::GetTicks());
+    return true;
+}
+
+//---------------------------------------------------------------------------
+void Thread::ReleaseJob(uint32_t u32ReleaseTick_)
+{
+    KERNEL_ASSERT(IsInitialized());
+
+    CS_ENTER();
+    m_u32Deadline = u32ReleaseTick_ + m_u32RelDeadline;
+
+    // Re-sort the thread among the ready threads in the band
+    if ((m_eState == ThreadState::Ready) && (m_uXPriority == KERNEL_EDF_PRIORITY)
+        && (m_pclCurrent == Scheduler::GetThreadList(KERNEL_EDF_PRIORITY))) {
+        Scheduler::Remove(this);
+        Scheduler::Add(this);
+    }
+    CS_EXIT();
+}
+#endif // #if KERNEL_EDF
+
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+void Thread::SetAffinity(uint8_t u8Affinity_)
+{
+    KERNEL_ASSERT(IsInitialized());
+    KERNEL_ASSERT(m_eState == ThreadState::Stop);
+
+    CS_ENTER();
+    KERNEL_ASSERT(g_apclCurrent[m_u8Core] != this);
+    Scheduler::ReleaseCore(m_u8Core);
+    m_u8Affinity = u8Affinity_;
+    m_u8Core     = Scheduler::SelectCore(u8Affinity_);
+    CS_EXIT();
+}
+#endif // #if KERNEL_SMP
+
+#if KERNEL_CPU_ACCOUNTING
+//---------------------------------------------------------------------------
+uint64_t Thread::GetRunCycles()
+{
+    KERNEL_ASSERT(IsInitialized());
+    uint64_t u64Cycles;
+    CS_ENTER();
+    u64Cycles = (m_u32CpuWindow == CpuUsage::GetWindow()) ? m_u64RunCycles : 0;
+    CS_EXIT();
+    return u64Cycles;
 }
+#endif // #if KERNEL_CPU_ACCOUNTING
 
 //---------------------------------------------------------------------------
 void Thread::ContextSwitchSWI()
@@ -395,10 +853,13 @@ void Thread::ContextSwitchSWI()
     // Call the context switch interrupt if the scheduler is enabled.
     if (Scheduler::IsEnabled()) {
 #if KERNEL_STACK_CHECK
-        if (g_pclCurrent && (g_pclCurrent->GetStackSlack() <= Kernel::GetStackGuardThreshold())) {
-            Kernel::Panic(PANIC_STACK_SLACK_VIOLATED);
+        if (g_pclCurrent != nullptr) {
+            g_pclCurrent->CheckStack();
         }
 #endif
+#if KERNEL_CPU_ACCOUNTING
+        CpuUsage::Update();
+#endif // #if KERNEL_CPU_ACCOUNTING
 #if KERNEL_CONTEXT_SWITCH_CALLOUT
         auto pfCallout = Kernel::GetThreadContextSwitchCallout();
         if (pfCallout != nullptr) {
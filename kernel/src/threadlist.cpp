@@ -86,6 +86,42 @@ void ThreadList::AddPriority(LinkListNode* node_)
     }
 }
 
+#if KERNEL_EDF
+//---------------------------------------------------------------------------
+void ThreadList::AddDeadline(LinkListNode* node_)
+{
+    KERNEL_ASSERT(node_ != nullptr);
+    auto* pclNode = static_cast<Thread*>(node_);
+    auto* pclCurr = static_cast<Thread*>(GetHead());
+
+    // Find the first thread that is due after this one.  Threads with equal
+    // deadlines are run first-come, first-served.
+    if (pclNode->HasDeadline()) {
+        while (pclCurr != nullptr) {
+            if (!pclCurr->HasDeadline() || TimeBefore(pclNode->GetDeadline(), pclCurr->GetDeadline())) {
+                break;
+            }
+            pclCurr = (pclCurr == GetTail()) ? nullptr : static_cast<Thread*>(pclCurr->GetNext());
+        }
+    } else {
+        pclCurr = nullptr;
+    }
+
+    if (pclCurr == nullptr) {
+        CircularLinkList::Add(pclNode);
+    } else {
+        InsertNodeBefore(pclNode, pclCurr);
+        if (pclCurr == GetHead()) {
+            m_pclHead = pclNode;
+        }
+    }
+
+    if (m_pclMap != nullptr) {
+        m_pclMap->Set(m_uXPriority);
+    }
+}
+#endif // #if KERNEL_EDF
+
 //---------------------------------------------------------------------------
 void ThreadList::Add(LinkListNode* node_, PriorityMap* pclMap_, PORT_PRIO_TYPE uXPriority_)
 {
@@ -23,7 +23,11 @@ See license.txt for more information
 
 namespace Mark3
 {
+#if KERNEL_TIMERS_WHEEL
+TimerWheel TimerScheduler::m_clTimerList;
+#else
 TimerList TimerScheduler::m_clTimerList;
+#endif
 
 //---------------------------------------------------------------------------
 Timer::Timer()
@@ -40,25 +44,38 @@ void Timer::Init()
     }
 
     ClearNode();
-    m_u32Interval = 0;
-    m_u32TimeLeft = 0;
-    m_u8Flags     = 0;
+    m_u32Interval  = 0;
+    m_u32Tolerance = 0;
+    m_u32TimeLeft  = 0;
+    m_u8Flags      = 0;
 
     SetInitialized();
 }
 
 //---------------------------------------------------------------------------
 void Timer::Start(bool bRepeat_, uint32_t u32IntervalMs_, TimerCallback pfCallback_, void* pvData_)
+{
+    Start(bRepeat_, u32IntervalMs_, 0, pfCallback_, pvData_);
+}
+
+//---------------------------------------------------------------------------
+void Timer::Start(bool          bRepeat_,
+                  uint32_t      u32IntervalMs_,
+                  uint32_t      u32ToleranceMs_,
+                  TimerCallback pfCallback_,
+                  void*         pvData_)
 {
     KERNEL_ASSERT(IsInitialized());
+    KERNEL_ASSERT(u32ToleranceMs_ <= MAX_TIMER_TICKS);
 
     if ((m_u8Flags & TIMERLIST_FLAG_ACTIVE) != 0) {
         return;
     }
 
-    m_u32Interval = u32IntervalMs_;
-    m_pfCallback  = pfCallback_;
-    m_pvData      = pvData_;
+    m_u32Interval  = u32IntervalMs_;
+    m_u32Tolerance = u32ToleranceMs_;
+    m_pfCallback   = pfCallback_;
+    m_pvData       = pvData_;
 
     if (!bRepeat_) {
         m_u8Flags = TIMERLIST_FLAG_ONE_SHOT;
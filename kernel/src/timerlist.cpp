@@ -28,67 +28,443 @@ void TimerList::Init(void)
 {
     m_bTimerActive  = false;
     m_u32NextWakeup = 0;
-    m_clMutex.Init();
+    m_u32Wakeups    = 0;
+    m_u32Coalesced  = 0;
+    m_u32Epoch      = 0;
+#if !KERNEL_TIMERS_TICKLESS
+    m_u32Lag = 0;
+#endif // #if !KERNEL_TIMERS_TICKLESS
+#if KERNEL_TIMERS_THREADED
+    m_clPending.Init();
+    m_u32PendingWakeup = 0;
+    m_u16Generation    = 0;
+#endif // #if KERNEL_TIMERS_THREADED
 }
 
 //---------------------------------------------------------------------------
 void TimerList::Add(Timer* pclListNode_)
 {
     KERNEL_ASSERT(pclListNode_ != nullptr);
-    auto lock = LockGuard{ &m_clMutex };
+    CS_ENTER();
 
-    pclListNode_->ClearNode();
-    DoubleLinkList::Add(pclListNode_);
+    // Expire at least one tick out
+    auto u32Interval = pclListNode_->m_u32Interval;
+    if (u32Interval == 0) {
+        u32Interval = 1;
+    }
+    // Timers are queued relative to the head of the list, which may lag the
+    // current tick count.
+    u32Interval += GetLag();
+
+#if KERNEL_TIMERS_THREADED
+#if KERNEL_TIMERS_TICKLESS
+    // Check whether this timer is due before every other timer, queued or not
+    auto u32Latest = m_u32Epoch + u32Interval + pclListNode_->m_u32Tolerance;
+    auto bEarliest = ((m_clPending.GetHead() == nullptr)
+                      || (static_cast<int32_t>(u32Latest - m_u32PendingWakeup) < 0))
+                     && ((GetHead() == nullptr)
+                         || (static_cast<int32_t>(u32Latest - (m_u32Epoch + m_u32NextWakeup)) < 0));
+#endif // #if KERNEL_TIMERS_TICKLESS
 
-    // Set the initial timer value
-    pclListNode_->m_u32TimeLeft = pclListNode_->m_u32Interval;
+    // Leave sorting the timer into the list to the timer thread, so that
+    // starting a timer only holds off interrupts for a constant time.
+    Defer(pclListNode_, m_u32Epoch + u32Interval);
+    pclListNode_->m_u8Flags |= TIMERLIST_FLAG_ACTIVE;
+
+#if KERNEL_TIMERS_TICKLESS
+    // Bring the kernel timer's expiry forward if this timer is now due first
+    if (bEarliest) {
+        SetWakeup();
+    }
+#endif // #if KERNEL_TIMERS_TICKLESS
+#else
+    Insert(pclListNode_, u32Interval);
 
     // Set the timer as active.
     pclListNode_->m_u8Flags |= TIMERLIST_FLAG_ACTIVE;
+
+#if KERNEL_TIMERS_TICKLESS
+    auto u32Wakeup = m_u32NextWakeup;
+    UpdateWakeup();
+
+    // Bring the kernel timer's expiry forward if this timer is now due first
+    if ((GetHead() == pclListNode_) || (m_u32NextWakeup != u32Wakeup)) {
+        SetWakeup();
+    }
+#else
+    UpdateWakeup();
+#endif // #if KERNEL_TIMERS_TICKLESS
+#endif // #if KERNEL_TIMERS_THREADED
+    CS_EXIT();
 }
 
 //---------------------------------------------------------------------------
 void TimerList::Remove(Timer* pclLinkListNode_)
 {
     KERNEL_ASSERT(pclLinkListNode_ != nullptr);
-    auto lock = LockGuard{ &m_clMutex };
+    CS_ENTER();
 
-    DoubleLinkList::Remove(pclLinkListNode_);
-    pclLinkListNode_->m_u8Flags &= ~TIMERLIST_FLAG_ACTIVE;
+    // Timers whose callback is running have already been taken off the list
+    auto u8Unlisted = uint8_t{ TIMERLIST_FLAG_CALLBACK };
+#if KERNEL_TIMERS_THREADED
+    if ((pclLinkListNode_->m_u8Flags & TIMERLIST_FLAG_PENDING) != 0) {
+        m_clPending.Remove(pclLinkListNode_);
+    }
+    // ... as have timers being sorted into it, which the timer thread drops
+    // once it sees that they have been stopped.
+    u8Unlisted |= TIMERLIST_FLAG_PENDING | TIMERLIST_FLAG_INSERTING;
+#endif // #if KERNEL_TIMERS_THREADED
+    if ((pclLinkListNode_->m_u8Flags & u8Unlisted) == 0) {
+        // Give the removed timer's delta back to its successor, so that the
+        // expiry of every timer behind it is unchanged.
+        auto* pclNext = static_cast<Timer*>(pclLinkListNode_->GetNext());
+        if (pclNext != nullptr) {
+            pclNext->m_u32TimeLeft += pclLinkListNode_->m_u32TimeLeft;
+        }
+        DoubleLinkList::Remove(pclLinkListNode_);
+#if KERNEL_TIMERS_THREADED
+        m_u16Generation++;
+#endif // #if KERNEL_TIMERS_THREADED
+        UpdateWakeup();
+    }
+    pclLinkListNode_->m_u8Flags &= ~(TIMERLIST_FLAG_ACTIVE | TIMERLIST_FLAG_CALLBACK);
+#if KERNEL_TIMERS_THREADED
+    pclLinkListNode_->m_u8Flags &= ~(TIMERLIST_FLAG_PENDING | TIMERLIST_FLAG_INSERTING);
+#endif // #if KERNEL_TIMERS_THREADED
+    CS_EXIT();
 }
 
 //---------------------------------------------------------------------------
 void TimerList::Process(void)
 {
-    auto lock = LockGuard{ &m_clMutex };
+    auto bDue = false;
+#if KERNEL_TIMERS_THREADED
+    Merge();
+#endif // #if KERNEL_TIMERS_THREADED
 
-    auto* pclCurr = static_cast<Timer*>(GetHead());
-    // Subtract the elapsed time interval from each active timer.
-    while (pclCurr != 0) {
-        auto* pclNext = static_cast<Timer*>(pclCurr->GetNext());
+    CS_ENTER();
+#if KERNEL_TIMERS_TICKLESS
+    auto u32Lag = GetLag();
+#else
+    auto u32Lag = ++m_u32Lag;
+#endif // #if KERNEL_TIMERS_TICKLESS
 
-        // Active timers only...
-        if ((pclCurr->m_u8Flags & TIMERLIST_FLAG_ACTIVE) != 0) {
-            pclCurr->m_u32TimeLeft--;
-            if (0 == pclCurr->m_u32TimeLeft) {
-                // Expired -- run the callback. these callbacks must be very fast...
-                if (pclCurr->m_pfCallback != nullptr) {
-                    pclCurr->m_pfCallback(pclCurr->m_pclOwner, pclCurr->m_pvData);
-                }
+    // Hold off on expiring timers until the next wakeup is due, so that timers
+    // whose tolerances overlap are expired together.
+    bDue = (GetHead() == nullptr) || (u32Lag >= m_u32NextWakeup);
+    CS_EXIT();
+
+    if (bDue) {
+        Advance();
+#if KERNEL_TIMERS_THREADED
+        // Sort in the repeating timers that were re-queued
+        Merge();
+#endif // #if KERNEL_TIMERS_THREADED
+    }
+#if KERNEL_TIMERS_TICKLESS
+    SetWakeup();
+#endif // #if KERNEL_TIMERS_TICKLESS
+}
+
+#if KERNEL_TIMERS_TICKLESS
+//---------------------------------------------------------------------------
+void TimerList::ForceUpdate(uint32_t u32Ticks_)
+{
+    CS_ENTER();
+    Kernel::Tick(u32Ticks_);
+    CS_EXIT();
+
+    Process();
+}
+
+//---------------------------------------------------------------------------
+void TimerList::SetWakeup(void)
+{
+    CS_ENTER();
+    auto u32Ticks  = uint32_t{ 0 };
+    auto u32Wakeup = m_u32NextWakeup;
+    auto bExpiry   = (GetHead() != nullptr);
+#if KERNEL_TIMERS_THREADED
+    // Timers that have yet to be sorted into the list must be woken for too
+    if (m_clPending.GetHead() != nullptr) {
+        auto iPending   = static_cast<int32_t>(m_u32PendingWakeup - m_u32Epoch);
+        auto u32Pending = (iPending > 0) ? static_cast<uint32_t>(iPending) : uint32_t{ 0 };
+        if (!bExpiry || (u32Pending < u32Wakeup)) {
+            u32Wakeup = u32Pending;
+        }
+        bExpiry = true;
+    }
+#endif // #if KERNEL_TIMERS_THREADED
+    if (bExpiry) {
+        // The next wakeup is relative to the list's epoch, which may lag the
+        // current tick count.  Anything overdue expires on the next tick.
+        auto u32Lag = GetLag();
+        u32Ticks    = 1;
+        if (u32Wakeup > u32Lag) {
+            u32Ticks = u32Wakeup - u32Lag;
+        }
+    }
+#if KERNEL_ROUND_ROBIN
+    // Keep ticking while a round-robin quantum is being counted down
+    if (Quantum::IsActive()) {
+        u32Ticks = 1;
+    }
+#endif // #if KERNEL_ROUND_ROBIN
+
+    if (u32Ticks == 0) {
+        KernelTimer::ClearExpiry();
+    } else {
+        KernelTimer::SetExpiry(u32Ticks);
+    }
+    CS_EXIT();
+}
+#endif // #if KERNEL_TIMERS_TICKLESS
+
+//---------------------------------------------------------------------------
+void TimerList::Advance()
+{
+    // Only the head of the list carries the time remaining until the next
+    // expiry -- every other timer is relative to its predecessor.  Expire
+    // timers from the front of the list until the elapsed time is used up.
+    //
+    // The list is only locked while it is being modified -- callbacks run with
+    // interrupts enabled, during which other threads may add and remove timers
+    // (including the expiring timer itself).
+    auto u32Expired = uint32_t{ 0 };
+    while (true) {
+        Timer* pclCurr;
+        CS_ENTER();
+        auto u32Lag = GetLag();
+        pclCurr     = static_cast<Timer*>(GetHead());
+        if ((pclCurr != nullptr) && (pclCurr->m_u32TimeLeft <= u32Lag)) {
+            Consume(pclCurr->m_u32TimeLeft);
+            pclCurr->m_u32TimeLeft = 0;
+            DoubleLinkList::Remove(pclCurr);
+#if KERNEL_TIMERS_THREADED
+            m_u16Generation++;
+#endif // #if KERNEL_TIMERS_THREADED
+            pclCurr->m_u8Flags |= TIMERLIST_FLAG_CALLBACK;
+            u32Expired++;
+        } else {
+            // Nothing else is due - bring the head of the list up to date.
+            if (pclCurr != nullptr) {
+                pclCurr->m_u32TimeLeft -= u32Lag;
+            }
+            Consume(u32Lag);
+            if (u32Expired != 0) {
+                m_u32Wakeups++;
+                m_u32Coalesced += u32Expired - 1;
+            }
+            UpdateWakeup();
+            pclCurr = nullptr;
+        }
+        CS_EXIT();
+
+        if (pclCurr == nullptr) {
+            break;
+        }
+
+        // Expired -- run the callback. these callbacks must be very fast...
+        // When processed from the timer interrupt, callbacks keep running with
+        // interrupts disabled, as they always have.
+        if (pclCurr->m_pfCallback != nullptr) {
+#if !KERNEL_TIMERS_THREADED
+            CS_ENTER();
+#endif // #if !KERNEL_TIMERS_THREADED
+            pclCurr->m_pfCallback(pclCurr->m_pclOwner, pclCurr->m_pvData);
+#if !KERNEL_TIMERS_THREADED
+            CS_EXIT();
+#endif // #if !KERNEL_TIMERS_THREADED
+        }
 
-                if ((pclCurr->m_u8Flags & TIMERLIST_FLAG_ONE_SHOT) != 0) {
-                    // If this was a one-shot timer, deactivate the timer + remove
-                    pclCurr->m_u8Flags |= TIMERLIST_FLAG_EXPIRED;
-                    pclCurr->m_u8Flags &= ~TIMERLIST_FLAG_ACTIVE;
-                    Remove(pclCurr);
-                } else {
-                    // Reset the interval timer.
-                    pclCurr->m_u32TimeLeft = pclCurr->m_u32Interval;
+        CS_ENTER();
+        // Unless the callback has stopped or restarted this timer, retire it.
+        if ((pclCurr->m_u8Flags & TIMERLIST_FLAG_CALLBACK) != 0) {
+            pclCurr->m_u8Flags &= ~TIMERLIST_FLAG_CALLBACK;
+            if ((pclCurr->m_u8Flags & TIMERLIST_FLAG_ONE_SHOT) != 0) {
+                // If this was a one-shot timer, deactivate the timer
+                pclCurr->m_u8Flags |= TIMERLIST_FLAG_EXPIRED;
+                pclCurr->m_u8Flags &= ~TIMERLIST_FLAG_ACTIVE;
+            } else {
+                // Re-queue the interval timer, at least one tick out.
+                auto u32Interval = pclCurr->m_u32Interval;
+                if (u32Interval == 0) {
+                    u32Interval = 1;
                 }
+                // A timer that was expired late as part of a batch skips any
+                // periods that have already elapsed, rather than expiring
+                // repeatedly to catch up.  It remains in phase.
+                auto u32Lag = GetLag();
+                if ((pclCurr->m_u32Tolerance != 0) && (u32Interval <= u32Lag)) {
+                    u32Interval += ((u32Lag - u32Interval) / u32Interval + 1) * u32Interval;
+                }
+#if KERNEL_TIMERS_THREADED
+                Defer(pclCurr, m_u32Epoch + u32Interval);
+#else
+                Insert(pclCurr, u32Interval);
+#endif // #if KERNEL_TIMERS_THREADED
             }
         }
-        pclCurr = pclNext;
+        CS_EXIT();
+    }
+}
+
+//---------------------------------------------------------------------------
+void TimerList::Consume(uint32_t u32Ticks_)
+{
+    m_u32Epoch += u32Ticks_;
+#if !KERNEL_TIMERS_TICKLESS
+    m_u32Lag -= u32Ticks_;
+#endif // #if !KERNEL_TIMERS_TICKLESS
+}
+
+//---------------------------------------------------------------------------
+void TimerList::UpdateWakeup()
+{
+    // The list is sorted by earliest expiry, so once a timer's earliest expiry
+    // is beyond the wakeup found so far, no timer behind it can bring the
+    // wakeup forward.
+    auto  u32Wakeup = uint32_t{ 0xFFFFFFFF };
+    auto  u32Expiry = uint32_t{ 0 };
+    auto* pclCurr   = static_cast<Timer*>(GetHead());
+    while (pclCurr != nullptr) {
+        u32Expiry += pclCurr->m_u32TimeLeft;
+        if (u32Expiry >= u32Wakeup) {
+            break;
+        }
+        auto u32Latest = u32Expiry + pclCurr->m_u32Tolerance;
+        if (u32Latest < u32Wakeup) {
+            u32Wakeup = u32Latest;
+        }
+        pclCurr = static_cast<Timer*>(pclCurr->GetNext());
+    }
+    m_u32NextWakeup = u32Wakeup;
+}
+
+//---------------------------------------------------------------------------
+uint32_t TimerList::GetLag()
+{
+#if KERNEL_TIMERS_TICKLESS
+    return Kernel::GetTicks() - m_u32Epoch;
+#else
+    return m_u32Lag;
+#endif // #if KERNEL_TIMERS_TICKLESS
+}
+
+//---------------------------------------------------------------------------
+void TimerList::Insert(Timer* pclListNode_, uint32_t u32Ticks_)
+{
+    auto* pclNext = Find(&u32Ticks_);
+    Splice(pclListNode_, pclNext, u32Ticks_);
+}
+
+//---------------------------------------------------------------------------
+Timer* TimerList::Find(uint32_t* pu32Ticks_)
+{
+    // Walk the list, consuming the deltas of all timers that expire on or
+    // before this one.  Timers with the same expiry fire in the order added.
+    auto  u32Ticks = *pu32Ticks_;
+    auto* pclCurr  = static_cast<Timer*>(GetHead());
+    while ((pclCurr != nullptr) && (pclCurr->m_u32TimeLeft <= u32Ticks)) {
+        u32Ticks -= pclCurr->m_u32TimeLeft;
+        pclCurr = static_cast<Timer*>(pclCurr->GetNext());
+    }
+    *pu32Ticks_ = u32Ticks;
+    return pclCurr;
+}
+
+//---------------------------------------------------------------------------
+void TimerList::Splice(Timer* pclListNode_, Timer* pclNext_, uint32_t u32Ticks_)
+{
+    pclListNode_->ClearNode();
+    pclListNode_->m_u32TimeLeft = u32Ticks_;
+    if (pclNext_ == nullptr) {
+        DoubleLinkList::Add(pclListNode_);
+    } else {
+        pclNext_->m_u32TimeLeft -= u32Ticks_;
+        DoubleLinkList::InsertNodeBefore(pclListNode_, pclNext_);
+    }
+}
+
+#if KERNEL_TIMERS_THREADED
+//---------------------------------------------------------------------------
+void TimerList::Defer(Timer* pclListNode_, uint32_t u32Expiry_)
+{
+    auto u32Latest = u32Expiry_ + pclListNode_->m_u32Tolerance;
+    if ((m_clPending.GetHead() == nullptr) || (static_cast<int32_t>(u32Latest - m_u32PendingWakeup) < 0)) {
+        m_u32PendingWakeup = u32Latest;
+    }
+
+    // Pending timers hold their expiry in list time, as the head of the list
+    // may move on before they are sorted into it.
+    pclListNode_->ClearNode();
+    pclListNode_->m_u32TimeLeft = u32Expiry_;
+    pclListNode_->m_u8Flags |= TIMERLIST_FLAG_PENDING;
+    m_clPending.Add(pclListNode_);
+}
+
+//---------------------------------------------------------------------------
+void TimerList::Merge()
+{
+    while (true) {
+        auto   u32Ticks      = uint32_t{ 0 };
+        auto   u16Generation = uint16_t{ 0 };
+        Timer* pclTimer;
+
+        CS_ENTER();
+        pclTimer = static_cast<Timer*>(m_clPending.GetHead());
+        if (pclTimer != nullptr) {
+            m_clPending.Remove(pclTimer);
+            pclTimer->m_u8Flags &= ~TIMERLIST_FLAG_PENDING;
+            pclTimer->m_u8Flags |= TIMERLIST_FLAG_INSERTING;
+
+            // Anything already overdue goes to the front of the list
+            auto iTicks   = static_cast<int32_t>(pclTimer->m_u32TimeLeft - m_u32Epoch);
+            u32Ticks      = (iTicks > 0) ? static_cast<uint32_t>(iTicks) : uint32_t{ 0 };
+            u16Generation = m_u16Generation;
+        }
+        CS_EXIT();
+
+        if (pclTimer == nullptr) {
+            break;
+        }
+
+#if KERNEL_SMP
+        // Other cores keep running with the scheduler disabled, so the list can
+        // only be walked with the kernel lock held.
+        (void)u16Generation;
+        auto u32Delta = u32Ticks;
+        CS_ENTER();
+        auto* pclNext = Find(&u32Delta);
+#else
+        // Find the timer's place with only the scheduler disabled.  No other
+        // thread can modify the list in the meantime; an interrupt that stops
+        // a timer is caught by the generation count, and the walk redone.
+        auto  bEnabled = Scheduler::SetScheduler(false);
+        auto  u32Delta = u32Ticks;
+        auto* pclNext  = Find(&u32Delta);
+
+        CS_ENTER();
+        if (m_u16Generation != u16Generation) {
+            u32Delta = u32Ticks;
+            pclNext  = Find(&u32Delta);
+        }
+#endif // #if KERNEL_SMP
+
+        // Drop the timer if it was stopped while its place was being found
+        if ((pclTimer->m_u8Flags & TIMERLIST_FLAG_INSERTING) != 0) {
+            pclTimer->m_u8Flags &= ~TIMERLIST_FLAG_INSERTING;
+            Splice(pclTimer, pclNext, u32Delta);
+            m_u16Generation++;
+            UpdateWakeup();
+        }
+        CS_EXIT();
+
+#if !KERNEL_SMP
+        Scheduler::SetScheduler(bEnabled);
+#endif // #if !KERNEL_SMP
     }
 }
+#endif // #if KERNEL_TIMERS_THREADED
 
 } // namespace Mark3
@@ -0,0 +1,217 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   timerwheel.cpp
+
+    @brief  Implements a hierarchical timer wheel, responsible for timer tick
+            and expiry logic when a large number of timers are in use.
+
+*/
+
+#include "mark3.h"
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Mask for the slot index within a level of the wheel
+constexpr auto cu32SlotMask = uint32_t{ (1 << KERNEL_TIMERS_WHEEL_BITS) - 1 };
+
+// Number of ticks covered by the full wheel.  Timers further out than this
+// are parked at the top level, and re-cascaded until they come into range.
+constexpr auto cu32WheelRange = uint32_t{ 1UL << (KERNEL_TIMERS_WHEEL_BITS * KERNEL_TIMERS_WHEEL_LEVELS) };
+
+static_assert((KERNEL_TIMERS_WHEEL_BITS * KERNEL_TIMERS_WHEEL_LEVELS) < 32, "Timer wheel must cover < 2^32 ticks");
+static_assert(((1 << KERNEL_TIMERS_WHEEL_BITS) * KERNEL_TIMERS_WHEEL_LEVELS) <= 256,
+              "Timer wheel slot index must fit in 8 bits");
+
+//---------------------------------------------------------------------------
+// Delay an expiry to the coarsest power-of-two tick boundary that is within the
+// timer's tolerance, so that timers whose tolerances overlap share a slot.
+uint32_t Coalesce(uint32_t u32Expiry_, uint32_t u32Tolerance_)
+{
+    auto u32Granule = uint32_t{ 1 };
+    while ((((u32Granule << 1) - 1) <= u32Tolerance_) && (u32Granule < (1UL << 30))) { u32Granule <<= 1; }
+    return (u32Expiry_ + u32Granule - 1) & ~(u32Granule - 1);
+}
+} // anonymous namespace
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void TimerWheel::Init(void)
+{
+    for (auto& clSlot : m_aclSlots) { clSlot.Init(); }
+    m_u32Now       = 0;
+    m_u32Wakeups   = 0;
+    m_u32Coalesced = 0;
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::Add(Timer* pclListNode_)
+{
+    KERNEL_ASSERT(pclListNode_ != nullptr);
+    CS_ENTER();
+
+    // Expire at least one tick out, since the current slot has already been
+    // processed for this tick.
+    auto u32Interval = pclListNode_->m_u32Interval;
+    if (u32Interval == 0) {
+        u32Interval = 1;
+    }
+    pclListNode_->m_u32TimeLeft = Coalesce(m_u32Now + u32Interval, pclListNode_->m_u32Tolerance);
+    Insert(pclListNode_);
+
+    // Set the timer as active.
+    pclListNode_->m_u8Flags |= TIMERLIST_FLAG_ACTIVE;
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::Remove(Timer* pclLinkListNode_)
+{
+    KERNEL_ASSERT(pclLinkListNode_ != nullptr);
+    CS_ENTER();
+
+    // Timers whose callback is running have already been taken off the wheel
+    if ((pclLinkListNode_->m_u8Flags & TIMERLIST_FLAG_CALLBACK) == 0) {
+        m_aclSlots[pclLinkListNode_->m_u8WheelSlot].Remove(pclLinkListNode_);
+    }
+    pclLinkListNode_->m_u8Flags &= ~(TIMERLIST_FLAG_ACTIVE | TIMERLIST_FLAG_CALLBACK);
+    CS_EXIT();
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::Process(void)
+{
+    auto u32Now = uint32_t{ 0 };
+
+    CS_ENTER();
+    m_u32Now++;
+
+    // Each time a level wraps around, pull the next slot of the level above
+    // it down into the wheel.
+    for (uint8_t u8Level = 1; u8Level < KERNEL_TIMERS_WHEEL_LEVELS; u8Level++) {
+        if (((m_u32Now >> (KERNEL_TIMERS_WHEEL_BITS * (u8Level - 1))) & cu32SlotMask) != 0) {
+            break;
+        }
+        Cascade(u8Level);
+    }
+    u32Now = m_u32Now;
+    CS_EXIT();
+
+    // Every timer in the current slot of the lowest level expires this tick.
+    // Timers are popped one at a time so that callbacks run with interrupts
+    // enabled.
+    auto& clSlot     = m_aclSlots[u32Now & cu32SlotMask];
+    auto  u32Expired = uint32_t{ 0 };
+    while (true) {
+        Timer* pclCurr;
+        CS_ENTER();
+        pclCurr = static_cast<Timer*>(clSlot.GetHead());
+        if (pclCurr != nullptr) {
+            clSlot.Remove(pclCurr);
+            pclCurr->m_u8Flags |= TIMERLIST_FLAG_CALLBACK;
+            u32Expired++;
+        }
+        CS_EXIT();
+        if (pclCurr == nullptr) {
+            break;
+        }
+
+        // Expired -- run the callback. these callbacks must be very fast...
+        // When processed from the timer interrupt, callbacks keep running with
+        // interrupts disabled, as they always have.
+        if (pclCurr->m_pfCallback != nullptr) {
+#if !KERNEL_TIMERS_THREADED
+            CS_ENTER();
+#endif // #if !KERNEL_TIMERS_THREADED
+            pclCurr->m_pfCallback(pclCurr->m_pclOwner, pclCurr->m_pvData);
+#if !KERNEL_TIMERS_THREADED
+            CS_EXIT();
+#endif // #if !KERNEL_TIMERS_THREADED
+        }
+
+        // Unless the callback has stopped or restarted this timer, retire it.
+        CS_ENTER();
+        if ((pclCurr->m_u8Flags & TIMERLIST_FLAG_CALLBACK) != 0) {
+            pclCurr->m_u8Flags &= ~TIMERLIST_FLAG_CALLBACK;
+            if ((pclCurr->m_u8Flags & TIMERLIST_FLAG_ONE_SHOT) != 0) {
+                // If this was a one-shot timer, deactivate the timer
+                pclCurr->m_u8Flags |= TIMERLIST_FLAG_EXPIRED;
+                pclCurr->m_u8Flags &= ~TIMERLIST_FLAG_ACTIVE;
+            } else {
+                // Re-queue the interval timer, at least one tick out.
+                auto u32Interval = pclCurr->m_u32Interval;
+                if (u32Interval == 0) {
+                    u32Interval = 1;
+                }
+                pclCurr->m_u32TimeLeft = Coalesce(m_u32Now + u32Interval, pclCurr->m_u32Tolerance);
+                Insert(pclCurr);
+            }
+        }
+        CS_EXIT();
+    }
+
+    if (u32Expired != 0) {
+        CS_ENTER();
+        m_u32Wakeups++;
+        m_u32Coalesced += u32Expired - 1;
+        CS_EXIT();
+    }
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::Insert(Timer* pclListNode_)
+{
+    pclListNode_->ClearNode();
+
+    // m_u32TimeLeft holds the absolute expiry of the timer while on the wheel
+    auto u32Expiry = pclListNode_->m_u32TimeLeft;
+    auto u32Delta  = u32Expiry - m_u32Now;
+    if (u32Delta >= cu32WheelRange) {
+        u32Delta  = cu32WheelRange - 1;
+        u32Expiry = m_u32Now + u32Delta;
+    }
+
+    // Select the lowest level whose span covers the time remaining
+    auto u8Level = uint8_t{ 0 };
+    while ((u8Level < (KERNEL_TIMERS_WHEEL_LEVELS - 1))
+           && (u32Delta >= (1UL << (KERNEL_TIMERS_WHEEL_BITS * (u8Level + 1))))) {
+        u8Level++;
+    }
+
+    auto u8Slot = static_cast<uint8_t>((u8Level * m_u16Slots)
+                                       + ((u32Expiry >> (KERNEL_TIMERS_WHEEL_BITS * u8Level)) & cu32SlotMask));
+    pclListNode_->m_u8WheelSlot = u8Slot;
+    m_aclSlots[u8Slot].Add(pclListNode_);
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::Cascade(uint8_t u8Level_)
+{
+    auto  u8Slot
+        = static_cast<uint8_t>((u8Level_ * m_u16Slots) + ((m_u32Now >> (KERNEL_TIMERS_WHEEL_BITS * u8Level_)) & cu32SlotMask));
+    auto& clSlot = m_aclSlots[u8Slot];
+
+    // Timers are always re-inserted into a lower level, or into a different
+    // slot at the top level, so this terminates.
+    auto* pclCurr = static_cast<Timer*>(clSlot.GetHead());
+    while (pclCurr != nullptr) {
+        clSlot.Remove(pclCurr);
+        Insert(pclCurr);
+        pclCurr = static_cast<Timer*>(clSlot.GetHead());
+    }
+}
+} // namespace Mark3
@@ -0,0 +1,280 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+/**
+
+    @file   waitset.cpp
+
+    @brief  Wait set implementation
+
+*/
+
+#include "mark3.h"
+
+#if KERNEL_WAIT_SETS
+namespace Mark3
+{
+namespace
+{
+    //---------------------------------------------------------------------------
+    /**
+     * @brief TimedWaitSet_Callback
+     *
+     * This function is called from the timer-expired context to trigger a timeout
+     * on a wait set, waking the thread that was waiting on it.
+     *
+     * @param pclOwner_ Pointer to the thread to wake
+     * @param pvData_   Pointer to the wait set that the thread is blocked on
+     */
+    void TimedWaitSet_Callback(Thread* pclOwner_, void* pvData_)
+    {
+        KERNEL_ASSERT(pclOwner_ != nullptr);
+        KERNEL_ASSERT(pvData_ != nullptr);
+
+        auto* pclWaitSet = static_cast<WaitSet*>(static_cast<BlockingObject*>(pvData_));
+
+        // Indicate that the wait has expired on the thread
+        pclOwner_->SetExpired(true);
+
+        // Wake up the thread that was blocked on this wait set.
+        pclWaitSet->WakeMe(pclOwner_);
+
+        if (pclOwner_->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+            Thread::Yield();
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    constexpr uint32_t WaitSetBit(uint8_t u8Index_)
+    {
+        return (static_cast<uint32_t>(1) << u8Index_);
+    }
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+WaitSet::~WaitSet()
+{
+    // If there are any threads waiting on this object when it goes out
+    // of scope, set a kernel panic.
+    if (m_clBlockList.GetHead() != nullptr) {
+        Kernel::Panic(PANIC_ACTIVE_WAITSET_DESCOPED);
+    }
+
+    // Objects in the set must no longer signal it
+    if (IsInitialized()) {
+        CS_ENTER();
+        for (auto i = uint8_t{ 0 }; i < m_u8Count; i++) { m_apclObjects[i]->m_pclWaitSet = nullptr; }
+        CS_EXIT();
+    }
+}
+
+//---------------------------------------------------------------------------
+void WaitSet::Init()
+{
+    KERNEL_ASSERT(!m_clBlockList.GetHead());
+
+    CS_ENTER();
+    if (IsInitialized()) {
+        for (auto i = uint8_t{ 0 }; i < m_u8Count; i++) { m_apclObjects[i]->m_pclWaitSet = nullptr; }
+    }
+    m_u8Count      = 0;
+    m_u32Signalled = 0;
+    CS_EXIT();
+
+    SetInitialized();
+}
+
+//---------------------------------------------------------------------------
+uint8_t WaitSet::Add(Semaphore* pclSemaphore_)
+{
+    KERNEL_ASSERT(pclSemaphore_ != nullptr);
+    return Add_i(pclSemaphore_, Readiness::Count, 0);
+}
+
+//---------------------------------------------------------------------------
+uint8_t WaitSet::Add(MessageQueue* pclMessageQueue_)
+{
+    KERNEL_ASSERT(pclMessageQueue_ != nullptr);
+
+    // The queue's semaphore counts the messages it holds
+    return Add_i(&pclMessageQueue_->m_clSemaphore, Readiness::Count, 0);
+}
+
+//---------------------------------------------------------------------------
+uint8_t WaitSet::Add(Mailbox* pclMailbox_)
+{
+    KERNEL_ASSERT(pclMailbox_ != nullptr);
+
+    // The mailbox's receive semaphore counts the envelopes it holds
+    return Add_i(&pclMailbox_->m_clRecvSem, Readiness::Count, 0);
+}
+
+#if KERNEL_EVENT_FLAGS
+//---------------------------------------------------------------------------
+uint8_t WaitSet::Add(EventFlag* pclEventFlag_, uint16_t u16Mask_)
+{
+    KERNEL_ASSERT(pclEventFlag_ != nullptr);
+    KERNEL_ASSERT(u16Mask_ != 0);
+    return Add_i(pclEventFlag_, Readiness::Flags, u16Mask_);
+}
+#endif // #if KERNEL_EVENT_FLAGS
+
+//---------------------------------------------------------------------------
+uint8_t WaitSet::Add(Notify* pclNotify_)
+{
+    KERNEL_ASSERT(pclNotify_ != nullptr);
+    return Add_i(pclNotify_, Readiness::Pending, 0);
+}
+
+//---------------------------------------------------------------------------
+uint8_t WaitSet::Add_i(BlockingObject* pclObject_, Readiness eReadiness_, uint16_t u16Mask_)
+{
+    KERNEL_ASSERT(IsInitialized());
+    KERNEL_ASSERT(pclObject_->m_pclWaitSet == nullptr);
+    KERNEL_ASSERT(m_u8Count < KERNEL_WAIT_SET_SIZE);
+
+    auto u8Index = m_u8Count;
+
+    CS_ENTER();
+    m_apclObjects[u8Index] = pclObject_;
+    m_au16Masks[u8Index]   = u16Mask_;
+    m_aeReadiness[u8Index] = eReadiness_;
+    m_u8Count++;
+
+    pclObject_->m_u8WaitSetIndex = u8Index;
+    pclObject_->m_pclWaitSet     = this;
+
+    // The object may already be ready - check it on the next wait
+    m_u32Signalled |= WaitSetBit(u8Index);
+    CS_EXIT();
+
+    return u8Index;
+}
+
+//---------------------------------------------------------------------------
+uint8_t WaitSet::Wait()
+{
+    return Wait_i(0);
+}
+
+//---------------------------------------------------------------------------
+uint8_t WaitSet::Wait(uint32_t u32WaitTimeMS_)
+{
+    return Wait_i(u32WaitTimeMS_);
+}
+
+//---------------------------------------------------------------------------
+uint8_t WaitSet::Wait_i(uint32_t u32WaitTimeMS_)
+{
+    KERNEL_ASSERT(IsInitialized());
+
+    auto u8Index  = uint8_t{ WAIT_SET_NONE };
+    auto bBlocked = false;
+    auto bArmed   = false;
+
+    // Another thread may consume the object which woke this one before it gets
+    // to run, in which case it goes back to sleep.  The timeout is armed once,
+    // so a timed wait only sleeps for whatever remains of it.
+    do {
+        CS_ENTER();
+        u8Index  = FindReady_i();
+        bBlocked = (u8Index == WAIT_SET_NONE) && !(bArmed && g_pclCurrent->GetExpired());
+        if (bBlocked) {
+            // Nothing is ready - block until an object in the set signals it
+            if ((u32WaitTimeMS_ != 0u) && !bArmed) {
+                ArmTimeout(u32WaitTimeMS_, TimedWaitSet_Callback);
+                bArmed = true;
+            }
+            BlockPriority(g_pclCurrent);
+
+            // Switch Threads immediately
+            Thread::Yield();
+        }
+        CS_EXIT();
+    } while (bBlocked);
+
+    if (bArmed) {
+        DisarmTimeout();
+    }
+
+    return u8Index;
+}
+
+//---------------------------------------------------------------------------
+void WaitSet::Signal(uint8_t u8Index_)
+{
+    KERNEL_ASSERT(u8Index_ < m_u8Count);
+
+    auto bReschedule = false;
+
+    CS_ENTER();
+    m_u32Signalled |= WaitSetBit(u8Index_);
+
+    // Wake the waiting thread directly, rather than leaving it to poll
+    auto* pclChosenOne = m_clBlockList.HighestWaiter();
+    if (pclChosenOne != nullptr) {
+        UnBlock(pclChosenOne);
+        bReschedule = (pclChosenOne->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority());
+    }
+    CS_EXIT();
+
+    if (bReschedule) {
+        Thread::Yield();
+    }
+}
+
+//---------------------------------------------------------------------------
+void WaitSet::WakeMe(Thread* pclChosenOne_)
+{
+    KERNEL_ASSERT(pclChosenOne_ != nullptr);
+    KERNEL_ASSERT(IsInitialized());
+
+    // The thread may already have been woken by an object in the set
+    if (pclChosenOne_->GetCurrent() == &m_clBlockList) {
+        UnBlock(pclChosenOne_);
+    }
+}
+
+//---------------------------------------------------------------------------
+uint8_t WaitSet::FindReady_i()
+{
+    // Only objects that have signalled the set since they were last seen to
+    // be empty need to be checked.
+    auto u32Pending = m_u32Signalled;
+    for (auto i = uint8_t{ 0 }; u32Pending != 0; i++, u32Pending >>= 1) {
+        if ((u32Pending & 1) == 0) {
+            continue;
+        }
+
+        auto* pclObject = m_apclObjects[i];
+        auto  bReady    = false;
+        switch (m_aeReadiness[i]) {
+            case Readiness::Count: bReady = (static_cast<Semaphore*>(pclObject)->m_u16Value != 0); break;
+#if KERNEL_EVENT_FLAGS
+            case Readiness::Flags:
+                bReady = ((static_cast<EventFlag*>(pclObject)->m_u16SetMask & m_au16Masks[i]) != 0);
+                break;
+#endif // #if KERNEL_EVENT_FLAGS
+            case Readiness::Pending: bReady = static_cast<Notify*>(pclObject)->m_bPending; break;
+            default: break;
+        }
+
+        if (bReady) {
+            return i;
+        }
+        m_u32Signalled &= ~WaitSetBit(i);
+    }
+    return WAIT_SET_NONE;
+}
+} // namespace Mark3
+#endif // #if KERNEL_WAIT_SETS
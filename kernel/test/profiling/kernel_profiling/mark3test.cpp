@@ -9,6 +9,8 @@
 #include "mutex.h"
 #include "message.h"
 #include "timerlist.h"
+#include "cpuusage.h"
+#include "coroutine.h"
 #include "ut_support.h"
 
 #if defined(AVR)
@@ -76,33 +78,65 @@ ProfileTimer clProfileOverhead;
 ProfileTimer clSemInitTimer;
 ProfileTimer clSemPostTimer;
 ProfileTimer clSemPendTimer;
+ProfileTimer clSemSignalTimer;
 
 ProfileTimer clMutexInitTimer;
 ProfileTimer clMutexClaimTimer;
 ProfileTimer clMutexReleaseTimer;
+ProfileTimer clMutexInheritTimer;
+ProfileTimer clCeilingMutexClaimTimer;
 
 ProfileTimer clThreadInitTimer;
 ProfileTimer clThreadStartTimer;
 ProfileTimer clThreadExitTimer;
 ProfileTimer clContextSwitchTimer;
+ProfileTimer clThreadSwitchTimer;
 
 ProfileTimer clSemaphoreFlyback;
+ProfileTimer clSemaphoreTimedFlyback;
 ProfileTimer clSchedulerTimer;
+ProfileTimer clCoroutineFlyback;
+
+ProfileTimer clTickProbe;
+
+#if KERNEL_THREAD_NOTIFY
+ProfileTimer clNotifySignalTimer;
+ProfileTimer clNotifyFlyback;
+#endif // #if KERNEL_THREAD_NOTIFY
+
+// log2 histogram of semaphore flyback times, for tail latency
+constexpr auto cu8FlybackBuckets = uint8_t{ 20 };
+uint32_t       au32FlybackHistogram[cu8FlybackBuckets];
+
+#if KERNEL_CPU_ACCOUNTING
+ProfileTimer clCpuAccountTimer;
+#endif // #if KERNEL_CPU_ACCOUNTING
+uint32_t     u32TickCumulative;
+uint16_t     u16TickIterations;
 
 //---------------------------------------------------------------------------
 Semaphore clSemaphore;
 Mutex     clMutex;
 
+//---------------------------------------------------------------------------
+CoScheduler clCoScheduler;
+CoTask      clCoTask;
+CoSemaphore clCoSemaphore;
+
 //---------------------------------------------------------------------------
 Thread clMainThread;
 Thread clIdleThread;
 
 Thread clTestThread1;
+Thread clTestThread2;
+
+volatile bool bSwitchDone;
 
 //---------------------------------------------------------------------------
 K_WORD awMainStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
 K_WORD awIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
 K_WORD awTestStack1[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awTestStack2[PORT_KERNEL_DEFAULT_STACK_SIZE];
 
 //---------------------------------------------------------------------------
 void IdleMain(void* unused)
@@ -150,18 +184,37 @@ void ProfileInit()
     clSemInitTimer.Init();
     clSemPendTimer.Init();
     clSemPostTimer.Init();
+    clSemSignalTimer.Init();
     clSemaphoreFlyback.Init();
+    clSemaphoreFlyback.SetHistogram(au32FlybackHistogram, cu8FlybackBuckets);
+    clSemaphoreTimedFlyback.Init();
 
     clMutexInitTimer.Init();
     clMutexClaimTimer.Init();
     clMutexReleaseTimer.Init();
+    clMutexInheritTimer.Init();
+    clCeilingMutexClaimTimer.Init();
 
     clThreadExitTimer.Init();
     clThreadInitTimer.Init();
     clThreadStartTimer.Init();
     clContextSwitchTimer.Init();
+    clThreadSwitchTimer.Init();
 
     clSchedulerTimer.Init();
+    clCoroutineFlyback.Init();
+
+#if KERNEL_CPU_ACCOUNTING
+    clCpuAccountTimer.Init();
+#endif // #if KERNEL_CPU_ACCOUNTING
+
+#if KERNEL_THREAD_NOTIFY
+    clNotifySignalTimer.Init();
+    clNotifyFlyback.Init();
+#endif // #if KERNEL_THREAD_NOTIFY
+
+    u32TickCumulative = 0;
+    u16TickIterations = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -185,6 +238,17 @@ void Semaphore_Flyback(void* pvArg_)
     Scheduler::GetCurrentThread()->Exit();
 }
 
+//---------------------------------------------------------------------------
+void Semaphore_TimedFlyback(void* pvArg_)
+{
+    auto* pclSem = static_cast<Semaphore*>(pvArg_);
+    clSemaphoreTimedFlyback.Start();
+    pclSem->Pend(1000);
+    clSemaphoreTimedFlyback.Stop();
+
+    Scheduler::GetCurrentThread()->Exit();
+}
+
 //---------------------------------------------------------------------------
 void Semaphore_Profiling()
 {
@@ -204,6 +268,14 @@ void Semaphore_Profiling()
     for (i = 0; i < 1000; i++) { clSem.Pend(); }
     clSemPendTimer.Stop();
 
+    // Signal and consume, for comparison against thread notifications
+    clSemSignalTimer.Start();
+    for (i = 0; i < 1000; i++) {
+        clSem.Post();
+        clSem.Pend();
+    }
+    clSemSignalTimer.Stop();
+
     clSem.Init(0, 1);
     for (i = 0; i < 1000; i++) {
         clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 2, Semaphore_Flyback, (void*)&clSem);
@@ -212,9 +284,50 @@ void Semaphore_Profiling()
         clSem.Post();
     }
 
+    for (i = 0; i < 1000; i++) {
+        clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 2, Semaphore_TimedFlyback, (void*)&clSem);
+        clTestThread1.Start();
+
+        clSem.Post();
+    }
+
     return;
 }
 
+#if KERNEL_THREAD_NOTIFY
+//---------------------------------------------------------------------------
+void Notify_Flyback(void* /*unused_*/)
+{
+    clNotifyFlyback.Start();
+    Thread::WaitNotification(1);
+    clNotifyFlyback.Stop();
+
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void Notify_Profiling()
+{
+    uint16_t i;
+    auto*    pclSelf = Scheduler::GetCurrentThread();
+
+    // The notification equivalents of the semaphore signal and flyback tests
+    clNotifySignalTimer.Start();
+    for (i = 0; i < 1000; i++) {
+        pclSelf->Notify(1, NotifyAction::SetBits);
+        Thread::WaitNotification(1);
+    }
+    clNotifySignalTimer.Stop();
+
+    for (i = 0; i < 1000; i++) {
+        clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 2, Notify_Flyback, nullptr);
+        clTestThread1.Start();
+
+        clTestThread1.Notify(1, NotifyAction::SetBits);
+    }
+}
+#endif // #if KERNEL_THREAD_NOTIFY
+
 //---------------------------------------------------------------------------
 void Mutex_Profiling()
 {
@@ -231,6 +344,61 @@ void Mutex_Profiling()
         clMutex.Release();
     }
     clMutexClaimTimer.Stop();
+
+    CeilingMutex clCeilingMutex;
+    clCeilingMutex.Init(2, true);
+
+    clCeilingMutexClaimTimer.Start();
+    for (i = 0; i < 1000; i++) {
+        clCeilingMutex.Claim();
+        clCeilingMutex.Release();
+    }
+    clCeilingMutexClaimTimer.Stop();
+}
+
+//---------------------------------------------------------------------------
+Mutex clMutexOuter;
+Mutex clMutexInner;
+
+void Mutex_InheritMid(void* /*unused_*/)
+{
+    clMutexOuter.Claim();
+    clMutexInner.Claim(); //-- Blocks on the main thread --
+    clMutexInner.Release();
+    clMutexOuter.Release();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+void Mutex_InheritHigh(void* /*unused_*/)
+{
+    // Profile the time it takes to block on a mutex, boosting the whole chain
+    // of owners (mid-priority thread, then the main thread), and switch to
+    // the main thread as the highest-priority ready thread.
+    clMutexInheritTimer.Start();
+    clMutexOuter.Claim(); //-- Switch to the main thread --
+    clMutexOuter.Release();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void Mutex_InheritProfiling()
+{
+    clMutexOuter.Init();
+    clMutexInner.Init();
+
+    for (uint16_t i = 0; i < 100; i++) {
+        clMutexInner.Claim();
+
+        clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 2, Mutex_InheritMid, nullptr);
+        clTestThread1.Start();
+        clTestThread2.Init(awTestStack2, sizeof(awTestStack2), 3, Mutex_InheritHigh, nullptr);
+        clTestThread2.Start();
+
+        clMutexInheritTimer.Stop();
+
+        // Unwind the chain, letting both threads run to completion
+        clMutexInner.Release();
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -280,6 +448,36 @@ void Thread_Profiling()
     Scheduler::SetScheduler(1);
 }
 
+//---------------------------------------------------------------------------
+void Switch_Partner(void* /*unused_*/)
+{
+    while (!bSwitchDone) { Thread::CoopYield(); }
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void Switch_Profiling()
+{
+    uint16_t i;
+
+    // Profile a round trip between two threads at the same priority, each
+    // yielding to the other - two full context switches, including the
+    // per-switch stack check when KERNEL_STACK_CHECK is enabled.
+    bSwitchDone = false;
+    clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 1, Switch_Partner, nullptr);
+    clTestThread1.Start();
+
+    for (i = 0; i < 1000; i++) {
+        clThreadSwitchTimer.Start();
+        Thread::CoopYield(); //-- Switch to the partner thread, and back --
+        clThreadSwitchTimer.Stop();
+    }
+
+    // Let the partner thread run to completion
+    bSwitchDone = true;
+    Thread::CoopYield();
+}
+
 //---------------------------------------------------------------------------
 void Scheduler_Profiling()
 {
@@ -295,6 +493,100 @@ void Scheduler_Profiling()
     }
 }
 
+//---------------------------------------------------------------------------
+CoResult Coroutine_Flyback(CoTask* pclTask_, void* /*pvArg_*/)
+{
+    CO_BEGIN(pclTask_);
+    while (true) {
+        clCoroutineFlyback.Start();
+        CO_AWAIT(pclTask_, clCoSemaphore.Pend(pclTask_));
+        clCoroutineFlyback.Stop();
+    }
+    CO_END(pclTask_);
+}
+
+//---------------------------------------------------------------------------
+void Coroutine_Profiling()
+{
+    uint16_t i;
+
+    // The coroutine equivalent of the semaphore flyback test - a task blocks
+    // on a semaphore, which is posted and the task resumed by its scheduler.
+    clCoScheduler.Init();
+    clCoSemaphore.Init(0, 1);
+    clCoTask.Init(Coroutine_Flyback, nullptr);
+    clCoScheduler.Add(&clCoTask);
+    clCoScheduler.RunOnce();
+
+    for (i = 0; i < 1000; i++) {
+        clCoSemaphore.Post();
+        clCoScheduler.RunOnce();
+    }
+}
+
+#if KERNEL_CPU_ACCOUNTING
+//---------------------------------------------------------------------------
+void CpuAccount_Profiling()
+{
+    uint16_t i;
+
+    for (i = 0; i < 100; i++) {
+        // Profile the CPU time accounting added to each context switch
+        clCpuAccountTimer.Start();
+        CpuUsage::Update();
+        clCpuAccountTimer.Stop();
+    }
+}
+#endif // #if KERNEL_CPU_ACCOUNTING
+
+//---------------------------------------------------------------------------
+void Tick_Callback(Thread* /*pclOwner_*/, void* /*pvData_*/) {}
+
+//---------------------------------------------------------------------------
+void Tick_Profiling()
+{
+    // Time each pass through a loop spinning on the kernel's tick count.  The
+    // pass in which a tick lands also includes all of the kernel's per-tick
+    // processing (with a timer expiring on every tick), and is compared
+    // against the average pass.
+    Timer clTimer;
+    clTimer.Init();
+    clTimer.Start(true, 1, Tick_Callback, nullptr);
+
+    for (uint16_t i = 0; i < 10; i++) {
+        clTickProbe.Init();
+        clTickProbe.Start();
+
+        auto u32Tick   = Kernel::GetTicks();
+        auto u32Last   = clTickProbe.GetCurrent();
+        auto u32Prev   = uint32_t{ 0 };
+        auto u32Total  = uint32_t{ 0 };
+        auto u32Passes = uint32_t{ 0 };
+        while (true) {
+            auto u32Now  = Kernel::GetTicks();
+            auto u32Curr = clTickProbe.GetCurrent();
+            auto u32Pass = u32Curr - u32Last;
+            u32Last      = u32Curr;
+
+            if (u32Now != u32Tick) {
+                // The tick landed in either this pass or the one before it
+                if (u32Passes != 0) {
+                    auto u32Max = (u32Pass > u32Prev) ? u32Pass : u32Prev;
+                    u32TickCumulative += u32Max - (u32Total / u32Passes);
+                    u16TickIterations++;
+                }
+                break;
+            }
+            u32Prev = u32Pass;
+            u32Total += u32Pass;
+            u32Passes++;
+        }
+        clTickProbe.Stop();
+    }
+
+    clTimer.Stop();
+}
+
 //---------------------------------------------------------------------------
 void PrintWait(Driver* pclDriver_, uint16_t u16Size_, const char* data)
 {
@@ -309,37 +601,69 @@ void PrintWait(Driver* pclDriver_, uint16_t u16Size_, const char* data)
 }
 
 //---------------------------------------------------------------------------
-void ProfilePrint(ProfileTimer* pclProfile, const char* szName_)
+void ProfilePrintValue(uint32_t u32Val, const char* szName_, const char* szSuffix_ = "")
 {
-    Driver*  pclUART = DriverList::FindByPath("/dev/tty");
-    char     szBuf[16];
-    uint32_t u32Val = pclProfile->GetAverage() - clProfileOverhead.GetAverage();
-    u32Val *= 8;
+    Driver* pclUART = DriverList::FindByPath("/dev/tty");
+    char    szBuf[16];
+    u32Val *= CLOCK_DIVIDE;
     for (int i = 0; i < 16; i++) { szBuf[i] = 0; }
     szBuf[0] = '0';
 
     PrintWait(pclUART, KUtil_Strlen(szName_), szName_);
+    PrintWait(pclUART, KUtil_Strlen(szSuffix_), szSuffix_);
     PrintWait(pclUART, 2, ": ");
     KUtil_Ultoa(u32Val, szBuf);
     PrintWait(pclUART, KUtil_Strlen(szBuf), szBuf);
     PrintWait(pclUART, 1, "\n");
 }
 
+//---------------------------------------------------------------------------
+uint32_t ProfileAdjust(uint32_t u32Val_, uint32_t u32Overhead_)
+{
+    return (u32Val_ > u32Overhead_) ? (u32Val_ - u32Overhead_) : 0;
+}
+
+//---------------------------------------------------------------------------
+void ProfilePrint(ProfileTimer* pclProfile, const char* szName_)
+{
+    auto u32Overhead = clProfileOverhead.GetMin();
+    ProfilePrintValue(ProfileAdjust(pclProfile->GetAverage(), clProfileOverhead.GetAverage()), szName_);
+    ProfilePrintValue(ProfileAdjust(pclProfile->GetMin(), u32Overhead), szName_, ".min");
+    ProfilePrintValue(ProfileAdjust(pclProfile->GetMax(), u32Overhead), szName_, ".max");
+}
+
 //---------------------------------------------------------------------------
 void ProfilePrintResults()
 {
     ProfilePrint(&clMutexInitTimer, "MI");
     ProfilePrint(&clMutexClaimTimer, "MC");
     ProfilePrint(&clMutexReleaseTimer, "MR");
+    ProfilePrint(&clMutexInheritTimer, "MPI");
+    ProfilePrint(&clCeilingMutexClaimTimer, "CMC");
     ProfilePrint(&clSemInitTimer, "SI");
     ProfilePrint(&clSemPendTimer, "SPo");
     ProfilePrint(&clSemPostTimer, "SPe");
+    ProfilePrint(&clSemSignalTimer, "SS");
     ProfilePrint(&clSemaphoreFlyback, "SF");
+    ProfilePrintValue(ProfileAdjust(clSemaphoreFlyback.GetPercentile(99), clProfileOverhead.GetMin()), "SF", ".p99");
+    ProfilePrint(&clSemaphoreTimedFlyback, "STF");
+#if KERNEL_THREAD_NOTIFY
+    ProfilePrint(&clNotifySignalTimer, "NS");
+    ProfilePrint(&clNotifyFlyback, "NF");
+#endif // #if KERNEL_THREAD_NOTIFY
     ProfilePrint(&clThreadExitTimer, "TE");
     ProfilePrint(&clThreadInitTimer, "TI");
     ProfilePrint(&clThreadStartTimer, "TS");
     ProfilePrint(&clContextSwitchTimer, "CS");
+    ProfilePrint(&clThreadSwitchTimer, "CX");
     ProfilePrint(&clSchedulerTimer, "SC");
+    ProfilePrint(&clCoroutineFlyback, "CF");
+    ProfilePrintValue(sizeof(CoTask), "CF", ".ram");
+    ProfilePrintValue(sizeof(Thread) + sizeof(awTestStack1), "SF", ".ram");
+#if KERNEL_CPU_ACCOUNTING
+    ProfilePrint(&clCpuAccountTimer, "CA");
+#endif // #if KERNEL_CPU_ACCOUNTING
+    ProfilePrintValue((u16TickIterations != 0) ? (u32TickCumulative / u16TickIterations) : 0, "TK");
 }
 
 //---------------------------------------------------------------------------
@@ -357,18 +681,36 @@ void AppMain(void* unused)
         pclUART->Write(".", 1);
         Semaphore_Profiling();
         pclUART->Write(".", 1);
+#if KERNEL_THREAD_NOTIFY
+        Notify_Profiling();
+        pclUART->Write(".", 1);
+#endif // #if KERNEL_THREAD_NOTIFY
         Mutex_Profiling();
         pclUART->Write(".", 1);
+        Mutex_InheritProfiling();
+        pclUART->Write(".", 1);
         Thread_Profiling();
         pclUART->Write(".", 1);
+        Switch_Profiling();
+        pclUART->Write(".", 1);
         Scheduler_Profiling();
         pclUART->Write(".", 1);
+        Coroutine_Profiling();
+        pclUART->Write(".", 1);
+#if KERNEL_CPU_ACCOUNTING
+        CpuAccount_Profiling();
+        pclUART->Write(".", 1);
+#endif // #if KERNEL_CPU_ACCOUNTING
+        Tick_Profiling();
+        pclUART->Write(".", 1);
         Profiler::Stop();
         pclUART->Write("\r\n", 2);
     }
     ProfilePrintResults();
     Thread::Sleep(1000);
 
+    UnitTestSupport::OnExit(0);
+
     typedef void (*myFunc)(void);
     myFunc reboot = 0;
     reboot();
@@ -0,0 +1,206 @@
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+#include "kernel.h"
+#include "thread.h"
+#include "scheduler.h"
+#include "driver.h"
+#include "ut_support.h"
+
+extern "C" void __cxa_pure_virtual() {}
+
+//---------------------------------------------------------------------------
+// Measures how the throughput of CPU-bound threads scales with the number of
+// cores they run on.  For 1..PORT_CORE_COUNT cores, one worker is pinned to
+// each core, and the work completed by all of them in a fixed interval is
+// reported:
+//
+//  cores N: W - units of work completed by N cores
+//---------------------------------------------------------------------------
+
+namespace
+{
+using namespace Mark3;
+
+//---------------------------------------------------------------------------
+#if KERNEL_SMP
+constexpr auto cu8MaxCores    = uint8_t{ PORT_CORE_COUNT };
+#else
+constexpr auto cu8MaxCores    = uint8_t{ 1 };
+#endif // #if KERNEL_SMP
+constexpr auto cu32IntervalMs = uint32_t{ 1000 };
+constexpr auto cu16UnitSize   = uint16_t{ 1000 };
+
+//---------------------------------------------------------------------------
+Thread clMainThread;
+Thread aclWorkers[cu8MaxCores];
+#if !KERNEL_SMP
+Thread clIdleThread;
+#endif // #if !KERNEL_SMP
+
+//---------------------------------------------------------------------------
+K_WORD awMainStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD aawWorkerStacks[cu8MaxCores][PORT_KERNEL_DEFAULT_STACK_SIZE];
+#if !KERNEL_SMP
+K_WORD awIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+#endif // #if !KERNEL_SMP
+
+//---------------------------------------------------------------------------
+volatile bool     bStop;
+volatile uint32_t au32Units[cu8MaxCores];
+volatile uint32_t au32Results[cu8MaxCores];
+
+#if !KERNEL_SMP
+//---------------------------------------------------------------------------
+void IdleMain(void* unused)
+{
+    while (1) {}
+}
+#endif // #if !KERNEL_SMP
+
+//---------------------------------------------------------------------------
+// Complete units of purely CPU-bound work until told to stop
+void WorkerMain(void* pvIndex_)
+{
+    auto u8Index = static_cast<uint8_t>(reinterpret_cast<K_ADDR>(pvIndex_));
+    auto u32Seed = uint32_t{ 1 };
+    while (!bStop) {
+        for (uint16_t i = 0; i < cu16UnitSize; i++) { u32Seed = (u32Seed * 1103515245) + 12345; }
+        au32Units[u8Index] = au32Units[u8Index] + 1;
+    }
+    au32Results[u8Index] = u32Seed;
+}
+
+//---------------------------------------------------------------------------
+// Basic string routines
+uint16_t KUtil_Strlen(const char* szStr_)
+{
+    char*    pcData = (char*)szStr_;
+    uint16_t u16Len = 0;
+
+    while (*pcData++) { u16Len++; }
+    return u16Len;
+}
+
+//---------------------------------------------------------------------------
+void KUtil_Ultoa(uint32_t u8Data_, char* szText_)
+{
+    uint32_t u8Mul;
+    uint32_t u8Max;
+
+    // Find max index to print...
+    u8Mul = 10;
+    u8Max = 1;
+    while ((u8Mul <= u8Data_) && (u8Max < 15)) {
+        u8Max++;
+        u8Mul *= 10;
+    }
+
+    szText_[u8Max] = 0;
+    while (u8Max--) {
+        szText_[u8Max] = '0' + (u8Data_ % 10);
+        u8Data_ /= 10;
+    }
+}
+
+//---------------------------------------------------------------------------
+void PrintWait(Driver* pclDriver_, uint16_t u16Size_, const char* data)
+{
+    uint16_t u16Written = 0;
+
+    while (u16Written < u16Size_) {
+        u16Written += pclDriver_->Write(&data[u16Written], (u16Size_ - u16Written));
+        if (u16Written != u16Size_) {
+            Thread::Sleep(5);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void PrintString(const char* szStr_)
+{
+    PrintWait(DriverList::FindByPath("/dev/tty"), KUtil_Strlen(szStr_), szStr_);
+}
+
+//---------------------------------------------------------------------------
+void PrintValue(uint32_t u32Val_)
+{
+    char szBuf[16];
+    for (int i = 0; i < 16; i++) { szBuf[i] = 0; }
+    szBuf[0] = '0';
+    KUtil_Ultoa(u32Val_, szBuf);
+    PrintString(szBuf);
+}
+
+//---------------------------------------------------------------------------
+uint32_t ProfileCores(uint8_t u8Cores_)
+{
+    bStop = false;
+    for (uint8_t i = 0; i < u8Cores_; i++) {
+        au32Units[i] = 0;
+        aclWorkers[i].Init(aawWorkerStacks[i], sizeof(aawWorkerStacks[i]), 2, WorkerMain, reinterpret_cast<void*>(static_cast<K_ADDR>(i)));
+#if KERNEL_SMP
+        aclWorkers[i].SetAffinity(static_cast<uint8_t>(1 << i));
+#endif // #if KERNEL_SMP
+        aclWorkers[i].Start();
+    }
+
+    Thread::Sleep(cu32IntervalMs);
+
+    bStop = true;
+    auto u32Units = uint32_t{ 0 };
+    for (uint8_t i = 0; i < u8Cores_; i++) {
+        aclWorkers[i].Exit();
+        u32Units += au32Units[i];
+    }
+    return u32Units;
+}
+
+//---------------------------------------------------------------------------
+void AppMain(void* unused)
+{
+    UnitTestSupport::OnStart();
+
+    PrintString("START\n");
+
+    for (uint8_t u8Cores = 1; u8Cores <= cu8MaxCores; u8Cores++) {
+        auto u32Units = ProfileCores(u8Cores);
+        PrintString("cores ");
+        PrintValue(u8Cores);
+        PrintString(": ");
+        PrintValue(u32Units);
+        PrintString("\n");
+    }
+
+    PrintString("--DONE--\n");
+    Thread::Sleep(100);
+
+    UnitTestSupport::OnExit(0);
+
+    typedef void (*myFunc)(void);
+    myFunc reboot = 0;
+    reboot();
+}
+} // anonymous namespace
+
+using namespace Mark3;
+
+//---------------------------------------------------------------------------
+int main(void)
+{
+    Kernel::Init();
+
+    // The workers on the boot core must not starve the thread measuring them
+    clMainThread.Init(awMainStack, sizeof(awMainStack), 3, AppMain, nullptr);
+    clMainThread.Start();
+
+#if !KERNEL_SMP
+    // With KERNEL_SMP, the kernel provides each core's idle thread
+    clIdleThread.Init(awIdleStack, sizeof(awIdleStack), 0, IdleMain, nullptr);
+    clIdleThread.Start();
+#endif // #if !KERNEL_SMP
+
+    UnitTestSupport::OnInit();
+
+    Kernel::Start();
+    return 0;
+}
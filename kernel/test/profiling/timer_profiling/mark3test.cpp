@@ -0,0 +1,268 @@
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+#include "kernel.h"
+#include "thread.h"
+#include "scheduler.h"
+#include "driver.h"
+#include "profile.h"
+#include "kernelprofile.h"
+#include "timerlist.h"
+#include "timerwheel.h"
+#include "ut_support.h"
+
+extern "C" void __cxa_pure_virtual() {}
+
+//---------------------------------------------------------------------------
+// Compares the cost of the timer scheduler backends (sorted TimerList vs.
+// TimerWheel) with an increasing number of armed timers.  For each backend,
+// the following are reported, in the same units as kernel_profile:
+//
+//  S - cost of starting (adding) a timer
+//  P - cost of stopping (removing) a timer
+//  T - cost of processing a single tick
+//---------------------------------------------------------------------------
+
+namespace
+{
+using namespace Mark3;
+
+//---------------------------------------------------------------------------
+constexpr uint16_t cau16TimerCounts[] = { 10, 100, 1000 };
+constexpr auto     cu16MaxTimers      = uint16_t{ 1000 };
+constexpr auto     cu16Iterations     = uint16_t{ 1000 };
+constexpr auto     cu16Ticks          = uint16_t{ 1000 };
+constexpr auto     cu32MaxInterval    = uint32_t{ 2000 };
+
+//---------------------------------------------------------------------------
+ProfileTimer clProfileOverhead;
+ProfileTimer clStartTimer;
+ProfileTimer clStopTimer;
+ProfileTimer clTickTimer;
+
+//---------------------------------------------------------------------------
+TimerList  clTimerList;
+TimerWheel clTimerWheel;
+
+Timer    aclTimers[cu16MaxTimers];
+Timer    clProbeTimer;
+uint32_t u32Seed = 1;
+
+//---------------------------------------------------------------------------
+Thread clMainThread;
+Thread clIdleThread;
+
+//---------------------------------------------------------------------------
+K_WORD awMainStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+//---------------------------------------------------------------------------
+void IdleMain(void* unused)
+{
+    while (1) {}
+}
+
+//---------------------------------------------------------------------------
+uint32_t RandomInterval()
+{
+    u32Seed = (u32Seed * 1103515245) + 12345;
+    return 1 + ((u32Seed >> 8) % cu32MaxInterval);
+}
+
+//---------------------------------------------------------------------------
+// Timers don't expose their configuration outside of Start(), so configure
+// each one via the system timer scheduler before handing it to the backend
+// under test.
+void ConfigureTimer(Timer* pclTimer_, uint32_t u32Interval_)
+{
+    pclTimer_->Init();
+    pclTimer_->Start(true, u32Interval_, nullptr, nullptr);
+    pclTimer_->Stop();
+}
+
+//---------------------------------------------------------------------------
+// Basic string routines
+uint16_t KUtil_Strlen(const char* szStr_)
+{
+    char*    pcData = (char*)szStr_;
+    uint16_t u16Len = 0;
+
+    while (*pcData++) { u16Len++; }
+    return u16Len;
+}
+
+//---------------------------------------------------------------------------
+void KUtil_Ultoa(uint32_t u8Data_, char* szText_)
+{
+    uint32_t u8Mul;
+    uint32_t u8Max;
+
+    // Find max index to print...
+    u8Mul = 10;
+    u8Max = 1;
+    while ((u8Mul <= u8Data_) && (u8Max < 15)) {
+        u8Max++;
+        u8Mul *= 10;
+    }
+
+    szText_[u8Max] = 0;
+    while (u8Max--) {
+        szText_[u8Max] = '0' + (u8Data_ % 10);
+        u8Data_ /= 10;
+    }
+}
+
+//---------------------------------------------------------------------------
+void PrintWait(Driver* pclDriver_, uint16_t u16Size_, const char* data)
+{
+    uint16_t u16Written = 0;
+
+    while (u16Written < u16Size_) {
+        u16Written += pclDriver_->Write(&data[u16Written], (u16Size_ - u16Written));
+        if (u16Written != u16Size_) {
+            Thread::Sleep(5);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void PrintString(const char* szStr_)
+{
+    PrintWait(DriverList::FindByPath("/dev/tty"), KUtil_Strlen(szStr_), szStr_);
+}
+
+//---------------------------------------------------------------------------
+void PrintValue(uint32_t u32Val_)
+{
+    char szBuf[16];
+    for (int i = 0; i < 16; i++) { szBuf[i] = 0; }
+    szBuf[0] = '0';
+    KUtil_Ultoa(u32Val_, szBuf);
+    PrintString(szBuf);
+}
+
+//---------------------------------------------------------------------------
+void ProfilePrint(ProfileTimer* pclProfile_, const char* szName_)
+{
+    auto u32Overhead = clProfileOverhead.GetAverage();
+    auto u32Val      = pclProfile_->GetAverage();
+    u32Val           = (u32Val > u32Overhead) ? (u32Val - u32Overhead) : 0;
+    u32Val *= CLOCK_DIVIDE;
+
+    PrintString(szName_);
+    PrintString(": ");
+    PrintValue(u32Val);
+    PrintString(" ");
+}
+
+//---------------------------------------------------------------------------
+void ProfileOverhead()
+{
+    clProfileOverhead.Init();
+    Scheduler::SetScheduler(0);
+    for (uint16_t i = 0; i < cu16Ticks; i++) {
+        clProfileOverhead.Start();
+        clProfileOverhead.Stop();
+    }
+    Scheduler::SetScheduler(1);
+}
+
+//---------------------------------------------------------------------------
+template <typename T> void ProfileBackend(T* pclBackend_, const char* szName_, uint16_t u16Timers_)
+{
+    clStartTimer.Init();
+    clStopTimer.Init();
+    clTickTimer.Init();
+
+    // Keep the timer thread from preempting the measurements
+    Scheduler::SetScheduler(0);
+
+    // Arm the requested number of repeating timers with random intervals
+    u32Seed = 1;
+    pclBackend_->Init();
+    for (uint16_t i = 0; i < u16Timers_; i++) {
+        ConfigureTimer(&aclTimers[i], RandomInterval());
+        pclBackend_->Add(&aclTimers[i]);
+    }
+
+    // Start/stop cost of an additional timer, against the armed set
+    for (uint16_t i = 0; i < cu16Iterations; i++) {
+        ConfigureTimer(&clProbeTimer, RandomInterval());
+
+        clStartTimer.Start();
+        pclBackend_->Add(&clProbeTimer);
+        clStartTimer.Stop();
+
+        clStopTimer.Start();
+        pclBackend_->Remove(&clProbeTimer);
+        clStopTimer.Stop();
+    }
+
+    // Per-tick cost, including the expiry and re-arming of timers
+    for (uint16_t i = 0; i < cu16Ticks; i++) {
+        clTickTimer.Start();
+        pclBackend_->Process();
+        clTickTimer.Stop();
+    }
+
+    for (uint16_t i = 0; i < u16Timers_; i++) { pclBackend_->Remove(&aclTimers[i]); }
+    Scheduler::SetScheduler(1);
+
+    PrintString(szName_);
+    PrintString(" ");
+    PrintValue(u16Timers_);
+    PrintString(": ");
+    ProfilePrint(&clStartTimer, "S");
+    ProfilePrint(&clStopTimer, "P");
+    ProfilePrint(&clTickTimer, "T");
+    PrintString("\n");
+}
+
+//---------------------------------------------------------------------------
+void AppMain(void* unused)
+{
+    UnitTestSupport::OnStart();
+
+    PrintString("START\n");
+
+    Profiler::Start();
+    ProfileOverhead();
+    for (auto u16Timers : cau16TimerCounts) {
+#if !KERNEL_TIMERS_TICKLESS
+        // A tickless TimerList follows the kernel's tick count and programs
+        // the kernel timer, so it can't be driven standalone.
+        ProfileBackend(&clTimerList, "list", u16Timers);
+#endif // #if !KERNEL_TIMERS_TICKLESS
+        ProfileBackend(&clTimerWheel, "wheel", u16Timers);
+    }
+    Profiler::Stop();
+
+    PrintString("--DONE--\n");
+    Thread::Sleep(100);
+
+    UnitTestSupport::OnExit(0);
+
+    typedef void (*myFunc)(void);
+    myFunc reboot = 0;
+    reboot();
+}
+} // anonymous namespace
+
+using namespace Mark3;
+
+//---------------------------------------------------------------------------
+int main(void)
+{
+    Kernel::Init();
+
+    clMainThread.Init(awMainStack, sizeof(awMainStack), 1, AppMain, nullptr);
+
+    clIdleThread.Init(awIdleStack, sizeof(awIdleStack), 0, IdleMain, nullptr);
+
+    clMainThread.Start();
+    clIdleThread.Start();
+
+    UnitTestSupport::OnInit();
+
+    Kernel::Start();
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+#if KERNEL_CPU_BUDGETS
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+constexpr auto cuXTestPriority  = PORT_PRIO_TYPE{ 5 };
+constexpr auto cuXHogPriority   = PORT_PRIO_TYPE{ 4 };
+constexpr auto cuXWorkPriority  = PORT_PRIO_TYPE{ 3 };
+constexpr auto cuXBackground    = PORT_PRIO_TYPE{ 2 };
+constexpr auto cu32BudgetMs     = uint32_t{ 10 };
+constexpr auto cu32PeriodMs     = uint32_t{ 50 };
+constexpr auto cu32RunMs        = uint32_t{ 1000 };
+
+Thread clHogThread;
+Thread clWorkThread;
+K_WORD awHogStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awWorkStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+CpuBudget clBudget;
+
+volatile uint32_t u32HogCount;
+volatile uint32_t u32WorkCount;
+
+//---------------------------------------------------------------------------
+// A thread which never blocks
+void SpinTask(void* pvCounter_)
+{
+    auto* pu32Counter = static_cast<volatile uint32_t*>(pvCounter_);
+    while (true) { *pu32Counter = *pu32Counter + 1; }
+}
+
+//---------------------------------------------------------------------------
+// A thread which uses a fraction of its budget in each period
+void LightTask(void* pvCounter_)
+{
+    auto* pu32Counter = static_cast<volatile uint32_t*>(pvCounter_);
+    while (true) {
+        auto u32Start = Kernel::GetTicks();
+        while ((Kernel::GetTicks() - u32Start) < (cu32BudgetMs / 4)) {}
+        *pu32Counter = *pu32Counter + 1;
+        Thread::Sleep(cu32PeriodMs);
+    }
+}
+
+//---------------------------------------------------------------------------
+void StartThreads(ThreadEntryFunc pfHog_)
+{
+    u32HogCount  = 0;
+    u32WorkCount = 0;
+    clHogThread.Init(awHogStack, sizeof(awHogStack), cuXHogPriority, pfHog_, (void*)&u32HogCount);
+    clWorkThread.Init(awWorkStack, sizeof(awWorkStack), cuXWorkPriority, SpinTask, (void*)&u32WorkCount);
+    clBudget.Init();
+    clBudget.Start(&clHogThread, cu32BudgetMs, cu32PeriodMs, cuXBackground);
+    clHogThread.Start();
+    clWorkThread.Start();
+}
+} // anonymous namespace
+#endif // #if KERNEL_CPU_BUDGETS
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_CPU_BUDGETS
+TEST(ut_budget_enforce)
+{
+    Scheduler::GetCurrentThread()->SetPriority(cuXTestPriority);
+
+    // Without a budget, the higher-priority hog would starve the worker.  With
+    // one, it is demoted once its budget is used, and the worker gets the rest.
+    StartThreads(SpinTask);
+    Thread::Sleep(cu32RunMs);
+    clHogThread.Stop();
+    clWorkThread.Stop();
+
+    EXPECT_GT(u32WorkCount, 0);
+    EXPECT_GT(u32HogCount, 0);
+
+    // Each window overruns, and the hog gets its budget's share of the CPU
+    auto u32Windows = cu32RunMs / cu32PeriodMs;
+    EXPECT_GTE(clBudget.GetOverruns(), (u32Windows * 3) / 4);
+    EXPECT_LTE(clBudget.GetOverruns(), u32Windows);
+    auto u32Share = static_cast<uint32_t>((static_cast<uint64_t>(u32HogCount) * 100) / (u32HogCount + u32WorkCount));
+    EXPECT_GT(u32Share, 5);
+    EXPECT_LT(u32Share, 40);
+
+    // Stopping the budget restores the thread's own priority
+    clBudget.Stop();
+    EXPECT_EQUALS(clHogThread.GetPriority(), cuXHogPriority);
+    EXPECT_TRUE(clHogThread.GetBudget() == nullptr);
+
+    clHogThread.Exit();
+    clWorkThread.Exit();
+    Scheduler::GetCurrentThread()->SetPriority(1);
+}
+
+//===========================================================================
+TEST(ut_budget_within)
+{
+    Scheduler::GetCurrentThread()->SetPriority(cuXTestPriority);
+
+    // A thread that stays within its budget keeps its priority, and the
+    // threads beneath it are unaffected.
+    StartThreads(LightTask);
+    Thread::Sleep(cu32RunMs / 2);
+
+    EXPECT_GT(u32HogCount, 0);
+    EXPECT_GT(u32WorkCount, 0);
+    EXPECT_EQUALS(clBudget.GetOverruns(), 0);
+    EXPECT_FALSE(clBudget.IsDepleted());
+    EXPECT_EQUALS(clHogThread.GetPriority(), cuXHogPriority);
+
+    clHogThread.Exit();
+    clWorkThread.Exit();
+    Scheduler::GetCurrentThread()->SetPriority(1);
+}
+
+//===========================================================================
+TEST(ut_budget_exit)
+{
+    Scheduler::GetCurrentThread()->SetPriority(cuXTestPriority);
+
+    // A thread that exits - even while demoted - is detached from its budget
+    StartThreads(SpinTask);
+    while (!clBudget.IsDepleted()) { Thread::Sleep(1); }
+    EXPECT_EQUALS(clHogThread.GetPriority(), cuXBackground);
+
+    clHogThread.Exit();
+    EXPECT_TRUE(clBudget.GetThread() == nullptr);
+    EXPECT_FALSE(clBudget.IsDepleted());
+
+    // ... and the budget's replenishment timer no longer touches it
+    Thread::Sleep(cu32PeriodMs * 2);
+    EXPECT_EQUALS(clHogThread.GetState(), ThreadState::Exit);
+
+    clWorkThread.Exit();
+    Scheduler::GetCurrentThread()->SetPriority(1);
+}
+#endif // #if KERNEL_CPU_BUDGETS
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_CPU_BUDGETS
+TEST_CASE(ut_budget_enforce)
+, TEST_CASE(ut_budget_within), TEST_CASE(ut_budget_exit),
+#endif // #if KERNEL_CPU_BUDGETS
+    TEST_CASE_END
+} // namespace Mark3
@@ -0,0 +1,274 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+#include "coroutine.h"
+
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+CoScheduler clScheduler;
+CoTask      aclTasks[2];
+
+Thread clHostThread;
+K_WORD awHostStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+CoSemaphore clCoSem;
+CoMailbox   clCoMailbox;
+uint32_t    au32MailboxBuffer[2];
+CoEventFlag clCoFlag;
+CoTimer     clCoTimer;
+
+// Persistent task state - coroutine locals do not survive a yield.
+struct TaskState {
+    uint8_t  u8Id;
+    uint8_t  u8Count;
+    uint16_t u16Flags;
+    uint32_t u32Data;
+};
+
+TaskState astState[2];
+uint8_t   au8Log[8];
+uint8_t   u8LogIdx;
+
+//---------------------------------------------------------------------------
+CoResult YieldTask(CoTask* pclTask_, void* pvArg_)
+{
+    auto* pstState = static_cast<TaskState*>(pvArg_);
+    CO_BEGIN(pclTask_);
+    for (pstState->u8Count = 0; pstState->u8Count < 3; pstState->u8Count++) {
+        au8Log[u8LogIdx++] = pstState->u8Id;
+        CO_YIELD(pclTask_);
+    }
+    CO_END(pclTask_);
+}
+
+//---------------------------------------------------------------------------
+CoResult SemaphoreTask(CoTask* pclTask_, void* pvArg_)
+{
+    auto* pstState = static_cast<TaskState*>(pvArg_);
+    CO_BEGIN(pclTask_);
+    while (true) {
+        CO_AWAIT(pclTask_, clCoSem.Pend(pclTask_));
+        pstState->u8Count++;
+    }
+    CO_END(pclTask_);
+}
+
+//---------------------------------------------------------------------------
+CoResult ReceiveTask(CoTask* pclTask_, void* pvArg_)
+{
+    auto* pstState = static_cast<TaskState*>(pvArg_);
+    CO_BEGIN(pclTask_);
+    CO_AWAIT(pclTask_, clCoMailbox.Receive(pclTask_, &pstState->u32Data));
+    pstState->u8Count++;
+    CO_END(pclTask_);
+}
+
+//---------------------------------------------------------------------------
+CoResult SendTask(CoTask* pclTask_, void* pvArg_)
+{
+    auto* pstState = static_cast<TaskState*>(pvArg_);
+    CO_BEGIN(pclTask_);
+    for (pstState->u8Count = 0; pstState->u8Count < 3; pstState->u8Count++) {
+        pstState->u32Data = 0x100 + pstState->u8Count;
+        CO_AWAIT(pclTask_, clCoMailbox.Send(pclTask_, &pstState->u32Data));
+    }
+    CO_END(pclTask_);
+}
+
+//---------------------------------------------------------------------------
+CoResult FlagTask(CoTask* pclTask_, void* pvArg_)
+{
+    auto* pstState = static_cast<TaskState*>(pvArg_);
+    CO_BEGIN(pclTask_);
+    CO_AWAIT(pclTask_, (pstState->u16Flags = clCoFlag.Wait(pclTask_, 0x0006, EventFlagOperation::Any_Clear)) != 0);
+    CO_END(pclTask_);
+}
+
+//---------------------------------------------------------------------------
+CoResult SleepTask(CoTask* pclTask_, void* pvArg_)
+{
+    auto* pstState = static_cast<TaskState*>(pvArg_);
+    CO_BEGIN(pclTask_);
+    clCoTimer.Start(20);
+    CO_AWAIT(pclTask_, clCoTimer.Expired(pclTask_));
+    pstState->u32Data = Kernel::GetTicks();
+    CO_END(pclTask_);
+}
+
+//---------------------------------------------------------------------------
+void HostTask(void* /*pvArg_*/)
+{
+    clScheduler.Run();
+}
+
+//---------------------------------------------------------------------------
+void StartTask(uint8_t u8Idx_, CoTaskFunc pfFunc_)
+{
+    astState[u8Idx_] = {};
+    astState[u8Idx_].u8Id = u8Idx_;
+    aclTasks[u8Idx_].Init(pfFunc_, &astState[u8Idx_]);
+    clScheduler.Add(&aclTasks[u8Idx_]);
+}
+} // anonymous namespace
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+TEST(ut_coroutine_yield)
+{
+    // Two yielding tasks alternate round-robin, then complete.
+    clScheduler.Init();
+    u8LogIdx = 0;
+    StartTask(0, YieldTask);
+    StartTask(1, YieldTask);
+
+    while (clScheduler.RunOnce()) {}
+
+    const uint8_t au8Expected[] = { 0, 1, 0, 1, 0, 1 };
+    EXPECT_EQUALS(u8LogIdx, sizeof(au8Expected));
+    for (uint8_t i = 0; i < sizeof(au8Expected); i++) { EXPECT_EQUALS(au8Log[i], au8Expected[i]); }
+    EXPECT_TRUE(aclTasks[0].GetState() == CoState::Stopped);
+    EXPECT_TRUE(aclTasks[1].GetState() == CoState::Stopped);
+
+    // A completed task may be restarted from the top
+    aclTasks[0].Init(YieldTask, &astState[0]);
+    clScheduler.Add(&aclTasks[0]);
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_EQUALS(u8LogIdx, 7);
+}
+
+//===========================================================================
+TEST(ut_coroutine_semaphore)
+{
+    clScheduler.Init();
+    clCoSem.Init(1, 2);
+    StartTask(0, SemaphoreTask);
+
+    // The initial count is consumed, then the task waits instead of spinning
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_EQUALS(astState[0].u8Count, 1);
+    EXPECT_TRUE(aclTasks[0].GetState() == CoState::Waiting);
+    EXPECT_FALSE(clScheduler.RunOnce());
+
+    // Each post runs the task once more
+    clCoSem.Post();
+    clCoSem.Post();
+    EXPECT_TRUE(aclTasks[0].GetState() == CoState::Ready);
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_EQUALS(astState[0].u8Count, 3);
+    EXPECT_FALSE(clScheduler.RunOnce());
+
+    // A count taken by a thread is not delivered to the waiting task
+    clCoSem.Post();
+    EXPECT_TRUE(clCoSem.GetSemaphore()->Pend(1));
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_EQUALS(astState[0].u8Count, 3);
+    EXPECT_TRUE(aclTasks[0].GetState() == CoState::Waiting);
+}
+
+//===========================================================================
+TEST(ut_coroutine_mailbox)
+{
+    clScheduler.Init();
+    clCoMailbox.Init(au32MailboxBuffer, sizeof(au32MailboxBuffer), sizeof(uint32_t));
+
+    // Receiver waits on an empty mailbox, and is woken by a send
+    StartTask(0, ReceiveTask);
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_FALSE(clScheduler.RunOnce());
+
+    uint32_t u32Data = 0x1234;
+    EXPECT_TRUE(clCoMailbox.Send(&u32Data));
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_EQUALS(astState[0].u8Count, 1);
+    EXPECT_EQUALS(astState[0].u32Data, 0x1234);
+
+    // Sender fills the two-slot mailbox, and waits for a thread to make room
+    StartTask(1, SendTask);
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_EQUALS(astState[1].u8Count, 2);
+    EXPECT_TRUE(aclTasks[1].GetState() == CoState::Waiting);
+
+    // Freeing a slot through a coroutine receive wakes the sender
+    StartTask(0, ReceiveTask);
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_TRUE(aclTasks[1].GetState() == CoState::Stopped);
+
+    EXPECT_TRUE(clCoMailbox.GetMailbox()->Receive(&u32Data, 1));
+    EXPECT_TRUE(clCoMailbox.GetMailbox()->Receive(&u32Data, 1));
+    EXPECT_FALSE(clCoMailbox.GetMailbox()->TryReceive(&u32Data));
+}
+
+//===========================================================================
+TEST(ut_coroutine_eventflag)
+{
+    clScheduler.Init();
+    clCoFlag.Init();
+    StartTask(0, FlagTask);
+
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_FALSE(clScheduler.RunOnce());
+
+    // Flags outside the mask do not release the task
+    clCoFlag.Set(0x0001);
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_TRUE(aclTasks[0].GetState() == CoState::Waiting);
+
+    // A matching flag does, and is consumed
+    clCoFlag.Set(0x0004);
+    EXPECT_TRUE(clScheduler.RunOnce());
+    EXPECT_TRUE(aclTasks[0].GetState() == CoState::Stopped);
+    EXPECT_EQUALS(astState[0].u16Flags, 0x0004);
+    EXPECT_EQUALS(clCoFlag.GetEventFlag()->GetMask(), 0x0001);
+}
+
+//===========================================================================
+TEST(ut_coroutine_timer)
+{
+    // Run the scheduler from its own thread, which blocks while its only task sleeps
+    clScheduler.Init();
+    clCoTimer.Init();
+    clHostThread.Init(awHostStack, sizeof(awHostStack), 2, HostTask, nullptr);
+
+    auto u32Start = Kernel::GetTicks();
+    StartTask(0, SleepTask);
+    clHostThread.Start();
+
+    Thread::Sleep(100);
+    EXPECT_TRUE(aclTasks[0].GetState() == CoState::Stopped);
+    EXPECT_GTE(astState[0].u32Data - u32Start, 20);
+    EXPECT_LT(astState[0].u32Data - u32Start, 100);
+
+    clHostThread.Exit();
+}
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+TEST_CASE(ut_coroutine_yield), TEST_CASE(ut_coroutine_semaphore), TEST_CASE(ut_coroutine_mailbox),
+    TEST_CASE(ut_coroutine_eventflag), TEST_CASE(ut_coroutine_timer), TEST_CASE_END
+} // namespace Mark3
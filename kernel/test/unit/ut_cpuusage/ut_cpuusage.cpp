@@ -0,0 +1,147 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+#if KERNEL_CPU_ACCOUNTING
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+Thread    aclThreads[2];
+K_WORD    aawStacks[2][PORT_KERNEL_DEFAULT_STACK_SIZE];
+Semaphore clBlockSem;
+
+//---------------------------------------------------------------------------
+// Spin for a number of kernel ticks without blocking
+void Spin(uint32_t u32Ticks_)
+{
+    auto u32Start = Kernel::GetTicks();
+    while ((Kernel::GetTicks() - u32Start) < u32Ticks_) {}
+}
+
+//---------------------------------------------------------------------------
+void SpinTask(void* pvArg_)
+{
+    Spin(static_cast<uint32_t>(reinterpret_cast<K_ADDR>(pvArg_)));
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void BlockTask(void* pvArg_)
+{
+    Spin(static_cast<uint32_t>(reinterpret_cast<K_ADDR>(pvArg_)));
+    clBlockSem.Pend();
+    Scheduler::GetCurrentThread()->Exit();
+}
+} // anonymous namespace
+#endif // #if KERNEL_CPU_ACCOUNTING
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_CPU_ACCOUNTING
+TEST(ut_cpuusage_share)
+{
+    // Two higher-priority threads spin for 40 and 10 ticks each, and are
+    // charged in proportion.
+    const uint32_t au32Spin[2] = { 40, 10 };
+    for (uint8_t i = 0; i < 2; i++) {
+        aclThreads[i].Init(
+            aawStacks[i], sizeof(aawStacks[i]), 2, SpinTask, reinterpret_cast<void*>(static_cast<K_ADDR>(au32Spin[i])));
+    }
+
+    CpuUsage::Reset();
+    Scheduler::SetScheduler(false);
+    for (auto& clThread : aclThreads) { clThread.Start(); }
+    Scheduler::SetScheduler(true);
+    auto u64Window = CpuUsage::Sample();
+
+    auto u64Long  = aclThreads[0].GetRunCycles();
+    auto u64Short = aclThreads[1].GetRunCycles();
+    EXPECT_GT(u64Short, 0);
+    EXPECT_GT(u64Long, u64Short * 2);
+    EXPECT_GT(CpuUsage::GetLoad(u64Long + u64Short, u64Window), 5000);
+    EXPECT_LT(CpuUsage::GetLoad(Scheduler::GetCurrentThread()->GetRunCycles(), u64Window), 5000);
+}
+
+//===========================================================================
+TEST(ut_cpuusage_idle)
+{
+    // Sleeping leaves the CPU to the idle thread...
+    CpuUsage::Reset();
+    Thread::Sleep(50);
+    EXPECT_LT(CpuUsage::GetCpuLoad(), 5000);
+    EXPECT_GT(CpuUsage::GetIdleCycles(), 0);
+
+    // ... while spinning leaves it no time at all.
+    CpuUsage::Reset();
+    Spin(20);
+    EXPECT_EQUALS(CpuUsage::GetCpuLoad(), 10000);
+    EXPECT_EQUALS(CpuUsage::GetIdleCycles(), 0);
+}
+
+//===========================================================================
+TEST(ut_cpuusage_reset)
+{
+    aclThreads[0].Init(
+        aawStacks[0], sizeof(aawStacks[0]), 2, SpinTask, reinterpret_cast<void*>(static_cast<K_ADDR>(5)));
+    aclThreads[0].Start();
+    EXPECT_GT(aclThreads[0].GetRunCycles(), 0);
+
+    // Counters of threads that have not run since a reset read as zero
+    CpuUsage::Reset();
+    EXPECT_EQUALS(aclThreads[0].GetRunCycles(), 0);
+    EXPECT_EQUALS(CpuUsage::GetIdleCycles(), 0);
+    EXPECT_EQUALS(CpuUsage::GetLoad(1, 0), 0);
+    EXPECT_EQUALS(CpuUsage::GetLoad(3, 4), 7500);
+}
+
+//===========================================================================
+TEST(ut_cpuusage_window_wrap)
+{
+    // A thread blocked across many resets must not have its counter from an
+    // earlier window read back once the window index comes around again.
+    clBlockSem.Init(0, 1);
+    aclThreads[0].Init(
+        aawStacks[0], sizeof(aawStacks[0]), 2, BlockTask, reinterpret_cast<void*>(static_cast<K_ADDR>(5)));
+    aclThreads[0].Start();
+    EXPECT_GT(aclThreads[0].GetRunCycles(), 0);
+
+    for (uint16_t i = 0; i < 256; i++) { CpuUsage::Reset(); }
+    EXPECT_EQUALS(aclThreads[0].GetRunCycles(), 0);
+
+    clBlockSem.Post();
+    EXPECT_EQUALS(aclThreads[0].GetState(), ThreadState::Exit);
+}
+#endif // #if KERNEL_CPU_ACCOUNTING
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_CPU_ACCOUNTING
+TEST_CASE(ut_cpuusage_share)
+, TEST_CASE(ut_cpuusage_idle), TEST_CASE(ut_cpuusage_reset), TEST_CASE(ut_cpuusage_window_wrap),
+#endif // #if KERNEL_CPU_ACCOUNTING
+    TEST_CASE_END
+} // namespace Mark3
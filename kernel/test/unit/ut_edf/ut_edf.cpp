@@ -0,0 +1,201 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+#if KERNEL_EDF
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+constexpr auto cu8NumThreads = uint8_t{ 3 };
+
+// Two tasks that rate-monotonic priorities cannot schedule, at 88% utilization.
+// Under RM, one job of the slower task in each hyperperiod (600 ticks) overruns
+// its period by 15 ticks; under EDF, every job has at least 35 ticks to spare.
+constexpr auto cu32Period1   = uint32_t{ 200 };
+constexpr auto cu32ExecTime1 = uint32_t{ 100 };
+constexpr auto cu32Period2   = uint32_t{ 300 };
+constexpr auto cu32ExecTime2 = uint32_t{ 115 };
+constexpr auto cu32RunTime   = uint32_t{ 600 * 4 };
+
+Thread           aclThreads[cu8NumThreads];
+K_WORD           aawStacks[cu8NumThreads][PORT_KERNEL_DEFAULT_STACK_SIZE];
+Periodic         aclPeriodic[2];
+uint8_t          au8Order[cu8NumThreads];
+volatile uint8_t u8RunCount;
+
+//---------------------------------------------------------------------------
+// Spin for a number of ticks of execution.  A tick is charged each time the
+// tick count is seen to advance while the task is running, so time spent
+// preempted - or with the whole simulator stalled by the host - is charged
+// as a single tick, and the work done is independent of the host.
+void Work(uint32_t u32Ticks_)
+{
+    auto u32Last     = Kernel::GetTicks();
+    auto u32Executed = uint32_t{ 0 };
+    while (u32Executed < u32Ticks_) {
+        auto u32Now = Kernel::GetTicks();
+        if (u32Now != u32Last) {
+            u32Last = u32Now;
+            u32Executed++;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void OrderTask(void* pvArg_)
+{
+    au8Order[u8RunCount++] = static_cast<uint8_t>(reinterpret_cast<K_ADDR>(pvArg_));
+}
+
+//---------------------------------------------------------------------------
+void PeriodicTask(void* pvArg_)
+{
+    auto  u8Index     = static_cast<uint8_t>(reinterpret_cast<K_ADDR>(pvArg_));
+    auto  u32ExecTime = (u8Index == 0) ? cu32ExecTime1 : cu32ExecTime2;
+    auto& clPeriodic  = aclPeriodic[u8Index];
+    while (1) {
+        clPeriodic.Wait();
+        Work(u32ExecTime);
+    }
+}
+
+//---------------------------------------------------------------------------
+// Run the two-task set for a fixed time, returning the total number of missed
+// deadlines.  Under EDF, both tasks share the EDF band; otherwise, they are
+// given rate-monotonic priorities below it.
+uint32_t RunTaskSet(bool bEDF_)
+{
+    for (uint8_t i = 0; i < 2; i++) {
+        auto uXPriority = static_cast<PORT_PRIO_TYPE>(bEDF_ ? KERNEL_EDF_PRIORITY : (KERNEL_EDF_PRIORITY - 1 - i));
+        aclThreads[i].Init(aawStacks[i],
+                           sizeof(aawStacks[i]),
+                           uXPriority,
+                           PeriodicTask,
+                           reinterpret_cast<void*>(static_cast<K_ADDR>(i)));
+        aclPeriodic[i].Init();
+    }
+    if (bEDF_) {
+        aclThreads[0].SetDeadline(cu32Period1, cu32Period1, cu32ExecTime1);
+        aclThreads[1].SetDeadline(cu32Period2, cu32Period2, cu32ExecTime2);
+    }
+
+    aclPeriodic[0].Start(cu32Period1);
+    aclPeriodic[1].Start(cu32Period2);
+    aclThreads[0].Start();
+    aclThreads[1].Start();
+
+    Thread::Sleep(cu32RunTime);
+
+    auto u32Misses = uint32_t{ 0 };
+    for (uint8_t i = 0; i < 2; i++) {
+        aclThreads[i].Exit();
+        aclPeriodic[i].Stop();
+        u32Misses += aclPeriodic[i].GetOverruns();
+    }
+    return u32Misses;
+}
+} // anonymous namespace
+#endif // #if KERNEL_EDF
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_EDF
+TEST(ut_edf_admission)
+{
+    for (uint8_t i = 0; i < 2; i++) {
+        aclThreads[i].Init(aawStacks[i], sizeof(aawStacks[i]), KERNEL_EDF_PRIORITY, OrderTask, nullptr);
+    }
+    auto u32Base = Scheduler::GetUtilization();
+
+    // 50% - deadline shorter than the period bounds the utilization
+    EXPECT_TRUE(aclThreads[0].SetDeadline(10, 20, 5));
+    EXPECT_EQUALS(Scheduler::GetUtilization() - u32Base, SCHEDULER_EDF_UTILIZATION_MAX / 2);
+
+    // 60% would overload the band, 50% fits exactly
+    EXPECT_FALSE(aclThreads[1].SetDeadline(10, 10, 6));
+    EXPECT_TRUE(aclThreads[1].SetDeadline(20, 20, 10));
+    EXPECT_EQUALS(Scheduler::GetUtilization() - u32Base, SCHEDULER_EDF_UTILIZATION_MAX);
+
+    // Jobs that cannot complete in their own window are never admitted
+    EXPECT_FALSE(aclThreads[0].SetDeadline(10, 10, 11));
+
+    // Leaving the EDF class (or exiting) releases the thread's utilization
+    EXPECT_TRUE(aclThreads[0].SetDeadline(0, 0, 0));
+    EXPECT_FALSE(aclThreads[0].HasDeadline());
+    EXPECT_EQUALS(Scheduler::GetUtilization() - u32Base, SCHEDULER_EDF_UTILIZATION_MAX / 2);
+    aclThreads[1].Exit();
+    EXPECT_EQUALS(Scheduler::GetUtilization(), u32Base);
+    aclThreads[0].Exit();
+}
+
+//===========================================================================
+TEST(ut_edf_order)
+{
+    // Threads released together run in deadline order, regardless of the
+    // order in which they were made ready.
+    const uint32_t au32Deadlines[cu8NumThreads] = { 30, 10, 20 };
+    for (uint8_t i = 0; i < cu8NumThreads; i++) {
+        aclThreads[i].Init(aawStacks[i],
+                           sizeof(aawStacks[i]),
+                           KERNEL_EDF_PRIORITY,
+                           OrderTask,
+                           reinterpret_cast<void*>(static_cast<K_ADDR>(i)));
+        EXPECT_TRUE(aclThreads[i].SetDeadline(au32Deadlines[i], 0, 1));
+    }
+
+    u8RunCount = 0;
+    Scheduler::SetScheduler(false);
+    for (auto& clThread : aclThreads) { clThread.Start(); }
+    Scheduler::SetScheduler(true);
+
+    EXPECT_EQUALS(u8RunCount, cu8NumThreads);
+    EXPECT_EQUALS(au8Order[0], 1);
+    EXPECT_EQUALS(au8Order[1], 2);
+    EXPECT_EQUALS(au8Order[2], 0);
+}
+
+//===========================================================================
+TEST(ut_edf_vs_rm)
+{
+    auto u32RMMisses  = RunTaskSet(false);
+    auto u32EDFMisses = RunTaskSet(true);
+
+    // EDF should meet every deadline; allow for the odd miss where the host
+    // stalls the simulator while a task is running and charges it for that.
+    EXPECT_GT(u32RMMisses, 0);
+    EXPECT_LT(u32EDFMisses, u32RMMisses);
+}
+#endif // #if KERNEL_EDF
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_EDF
+TEST_CASE(ut_edf_admission)
+, TEST_CASE(ut_edf_order), TEST_CASE(ut_edf_vs_rm),
+#endif // #if KERNEL_EDF
+    TEST_CASE_END
+} // namespace Mark3
@@ -0,0 +1,184 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "hrtimer.h"
+#include "thread.h"
+#include "ksemaphore.h"
+
+#if KERNEL_HRTIMERS
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+constexpr auto cu8NumTimers = uint8_t{ 5 };
+
+HRTimer           aclTimers[cu8NumTimers];
+Semaphore         clTimerSem;
+uint8_t           au8Order[cu8NumTimers];
+uint32_t          au32Count[cu8NumTimers];
+volatile uint8_t  u8ExpiredCount = 0;
+volatile uint32_t u32RepeatCount = 0;
+
+void OrderCallback(HRTimer* pclTimer_, void* pvVal_)
+{
+    auto u8Index = static_cast<uint8_t>(reinterpret_cast<K_ADDR>(pvVal_));
+    au8Order[u8ExpiredCount]  = u8Index;
+    au32Count[u8ExpiredCount] = HRTimer::GetCount();
+    u8ExpiredCount++;
+    clTimerSem.Post();
+}
+
+void RepeatCallback(HRTimer* pclTimer_, void* pvVal_)
+{
+    u32RepeatCount++;
+}
+
+void RestartCallback(HRTimer* pclTimer_, void* pvVal_)
+{
+    // Restart the timer from its own callback a fixed number of times
+    u32RepeatCount++;
+    if (u32RepeatCount < 10) {
+        pclTimer_->Start(false, HRTimer::UsToCounts(100), RestartCallback, pvVal_);
+    } else {
+        clTimerSem.Post();
+    }
+}
+
+void ResetTimers()
+{
+    for (auto& clTimer : aclTimers) { clTimer.Init(); }
+    for (auto& u8Order : au8Order) { u8Order = 0xFF; }
+    u8ExpiredCount = 0;
+    u32RepeatCount = 0;
+}
+} // anonymous namespace
+#endif // #if KERNEL_HRTIMERS
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_HRTIMERS
+TEST(ut_hrtimer_order)
+{
+    // Sub-tick timers must expire in order of their deadlines, no earlier than
+    // their requested intervals.
+    static const uint32_t au32IntervalUs[cu8NumTimers] = { 700, 300, 900, 100, 500 };
+    static const uint8_t  au8Expected[cu8NumTimers]    = { 3, 1, 4, 0, 2 };
+
+    clTimerSem.Init(0, cu8NumTimers);
+    ResetTimers();
+
+    auto u32Start = HRTimer::GetCount();
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        aclTimers[i].Start(false,
+                           HRTimer::UsToCounts(au32IntervalUs[i]),
+                           OrderCallback,
+                           reinterpret_cast<void*>(static_cast<K_ADDR>(i)));
+    }
+    for (uint8_t i = 0; i < cu8NumTimers; i++) { clTimerSem.Pend(); }
+
+    EXPECT_EQUALS(u8ExpiredCount, cu8NumTimers);
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        EXPECT_EQUALS(au8Order[i], au8Expected[i]);
+        EXPECT_GTE(au32Count[i] - u32Start, HRTimer::UsToCounts(au32IntervalUs[au8Expected[i]]));
+    }
+    for (auto& clTimer : aclTimers) { EXPECT_FALSE(clTimer.IsActive()); }
+}
+
+TEST(ut_hrtimer_stop)
+{
+    // Timers stopped before their deadline must never expire, without
+    // affecting the timers around them.
+    clTimerSem.Init(0, cu8NumTimers);
+    ResetTimers();
+
+    for (uint8_t i = 0; i < 3; i++) {
+        aclTimers[i].Start(false,
+                           HRTimer::UsToCounts(200 * (i + 1)),
+                           OrderCallback,
+                           reinterpret_cast<void*>(static_cast<K_ADDR>(i)));
+    }
+    aclTimers[0].Stop();
+    aclTimers[1].Stop();
+    EXPECT_FALSE(aclTimers[0].IsActive());
+
+    clTimerSem.Pend();
+    Thread::Sleep(5);
+
+    EXPECT_EQUALS(u8ExpiredCount, 1);
+    EXPECT_EQUALS(au8Order[0], 2);
+}
+
+TEST(ut_hrtimer_repeat)
+{
+    // A repeating timer keeps firing until stopped, and never after.
+    ResetTimers();
+
+    aclTimers[0].Start(true, HRTimer::UsToCounts(250), RepeatCallback, nullptr);
+    Thread::Sleep(20);
+    EXPECT_TRUE(aclTimers[0].IsActive());
+    aclTimers[0].Stop();
+    EXPECT_FALSE(aclTimers[0].IsActive());
+
+    auto u32AtStop = u32RepeatCount;
+    EXPECT_GT(u32AtStop, 1);
+    Thread::Sleep(5);
+    EXPECT_EQUALS(u32RepeatCount, u32AtStop);
+}
+
+TEST(ut_hrtimer_count64)
+{
+    // The extended count tracks the hardware counter, and is monotonic.
+    auto u64Start = HRTimer::GetCount64();
+    auto u32Start = HRTimer::GetCount();
+    Thread::Sleep(2);
+    auto u64Now = HRTimer::GetCount64();
+
+    EXPECT_GT(u64Now, u64Start);
+    EXPECT_GTE(static_cast<uint32_t>(u64Now) - u32Start, HRTimer::UsToCounts(1000));
+}
+
+TEST(ut_hrtimer_restart)
+{
+    // One-shot timers may be restarted from their own callback.
+    clTimerSem.Init(0, 1);
+    ResetTimers();
+
+    aclTimers[0].Start(false, HRTimer::UsToCounts(100), RestartCallback, nullptr);
+    clTimerSem.Pend();
+
+    EXPECT_EQUALS(u32RepeatCount, 10);
+    EXPECT_FALSE(aclTimers[0].IsActive());
+}
+#endif // #if KERNEL_HRTIMERS
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_HRTIMERS
+TEST_CASE(ut_hrtimer_order)
+, TEST_CASE(ut_hrtimer_stop), TEST_CASE(ut_hrtimer_repeat), TEST_CASE(ut_hrtimer_count64),
+    TEST_CASE(ut_hrtimer_restart),
+#endif // #if KERNEL_HRTIMERS
+    TEST_CASE_END
+} // namespace Mark3
@@ -30,6 +30,12 @@ Thread clMutexThread;
 K_WORD           aucTestStack2[PORT_KERNEL_DEFAULT_STACK_SIZE];
 Thread           clTestThread2;
 volatile uint8_t u8Token;
+
+K_WORD aucTestStack3[PORT_KERNEL_DEFAULT_STACK_SIZE];
+Thread clTestThread3;
+
+Mutex clMutexA;
+Mutex clMutexB;
 } // anonymous namespace
 
 namespace Mark3
@@ -244,10 +250,279 @@ TEST(ut_raii_timeout)
     clTestThread2.Exit();
 }
 
+//===========================================================================
+TEST(ut_chained_priority_mutex)
+{
+    // Low-priority thread holds B for a while
+    auto lLowThread = [](void* /*unused_*/) {
+        clMutexB.Claim();
+        Thread::Sleep(200);
+        clMutexB.Release();
+        while (1) { Thread::Sleep(1000); }
+    };
+
+    // Mid-priority thread holds A, and waits on B while holding it
+    auto lMidThread = [](void* /*unused_*/) {
+        clMutexA.Claim();
+        clMutexB.Claim();
+        clMutexB.Release();
+        clMutexA.Release();
+        while (1) { Thread::Sleep(1000); }
+    };
+
+    // High-priority thread waits on A
+    auto lHighThread = [](void* /*unused_*/) {
+        clMutexA.Claim();
+        u8Token = 1;
+        clMutexA.Release();
+        while (1) { Thread::Sleep(1000); }
+    };
+
+    // Test - Transitive priority inheritence.  A thread blocked on a mutex
+    // whose owner is itself blocked on another mutex must boost both owners.
+    clMutexA.Init();
+    clMutexB.Init();
+    u8Token = 0;
+
+    Scheduler::GetCurrentThread()->SetPriority(7);
+
+    clMutexThread.Init(aucTestStack, sizeof(aucTestStack), 2, lLowThread, nullptr);
+    clTestThread2.Init(aucTestStack2, sizeof(aucTestStack2), 3, lMidThread, nullptr);
+    clTestThread3.Init(aucTestStack3, sizeof(aucTestStack3), 5, lHighThread, nullptr);
+
+    clMutexThread.Start();
+    Thread::Sleep(20);
+    clTestThread2.Start();
+    Thread::Sleep(20);
+
+    // Test point - the low-priority thread is boosted by the mid-priority one
+    EXPECT_EQUALS(clMutexThread.GetCurPriority(), 3);
+
+    clTestThread3.Start();
+    Thread::Sleep(20);
+
+    // Test point - the boost from the high-priority thread is carried through
+    // the mid-priority thread to the low-priority thread
+    EXPECT_EQUALS(clTestThread2.GetCurPriority(), 5);
+    EXPECT_EQUALS(clMutexThread.GetCurPriority(), 5);
+    EXPECT_EQUALS(clTestThread3.GetCurPriority(), 5);
+    EXPECT_EQUALS(u8Token, 0);
+
+    Thread::Sleep(300);
+
+    // Test point - once the chain unwinds, everything is back where it started
+    EXPECT_EQUALS(u8Token, 1);
+    EXPECT_EQUALS(clMutexThread.GetCurPriority(), 2);
+    EXPECT_EQUALS(clTestThread2.GetCurPriority(), 3);
+    EXPECT_EQUALS(clTestThread3.GetCurPriority(), 5);
+
+    clMutexThread.Exit();
+    clTestThread2.Exit();
+    clTestThread3.Exit();
+}
+
+//===========================================================================
+TEST(ut_partial_deboost_mutex)
+{
+    // Low-priority thread holds both mutexes, releasing B before A
+    auto lLowThread = [](void* /*unused_*/) {
+        clMutexA.Claim();
+        clMutexB.Claim();
+        Thread::Sleep(100);
+        clMutexB.Release();
+        Thread::Sleep(100);
+        clMutexA.Release();
+        while (1) { Thread::Sleep(1000); }
+    };
+
+    auto lWaitThread = [](void* mutex_) {
+        auto* pclMutex = static_cast<Mutex*>(mutex_);
+        pclMutex->Claim();
+        pclMutex->Release();
+        while (1) { Thread::Sleep(1000); }
+    };
+
+    // Test - When a thread holding several mutexes releases one of them, it
+    // should keep any priority still inherited through the others.
+    clMutexA.Init();
+    clMutexB.Init();
+
+    Scheduler::GetCurrentThread()->SetPriority(7);
+
+    clMutexThread.Init(aucTestStack, sizeof(aucTestStack), 2, lLowThread, nullptr);
+    clTestThread2.Init(aucTestStack2, sizeof(aucTestStack2), 4, lWaitThread, &clMutexA);
+    clTestThread3.Init(aucTestStack3, sizeof(aucTestStack3), 6, lWaitThread, &clMutexB);
+
+    clMutexThread.Start();
+    Thread::Sleep(20);
+    clTestThread2.Start();
+    clTestThread3.Start();
+    Thread::Sleep(20);
+
+    EXPECT_EQUALS(clMutexThread.GetCurPriority(), 6);
+
+    // Test point - releasing B drops the boost from its waiter, but keeps the
+    // boost from the thread waiting on A.
+    Thread::Sleep(100);
+    EXPECT_EQUALS(clMutexThread.GetCurPriority(), 4);
+
+    Thread::Sleep(100);
+    EXPECT_EQUALS(clMutexThread.GetCurPriority(), 2);
+
+    clMutexThread.Exit();
+    clTestThread2.Exit();
+    clTestThread3.Exit();
+}
+
+//===========================================================================
+TEST(ut_timeout_deboost_mutex)
+{
+    auto lLowThread = [](void* /*unused_*/) {
+        clMutexA.Claim();
+        Thread::Sleep(200);
+        clMutexA.Release();
+        while (1) { Thread::Sleep(1000); }
+    };
+
+    auto lTimedThread = [](void* /*unused_*/) {
+        u8Token = clMutexA.Claim(50) ? 1 : 2;
+        while (1) { Thread::Sleep(1000); }
+    };
+
+    // Test - A waiter that times out no longer boosts the mutex owner
+    clMutexA.Init();
+    u8Token = 0;
+
+    Scheduler::GetCurrentThread()->SetPriority(7);
+
+    clMutexThread.Init(aucTestStack, sizeof(aucTestStack), 2, lLowThread, nullptr);
+    clTestThread2.Init(aucTestStack2, sizeof(aucTestStack2), 5, lTimedThread, nullptr);
+
+    clMutexThread.Start();
+    Thread::Sleep(20);
+    clTestThread2.Start();
+    Thread::Sleep(20);
+    EXPECT_EQUALS(clMutexThread.GetCurPriority(), 5);
+
+    Thread::Sleep(100);
+    EXPECT_EQUALS(u8Token, 2);
+    EXPECT_EQUALS(clMutexThread.GetCurPriority(), 2);
+
+    Thread::Sleep(200);
+
+    clMutexThread.Exit();
+    clTestThread2.Exit();
+}
+
+//===========================================================================
+TEST(ut_ceiling_mutex)
+{
+    auto lTokenThread = [](void* /*unused_*/) {
+        u8Token = 1;
+        Scheduler::GetCurrentThread()->Exit();
+    };
+
+    // Test - A thread claiming a priority-ceiling mutex runs at the ceiling
+    // until it releases it, so threads below the ceiling cannot preempt it.
+    CeilingMutex clMutex;
+    clMutex.Init(5, true);
+    u8Token = 0;
+
+    auto* pclMe = Scheduler::GetCurrentThread();
+    pclMe->SetPriority(2);
+
+    clMutex.Claim();
+    EXPECT_EQUALS(pclMe->GetCurPriority(), 5);
+
+    clMutexThread.Init(aucTestStack, sizeof(aucTestStack), 4, lTokenThread, nullptr);
+    clMutexThread.Start();
+    EXPECT_EQUALS(u8Token, 0);
+
+    clMutex.Release();
+    EXPECT_EQUALS(pclMe->GetCurPriority(), 2);
+    EXPECT_EQUALS(u8Token, 1);
+
+    // Test - Nested ceilings are unwound in turn, regardless of release order
+    CeilingMutex clMutex2;
+    clMutex2.Init(6, true);
+
+    clMutex.Claim();
+    clMutex2.Claim();
+    EXPECT_EQUALS(pclMe->GetCurPriority(), 6);
+    clMutex2.Release();
+    EXPECT_EQUALS(pclMe->GetCurPriority(), 5);
+    clMutex.Release();
+    EXPECT_EQUALS(pclMe->GetCurPriority(), 2);
+
+    clMutex.Claim();
+    clMutex2.Claim();
+    clMutex.Release();
+    EXPECT_EQUALS(pclMe->GetCurPriority(), 6);
+    clMutex2.Release();
+    EXPECT_EQUALS(pclMe->GetCurPriority(), 2);
+
+    // Test - Ceiling mutexes work with RAII lock guards
+    {
+        LockGuard lockGuard{ &clMutex };
+        EXPECT_EQUALS(pclMe->GetCurPriority(), 5);
+    }
+    EXPECT_EQUALS(pclMe->GetCurPriority(), 2);
+}
+
+//===========================================================================
+TEST(ut_recursive_handoff_mutex)
+{
+    auto lMutexTest = [](void* mutex_) {
+        auto* pclMutex = static_cast<Mutex*>(mutex_);
+        pclMutex->Claim();
+        u8Token++;
+        pclMutex->Release();
+        Scheduler::GetCurrentThread()->Exit();
+    };
+
+    // Test - A recursively-held mutex is only handed over to a waiting thread
+    // once the owner has released it as many times as it was claimed, and is
+    // left free once the waiter is done with it.
+    Mutex clMutex;
+    clMutex.Init();
+    u8Token = 0;
+
+    clMutex.Claim();
+    clMutex.Claim();
+    clMutex.Claim();
+
+    clMutexThread.Init(aucTestStack, sizeof(aucTestStack), 7, lMutexTest, &clMutex);
+    clMutexThread.Start();
+    EXPECT_EQUALS(u8Token, 0);
+
+    clMutex.Release();
+    clMutex.Release();
+    EXPECT_EQUALS(u8Token, 0);
+
+    clMutex.Release();
+    EXPECT_EQUALS(u8Token, 1);
+
+    // Test - The mutex can be claimed and released without contention again,
+    // and a new waiter still blocks on it
+    EXPECT_TRUE(clMutex.Claim(10));
+    clMutexThread.Init(aucTestStack, sizeof(aucTestStack), 7, lMutexTest, &clMutex);
+    clMutexThread.Start();
+    EXPECT_EQUALS(u8Token, 1);
+    clMutex.Release();
+    EXPECT_EQUALS(u8Token, 2);
+
+    clMutex.Claim();
+    clMutex.Release();
+    EXPECT_TRUE(clMutex.Claim(10));
+    clMutex.Release();
+}
+
 //===========================================================================
 // Test Whitelist Goes Here
 //===========================================================================
 TEST_CASE_START
 TEST_CASE(ut_typical_mutex), TEST_CASE(ut_timed_mutex), TEST_CASE(ut_priority_mutex), TEST_CASE(ut_raii),
-    TEST_CASE(ut_raii_timeout), TEST_CASE_END
+    TEST_CASE(ut_raii_timeout), TEST_CASE(ut_chained_priority_mutex), TEST_CASE(ut_partial_deboost_mutex),
+    TEST_CASE(ut_timeout_deboost_mutex), TEST_CASE(ut_ceiling_mutex), TEST_CASE(ut_recursive_handoff_mutex),
+    TEST_CASE_END
 } // namespace Mark3
@@ -0,0 +1,128 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+#define PERIOD_TICKS (10)
+#define WORK_TICKS (3)
+#define ITERATIONS (20)
+
+Periodic clPeriodic;
+
+//---------------------------------------------------------------------------
+// Simulate a fixed amount of processing within each period
+void DoWork(uint32_t u32Ticks_)
+{
+    auto u32Start = Kernel::GetTicks();
+    while ((Kernel::GetTicks() - u32Start) < u32Ticks_) {}
+}
+} // anonymous namespace
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+TEST(ut_periodic_sleepuntil)
+{
+    // A loop built on relative sleeps drifts by its processing time on every
+    // iteration.
+    auto u32Start = Kernel::GetTicks();
+    for (int i = 0; i < ITERATIONS; i++) {
+        DoWork(WORK_TICKS);
+        Thread::Sleep(PERIOD_TICKS);
+    }
+    auto u32Drift = Kernel::GetTicks() - (u32Start + (ITERATIONS * PERIOD_TICKS));
+    EXPECT_GTE(u32Drift, (ITERATIONS * WORK_TICKS));
+
+    // The same loop built on absolute deadlines does not.
+    auto u32Next = Kernel::GetTicks();
+    for (int i = 0; i < ITERATIONS; i++) {
+        DoWork(WORK_TICKS);
+        u32Next += PERIOD_TICKS;
+        Thread::SleepUntil(u32Next);
+    }
+    EXPECT_TRUE(DeadlineReached(u32Next, Kernel::GetTicks()));
+    u32Drift = Kernel::GetTicks() - u32Next;
+    EXPECT_LT(u32Drift, (ITERATIONS * WORK_TICKS));
+
+    // Deadlines that have already passed return immediately.
+    u32Start = Kernel::GetTicks();
+    Thread::SleepUntil(u32Start - PERIOD_TICKS);
+    EXPECT_LTE(Kernel::GetTicks() - u32Start, 1);
+}
+
+//===========================================================================
+TEST(ut_periodic_release)
+{
+    clPeriodic.Init();
+
+    auto bOnTime = true;
+    clPeriodic.Start(PERIOD_TICKS);
+    auto u32Start = clPeriodic.GetNextRelease() - PERIOD_TICKS;
+    for (int i = 0; i < ITERATIONS; i++) {
+        DoWork(WORK_TICKS);
+        bOnTime = clPeriodic.Wait() && bOnTime;
+    }
+    auto u32Now  = Kernel::GetTicks();
+    auto u32Next = clPeriodic.GetNextRelease();
+    clPeriodic.Stop();
+
+    // Releases stay on the original grid, and the next one is still ahead.
+    EXPECT_EQUALS((u32Next - u32Start) % PERIOD_TICKS, 0);
+    EXPECT_TRUE(TimeAfter(u32Next, u32Now));
+    EXPECT_LTE(u32Next - u32Now, PERIOD_TICKS);
+    EXPECT_EQUALS(bOnTime, (clPeriodic.GetOverruns() == 0));
+}
+
+//===========================================================================
+TEST(ut_periodic_overrun)
+{
+    clPeriodic.Init();
+
+    clPeriodic.Start(PERIOD_TICKS);
+    auto u32Start = clPeriodic.GetNextRelease() - PERIOD_TICKS;
+    clPeriodic.Wait();
+
+    // Overrun the next two releases - the late period runs immediately.
+    auto u32Overruns = clPeriodic.GetOverruns();
+    DoWork((PERIOD_TICKS * 2) + (PERIOD_TICKS / 2));
+    EXPECT_FALSE(clPeriodic.Wait());
+    EXPECT_GTE(clPeriodic.GetOverruns() - u32Overruns, 2);
+
+    // ... and the thread is back in phase with the original releases.
+    clPeriodic.Wait();
+    auto u32Now  = Kernel::GetTicks();
+    auto u32Next = clPeriodic.GetNextRelease();
+    clPeriodic.Stop();
+    EXPECT_EQUALS((u32Next - u32Start) % PERIOD_TICKS, 0);
+    EXPECT_TRUE(TimeAfter(u32Next, u32Now));
+}
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+TEST_CASE(ut_periodic_sleepuntil), TEST_CASE(ut_periodic_release), TEST_CASE(ut_periodic_overrun), TEST_CASE_END
+} // namespace Mark3
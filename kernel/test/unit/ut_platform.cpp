@@ -52,6 +52,12 @@ void run_tests()
 {
     auto* pstCase = astTestCases;
 
+    // Suites for features disabled in mark3cfg.h compile to an empty list -
+    // report them as skipped rather than passed.
+    if (!pstCase->pclTestCase) {
+        PrintString("--SKIPPED--\n");
+    }
+
     while (pstCase->pclTestCase) {
         pstCase->pfTestFunc(pstCase->pclTestCase);
         pstCase->pclTestCase->Complete();
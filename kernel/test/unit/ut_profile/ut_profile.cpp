@@ -0,0 +1,110 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+constexpr auto cu8Buckets    = uint8_t{ 33 };
+constexpr auto cu32LongTicks = uint32_t{ PORT_SYSTEM_FREQ / (CLOCK_DIVIDE * 1000) }; // 1ms
+
+ProfileTimer clTimer;
+uint32_t     au32Histogram[cu8Buckets];
+
+//---------------------------------------------------------------------------
+// Spin for (at least) the given number of profiling timer counts
+void Spin(uint32_t u32Ticks_)
+{
+    ProfileTimer clSpin;
+    clSpin.Init();
+    clSpin.Start();
+    while (clSpin.GetCurrent() < u32Ticks_) {}
+    clSpin.Stop();
+}
+} // anonymous namespace
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+TEST(ut_profile_stats)
+{
+    Profiler::Init();
+    Profiler::Start();
+
+    // Half of the iterations are (nearly) empty, and half spin for 1ms
+    clTimer.Init();
+    clTimer.SetHistogram(au32Histogram, cu8Buckets);
+    for (uint8_t i = 0; i < 50; i++) {
+        clTimer.Start();
+        clTimer.Stop();
+        clTimer.Start();
+        Spin(cu32LongTicks);
+        clTimer.Stop();
+    }
+
+    EXPECT_EQUALS(clTimer.GetIterations(), 100);
+    EXPECT_LT(clTimer.GetMin(), cu32LongTicks);
+    EXPECT_GTE(clTimer.GetMax(), cu32LongTicks);
+    EXPECT_GT(clTimer.GetAverage(), clTimer.GetMin());
+    EXPECT_LT(clTimer.GetAverage(), clTimer.GetMax());
+    EXPECT_EQUALS(clTimer.GetCumulative() / 100, clTimer.GetAverage());
+
+    // The two groups of iterations are about half a long iteration from the mean
+    auto u64Spread = static_cast<uint64_t>(cu32LongTicks / 4);
+    EXPECT_GT(clTimer.GetVariance(), u64Spread * u64Spread);
+
+    auto u32Total = uint32_t{ 0 };
+    for (auto u32Count : au32Histogram) { u32Total += u32Count; }
+    EXPECT_EQUALS(u32Total, 100);
+
+    // The median lies among the empty iterations, and the tail among the long ones
+    EXPECT_LT(clTimer.GetPercentile(50), cu32LongTicks / 2);
+    EXPECT_GTE(clTimer.GetPercentile(99), cu32LongTicks / 2);
+    EXPECT_EQUALS(clTimer.GetPercentile(100), clTimer.GetMax());
+
+    Profiler::Stop();
+}
+
+//===========================================================================
+TEST(ut_profile_reset)
+{
+    clTimer.Init();
+    EXPECT_EQUALS(clTimer.GetIterations(), 0);
+    EXPECT_EQUALS(clTimer.GetMin(), 0);
+    EXPECT_EQUALS(clTimer.GetMax(), 0);
+    EXPECT_EQUALS(clTimer.GetAverage(), 0);
+    EXPECT_EQUALS(clTimer.GetVariance(), 0);
+
+    // Without a histogram, percentiles fall back to the maximum
+    clTimer.Start();
+    clTimer.Stop();
+    EXPECT_EQUALS(clTimer.GetPercentile(50), clTimer.GetMax());
+}
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+TEST_CASE(ut_profile_stats), TEST_CASE(ut_profile_reset), TEST_CASE_END
+} // namespace Mark3
@@ -34,8 +34,10 @@ Thread clTestThread3;
 Thread clTestThread1;
 
 K_WORD aucTestStack1[TEST_STACK1_SIZE];
+#if KERNEL_ROUND_ROBIN
 K_WORD aucTestStack2[TEST_STACK2_SIZE];
 K_WORD aucTestStack3[TEST_STACK3_SIZE];
+#endif // #if KERNEL_ROUND_ROBIN
 
 #define MESSAGE_POOL_SIZE (3)
 MessagePool s_clMessagePool;
@@ -157,7 +159,7 @@ TEST(ut_sanity_sem)
 
     clSemaphore.Init(0, 1);
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 1, lBinaryTest, (void*)&clSemaphore);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 1, lBinaryTest, (void*)&clSemaphore);
     clTestThread1.Start();
 
     u8TestVal = 0x12;
@@ -205,7 +207,7 @@ TEST(ut_sanity_timed_sem)
 
     clSem.Init(0, 1);
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, lShortTime, (void*)&clSem);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lShortTime, (void*)&clSem);
     clTestThread1.Start();
 
     // Test 1 - block on a semaphore, wait on thread that will post before expiry
@@ -215,7 +217,7 @@ TEST(ut_sanity_timed_sem)
     // Test 2 - block on a semaphore, wait on thread that will post after expiry
     clSem.Init(0, 1);
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, lLongTime, (void*)&clSem);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lLongTime, (void*)&clSem);
     clTestThread1.Start();
 
     EXPECT_FALSE(clSem.Pend(15));
@@ -244,7 +246,7 @@ TEST(ut_sanity_sleep)
 
     // Create a lower-priority thread that sets the test value to a known
     // cookie.
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, lSleepFunc, nullptr);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lSleepFunc, nullptr);
     clTestThread1.Start();
 
     // Sleep, when we wake up check the test value
@@ -301,7 +303,7 @@ TEST(ut_sanity_mutex)
         Scheduler::GetCurrentThread()->Exit();
     };
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, lMutexTest, (void*)&clMutex);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lMutexTest, (void*)&clMutex);
     clTestThread1.Start();
 
     u8TestVal = 0xDC;
@@ -324,7 +326,7 @@ TEST(ut_sanity_mutex)
         Scheduler::GetCurrentThread()->Exit();
     };
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, lMutexShort, (void*)&clMutex);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lMutexShort, (void*)&clMutex);
     clTestThread1.Start();
 
     EXPECT_TRUE(clMutex.Claim(15));
@@ -343,7 +345,7 @@ TEST(ut_sanity_mutex)
         Scheduler::GetCurrentThread()->Exit();
     };
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, lMutexLong, (void*)&clMutex);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lMutexLong, (void*)&clMutex);
     clTestThread1.Start();
 
     EXPECT_FALSE(clMutex.Claim(15));
@@ -369,7 +371,7 @@ TEST(ut_sanity_timed_msg)
         Scheduler::GetCurrentThread()->Exit();
     };
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, lTimedMessage, (void*)&clMsgQ1);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lTimedMessage, (void*)&clMsgQ1);
     clTestThread1.Start();
 
     auto pclMsg = clMsgQ1.Receive(15);
@@ -407,7 +409,7 @@ TEST(ut_sanity_msg)
 
     auto* pclMesg = s_clMessagePool.Pop();
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, (ThreadEntryFunc)TestMessageTest, nullptr);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, (ThreadEntryFunc)TestMessageTest, nullptr);
     clTestThread1.Start();
     Thread::Yield();
 
@@ -452,6 +454,7 @@ TEST(ut_sanity_msg)
     clTestThread1.Exit();
 }
 
+#if KERNEL_ROUND_ROBIN
 //---------------------------------------------------------------------------
 // Round-Robin Thread
 //  Create 3 threads in the same priority group (lower than our thread), and
@@ -474,9 +477,9 @@ TEST(ut_sanity_rr)
 
     Scheduler::GetCurrentThread()->SetPriority(3);
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, lRRFunc, (void*)&u32Counter1);
-    clTestThread2.Init(aucTestStack2, TEST_STACK2_SIZE, 2, lRRFunc, (void*)&u32Counter2);
-    clTestThread3.Init(aucTestStack3, TEST_STACK3_SIZE, 2, lRRFunc, (void*)&u32Counter3);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lRRFunc, (void*)&u32Counter1);
+    clTestThread2.Init(aucTestStack2, sizeof(aucTestStack2), 2, lRRFunc, (void*)&u32Counter2);
+    clTestThread3.Init(aucTestStack3, sizeof(aucTestStack3), 2, lRRFunc, (void*)&u32Counter3);
 
     clTestThread1.Start();
     clTestThread2.Start();
@@ -526,9 +529,9 @@ TEST(ut_sanity_quantum)
 
     Scheduler::GetCurrentThread()->SetPriority(3);
 
-    clTestThread1.Init(aucTestStack1, TEST_STACK1_SIZE, 2, lRRFunc, (void*)&u32Counter1);
-    clTestThread2.Init(aucTestStack2, TEST_STACK2_SIZE, 2, lRRFunc, (void*)&u32Counter2);
-    clTestThread3.Init(aucTestStack3, TEST_STACK3_SIZE, 2, lRRFunc, (void*)&u32Counter3);
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lRRFunc, (void*)&u32Counter1);
+    clTestThread2.Init(aucTestStack2, sizeof(aucTestStack2), 2, lRRFunc, (void*)&u32Counter2);
+    clTestThread3.Init(aucTestStack3, sizeof(aucTestStack3), 2, lRRFunc, (void*)&u32Counter3);
 
     clTestThread1.SetQuantum(10);
     clTestThread2.SetQuantum(20);
@@ -569,6 +572,7 @@ TEST(ut_sanity_quantum)
 
     Scheduler::GetCurrentThread()->SetPriority(1);
 }
+#endif // #if KERNEL_ROUND_ROBIN
 
 // void UT_TimerTest(void)
 TEST(ut_sanity_timer)
@@ -606,6 +610,10 @@ TEST(ut_sanity_timer)
 TEST_CASE_START
 TEST_CASE(ut_sanity_sem)
 , TEST_CASE(ut_sanity_timed_sem), TEST_CASE(ut_sanity_sleep), TEST_CASE(ut_sanity_mutex), TEST_CASE(ut_sanity_msg),
-    TEST_CASE(ut_sanity_timed_msg), TEST_CASE(ut_sanity_rr), TEST_CASE(ut_sanity_quantum),
-    TEST_CASE(ut_sanity_timer), TEST_CASE_END
+    TEST_CASE(ut_sanity_timed_msg),
+#if KERNEL_ROUND_ROBIN
+    TEST_CASE(ut_sanity_rr), TEST_CASE(ut_sanity_quantum),
+#endif // #if KERNEL_ROUND_ROBIN
+    TEST_CASE(ut_sanity_timer),
+    TEST_CASE_END
 } // namespace Mark3
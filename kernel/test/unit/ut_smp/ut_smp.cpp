@@ -0,0 +1,243 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+#if KERNEL_SMP
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+constexpr auto cu8NumThreads   = uint8_t{ PORT_CORE_COUNT - 1 };
+constexpr auto cu8OtherCores   = static_cast<uint8_t>(((1 << PORT_CORE_COUNT) - 1) & ~1);
+constexpr auto cu16Iterations  = uint16_t{ 1000 };
+constexpr auto cu32TimeoutMs   = uint32_t{ 5000 };
+
+Thread            aclThreads[cu8NumThreads];
+K_WORD            aawStacks[cu8NumThreads][PORT_KERNEL_DEFAULT_STACK_SIZE];
+Semaphore         aclSemaphores[2];
+Mutex             clMutex;
+volatile bool     abArrived[cu8NumThreads];
+volatile uint8_t  au8RanOn[cu8NumThreads];
+volatile uint32_t au32Counts[cu8NumThreads];
+volatile uint32_t u32Shared;
+
+//---------------------------------------------------------------------------
+// Start one thread on each core other than the boot core
+void StartOnOtherCores(ThreadEntryFunc pfEntry_)
+{
+    for (uint8_t i = 0; i < cu8NumThreads; i++) {
+        abArrived[i]  = false;
+        au8RanOn[i]   = 0xFF;
+        au32Counts[i] = 0;
+        aclThreads[i].Init(aawStacks[i], sizeof(aawStacks[i]), 2, pfEntry_, reinterpret_cast<void*>(static_cast<K_ADDR>(i)));
+        aclThreads[i].SetAffinity(cu8OtherCores);
+        aclThreads[i].Start();
+    }
+}
+
+//---------------------------------------------------------------------------
+void ExitAll()
+{
+    for (auto& clThread : aclThreads) { clThread.Exit(); }
+}
+
+//---------------------------------------------------------------------------
+// Wait (polling) until a condition is met, or the test times out
+template <typename T> bool WaitFor(T pfCondition_)
+{
+    for (uint32_t u32Elapsed = 0; u32Elapsed < cu32TimeoutMs; u32Elapsed += 10) {
+        if (pfCondition_()) {
+            return true;
+        }
+        Thread::Sleep(10);
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------
+uint8_t GetIndex(void* pvArg_)
+{
+    return static_cast<uint8_t>(reinterpret_cast<K_ADDR>(pvArg_));
+}
+
+//---------------------------------------------------------------------------
+// Wait for every other thread to arrive - only possible if all run at once
+void RendezvousTask(void* pvArg_)
+{
+    auto u8Index       = GetIndex(pvArg_);
+    au8RanOn[u8Index]  = ThreadPort::CoreId();
+    abArrived[u8Index] = true;
+    for (uint8_t i = 0; i < cu8NumThreads; i++) {
+        while (!abArrived[i]) {}
+    }
+    au32Counts[u8Index] = 1;
+    while (true) { Thread::Sleep(1000); }
+}
+
+//---------------------------------------------------------------------------
+void PingPongTask(void* /*unused*/)
+{
+    while (true) {
+        aclSemaphores[0].Pend();
+        au32Counts[0]++;
+        aclSemaphores[1].Post();
+    }
+}
+
+//---------------------------------------------------------------------------
+void SpinTask(void* pvArg_)
+{
+    auto u8Index = GetIndex(pvArg_);
+    while (true) { au32Counts[u8Index]++; }
+}
+
+//---------------------------------------------------------------------------
+void MutexTask(void* pvArg_)
+{
+    auto u8Index = GetIndex(pvArg_);
+    for (uint16_t i = 0; i < cu16Iterations; i++) {
+        clMutex.Claim();
+        auto u32Value = u32Shared;
+        Thread::Yield();
+        u32Shared = u32Value + 1;
+        clMutex.Release();
+    }
+    au32Counts[u8Index] = 1;
+    while (true) { Thread::Sleep(1000); }
+}
+} // anonymous namespace
+#endif // #if KERNEL_SMP
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_SMP
+TEST(ut_smp_affinity)
+{
+    // Threads stay on the boot core by default
+    aclThreads[0].Init(aawStacks[0], sizeof(aawStacks[0]), 2, SpinTask, nullptr);
+    EXPECT_EQUALS(aclThreads[0].GetAffinity(), 1);
+    EXPECT_EQUALS(aclThreads[0].GetCore(), 0);
+    aclThreads[0].Exit();
+
+    // Threads allowed on several cores are spread across them
+    auto u8Cores = uint8_t{ 0 };
+    StartOnOtherCores(SpinTask);
+    for (auto& clThread : aclThreads) {
+        EXPECT_TRUE((cu8OtherCores & (1 << clThread.GetCore())) != 0);
+        u8Cores |= static_cast<uint8_t>(1 << clThread.GetCore());
+    }
+    EXPECT_EQUALS(u8Cores, cu8OtherCores);
+    ExitAll();
+}
+
+//===========================================================================
+TEST(ut_smp_parallel)
+{
+    // Each thread spins until all of the others have started, which only
+    // completes if they are running at the same time, on their own cores.
+    StartOnOtherCores(RendezvousTask);
+    EXPECT_TRUE(WaitFor([]() {
+        for (auto u32Count : au32Counts) {
+            if (u32Count == 0) {
+                return false;
+            }
+        }
+        return true;
+    }));
+    for (uint8_t i = 0; i < cu8NumThreads; i++) { EXPECT_EQUALS(au8RanOn[i], aclThreads[i].GetCore()); }
+    ExitAll();
+}
+
+//===========================================================================
+TEST(ut_smp_wakeup)
+{
+    // Threads woken from another core are switched-in by an IPI
+    aclSemaphores[0].Init(0, 1);
+    aclSemaphores[1].Init(0, 1);
+    au32Counts[0] = 0;
+    aclThreads[0].Init(aawStacks[0], sizeof(aawStacks[0]), 2, PingPongTask, nullptr);
+    aclThreads[0].SetAffinity(cu8OtherCores);
+    aclThreads[0].Start();
+
+    auto u16Completed = uint16_t{ 0 };
+    for (uint16_t i = 0; i < cu16Iterations; i++) {
+        aclSemaphores[0].Post();
+        if (!aclSemaphores[1].Pend(cu32TimeoutMs)) {
+            break;
+        }
+        u16Completed++;
+    }
+    EXPECT_EQUALS(u16Completed, cu16Iterations);
+    EXPECT_EQUALS(au32Counts[0], cu16Iterations);
+    aclThreads[0].Exit();
+}
+
+//===========================================================================
+TEST(ut_smp_stop_remote)
+{
+    // Stopping a thread running on another core takes it off that core
+    StartOnOtherCores(SpinTask);
+    EXPECT_TRUE(WaitFor([]() { return au32Counts[0] != 0; }));
+    aclThreads[0].Stop();
+    Thread::Sleep(10);
+    auto u32Stopped = au32Counts[0];
+    Thread::Sleep(50);
+    EXPECT_EQUALS(au32Counts[0], u32Stopped);
+
+    // ... and restarting it puts it back on the same core
+    aclThreads[0].Start();
+    EXPECT_TRUE(WaitFor([u32Stopped]() { return au32Counts[0] != u32Stopped; }));
+    ExitAll();
+}
+
+//===========================================================================
+TEST(ut_smp_mutex)
+{
+    // Threads on different cores contend for the same mutex
+    clMutex.Init();
+    u32Shared = 0;
+    StartOnOtherCores(MutexTask);
+    EXPECT_TRUE(WaitFor([]() {
+        for (auto u32Count : au32Counts) {
+            if (u32Count == 0) {
+                return false;
+            }
+        }
+        return true;
+    }));
+    EXPECT_EQUALS(u32Shared, static_cast<uint32_t>(cu16Iterations) * cu8NumThreads);
+    ExitAll();
+}
+#endif // #if KERNEL_SMP
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_SMP
+TEST_CASE(ut_smp_affinity)
+, TEST_CASE(ut_smp_parallel), TEST_CASE(ut_smp_wakeup), TEST_CASE(ut_smp_stop_remote), TEST_CASE(ut_smp_mutex),
+#endif // #if KERNEL_SMP
+    TEST_CASE_END
+} // namespace Mark3
@@ -0,0 +1,73 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+#if KERNEL_STACK_CHECK
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+Thread clTestThread1;
+K_WORD aucTestStack1[PORT_KERNEL_DEFAULT_STACK_SIZE];
+} // anonymous namespace
+#endif // #if KERNEL_STACK_CHECK
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_STACK_CHECK
+TEST(ut_stack_highwater)
+{
+    // The stack used by a thread is picked up by the high-water mark
+    // maintained at context switches, and agrees with a full slack scan.
+    auto lStackFunc = [](void* /*unused_*/) {
+        volatile K_WORD awBuffer[256];
+        for (auto& wWord : awBuffer) { wWord = 0; }
+        Thread::Sleep(1);
+        Scheduler::GetCurrentThread()->Exit();
+    };
+
+    auto u16StackWords = static_cast<uint16_t>(sizeof(aucTestStack1) / sizeof(K_WORD));
+
+    clTestThread1.Init(aucTestStack1, sizeof(aucTestStack1), 2, lStackFunc, nullptr);
+    EXPECT_LT(clTestThread1.GetStackHighWater(), 256);
+
+    clTestThread1.Start();
+    Thread::Sleep(5);
+
+    auto u16HighWater = clTestThread1.GetStackHighWater();
+    EXPECT_GTE(u16HighWater, 256);
+    EXPECT_LT(u16HighWater, u16StackWords);
+    EXPECT_LTE(clTestThread1.GetStackSlack(), u16StackWords - 256);
+}
+#endif // #if KERNEL_STACK_CHECK
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_STACK_CHECK
+TEST_CASE(ut_stack_highwater),
+#endif // #if KERNEL_STACK_CHECK
+    TEST_CASE_END
+} // namespace Mark3
@@ -32,8 +32,10 @@ using namespace Mark3;
 // Local Defines
 //===========================================================================
 K_WORD aucStack1[PORT_KERNEL_DEFAULT_STACK_SIZE];
+#if KERNEL_ROUND_ROBIN
 K_WORD aucStack2[PORT_KERNEL_DEFAULT_STACK_SIZE];
 K_WORD aucStack3[PORT_KERNEL_DEFAULT_STACK_SIZE];
+#endif // #if KERNEL_ROUND_ROBIN
 
 Thread clThread1;
 Thread clThread2;
@@ -174,6 +176,7 @@ TEST(ut_threadsleep)
     Profiler::Stop();
 }
 
+#if KERNEL_ROUND_ROBIN
 //===========================================================================
 TEST(ut_roundrobin)
 {
@@ -329,12 +332,16 @@ TEST(ut_quanta)
     EXPECT_FAIL_EQUALS(u32RR2, 0);
     EXPECT_FAIL_EQUALS(u32RR3, 0);
 }
+#endif // #if KERNEL_ROUND_ROBIN
 
 //===========================================================================
 // Test Whitelist Goes Here
 //===========================================================================
 TEST_CASE_START
 TEST_CASE(ut_threadcreate)
-, TEST_CASE(ut_threadstop), TEST_CASE(ut_threadexit), TEST_CASE(ut_threadsleep), TEST_CASE(ut_roundrobin),
-    TEST_CASE(ut_quanta), TEST_CASE_END
+, TEST_CASE(ut_threadstop), TEST_CASE(ut_threadexit), TEST_CASE(ut_threadsleep),
+#if KERNEL_ROUND_ROBIN
+    TEST_CASE(ut_roundrobin), TEST_CASE(ut_quanta),
+#endif // #if KERNEL_ROUND_ROBIN
+    TEST_CASE_END
 } // namespace Mark3
@@ -0,0 +1,180 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+#if KERNEL_THREAD_NOTIFY
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+Thread            clThread;
+K_WORD            awStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+Timer             clTimer;
+volatile uint32_t u32Result;
+volatile uint32_t u32Wakes;
+
+//---------------------------------------------------------------------------
+void WaitTask(void* pvMask_)
+{
+    auto u32Mask = static_cast<uint32_t>(reinterpret_cast<K_ADDR>(pvMask_));
+    while (true) {
+        u32Result = Thread::WaitNotification(u32Mask);
+        u32Wakes++;
+    }
+}
+
+//---------------------------------------------------------------------------
+void StartWaiter(uint32_t u32Mask_)
+{
+    u32Result = 0;
+    u32Wakes  = 0;
+    clThread.Init(awStack, sizeof(awStack), 2, WaitTask, reinterpret_cast<void*>(static_cast<K_ADDR>(u32Mask_)));
+    clThread.Start();
+}
+
+//---------------------------------------------------------------------------
+void TimerNotify(Thread* /*pclOwner_*/, void* pvData_)
+{
+    static_cast<Thread*>(pvData_)->Notify(0x80, NotifyAction::SetBits);
+}
+} // anonymous namespace
+#endif // #if KERNEL_THREAD_NOTIFY
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_THREAD_NOTIFY
+TEST(ut_threadnotify_setbits)
+{
+    StartWaiter(0x03);
+    EXPECT_EQUALS(u32Wakes, 0);
+
+    // Bits outside the mask are recorded, but don't wake the thread
+    clThread.Notify(0x04, NotifyAction::SetBits);
+    EXPECT_EQUALS(u32Wakes, 0);
+    EXPECT_EQUALS(clThread.GetNotification(), 0x04);
+
+    // Bits within the mask wake the (higher-priority) thread immediately,
+    // and only those bits are consumed.
+    clThread.Notify(0x02, NotifyAction::SetBits);
+    EXPECT_EQUALS(u32Wakes, 1);
+    EXPECT_EQUALS(u32Result, 0x02);
+    EXPECT_EQUALS(clThread.GetNotification(), 0x04);
+
+    clThread.Notify(0x03, NotifyAction::SetBits);
+    EXPECT_EQUALS(u32Wakes, 2);
+    EXPECT_EQUALS(u32Result, 0x03);
+
+    clThread.Exit();
+}
+
+//===========================================================================
+TEST(ut_threadnotify_increment)
+{
+    auto* pclSelf = Scheduler::GetCurrentThread();
+
+    // Used as a count, the word is consumed all at once
+    for (auto i = 0; i < 5; i++) { pclSelf->Notify(0, NotifyAction::Increment); }
+    EXPECT_EQUALS(pclSelf->GetNotification(), 5);
+    EXPECT_EQUALS(Thread::WaitNotification(0xFFFFFFFF), 5);
+    EXPECT_EQUALS(pclSelf->GetNotification(), 0);
+
+    StartWaiter(0xFFFFFFFF);
+    clThread.Notify(0, NotifyAction::Increment);
+    EXPECT_EQUALS(u32Wakes, 1);
+    EXPECT_EQUALS(u32Result, 1);
+
+    clThread.Exit();
+}
+
+//===========================================================================
+TEST(ut_threadnotify_overwrite)
+{
+    auto* pclSelf = Scheduler::GetCurrentThread();
+
+    pclSelf->Notify(0x0F, NotifyAction::SetBits);
+    pclSelf->Notify(0x30, NotifyAction::Overwrite);
+    EXPECT_EQUALS(pclSelf->GetNotification(), 0x30);
+    EXPECT_EQUALS(Thread::WaitNotification(0x10), 0x10);
+    EXPECT_EQUALS(Thread::WaitNotification(0x20), 0x20);
+
+    // Overwriting with bits outside of the mask doesn't wake the thread
+    StartWaiter(0x01);
+    clThread.Notify(0x02, NotifyAction::Overwrite);
+    EXPECT_EQUALS(u32Wakes, 0);
+    clThread.Notify(0x01, NotifyAction::Overwrite);
+    EXPECT_EQUALS(u32Wakes, 1);
+    EXPECT_EQUALS(u32Result, 0x01);
+
+    clThread.Exit();
+}
+
+//===========================================================================
+TEST(ut_threadnotify_timeout)
+{
+    // Nothing arrives - the wait times out, returning no bits
+    auto u32Start = Kernel::GetTicks();
+    EXPECT_EQUALS(Thread::WaitNotification(0x01, 50), 0);
+    EXPECT_GTE(Kernel::GetTicks() - u32Start, 50);
+
+    // A notification from a timer callback wakes the thread before the timeout
+    clTimer.Init();
+    clTimer.Start(false, 20, TimerNotify, Scheduler::GetCurrentThread());
+    u32Start = Kernel::GetTicks();
+    EXPECT_EQUALS(Thread::WaitNotification(0x80, 1000), 0x80);
+    EXPECT_LT(Kernel::GetTicks() - u32Start, 1000);
+
+    // ... and the expired timeout doesn't disturb subsequent waits
+    Thread::Sleep(50);
+    EXPECT_EQUALS(Thread::WaitNotification(0x80, 10), 0);
+}
+
+//===========================================================================
+TEST(ut_threadnotify_stop)
+{
+    // A notification sent while the waiter is stopped is held for it
+    StartWaiter(0x01);
+    clThread.Stop();
+    clThread.Notify(0x01, NotifyAction::SetBits);
+    EXPECT_EQUALS(u32Wakes, 0);
+    EXPECT_EQUALS(clThread.GetNotification(), 0x01);
+
+    clThread.Start();
+    EXPECT_EQUALS(u32Wakes, 1);
+    EXPECT_EQUALS(u32Result, 0x01);
+
+    clThread.Exit();
+}
+#endif // #if KERNEL_THREAD_NOTIFY
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_THREAD_NOTIFY
+TEST_CASE(ut_threadnotify_setbits)
+, TEST_CASE(ut_threadnotify_increment), TEST_CASE(ut_threadnotify_overwrite), TEST_CASE(ut_threadnotify_timeout),
+    TEST_CASE(ut_threadnotify_stop),
+#endif // #if KERNEL_THREAD_NOTIFY
+    TEST_CASE_END
+} // namespace Mark3
@@ -27,6 +27,10 @@ See license.txt for more information
 namespace
 {
 using namespace Mark3;
+//---------------------------------------------------------------------------
+// Convert a time in 1/16ths of a millisecond to CPU cycles (profiler ticks * CLOCK_DIVIDE)
+#define SIXTEENTHS_MS_TO_CYCLES(x) ((uint32_t)(x) * (uint32_t)(PORT_SYSTEM_FREQ / 16000))
+
 //---------------------------------------------------------------------------
 // Global objects
 ProfileTimer clProfiler100m; //!< Profiling timer
@@ -122,27 +126,27 @@ TEST(ut_timer_sanity_multi)
         switch (pclMsg->GetCode()) {
             case 0:
                 clProfiler1.Stop();
-                aulDelta[0] = clProfiler1.GetCurrent() * 8;
+                aulDelta[0] = clProfiler1.GetCurrent() * CLOCK_DIVIDE;
                 clProfiler1.Start();
-                if ((aulDelta[0] < (6 * 16000L)) || (aulDelta[0] > (8 * 16000L))) {
+                if ((aulDelta[0] < SIXTEENTHS_MS_TO_CYCLES(96)) || (aulDelta[0] > SIXTEENTHS_MS_TO_CYCLES(128))) {
                     EXPECT_TRUE(0);
                     bDone = true;
                 }
                 break;
             case 1:
                 clProfiler2.Stop();
-                aulDelta[1] = clProfiler2.GetCurrent() * 8;
+                aulDelta[1] = clProfiler2.GetCurrent() * CLOCK_DIVIDE;
                 clProfiler2.Start();
-                if ((aulDelta[1] < (12 * 16000L)) || (aulDelta[1] > (14 * 16000L))) {
+                if ((aulDelta[1] < SIXTEENTHS_MS_TO_CYCLES(192)) || (aulDelta[1] > SIXTEENTHS_MS_TO_CYCLES(224))) {
                     EXPECT_TRUE(0);
                     bDone = true;
                 }
                 break;
             case 2:
                 clProfiler3.Stop();
-                aulDelta[2] = clProfiler3.GetCurrent() * 8;
+                aulDelta[2] = clProfiler3.GetCurrent() * CLOCK_DIVIDE;
                 clProfiler3.Start();
-                if ((aulDelta[2] < (18 * 16000L)) || (aulDelta[2] > (20 * 16000L))) {
+                if ((aulDelta[2] < SIXTEENTHS_MS_TO_CYCLES(288)) || (aulDelta[2] > SIXTEENTHS_MS_TO_CYCLES(320))) {
                     EXPECT_TRUE(0);
                     bDone = true;
                 }
@@ -208,8 +212,8 @@ TEST(ut_timer_sanity_precision)
 
         clTimerSem.Pend();
         clProfiler1m.Stop();
-        u32Delta = clProfiler1m.GetCurrent() * 8;
-        if ((u32Delta < 12000) || (u32Delta > 20000)) {
+        u32Delta = clProfiler1m.GetCurrent() * CLOCK_DIVIDE;
+        if ((u32Delta < SIXTEENTHS_MS_TO_CYCLES(12)) || (u32Delta > SIXTEENTHS_MS_TO_CYCLES(20))) {
             // Write error...
             bPass = false;
             break;
@@ -225,8 +229,8 @@ TEST(ut_timer_sanity_precision)
         clProfiler10m.Start();
         clTimerSem.Pend();
         clProfiler10m.Stop();
-        u32Delta = clProfiler10m.GetCurrent() * 8;
-        if ((u32Delta < 155000) || (u32Delta > 165000)) {
+        u32Delta = clProfiler10m.GetCurrent() * CLOCK_DIVIDE;
+        if ((u32Delta < SIXTEENTHS_MS_TO_CYCLES(155)) || (u32Delta > SIXTEENTHS_MS_TO_CYCLES(165))) {
             // Write error...
             bPass = false;
             break;
@@ -242,8 +246,8 @@ TEST(ut_timer_sanity_precision)
         clProfiler100m.Start();
         clTimerSem.Pend();
         clProfiler100m.Stop();
-        u32Delta = clProfiler100m.GetCurrent() * 8;
-        if ((u32Delta < 1595000) || (u32Delta > 1605000)) {
+        u32Delta = clProfiler100m.GetCurrent() * CLOCK_DIVIDE;
+        if ((u32Delta < SIXTEENTHS_MS_TO_CYCLES(1595)) || (u32Delta > SIXTEENTHS_MS_TO_CYCLES(1605))) {
             // Write error...
             bPass = false;
             break;
@@ -0,0 +1,397 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "timerlist.h"
+#include "timerwheel.h"
+#include "thread.h"
+#include "ksemaphore.h"
+#include "ktime.h"
+
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+constexpr auto cu8NumTimers = uint8_t{ 6 };
+
+Timer             aclTimers[cu8NumTimers];
+Semaphore         clTimerSem;
+uint8_t           au8Order[cu8NumTimers];
+uint32_t          au32Ticks[cu8NumTimers];
+volatile uint8_t  u8ExpiredCount  = 0;
+volatile uint32_t u32RepeatCount  = 0;
+volatile uint32_t u32RepeatAtStop = 0;
+
+void OrderCallback(Thread* pclOwner_, void* pvVal_)
+{
+    auto u8Index = static_cast<uint8_t>(reinterpret_cast<K_ADDR>(pvVal_));
+    au8Order[u8ExpiredCount]  = u8Index;
+    au32Ticks[u8ExpiredCount] = Kernel::GetTicks();
+    u8ExpiredCount++;
+    clTimerSem.Post();
+}
+
+void RepeatCallback(Thread* pclOwner_, void* pvVal_)
+{
+    u32RepeatCount++;
+}
+
+void OneShotCallback(Thread* pclOwner_, void* pvVal_)
+{
+    u32RepeatAtStop = u32RepeatCount;
+    clTimerSem.Post();
+}
+
+volatile uint32_t u32Now = 0;
+uint32_t          au32Expiry[cu8NumTimers];
+uint32_t          au32Count[cu8NumTimers];
+
+void BackendCallback(Thread* pclOwner_, void* pvVal_)
+{
+    auto u8Index = static_cast<uint8_t>(reinterpret_cast<K_ADDR>(pvVal_));
+    au32Expiry[u8Index] = u32Now;
+    au32Count[u8Index]++;
+}
+
+// Timers only expose their configuration through Start(), so configure them
+// via the system timer scheduler before handing them to a backend under test.
+void ConfigureTimer(Timer* pclTimer_, bool bRepeat_, uint32_t u32Interval_, uint8_t u8Index_, uint32_t u32Tolerance_ = 0)
+{
+    pclTimer_->Init();
+    pclTimer_->Start(bRepeat_,
+                     u32Interval_,
+                     u32Tolerance_,
+                     BackendCallback,
+                     reinterpret_cast<void*>(static_cast<K_ADDR>(u8Index_)));
+    pclTimer_->Stop();
+}
+
+// Run one-shot timers at boundaries of the backend's internal structure, and
+// check that each one expires on exactly the right tick.
+template <typename T> bool CheckOneShots(T* pclBackend_)
+{
+    static const uint32_t au32Interval[cu8NumTimers] = { 1, 63, 64, 4097, 262145, 16777221 };
+
+    pclBackend_->Init();
+    u32Now = 0;
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        ConfigureTimer(&aclTimers[i], false, au32Interval[i], i);
+        au32Expiry[i] = 0;
+        au32Count[i]  = 0;
+        pclBackend_->Add(&aclTimers[i]);
+    }
+    while (u32Now < au32Interval[cu8NumTimers - 1] + 100) {
+        u32Now++;
+        pclBackend_->Process();
+    }
+
+    bool bRet = true;
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        if ((au32Count[i] != 1) || (au32Expiry[i] != au32Interval[i])) {
+            bRet = false;
+        }
+    }
+    return bRet;
+}
+
+// Run repeating timers, stopping one part-way through, and check that each
+// timer expired the expected number of times.
+template <typename T> bool CheckRepeats(T* pclBackend_)
+{
+    static const uint32_t au32Interval[cu8NumTimers] = { 1, 7, 64, 65, 100, 1000 };
+    constexpr auto        cu32Ticks                  = uint32_t{ 10000 };
+
+    pclBackend_->Init();
+    u32Now = 0;
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        ConfigureTimer(&aclTimers[i], true, au32Interval[i], i);
+        au32Count[i] = 0;
+        pclBackend_->Add(&aclTimers[i]);
+    }
+    while (u32Now < cu32Ticks) {
+        u32Now++;
+        pclBackend_->Process();
+        if (u32Now == (cu32Ticks / 2)) {
+            pclBackend_->Remove(&aclTimers[1]);
+        }
+    }
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        if (i != 1) {
+            pclBackend_->Remove(&aclTimers[i]);
+        }
+    }
+
+    bool bRet = true;
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        auto u32Ticks = (i == 1) ? (cu32Ticks / 2) : cu32Ticks;
+        if (au32Count[i] != (u32Ticks / au32Interval[i])) {
+            bRet = false;
+        }
+    }
+    return bRet;
+}
+
+#if !KERNEL_TIMERS_TICKLESS
+// Run one-shot timers with tolerances, and check that timers whose windows
+// overlap are expired together, at the latest tick allowed by the first of them.
+bool CheckCoalesce(TimerList* pclBackend_)
+{
+    static const uint32_t au32Interval[cu8NumTimers]  = { 100, 110, 120, 200, 205, 300 };
+    static const uint32_t au32Tolerance[cu8NumTimers] = { 30, 30, 30, 0, 10, 0 };
+    static const uint32_t au32Expected[cu8NumTimers]  = { 130, 130, 130, 200, 215, 300 };
+
+    pclBackend_->Init();
+    u32Now = 0;
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        ConfigureTimer(&aclTimers[i], false, au32Interval[i], i, au32Tolerance[i]);
+        au32Expiry[i] = 0;
+        au32Count[i]  = 0;
+        pclBackend_->Add(&aclTimers[i]);
+    }
+    while (u32Now < 400) {
+        u32Now++;
+        pclBackend_->Process();
+    }
+
+    bool bRet = (pclBackend_->GetWakeupCount() == 4) && (pclBackend_->GetCoalescedCount() == 2);
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        if ((au32Count[i] != 1) || (au32Expiry[i] != au32Expected[i])) {
+            bRet = false;
+        }
+    }
+    return bRet;
+}
+#endif // #if !KERNEL_TIMERS_TICKLESS
+
+TimerList  clTimerList;
+TimerWheel clTimerWheel;
+
+void ResetTimers()
+{
+    for (auto& clTimer : aclTimers) { clTimer.Init(); }
+    for (auto& u8Order : au8Order) { u8Order = 0xFF; }
+    u8ExpiredCount = 0;
+}
+} // anonymous namespace
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+TEST(ut_timerlist_order)
+{
+    // Timers started out of order must expire in order of their deadlines,
+    // with timers sharing a deadline expiring in the order they were started.
+    static const uint32_t au32Interval[cu8NumTimers] = { 70, 30, 110, 30, 10, 50 };
+    static const uint8_t  au8Expected[cu8NumTimers]  = { 4, 1, 3, 5, 0, 2 };
+
+    clTimerSem.Init(0, cu8NumTimers);
+    ResetTimers();
+
+    for (uint8_t i = 0; i < cu8NumTimers; i++) {
+        aclTimers[i].Start(false, au32Interval[i], OrderCallback, reinterpret_cast<void*>(static_cast<K_ADDR>(i)));
+    }
+    for (uint8_t i = 0; i < cu8NumTimers; i++) { clTimerSem.Pend(); }
+
+    EXPECT_EQUALS(u8ExpiredCount, cu8NumTimers);
+    for (uint8_t i = 0; i < cu8NumTimers; i++) { EXPECT_EQUALS(au8Order[i], au8Expected[i]); }
+}
+
+TEST(ut_timerlist_remove)
+{
+    // Removing a timer from the middle of the list must not change when the
+    // timers behind it expire.
+    clTimerSem.Init(0, cu8NumTimers);
+    ResetTimers();
+
+    auto u32Start = Kernel::GetTicks();
+    aclTimers[0].Start(false, 20, OrderCallback, reinterpret_cast<void*>(0));
+    aclTimers[1].Start(false, 40, OrderCallback, reinterpret_cast<void*>(1));
+    aclTimers[2].Start(false, 60, OrderCallback, reinterpret_cast<void*>(2));
+    aclTimers[1].Stop();
+
+    clTimerSem.Pend();
+    clTimerSem.Pend();
+
+    EXPECT_EQUALS(u8ExpiredCount, 2);
+    EXPECT_EQUALS(au8Order[0], 0);
+    EXPECT_EQUALS(au8Order[1], 2);
+    EXPECT_GTE(au32Ticks[0] - u32Start, 20);
+    EXPECT_GTE(au32Ticks[1] - u32Start, 60);
+
+    // The stopped timer must not fire later on.
+    Thread::Sleep(60);
+    EXPECT_EQUALS(u8ExpiredCount, 2);
+
+    // Removing the head must hand its remaining time to the next timer.
+    ResetTimers();
+    u32Start = Kernel::GetTicks();
+    aclTimers[0].Start(false, 20, OrderCallback, reinterpret_cast<void*>(0));
+    aclTimers[1].Start(false, 40, OrderCallback, reinterpret_cast<void*>(1));
+    aclTimers[0].Stop();
+
+    clTimerSem.Pend();
+    EXPECT_EQUALS(u8ExpiredCount, 1);
+    EXPECT_EQUALS(au8Order[0], 1);
+    EXPECT_GTE(au32Ticks[0] - u32Start, 40);
+}
+
+TEST(ut_timerlist_restart)
+{
+    // A timer stopped before the timer scheduler has sorted it into its list
+    // must never fire, and a timer stopped and restarted that way must only
+    // fire for its last start.
+    clTimerSem.Init(0, cu8NumTimers);
+    ResetTimers();
+
+    auto u32Start = Kernel::GetTicks();
+    aclTimers[0].Start(false, 10, OrderCallback, reinterpret_cast<void*>(0));
+    aclTimers[0].Stop();
+    for (uint8_t i = 0; i < 4; i++) {
+        aclTimers[1].Stop();
+        aclTimers[1].Start(false, 20 + (i * 10), OrderCallback, reinterpret_cast<void*>(1));
+    }
+
+    clTimerSem.Pend();
+    EXPECT_EQUALS(u8ExpiredCount, 1);
+    EXPECT_EQUALS(au8Order[0], 1);
+    EXPECT_GTE(au32Ticks[0] - u32Start, 50);
+
+    Thread::Sleep(60);
+    EXPECT_EQUALS(u8ExpiredCount, 1);
+}
+
+TEST(ut_timerlist_repeat)
+{
+    // A repeating timer is re-queued behind the one-shot timer's deadline:
+    // expiries at 40/80 ticks happen before the one-shot at 100 ticks, the
+    // one at 120 ticks does not.
+    clTimerSem.Init(0, 1);
+    ResetTimers();
+    u32RepeatCount = 0;
+
+    aclTimers[0].Start(true, 40, RepeatCallback, 0);
+    aclTimers[1].Start(false, 100, OneShotCallback, 0);
+
+    clTimerSem.Pend();
+    aclTimers[0].Stop();
+
+    EXPECT_EQUALS(u32RepeatAtStop, 2);
+
+    // Stopped repeating timers stay stopped.
+    auto u32Count = u32RepeatCount;
+    Thread::Sleep(100);
+    EXPECT_EQUALS(u32RepeatCount, u32Count);
+}
+
+TEST(ut_timerlist_backends)
+{
+    // Drive each timer scheduler backend directly, independent of the tick.
+    // A tickless TimerList follows the kernel's tick count instead.
+#if !KERNEL_TIMERS_TICKLESS
+    EXPECT_TRUE(CheckOneShots(&clTimerList));
+    EXPECT_TRUE(CheckRepeats(&clTimerList));
+    EXPECT_TRUE(CheckCoalesce(&clTimerList));
+#endif // #if !KERNEL_TIMERS_TICKLESS
+    EXPECT_TRUE(CheckOneShots(&clTimerWheel));
+    EXPECT_TRUE(CheckRepeats(&clTimerWheel));
+}
+
+TEST(ut_timerlist_clock)
+{
+    // Deadline comparisons must hold across a wrap of the counter.
+    EXPECT_TRUE(TimeAfter(uint32_t{ 5 }, uint32_t{ 0xFFFFFFF0 }));
+    EXPECT_TRUE(TimeBefore(uint32_t{ 0xFFFFFFF0 }, uint32_t{ 5 }));
+    EXPECT_FALSE(TimeAfter(uint32_t{ 5 }, uint32_t{ 5 }));
+    EXPECT_TRUE(DeadlineReached(uint32_t{ 0xFFFFFFF0 }, uint32_t{ 5 }));
+    EXPECT_FALSE(DeadlineReached(uint32_t{ 5 }, uint32_t{ 0xFFFFFFF0 }));
+    EXPECT_EQUALS(TimeUntil(uint32_t{ 5 }, uint32_t{ 0xFFFFFFF0 }), 21);
+    EXPECT_EQUALS(TimeUntil(uint32_t{ 0xFFFFFFF0 }, uint32_t{ 5 }), 0);
+    EXPECT_TRUE(TimeAfter(uint64_t{ 0x100000000ULL }, uint64_t{ 0xFFFFFFFFULL }));
+
+    // The 64-bit tick count is monotonic, and agrees with the 32-bit count.
+    auto u64Start = Kernel::GetTicks64();
+    Thread::Sleep(10);
+    auto u32Now = Kernel::GetTicks();
+    auto u64Now = Kernel::GetTicks64();
+    EXPECT_GTE(u64Now - u64Start, 10);
+    EXPECT_LTE(static_cast<uint32_t>(u64Now) - u32Now, 1);
+}
+
+#if !KERNEL_TIMERS_WHEEL
+TEST(ut_timerlist_tolerance)
+{
+    // Timers whose tolerances overlap expire on the same tick, using a single
+    // timer scheduler wakeup.
+    clTimerSem.Init(0, cu8NumTimers);
+    ResetTimers();
+
+    auto u32Start     = Kernel::GetTicks();
+    auto u32Coalesced = TimerScheduler::GetCoalescedCount();
+    for (uint8_t i = 0; i < 3; i++) {
+        aclTimers[i].Start(false, 50 + (i * 5), 20, OrderCallback, reinterpret_cast<void*>(static_cast<K_ADDR>(i)));
+    }
+    for (uint8_t i = 0; i < 3; i++) { clTimerSem.Pend(); }
+
+    EXPECT_EQUALS(au32Ticks[0], au32Ticks[1]);
+    EXPECT_EQUALS(au32Ticks[1], au32Ticks[2]);
+    EXPECT_GTE(au32Ticks[0] - u32Start, 60);
+    EXPECT_GTE(TimerScheduler::GetCoalescedCount() - u32Coalesced, 2);
+}
+#endif // #if !KERNEL_TIMERS_WHEEL
+
+#if KERNEL_TIMERS_TICKLESS
+TEST(ut_timerlist_forceupdate)
+{
+    // Ticks accounted for by ForceUpdate() must expire timers immediately,
+    // and be reflected in the kernel's tick count.
+    clTimerSem.Init(0, cu8NumTimers);
+    ResetTimers();
+
+    auto u32Start = Kernel::GetTicks();
+    aclTimers[0].Start(false, 1000, OrderCallback, reinterpret_cast<void*>(0));
+    aclTimers[1].Start(false, 5000, OrderCallback, reinterpret_cast<void*>(1));
+    TimerScheduler::ForceUpdate(1000);
+
+    EXPECT_EQUALS(u8ExpiredCount, 1);
+    EXPECT_EQUALS(au8Order[0], 0);
+    EXPECT_GTE(Kernel::GetTicks() - u32Start, 1000);
+
+    aclTimers[1].Stop();
+    EXPECT_EQUALS(u8ExpiredCount, 1);
+}
+#endif // #if KERNEL_TIMERS_TICKLESS
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+TEST_CASE(ut_timerlist_order)
+, TEST_CASE(ut_timerlist_remove), TEST_CASE(ut_timerlist_restart), TEST_CASE(ut_timerlist_repeat), TEST_CASE(ut_timerlist_backends),
+    TEST_CASE(ut_timerlist_clock),
+#if !KERNEL_TIMERS_WHEEL
+    TEST_CASE(ut_timerlist_tolerance),
+#endif // #if !KERNEL_TIMERS_WHEEL
+#if KERNEL_TIMERS_TICKLESS
+    TEST_CASE(ut_timerlist_forceupdate),
+#endif // #if KERNEL_TIMERS_TICKLESS
+    TEST_CASE_END
+} // namespace Mark3
@@ -0,0 +1,264 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2018 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+#if KERNEL_WAIT_SETS
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+WaitSet      clWaitSet;
+MessageQueue clMessageQueue;
+Mailbox      clMailbox;
+Semaphore    clSemaphore;
+EventFlag    clEventFlag;
+Notify       clNotify;
+
+Message  clMessage;
+uint32_t au32MailboxBuffer[4];
+
+Thread clGatewayThread;
+K_WORD awGatewayStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+Thread clLowThread;
+K_WORD awLowStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+constexpr auto cu16FlagMask = uint16_t{ 0x0003 };
+
+volatile uint8_t  u8LastIndex;
+volatile uint32_t u32Events;
+volatile uint32_t u32LastData;
+volatile uint32_t u32WaitEnd;
+
+//---------------------------------------------------------------------------
+// A single thread servicing every object in the set
+void GatewayTask(void* /*unused*/)
+{
+    while (true) {
+        auto u8Index = clWaitSet.Wait();
+        switch (u8Index) {
+            case 0: {
+                auto* pclMessage = clMessageQueue.Receive();
+                u32LastData      = pclMessage->GetCode();
+            } break;
+            case 1: {
+                uint32_t u32Data = 0;
+                clMailbox.TryReceive(&u32Data);
+                u32LastData = u32Data;
+            } break;
+            case 2: {
+                clSemaphore.TryPend();
+            } break;
+            case 3: {
+                u32LastData = clEventFlag.TryWait(cu16FlagMask, EventFlagOperation::Any_Set);
+                clEventFlag.Clear(cu16FlagMask);
+            } break;
+            case 4: {
+                bool bFlag;
+                clNotify.Wait(&bFlag);
+            } break;
+            default: break;
+        }
+        u8LastIndex = u8Index;
+        u32Events++;
+    }
+}
+
+//---------------------------------------------------------------------------
+void InitObjects()
+{
+    clMessageQueue.Init();
+    clMailbox.Init(au32MailboxBuffer, sizeof(au32MailboxBuffer), sizeof(uint32_t));
+    clSemaphore.Init(0, 10);
+    clEventFlag.Init();
+    clNotify.Init();
+    clMessage.Init();
+
+    clWaitSet.Init();
+    clWaitSet.Add(&clMessageQueue);
+    clWaitSet.Add(&clMailbox);
+    clWaitSet.Add(&clSemaphore);
+    clWaitSet.Add(&clEventFlag, cu16FlagMask);
+    clWaitSet.Add(&clNotify);
+
+    u8LastIndex = WAIT_SET_NONE;
+    u32Events   = 0;
+    u32LastData = 0;
+}
+} // anonymous namespace
+#endif // #if KERNEL_WAIT_SETS
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_WAIT_SETS
+TEST(ut_waitset_any)
+{
+    InitObjects();
+    clGatewayThread.Init(awGatewayStack, sizeof(awGatewayStack), 2, GatewayTask, nullptr);
+    clGatewayThread.Start();
+    EXPECT_EQUALS(u32Events, 0);
+
+    // Each object wakes the (higher-priority) gateway thread as soon as it
+    // becomes ready, identifying itself by its index in the set.
+    clMessage.SetCode(1234);
+    clMessageQueue.Send(&clMessage);
+    EXPECT_EQUALS(u32Events, 1);
+    EXPECT_EQUALS(u8LastIndex, 0);
+    EXPECT_EQUALS(u32LastData, 1234);
+
+    uint32_t u32Data = 5678;
+    clMailbox.Send(&u32Data);
+    EXPECT_EQUALS(u32Events, 2);
+    EXPECT_EQUALS(u8LastIndex, 1);
+    EXPECT_EQUALS(u32LastData, 5678);
+
+    clSemaphore.Post();
+    EXPECT_EQUALS(u32Events, 3);
+    EXPECT_EQUALS(u8LastIndex, 2);
+    EXPECT_EQUALS(clSemaphore.GetCount(), 0);
+
+    // Flags outside the mask of interest don't make the object ready
+    clEventFlag.Set(0x0004);
+    EXPECT_EQUALS(u32Events, 3);
+    clEventFlag.Set(0x0002);
+    EXPECT_EQUALS(u32Events, 4);
+    EXPECT_EQUALS(u8LastIndex, 3);
+    EXPECT_EQUALS(u32LastData, 0x0002);
+
+    clNotify.Signal();
+    EXPECT_EQUALS(u32Events, 5);
+    EXPECT_EQUALS(u8LastIndex, 4);
+
+    clGatewayThread.Exit();
+}
+
+//===========================================================================
+TEST(ut_waitset_ready)
+{
+    InitObjects();
+
+    // Objects that are already ready are returned without blocking, lowest
+    // index first, for as long as they remain ready.
+    clNotify.Signal();
+    clSemaphore.Post();
+    EXPECT_EQUALS(clWaitSet.Wait(10), 2);
+    EXPECT_TRUE(clSemaphore.TryPend());
+    EXPECT_EQUALS(clWaitSet.Wait(10), 4);
+    EXPECT_EQUALS(clWaitSet.Wait(10), 4);
+
+    bool bFlag;
+    clNotify.Wait(&bFlag);
+    EXPECT_EQUALS(clWaitSet.Wait(10), WAIT_SET_NONE);
+
+    // Objects added while already ready are returned too
+    clWaitSet.Init();
+    clSemaphore.Post();
+    clWaitSet.Add(&clSemaphore);
+    EXPECT_EQUALS(clWaitSet.Wait(10), 0);
+    EXPECT_TRUE(clSemaphore.TryPend());
+}
+
+//===========================================================================
+TEST(ut_waitset_timeout)
+{
+    InitObjects();
+
+    auto u32Start = Kernel::GetTicks();
+    EXPECT_EQUALS(clWaitSet.Wait(50), WAIT_SET_NONE);
+    EXPECT_GTE(Kernel::GetTicks() - u32Start, 50);
+
+    // An object which becomes ready before the timeout ends the wait early
+    clGatewayThread.Init(awGatewayStack, sizeof(awGatewayStack), 2, [](void* /*unused*/) {
+        Thread::Sleep(20);
+        clSemaphore.Post();
+        Scheduler::GetCurrentThread()->Exit();
+    }, nullptr);
+    clGatewayThread.Start();
+
+    u32Start = Kernel::GetTicks();
+    EXPECT_EQUALS(clWaitSet.Wait(1000), 2);
+    EXPECT_LT(Kernel::GetTicks() - u32Start, 1000);
+    EXPECT_TRUE(clSemaphore.TryPend());
+
+    // Removing the objects from the set stops them signalling it
+    clWaitSet.Init();
+    clSemaphore.Post();
+    EXPECT_EQUALS(clWaitSet.Wait(10), WAIT_SET_NONE);
+}
+
+//===========================================================================
+TEST(ut_waitset_direct)
+{
+    InitObjects();
+    Scheduler::GetCurrentThread()->SetPriority(4);
+
+    // A lower-priority thread blocked on the semaphore itself, rather than
+    // through the set.
+    clLowThread.Init(awLowStack, sizeof(awLowStack), 2, [](void* /*unused*/) {
+        clSemaphore.Pend();
+        u32LastData = 1;
+        Scheduler::GetCurrentThread()->Exit();
+    }, nullptr);
+    clLowThread.Start();
+
+    auto u32Start = Kernel::GetTicks();
+    clGatewayThread.Init(awGatewayStack, sizeof(awGatewayStack), 3, [](void* /*unused*/) {
+        u8LastIndex = clWaitSet.Wait(100);
+        u32WaitEnd  = Kernel::GetTicks();
+        u32Events++;
+        Scheduler::GetCurrentThread()->Exit();
+    }, nullptr);
+    clGatewayThread.Start();
+    Thread::Sleep(5);
+
+    // A post handed to the direct waiter leaves no count behind, so it must
+    // not wake the set - even though the waiter can't preempt this thread.
+    clSemaphore.Post();
+    Thread::Sleep(5);
+    EXPECT_EQUALS(u32LastData, 1);
+    EXPECT_EQUALS(u32Events, 0);
+
+    // A count consumed before the set's waiter gets to run sends it back to
+    // sleep for the rest of its timeout, rather than ending the wait early.
+    clSemaphore.Post();
+    EXPECT_TRUE(clSemaphore.TryPend());
+    Thread::Sleep(200);
+    EXPECT_EQUALS(u32Events, 1);
+    EXPECT_EQUALS(u8LastIndex, WAIT_SET_NONE);
+    EXPECT_GTE(u32WaitEnd - u32Start, 100);
+
+    Scheduler::GetCurrentThread()->SetPriority(1);
+}
+#endif // #if KERNEL_WAIT_SETS
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_WAIT_SETS
+TEST_CASE(ut_waitset_any)
+, TEST_CASE(ut_waitset_ready), TEST_CASE(ut_waitset_timeout), TEST_CASE(ut_waitset_direct),
+#endif // #if KERNEL_WAIT_SETS
+    TEST_CASE_END
+} // namespace Mark3